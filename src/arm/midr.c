@@ -8,6 +8,7 @@
 #ifdef __linux__
   #include <sys/auxv.h>
   #include <asm/hwcap.h>
+  #include <math.h>
   #include "../common/freq.h"
 #elif defined __APPLE__ || __MACH__
   #include "../common/sysctl.h"
@@ -73,7 +74,7 @@ bool read_registry_hklm_int(char* path, char* name, void* value, bool is64) {
 bool get_win32_core_info_int(uint32_t core_index, char* name, void* value, bool is64) {
   // path + digits
   uint32_t max_path_size = 45+3+1;
-  char* path = ecalloc(sizeof(char) * max_path_size, sizeof(char));
+  char* path = acalloc(sizeof(char) * max_path_size, sizeof(char));
   snprintf(path, max_path_size, "HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\%u", core_index);
   return read_registry_hklm_int(path, name, value, is64);
 }
@@ -83,8 +84,39 @@ bool cores_are_equal(int c1pos, int c2pos, uint32_t* midr_array, int32_t* freq_a
   return midr_array[c1pos] == midr_array[c2pos] && freq_array[c1pos] == freq_array[c2pos];
 }
 
+#ifdef __linux__
+#define FREQ_CLUSTER_TOL_PCT 5
+
+// Without cpufreq, cores with the same MIDR but different clocks would
+// end up in the same cluster. Instead, all the cores are measured, and
+// each one joins the first cluster (same MIDR) whose measured frequency
+// is within FREQ_CLUSTER_TOL_PCT of its own
+static bool fill_freq_from_measurement(uint32_t* midr_array, int32_t* freq_array, int ncores) {
+  double* freqs = emalloc(sizeof(double) * ncores);
+  if(!measure_max_frequency_cpus(ncores, freqs)) {
+    free(freqs);
+    return false;
+  }
+
+  for(int i=0; i < ncores; i++) {
+    int j = 0;
+    while(j < i && (midr_array[j] != midr_array[i] || freqs[j] <= 0 || freqs[i] <= 0 ||
+          fabs(freqs[i] - freqs[j]) > freqs[j] * FREQ_CLUSTER_TOL_PCT / 100)) j++;
+
+    if(j < i) freq_array[i] = freq_array[j];
+    else if(freqs[i] > 0) freq_array[i] = (((int) freqs[i] + 5)/10) * 10;
+    else freq_array[i] = freq_array[0];
+    // The next cores are compared against the first core of the cluster
+    if(j < i) freqs[i] = freqs[j];
+  }
+
+  free(freqs);
+  return true;
+}
+#endif
+
 struct cache* get_cache_info(struct cpuInfo* cpu) {
-  struct cache* cach = emalloc(sizeof(struct cache));
+  struct cache* cach = amalloc(sizeof(struct cache));
   init_cache_struct(cach);
 
   cach->max_cache_level = 2;
@@ -97,8 +129,10 @@ struct cache* get_cache_info(struct cpuInfo* cpu) {
   return cach;
 }
 
-struct frequency* get_frequency_info(uint32_t core) {
-  struct frequency* freq = emalloc(sizeof(struct frequency));
+// The max frequency is measured over the cluster of core, i.e,
+// the cores equal to it
+struct frequency* get_frequency_info(uint32_t core, uint32_t* midr_array, int32_t* freq_array, int ncores) {
+  struct frequency* freq = amalloc(sizeof(struct frequency));
 
   freq->measured = false;
   freq->base = UNKNOWN_DATA;
@@ -107,8 +141,11 @@ struct frequency* get_frequency_info(uint32_t core) {
     if (freq->max == UNKNOWN_DATA || measure_max_frequency_flag()) {
       if (freq->max == UNKNOWN_DATA)
         printWarn("Unable to find max frequency from udev, measuring CPU frequency");
-      freq->max = measure_max_frequency(core);
+      bool* cluster = emalloc(sizeof(bool) * ncores);
+      for(int i=0; i < ncores; i++) cluster[i] = cores_are_equal(core, i, midr_array, freq_array);
+      freq->max = measure_max_frequency(ncores, cluster);
       freq->measured = true;
+      free(cluster);
     }
   #endif
 
@@ -116,7 +153,7 @@ struct frequency* get_frequency_info(uint32_t core) {
 }
 
 struct topology* get_topology_info(struct cpuInfo* cpu, struct cache* cach, uint32_t* midr_array, int32_t* freq_array, int socket_idx, int ncores) {
-  struct topology* topo = emalloc(sizeof(struct topology));
+  struct topology* topo = amalloc(sizeof(struct topology));
   init_topology_struct(topo, cach);
 
   int sockets_seen = 0;
@@ -199,6 +236,12 @@ uint32_t fill_ids_from_midr(uint32_t* midr_array, int32_t* freq_array, uint32_t*
 
 void init_cpu_info(struct cpuInfo* cpu) {
   cpu->next_cpu = NULL;
+  cpu->feat = NULL;
+  cpu->freq = NULL;
+  cpu->cach = NULL;
+  cpu->topo = NULL;
+  cpu->soc = NULL;
+  cpu->peak_performance = -1;
 }
 
 // We assume all cpus share the same hardware
@@ -207,7 +250,7 @@ void init_cpu_info(struct cpuInfo* cpu) {
 // ARM32 https://elixir.bootlin.com/linux/latest/source/arch/arm/include/uapi/asm/hwcap.h
 // ARM64 https://elixir.bootlin.com/linux/latest/source/arch/arm64/include/uapi/asm/hwcap.h
 struct features* get_features_info(void) {
-  struct features* feat = emalloc(sizeof(struct features));
+  struct features* feat = amalloc(sizeof(struct features));
   bool *ptr = &(feat->AES);
   for(uint32_t i = 0; i < sizeof(struct features)/sizeof(bool); i++, ptr++) {
     *ptr = false;
@@ -320,10 +363,12 @@ struct cpuInfo* get_cpu_info_linux(struct cpuInfo* cpu) {
   init_cpu_info(cpu);
   int ncores = get_ncores_from_cpuinfo();
   bool success = false;
-  int32_t* freq_array = emalloc(sizeof(uint32_t) * ncores);
-  uint32_t* midr_array = emalloc(sizeof(uint32_t) * ncores);
-  uint32_t* ids_array = emalloc(sizeof(uint32_t) * ncores);
+  bool cpufreq = false;
+  int32_t* freq_array = amalloc(sizeof(uint32_t) * ncores);
+  uint32_t* midr_array = amalloc(sizeof(uint32_t) * ncores);
+  uint32_t* ids_array = amalloc(sizeof(uint32_t) * ncores);
 
+  TRACE_BEGIN(TRACE_PHASE_VENDOR);
   for(int i=0; i < ncores; i++) {
     midr_array[i] = get_midr_from_cpuinfo(i, &success);
 
@@ -337,15 +382,24 @@ struct cpuInfo* get_cpu_info_linux(struct cpuInfo* cpu) {
       printWarn("Unable to fetch max frequency for core %d. This is probably because the core is offline", i);
       freq_array[i] = freq_array[0];
     }
+    else {
+      cpufreq = true;
+    }
+  }
+  if(!cpufreq) {
+    printWarn("Unable to fetch max frequency from cpufreq, clustering cores by measured frequency");
+    if(!fill_freq_from_measurement(midr_array, freq_array, ncores))
+      printWarn("Unable to measure the frequency, cores with the same MIDR will be clustered together");
   }
   uint32_t sockets = fill_ids_from_midr(midr_array, freq_array, ids_array, ncores);
+  TRACE_END(TRACE_PHASE_VENDOR);
 
   struct cpuInfo* ptr = cpu;
   int midr_idx = 0;
   int tmp_midr_idx = 0;
   for(uint32_t i=0; i < sockets; i++) {
     if(i > 0) {
-      ptr->next_cpu = emalloc(sizeof(struct cpuInfo));
+      ptr->next_cpu = amalloc(sizeof(struct cpuInfo));
       ptr = ptr->next_cpu;
       init_cpu_info(ptr);
 
@@ -355,19 +409,63 @@ struct cpuInfo* get_cpu_info_linux(struct cpuInfo* cpu) {
     }
 
     ptr->midr = midr_array[midr_idx];
+    TRACE_BEGIN(TRACE_PHASE_UARCH);
     ptr->arch = get_uarch_from_midr(ptr->midr, ptr);
+    TRACE_END(TRACE_PHASE_UARCH);
 
-    ptr->feat = get_features_info();
-    ptr->freq = get_frequency_info(midr_idx);
-    ptr->cach = get_cache_info(ptr);
-    ptr->topo = get_topology_info(ptr, ptr->cach, midr_array, freq_array, i, ncores);
+    if(probe_enabled(PROBE_FEATURES)) {
+      TRACE_BEGIN(TRACE_PHASE_FEATURES);
+      ptr->feat = get_features_info();
+      TRACE_END(TRACE_PHASE_FEATURES);
+    }
+    if(probe_enabled(PROBE_FREQUENCY)) {
+      TRACE_BEGIN(TRACE_PHASE_FREQUENCY);
+      ptr->freq = get_frequency_info(midr_idx, midr_array, freq_array, ncores);
+      TRACE_END(TRACE_PHASE_FREQUENCY);
+    }
+    if(probe_enabled(PROBE_CACHE)) {
+      TRACE_BEGIN(TRACE_PHASE_CACHE);
+      ptr->cach = get_cache_info(ptr);
+      TRACE_END(TRACE_PHASE_CACHE);
+    }
+    if(probe_enabled(PROBE_TOPOLOGY)) {
+      TRACE_BEGIN(TRACE_PHASE_TOPOLOGY);
+      ptr->topo = get_topology_info(ptr, ptr->cach, midr_array, freq_array, i, ncores);
+      TRACE_END(TRACE_PHASE_TOPOLOGY);
+    }
+  }
+
+  // The rest of the CPUs are only measured for the frequency map,
+  // labeled with the uarch of their cluster (clusters are contiguous)
+  if(freq_map_enabled() && measure_max_frequency_flag() && probe_enabled(PROBE_FREQUENCY)) {
+    const char** core_types = emalloc(sizeof(char *) * ncores);
+    int first_core_idx = 0;
+    ptr = cpu;
+    for(int i=0; i < ncores; i++) {
+      if(!cores_are_equal(first_core_idx, i, midr_array, freq_array)) {
+        first_core_idx = i;
+        if(ptr != NULL) ptr = ptr->next_cpu;
+      }
+      core_types[i] = ptr == NULL ? NULL : get_str_uarch(ptr);
+    }
+    measure_max_frequency_map(ncores, core_types);
+    free(core_types);
   }
 
   cpu->num_cpus = sockets;
-  cpu->hv = emalloc(sizeof(struct hypervisor));
+  cpu->hv = amalloc(sizeof(struct hypervisor));
   cpu->hv->present = false;
-  cpu->soc = get_soc(cpu);
-  cpu->peak_performance = get_peak_performance(cpu);
+  // The SoC detection may need to scan PCI devices
+  if(probe_enabled(PROBE_SOC)) {
+    TRACE_BEGIN(TRACE_PHASE_SOC);
+    cpu->soc = get_soc(cpu);
+    TRACE_END(TRACE_PHASE_SOC);
+  }
+  if(probe_enabled(PROBE_PEAK)) {
+    TRACE_BEGIN(TRACE_PHASE_PEAK);
+    cpu->peak_performance = get_peak_performance(cpu);
+    TRACE_END(TRACE_PHASE_PEAK);
+  }
 
   return cpu;
 }
@@ -381,15 +479,15 @@ void fill_cpu_info_firestorm_icestorm(struct cpuInfo* cpu, uint32_t pcores, uint
   ice->arch = get_uarch_from_midr(ice->midr, ice);
   ice->cach = get_cache_info(ice);
   ice->feat = get_features_info();
-  ice->topo = malloc(sizeof(struct topology));
+  ice->topo = amalloc(sizeof(struct topology));
   ice->topo->cach = ice->cach;
   ice->topo->total_cores = ecores;
-  ice->freq = malloc(sizeof(struct frequency));
+  ice->freq = amalloc(sizeof(struct frequency));
   ice->freq->base = UNKNOWN_DATA;
   ice->freq->max = 2064;
-  ice->hv = malloc(sizeof(struct hypervisor));
+  ice->hv = amalloc(sizeof(struct hypervisor));
   ice->hv->present = false;
-  ice->next_cpu = malloc(sizeof(struct cpuInfo));
+  ice->next_cpu = amalloc(sizeof(struct cpuInfo));
 
   // 2. Fill FIRESTORM
   struct cpuInfo* fire = ice->next_cpu;
@@ -397,13 +495,13 @@ void fill_cpu_info_firestorm_icestorm(struct cpuInfo* cpu, uint32_t pcores, uint
   fire->arch = get_uarch_from_midr(fire->midr, fire);
   fire->cach = get_cache_info(fire);
   fire->feat = get_features_info();
-  fire->topo = malloc(sizeof(struct topology));
+  fire->topo = amalloc(sizeof(struct topology));
   fire->topo->cach = fire->cach;
   fire->topo->total_cores = pcores;
-  fire->freq = malloc(sizeof(struct frequency));
+  fire->freq = amalloc(sizeof(struct frequency));
   fire->freq->base = UNKNOWN_DATA;
   fire->freq->max = 3200;
-  fire->hv = malloc(sizeof(struct hypervisor));
+  fire->hv = amalloc(sizeof(struct hypervisor));
   fire->hv->present = false;
   fire->next_cpu = NULL;
 }
@@ -416,15 +514,15 @@ void fill_cpu_info_avalanche_blizzard(struct cpuInfo* cpu, uint32_t pcores, uint
   bli->arch = get_uarch_from_midr(bli->midr, bli);
   bli->cach = get_cache_info(bli);
   bli->feat = get_features_info();
-  bli->topo = malloc(sizeof(struct topology));
+  bli->topo = amalloc(sizeof(struct topology));
   bli->topo->cach = bli->cach;
   bli->topo->total_cores = ecores;
-  bli->freq = malloc(sizeof(struct frequency));
+  bli->freq = amalloc(sizeof(struct frequency));
   bli->freq->base = UNKNOWN_DATA;
   bli->freq->max = 2800;
-  bli->hv = malloc(sizeof(struct hypervisor));
+  bli->hv = amalloc(sizeof(struct hypervisor));
   bli->hv->present = false;
-  bli->next_cpu = malloc(sizeof(struct cpuInfo));
+  bli->next_cpu = amalloc(sizeof(struct cpuInfo));
 
   // 2. Fill AVALANCHE
   struct cpuInfo* ava = bli->next_cpu;
@@ -432,13 +530,13 @@ void fill_cpu_info_avalanche_blizzard(struct cpuInfo* cpu, uint32_t pcores, uint
   ava->arch = get_uarch_from_midr(ava->midr, ava);
   ava->cach = get_cache_info(ava);
   ava->feat = get_features_info();
-  ava->topo = malloc(sizeof(struct topology));
+  ava->topo = amalloc(sizeof(struct topology));
   ava->topo->cach = ava->cach;
   ava->topo->total_cores = pcores;
-  ava->freq = malloc(sizeof(struct frequency));
+  ava->freq = amalloc(sizeof(struct frequency));
   ava->freq->base = UNKNOWN_DATA;
   ava->freq->max = 3500;
-  ava->hv = malloc(sizeof(struct hypervisor));
+  ava->hv = amalloc(sizeof(struct hypervisor));
   ava->hv->present = false;
   ava->next_cpu = NULL;
 }
@@ -451,15 +549,15 @@ void fill_cpu_info_everest_sawtooth(struct cpuInfo* cpu, uint32_t pcores, uint32
   saw->arch = get_uarch_from_midr(saw->midr, saw);
   saw->cach = get_cache_info(saw);
   saw->feat = get_features_info();
-  saw->topo = malloc(sizeof(struct topology));
+  saw->topo = amalloc(sizeof(struct topology));
   saw->topo->cach = saw->cach;
   saw->topo->total_cores = ecores;
-  saw->freq = malloc(sizeof(struct frequency));
+  saw->freq = amalloc(sizeof(struct frequency));
   saw->freq->base = UNKNOWN_DATA;
   saw->freq->max = 2750;
-  saw->hv = malloc(sizeof(struct hypervisor));
+  saw->hv = amalloc(sizeof(struct hypervisor));
   saw->hv->present = false;
-  saw->next_cpu = malloc(sizeof(struct cpuInfo));
+  saw->next_cpu = amalloc(sizeof(struct cpuInfo));
 
   // 2. Fill EVEREST
   struct cpuInfo* eve = saw->next_cpu;
@@ -467,13 +565,13 @@ void fill_cpu_info_everest_sawtooth(struct cpuInfo* cpu, uint32_t pcores, uint32
   eve->arch = get_uarch_from_midr(eve->midr, eve);
   eve->cach = get_cache_info(eve);
   eve->feat = get_features_info();
-  eve->topo = malloc(sizeof(struct topology));
+  eve->topo = amalloc(sizeof(struct topology));
   eve->topo->cach = eve->cach;
   eve->topo->total_cores = pcores;
-  eve->freq = malloc(sizeof(struct frequency));
+  eve->freq = amalloc(sizeof(struct frequency));
   eve->freq->base = UNKNOWN_DATA;
   eve->freq->max = 4050;
-  eve->hv = malloc(sizeof(struct hypervisor));
+  eve->hv = amalloc(sizeof(struct hypervisor));
   eve->hv->present = false;
   eve->next_cpu = NULL;
 }
@@ -534,9 +632,9 @@ struct cpuInfo* get_cpu_info_windows(struct cpuInfo* cpu) {
   GetSystemInfo(&sys_info);
   int ncores = sys_info.dwNumberOfProcessors;
 
-  uint32_t* midr_array = emalloc(sizeof(uint32_t) * ncores);
-  int32_t* freq_array = emalloc(sizeof(uint32_t) * ncores);
-  uint32_t* ids_array = emalloc(sizeof(uint32_t) * ncores);
+  uint32_t* midr_array = amalloc(sizeof(uint32_t) * ncores);
+  int32_t* freq_array = amalloc(sizeof(uint32_t) * ncores);
+  uint32_t* ids_array = amalloc(sizeof(uint32_t) * ncores);
   for(int i=0; i < ncores; i++) {
     // Cast from 64 to 32 bit to be able to re-use the pre-existing
     // functions such as fill_ids_from_midr and cores_are_equal
@@ -557,7 +655,7 @@ struct cpuInfo* get_cpu_info_windows(struct cpuInfo* cpu) {
   int tmp_midr_idx = 0;
   for(uint32_t i=0; i < sockets; i++) {
     if(i > 0) {
-      ptr->next_cpu = emalloc(sizeof(struct cpuInfo));
+      ptr->next_cpu = amalloc(sizeof(struct cpuInfo));
       ptr = ptr->next_cpu;
       init_cpu_info(ptr);
 
@@ -571,7 +669,7 @@ struct cpuInfo* get_cpu_info_windows(struct cpuInfo* cpu) {
 
     ptr->feat = get_features_info();
     
-    ptr->freq = emalloc(sizeof(struct frequency));
+    ptr->freq = amalloc(sizeof(struct frequency));
     ptr->freq->measured = false;
     ptr->freq->base = freq_array[midr_idx];
     ptr->freq->max = UNKNOWN_DATA;
@@ -581,7 +679,7 @@ struct cpuInfo* get_cpu_info_windows(struct cpuInfo* cpu) {
   }
 
   cpu->num_cpus = sockets;
-  cpu->hv = emalloc(sizeof(struct hypervisor));
+  cpu->hv = amalloc(sizeof(struct hypervisor));
   cpu->hv->present = false;
   cpu->soc = get_soc(cpu);
   cpu->peak_performance = get_peak_performance(cpu);
@@ -591,7 +689,7 @@ struct cpuInfo* get_cpu_info_windows(struct cpuInfo* cpu) {
 #endif
 
 struct cpuInfo* get_cpu_info(void) {
-  struct cpuInfo* cpu = malloc(sizeof(struct cpuInfo));
+  struct cpuInfo* cpu = amalloc(sizeof(struct cpuInfo));
   init_cpu_info(cpu);
 
   #ifdef __linux__
@@ -605,7 +703,7 @@ struct cpuInfo* get_cpu_info(void) {
 
 char* get_str_topology(struct cpuInfo* cpu, struct topology* topo, bool dual_socket) {
   uint32_t size = 3+7+1;
-  char*  string = emalloc(sizeof(char)*size);
+  char*  string = amalloc(sizeof(char)*size);
   snprintf(string, size, "%d cores", topo->total_cores);
 
   return string;
@@ -615,7 +713,7 @@ char* get_str_features(struct cpuInfo* cpu) {
   struct features* feat = cpu->feat;
   uint32_t max_len = strlen("NEON,SHA1,SHA2,AES,CRC32,SVE,SVE2,") + 1;
   uint32_t len = 0;
-  char* string = ecalloc(max_len, sizeof(char));
+  char* string = acalloc(max_len, sizeof(char));
 
   if(feat->NEON) {
     strcat(string, "NEON,");
@@ -691,7 +789,3 @@ void print_debug(struct cpuInfo* cpu) {
     printf("hw.perflevel1.physicalcpu: %d\n", get_sys_info_by_name("hw.perflevel1.physicalcpu"));
   #endif
 }
-
-void free_topo_struct(struct topology* topo) {
-  free(topo);
-}
@@ -10,7 +10,6 @@ char* get_str_topology(struct cpuInfo* cpu, struct topology* topo, bool dual_soc
 char* get_str_features(struct cpuInfo* cpu);
 
 void print_debug(struct cpuInfo* cpu);
-void free_topo_struct(struct topology* topo);
 
 // Code taken from cpuinfo (https://github.com/pytorch/cpuinfo/blob/master/src/arm/midr.h)
 #define CPUINFO_ARM_MIDR_IMPLEMENTER_MASK  UINT32_C(0xFF000000)
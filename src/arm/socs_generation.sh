@@ -1,6 +1,6 @@
 #!/bin/bash -u
 
-SOC_LIST="$(grep SOC_EQ soc.c | grep -v '//SOC_EQ' | grep -v 'define' | cut -d',' -f2 | sed 's/"//')"
+SOC_LIST="$(grep '^SOC_EQ(' socs.def | grep -v '//SOC_EQ' | grep -v 'define' | cut -d',' -f2 | sed 's/"//')"
 
 IFS=$'"'
 
@@ -0,0 +1,1501 @@
+// Generated by socs_index_generation.sh from socs.def, do not edit
+#ifndef __SOCS_INDEX__
+#define __SOCS_INDEX__
+
+struct soc_index_entry {
+  char* pattern;
+  char* name;
+  SOC model;
+  int32_t process;
+};
+
+// child and sibling link the nodes of the trie (-1 if none), term is
+// the first entry whose pattern ends at the node and min is the first
+// entry in the subtree rooted at the node (-1 if none)
+struct soc_trie_node {
+  char c;
+  int16_t child;
+  int16_t sibling;
+  int16_t term;
+  int16_t min;
+};
+
+struct soc_index {
+  const struct soc_index_entry* entries;
+  const struct soc_trie_node* nodes;
+  int num_entries;
+};
+
+// broadcom: 15 entries, 48 nodes
+static const struct soc_index_entry SOC_ENTRIES_BROADCOM[] = {
+  { "BCM2835", "BCM2835", SOC_BCM_2835, 65 },
+  { "BCM2836", "BCM2836", SOC_BCM_2836, 40 },
+  { "BCM2837", "BCM2837", SOC_BCM_2837, 40 },
+  { "BCM2837B0", "BCM2837B0", SOC_BCM_2837B0, 40 },
+  { "BCM21553", "BCM21553", SOC_BCM_21553, 65 },
+  { "BCM21553-Thunderbird", "BCM21553 Thunderbird", SOC_BCM_21553T, 65 },
+  { "BCM21663", "BCM21663", SOC_BCM_21663, 40 },
+  { "BCM21664", "BCM21664", SOC_BCM_21664, 40 },
+  { "BCM28155", "BCM28155", SOC_BCM_28155, 40 },
+  { "BCM23550", "BCM23550", SOC_BCM_23550, 40 },
+  { "BCM28145", "BCM28145", SOC_BCM_28145, 40 },
+  { "BCM2157", "BCM2157", SOC_BCM_2157, 65 },
+  { "BCM21654", "BCM21654", SOC_BCM_21654, 40 },
+  { "BCM2711", "BCM2711", SOC_BCM_2711, 28 },
+  { "BCM2712", "BCM2712", SOC_BCM_2712, 16 },
+};
+
+static const struct soc_trie_node SOC_TRIE_BROADCOM[] = {
+  {    0,    1,   -1,   -1,    0 },
+  {  'B',    2,   -1,   -1,    0 },
+  {  'C',    3,   -1,   -1,    0 },
+  {  'M',    4,   -1,   -1,    0 },
+  {  '2',    5,   -1,   -1,    0 },
+  {  '8',    6,   12,   -1,    0 },
+  {  '3',    7,   32,   -1,    0 },
+  {  '5',   -1,    8,    0,    0 },
+  {  '6',   -1,    9,    1,    1 },
+  {  '7',   10,   -1,    2,    2 },
+  {  'B',   11,   -1,   -1,    3 },
+  {  '0',   -1,   -1,    3,    3 },
+  {  '1',   13,   35,   -1,    4 },
+  {  '5',   14,   28,   -1,    4 },
+  {  '5',   15,   41,   -1,    4 },
+  {  '3',   16,   -1,    4,    4 },
+  {  '-',   17,   -1,   -1,    5 },
+  {  'T',   18,   -1,   -1,    5 },
+  {  'h',   19,   -1,   -1,    5 },
+  {  'u',   20,   -1,   -1,    5 },
+  {  'n',   21,   -1,   -1,    5 },
+  {  'd',   22,   -1,   -1,    5 },
+  {  'e',   23,   -1,   -1,    5 },
+  {  'r',   24,   -1,   -1,    5 },
+  {  'b',   25,   -1,   -1,    5 },
+  {  'i',   26,   -1,   -1,    5 },
+  {  'r',   27,   -1,   -1,    5 },
+  {  'd',   -1,   -1,    5,    5 },
+  {  '6',   29,   -1,   -1,    6 },
+  {  '6',   30,   42,   -1,    6 },
+  {  '3',   -1,   31,    6,    6 },
+  {  '4',   -1,   -1,    7,    7 },
+  {  '1',   33,   -1,   -1,    8 },
+  {  '5',   34,   39,   -1,    8 },
+  {  '5',   -1,   -1,    8,    8 },
+  {  '3',   36,   44,   -1,    9 },
+  {  '5',   37,   -1,   -1,    9 },
+  {  '5',   38,   -1,   -1,    9 },
+  {  '0',   -1,   -1,    9,    9 },
+  {  '4',   40,   -1,   -1,   10 },
+  {  '5',   -1,   -1,   10,   10 },
+  {  '7',   -1,   -1,   11,   11 },
+  {  '5',   43,   -1,   -1,   12 },
+  {  '4',   -1,   -1,   12,   12 },
+  {  '7',   45,   -1,   -1,   13 },
+  {  '1',   46,   -1,   -1,   13 },
+  {  '1',   -1,   47,   13,   13 },
+  {  '2',   -1,   -1,   14,   14 },
+};
+
+static const struct soc_index SOC_INDEX_BROADCOM = { SOC_ENTRIES_BROADCOM, SOC_TRIE_BROADCOM, 15 };
+
+// google: 3 entries, 12 nodes
+static const struct soc_index_entry SOC_ENTRIES_GOOGLE[] = {
+  { "gs101", "Tensor", SOC_GOOGLE_TENSOR, 5 },
+  { "gs201", "Tensor G2", SOC_GOOGLE_TENSOR_G2, 5 },
+  { "gs301", "Tensor G3", SOC_GOOGLE_TENSOR_G3, 4 },
+};
+
+static const struct soc_trie_node SOC_TRIE_GOOGLE[] = {
+  {    0,    1,   -1,   -1,    0 },
+  {  'g',    2,   -1,   -1,    0 },
+  {  's',    3,   -1,   -1,    0 },
+  {  '1',    4,    6,   -1,    0 },
+  {  '0',    5,   -1,   -1,    0 },
+  {  '1',   -1,   -1,    0,    0 },
+  {  '2',    7,    9,   -1,    1 },
+  {  '0',    8,   -1,   -1,    1 },
+  {  '1',   -1,   -1,    1,    1 },
+  {  '3',   10,   -1,   -1,    2 },
+  {  '0',   11,   -1,   -1,    2 },
+  {  '1',   -1,   -1,    2,    2 },
+};
+
+static const struct soc_index SOC_INDEX_GOOGLE = { SOC_ENTRIES_GOOGLE, SOC_TRIE_GOOGLE, 3 };
+
+// hisilicon: 8 entries, 32 nodes
+static const struct soc_index_entry SOC_ENTRIES_HISILICON[] = {
+  { "hi3620GFC", "K3V2", SOC_HISILICON_3620, 40 },
+  { "hi3630", "920", SOC_HISILICON_3630, 28 },
+  { "hi3650", "950", SOC_HISILICON_3650, 16 },
+  { "hi3660", "960", SOC_HISILICON_3660, 16 },
+  { "hi3670", "970", SOC_HISILICON_3670, 10 },
+  { "hi3680", "980", SOC_HISILICON_3680, 7 },
+  { "hi3690", "990", SOC_HISILICON_3690, 7 },
+  { "kirin9000s", "9000s", SOC_HISILICON_9000S, 7 },
+};
+
+static const struct soc_trie_node SOC_TRIE_HISILICON[] = {
+  {    0,    1,   -1,   -1,    0 },
+  {  'h',    2,   22,   -1,    0 },
+  {  'i',    3,   -1,   -1,    0 },
+  {  '3',    4,   -1,   -1,    0 },
+  {  '6',    5,   -1,   -1,    0 },
+  {  '2',    6,   10,   -1,    0 },
+  {  '0',    7,   -1,   -1,    0 },
+  {  'G',    8,   -1,   -1,    0 },
+  {  'F',    9,   -1,   -1,    0 },
+  {  'C',   -1,   -1,    0,    0 },
+  {  '3',   11,   12,   -1,    1 },
+  {  '0',   -1,   -1,    1,    1 },
+  {  '5',   13,   14,   -1,    2 },
+  {  '0',   -1,   -1,    2,    2 },
+  {  '6',   15,   16,   -1,    3 },
+  {  '0',   -1,   -1,    3,    3 },
+  {  '7',   17,   18,   -1,    4 },
+  {  '0',   -1,   -1,    4,    4 },
+  {  '8',   19,   20,   -1,    5 },
+  {  '0',   -1,   -1,    5,    5 },
+  {  '9',   21,   -1,   -1,    6 },
+  {  '0',   -1,   -1,    6,    6 },
+  {  'k',   23,   -1,   -1,    7 },
+  {  'i',   24,   -1,   -1,    7 },
+  {  'r',   25,   -1,   -1,    7 },
+  {  'i',   26,   -1,   -1,    7 },
+  {  'n',   27,   -1,   -1,    7 },
+  {  '9',   28,   -1,   -1,    7 },
+  {  '0',   29,   -1,   -1,    7 },
+  {  '0',   30,   -1,   -1,    7 },
+  {  '0',   31,   -1,   -1,    7 },
+  {  's',   -1,   -1,    7,    7 },
+};
+
+static const struct soc_index SOC_INDEX_HISILICON = { SOC_ENTRIES_HISILICON, SOC_TRIE_HISILICON, 8 };
+
+// exynos: 70 entries, 170 nodes
+static const struct soc_index_entry SOC_ENTRIES_EXYNOS[] = {
+  { "exynos3475", "3475", SOC_EXYNOS_3475, 28 },
+  { "universal3475", "3475", SOC_EXYNOS_3475, 28 },
+  { "exynos4210", "4210", SOC_EXYNOS_4210, 45 },
+  { "universal4210", "4210", SOC_EXYNOS_4210, 45 },
+  { "exynos4212", "4212", SOC_EXYNOS_4212, 32 },
+  { "universal4212", "4212", SOC_EXYNOS_4212, 32 },
+  { "exynos4412", "4412", SOC_EXYNOS_4412, 32 },
+  { "universal4412", "4412", SOC_EXYNOS_4412, 32 },
+  { "exynos5250", "5250", SOC_EXYNOS_5250, 32 },
+  { "universal5250", "5250", SOC_EXYNOS_5250, 32 },
+  { "exynos5410", "5410", SOC_EXYNOS_5410, 28 },
+  { "universal5410", "5410", SOC_EXYNOS_5410, 28 },
+  { "exynos5420", "5420", SOC_EXYNOS_5420, 28 },
+  { "universal5420", "5420", SOC_EXYNOS_5420, 28 },
+  { "exynos5422", "5422", SOC_EXYNOS_5422, 28 },
+  { "universal5422", "5422", SOC_EXYNOS_5422, 28 },
+  { "exynos5430", "5430", SOC_EXYNOS_5430, 20 },
+  { "universal5430", "5430", SOC_EXYNOS_5430, 20 },
+  { "exynos5433", "5433", SOC_EXYNOS_5433, 20 },
+  { "universal5433", "5433", SOC_EXYNOS_5433, 20 },
+  { "exynos5260", "5260", SOC_EXYNOS_5260, 28 },
+  { "universal5260", "5260", SOC_EXYNOS_5260, 28 },
+  { "exynos7270", "7270", SOC_EXYNOS_7270, 14 },
+  { "universal7270", "7270", SOC_EXYNOS_7270, 14 },
+  { "exynos7420", "7420", SOC_EXYNOS_7420, 14 },
+  { "universal7420", "7420", SOC_EXYNOS_7420, 14 },
+  { "exynos7570", "7570", SOC_EXYNOS_7570, 14 },
+  { "universal7570", "7570", SOC_EXYNOS_7570, 14 },
+  { "exynos7570", "7570", SOC_EXYNOS_7570, 14 },
+  { "universal7570", "7570", SOC_EXYNOS_7570, 14 },
+  { "exynos7870", "7870", SOC_EXYNOS_7870, 14 },
+  { "universal7870", "7870", SOC_EXYNOS_7870, 14 },
+  { "exynos7870", "7870", SOC_EXYNOS_7870, 14 },
+  { "universal7870", "7870", SOC_EXYNOS_7870, 14 },
+  { "exynos7872", "7872", SOC_EXYNOS_7872, 14 },
+  { "universal7872", "7872", SOC_EXYNOS_7872, 14 },
+  { "exynos7880", "7880", SOC_EXYNOS_7880, 14 },
+  { "universal7880", "7880", SOC_EXYNOS_7880, 14 },
+  { "exynos7884", "7884", SOC_EXYNOS_7884, 14 },
+  { "universal7884", "7884", SOC_EXYNOS_7884, 14 },
+  { "exynos7885", "7885", SOC_EXYNOS_7885, 14 },
+  { "universal7885", "7885", SOC_EXYNOS_7885, 14 },
+  { "exynos7904", "7904", SOC_EXYNOS_7904, 14 },
+  { "universal7904", "7904", SOC_EXYNOS_7904, 14 },
+  { "exynos8890", "8890", SOC_EXYNOS_8890, 14 },
+  { "universal8890", "8890", SOC_EXYNOS_8890, 14 },
+  { "exynos8895", "8895", SOC_EXYNOS_8895, 10 },
+  { "universal8895", "8895", SOC_EXYNOS_8895, 10 },
+  { "exynos9110", "9110", SOC_EXYNOS_9110, 14 },
+  { "universal9110", "9110", SOC_EXYNOS_9110, 14 },
+  { "exynos9609", "9609", SOC_EXYNOS_9609, 10 },
+  { "universal9609", "9609", SOC_EXYNOS_9609, 10 },
+  { "exynos9610", "9610", SOC_EXYNOS_9610, 10 },
+  { "universal9610", "9610", SOC_EXYNOS_9610, 10 },
+  { "exynos9611", "9611", SOC_EXYNOS_9611, 10 },
+  { "universal9611", "9611", SOC_EXYNOS_9611, 10 },
+  { "exynos9810", "9810", SOC_EXYNOS_9810, 10 },
+  { "universal9810", "9810", SOC_EXYNOS_9810, 10 },
+  { "exynos9820", "9820", SOC_EXYNOS_9820, 8 },
+  { "universal9820", "9820", SOC_EXYNOS_9820, 8 },
+  { "exynos9825", "9825", SOC_EXYNOS_9825, 7 },
+  { "universal9825", "9825", SOC_EXYNOS_9825, 7 },
+  { "exynos1080", "1080", SOC_EXYNOS_1080, 5 },
+  { "universal1080", "1080", SOC_EXYNOS_1080, 5 },
+  { "exynos990", "990", SOC_EXYNOS_990, 7 },
+  { "universal990", "990", SOC_EXYNOS_990, 7 },
+  { "exynos980", "980", SOC_EXYNOS_980, 8 },
+  { "universal980", "980", SOC_EXYNOS_980, 8 },
+  { "exynos880", "880", SOC_EXYNOS_880, 8 },
+  { "universal880", "880", SOC_EXYNOS_880, 8 },
+};
+
+static const struct soc_trie_node SOC_TRIE_EXYNOS[] = {
+  {    0,    1,   -1,   -1,    0 },
+  {  'e',    2,   11,   -1,    0 },
+  {  'x',    3,   -1,   -1,    0 },
+  {  'y',    4,   -1,   -1,    0 },
+  {  'n',    5,   -1,   -1,    0 },
+  {  'o',    6,   -1,   -1,    0 },
+  {  's',    7,   -1,   -1,    0 },
+  {  '3',    8,   24,   -1,    0 },
+  {  '4',    9,   -1,   -1,    0 },
+  {  '7',   10,   -1,   -1,    0 },
+  {  '5',   -1,   -1,    0,    0 },
+  {  'u',   12,   -1,   -1,    1 },
+  {  'n',   13,   -1,   -1,    1 },
+  {  'i',   14,   -1,   -1,    1 },
+  {  'v',   15,   -1,   -1,    1 },
+  {  'e',   16,   -1,   -1,    1 },
+  {  'r',   17,   -1,   -1,    1 },
+  {  's',   18,   -1,   -1,    1 },
+  {  'a',   19,   -1,   -1,    1 },
+  {  'l',   20,   -1,   -1,    1 },
+  {  '3',   21,   28,   -1,    1 },
+  {  '4',   22,   -1,   -1,    1 },
+  {  '7',   23,   -1,   -1,    1 },
+  {  '5',   -1,   -1,    1,    1 },
+  {  '4',   25,   40,   -1,    2 },
+  {  '2',   26,   34,   -1,    2 },
+  {  '1',   27,   -1,   -1,    2 },
+  {  '0',   -1,   32,    2,    2 },
+  {  '4',   29,   44,   -1,    3 },
+  {  '2',   30,   37,   -1,    3 },
+  {  '1',   31,   -1,   -1,    3 },
+  {  '0',   -1,   33,    3,    3 },
+  {  '2',   -1,   -1,    4,    4 },
+  {  '2',   -1,   -1,    5,    5 },
+  {  '4',   35,   -1,   -1,    6 },
+  {  '1',   36,   -1,   -1,    6 },
+  {  '2',   -1,   -1,    6,    6 },
+  {  '4',   38,   -1,   -1,    7 },
+  {  '1',   39,   -1,   -1,    7 },
+  {  '2',   -1,   -1,    7,    7 },
+  {  '5',   41,   70,   -1,    8 },
+  {  '2',   42,   48,   -1,    8 },
+  {  '5',   43,   66,   -1,    8 },
+  {  '0',   -1,   -1,    8,    8 },
+  {  '5',   45,   74,   -1,    9 },
+  {  '2',   46,   51,   -1,    9 },
+  {  '5',   47,   68,   -1,    9 },
+  {  '0',   -1,   -1,    9,    9 },
+  {  '4',   49,   -1,   -1,   10 },
+  {  '1',   50,   54,   -1,   10 },
+  {  '0',   -1,   -1,   10,   10 },
+  {  '4',   52,   -1,   -1,   11 },
+  {  '1',   53,   56,   -1,   11 },
+  {  '0',   -1,   -1,   11,   11 },
+  {  '2',   55,   60,   -1,   12 },
+  {  '0',   -1,   58,   12,   12 },
+  {  '2',   57,   62,   -1,   13 },
+  {  '0',   -1,   59,   13,   13 },
+  {  '2',   -1,   -1,   14,   14 },
+  {  '2',   -1,   -1,   15,   15 },
+  {  '3',   61,   -1,   -1,   16 },
+  {  '0',   -1,   64,   16,   16 },
+  {  '3',   63,   -1,   -1,   17 },
+  {  '0',   -1,   65,   17,   17 },
+  {  '3',   -1,   -1,   18,   18 },
+  {  '3',   -1,   -1,   19,   19 },
+  {  '6',   67,   -1,   -1,   20 },
+  {  '0',   -1,   -1,   20,   20 },
+  {  '6',   69,   -1,   -1,   21 },
+  {  '0',   -1,   -1,   21,   21 },
+  {  '7',   71,  112,   -1,   22 },
+  {  '2',   72,   78,   -1,   22 },
+  {  '7',   73,   -1,   -1,   22 },
+  {  '0',   -1,   -1,   22,   22 },
+  {  '7',   75,  116,   -1,   23 },
+  {  '2',   76,   81,   -1,   23 },
+  {  '7',   77,   -1,   -1,   23 },
+  {  '0',   -1,   -1,   23,   23 },
+  {  '4',   79,   84,   -1,   24 },
+  {  '2',   80,   -1,   -1,   24 },
+  {  '0',   -1,   -1,   24,   24 },
+  {  '4',   82,   87,   -1,   25 },
+  {  '2',   83,   -1,   -1,   25 },
+  {  '0',   -1,   -1,   25,   25 },
+  {  '5',   85,   90,   -1,   26 },
+  {  '7',   86,   -1,   -1,   26 },
+  {  '0',   -1,   -1,   26,   26 },
+  {  '5',   88,   93,   -1,   27 },
+  {  '7',   89,   -1,   -1,   27 },
+  {  '0',   -1,   -1,   27,   27 },
+  {  '8',   91,  106,   -1,   30 },
+  {  '7',   92,   98,   -1,   30 },
+  {  '0',   -1,   96,   30,   30 },
+  {  '8',   94,  109,   -1,   31 },
+  {  '7',   95,  100,   -1,   31 },
+  {  '0',   -1,   97,   31,   31 },
+  {  '2',   -1,   -1,   34,   34 },
+  {  '2',   -1,   -1,   35,   35 },
+  {  '8',   99,   -1,   -1,   36 },
+  {  '0',   -1,  102,   36,   36 },
+  {  '8',  101,   -1,   -1,   37 },
+  {  '0',   -1,  103,   37,   37 },
+  {  '4',   -1,  104,   38,   38 },
+  {  '4',   -1,  105,   39,   39 },
+  {  '5',   -1,   -1,   40,   40 },
+  {  '5',   -1,   -1,   41,   41 },
+  {  '9',  107,   -1,   -1,   42 },
+  {  '0',  108,   -1,   -1,   42 },
+  {  '4',   -1,   -1,   42,   42 },
+  {  '9',  110,   -1,   -1,   43 },
+  {  '0',  111,   -1,   -1,   43 },
+  {  '4',   -1,   -1,   43,   43 },
+  {  '8',  113,  122,   -1,   44 },
+  {  '8',  114,   -1,   -1,   44 },
+  {  '9',  115,  168,   -1,   44 },
+  {  '0',   -1,  120,   44,   44 },
+  {  '8',  117,  126,   -1,   45 },
+  {  '8',  118,   -1,   -1,   45 },
+  {  '9',  119,  169,   -1,   45 },
+  {  '0',   -1,  121,   45,   45 },
+  {  '5',   -1,   -1,   46,   46 },
+  {  '5',   -1,   -1,   47,   47 },
+  {  '9',  123,  154,   -1,   48 },
+  {  '1',  124,  130,   -1,   48 },
+  {  '1',  125,   -1,   -1,   48 },
+  {  '0',   -1,   -1,   48,   48 },
+  {  '9',  127,  158,   -1,   49 },
+  {  '1',  128,  133,   -1,   49 },
+  {  '1',  129,   -1,   -1,   49 },
+  {  '0',   -1,   -1,   49,   49 },
+  {  '6',  131,  142,   -1,   50 },
+  {  '0',  132,  136,   -1,   50 },
+  {  '9',   -1,   -1,   50,   50 },
+  {  '6',  134,  145,   -1,   51 },
+  {  '0',  135,  138,   -1,   51 },
+  {  '9',   -1,   -1,   51,   51 },
+  {  '1',  137,   -1,   -1,   52 },
+  {  '0',   -1,  140,   52,   52 },
+  {  '1',  139,   -1,   -1,   53 },
+  {  '0',   -1,  141,   53,   53 },
+  {  '1',   -1,   -1,   54,   54 },
+  {  '1',   -1,   -1,   55,   55 },
+  {  '8',  143,  162,   -1,   56 },
+  {  '1',  144,  148,   -1,   56 },
+  {  '0',   -1,   -1,   56,   56 },
+  {  '8',  146,  164,   -1,   57 },
+  {  '1',  147,  150,   -1,   57 },
+  {  '0',   -1,   -1,   57,   57 },
+  {  '2',  149,  166,   -1,   58 },
+  {  '0',   -1,  152,   58,   58 },
+  {  '2',  151,  167,   -1,   59 },
+  {  '0',   -1,  153,   59,   59 },
+  {  '5',   -1,   -1,   60,   60 },
+  {  '5',   -1,   -1,   61,   61 },
+  {  '1',  155,   -1,   -1,   62 },
+  {  '0',  156,   -1,   -1,   62 },
+  {  '8',  157,   -1,   -1,   62 },
+  {  '0',   -1,   -1,   62,   62 },
+  {  '1',  159,   -1,   -1,   63 },
+  {  '0',  160,   -1,   -1,   63 },
+  {  '8',  161,   -1,   -1,   63 },
+  {  '0',   -1,   -1,   63,   63 },
+  {  '9',  163,   -1,   -1,   64 },
+  {  '0',   -1,   -1,   64,   64 },
+  {  '9',  165,   -1,   -1,   65 },
+  {  '0',   -1,   -1,   65,   65 },
+  {  '0',   -1,   -1,   66,   66 },
+  {  '0',   -1,   -1,   67,   67 },
+  {  '0',   -1,   -1,   68,   68 },
+  {  '0',   -1,   -1,   69,   69 },
+};
+
+static const struct soc_index SOC_INDEX_EXYNOS = { SOC_ENTRIES_EXYNOS, SOC_TRIE_EXYNOS, 70 };
+
+// mediatek: 145 entries, 239 nodes
+static const struct soc_index_entry SOC_ENTRIES_MEDIATEK[] = {
+  { "MT6983Z", "Dimensity 9000", SOC_MTK_MT6983Z, 4 },
+  { "MT8798Z/C", "Dimensity 9000", SOC_MTK_MT8798ZC, 4 },
+  { "MT6983W", "Dimensity 9000+", SOC_MTK_MT6983W, 4 },
+  { "MT8798Z/T", "Dimensity 9000+", SOC_MTK_MT8798ZT, 4 },
+  { "MT6985W", "Dimensity 9200+", SOC_MTK_MT6985W, 4 },
+  { "MT6985", "Dimensity 9200", SOC_MTK_MT6985, 4 },
+  { "MT6989", "Dimensity 9300", SOC_MTK_MT6989, 4 },
+  { "MT8796", "Dimensity 9300", SOC_MTK_MT8796, 4 },
+  { "MT6893Z", "Dimensity 1300", SOC_MTK_MT6893Z, 6 },
+  { "MT6893", "Dimensity 1200", SOC_MTK_MT6893, 6 },
+  { "MT6891", "Dimensity 1100", SOC_MTK_MT6891, 6 },
+  { "MT6879", "Dimensity 1050", SOC_MTK_MT6879, 6 },
+  { "MT6889", "Dimensity 1000", SOC_MTK_MT6889, 7 },
+  { "MT6885Z", "Dimensity 1000L", SOC_MTK_MT6885Z, 7 },
+  { "MT6889Z", "Dimensity 1000+", SOC_MTK_MT6889Z, 7 },
+  { "MT6883Z", "Dimensity 1000C", SOC_MTK_MT6883Z, 7 },
+  { "MT6877V/Z", "Dimensity 900", SOC_MTK_MT6877VZ, 6 },
+  { "MT6877T", "Dimensity 920", SOC_MTK_MT6877T, 6 },
+  { "MT6855", "Dimensity 930", SOC_MTK_MT6855, 6 },
+  { "MT6873", "Dimensity 800", SOC_MTK_MT6873, 7 },
+  { "MT6853V/T", "Dimensity 800U", SOC_MTK_MT6853VT, 7 },
+  { "MT6853T", "Dimensity 800U", SOC_MTK_MT6853T, 7 },
+  { "MT6833P", "Dimensity 810", SOC_MTK_MT6833P, 6 },
+  { "MT6833GP", "Dimensity 810", SOC_MTK_MT6833GP, 6 },
+  { "MT6833V", "Dimensity 810", SOC_MTK_MT6833V, 6 },
+  { "MT6875", "Dimensity 820", SOC_MTK_MT6875, 7 },
+  { "MT6833", "Dimensity 700", SOC_MTK_MT6833, 7 },
+  { "MT6853V", "Dimensity 720", SOC_MTK_MT6853, 7 },
+  { "MT6761D", "Helio A20", SOC_MTK_MT6761D, 12 },
+  { "MT6761", "Helio A22", SOC_MTK_MT6761, 12 },
+  { "MT6762D", "Helio A25", SOC_MTK_MT6762D, 12 },
+  { "MT6762G", "Helio G25", SOC_MTK_MT6762G, 12 },
+  { "MT6765G", "Helio G35", SOC_MTK_MT6765G, 12 },
+  { "MT6765H", "Helio G37", SOC_MTK_MT6765H, 12 },
+  { "MT6769V", "Helio G70", SOC_MTK_MT6769V, 12 },
+  { "MT6769T", "Helio G80", SOC_MTK_MT6769T, 12 },
+  { "MT6769Z", "Helio G85", SOC_MTK_MT6769Z, 12 },
+  { "MT6769H", "Helio G88", SOC_MTK_MT6769H, 12 },
+  { "MT6785V/CC", "Helio G90T", SOC_MTK_MT6785V_CC, 12 },
+  { "MT6785V/CD", "Helio G95", SOC_MTK_MT6785V_CD, 12 },
+  { "MT6789", "Helio G99", SOC_MTK_MT6789, 6 },
+  { "MT8781V", "Helio G99", SOC_MTK_MT8781V, 6 },
+  { "MT6755", "Helio P10", SOC_MTK_MT6755M, 28 },
+  { "MT6755M", "Helio P10 M", SOC_MTK_MT6755M, 28 },
+  { "MT6755T", "Helio P15", SOC_MTK_MT6755T, 28 },
+  { "MT6757", "Helio P20", SOC_MTK_MT6757, 16 },
+  { "MT6762", "Helio P22", SOC_MTK_MT6762, 12 },
+  { "MT6763V", "Helio P23", SOC_MTK_MT6763V, 16 },
+  { "MT6763T", "Helio P23", SOC_MTK_MT6763T, 16 },
+  { "MT6757CD", "Helio P25", SOC_MTK_MT6757CD, 16 },
+  { "MT6758", "Helio P30", SOC_MTK_MT6758, 16 },
+  { "MT6765", "Helio P35", SOC_MTK_MT6765, 12 },
+  { "MT6771", "Helio P60", SOC_MTK_MT6771, 12 },
+  { "MT6768", "Helio P65", SOC_MTK_MT6768, 12 },
+  { "MT6771T", "Helio P70", SOC_MTK_MT6771, 12 },
+  { "MT6771V", "Helio P70", SOC_MTK_MT6771, 12 },
+  { "MT6779V/CU", "Helio P90", SOC_MTK_MT6779V_CU, 12 },
+  { "MT6779V/CV", "Helio P95", SOC_MTK_MT6779V_CV, 12 },
+  { "MT6795", "Helio X10", SOC_MTK_MT6795, 28 },
+  { "MT6795T", "Helio X10 T", SOC_MTK_MT6795, 28 },
+  { "MT6797", "Helio X20", SOC_MTK_MT6797, 20 },
+  { "MT6797M", "Helio X20 M", SOC_MTK_MT6797, 20 },
+  { "MT6797D", "Helio X23", SOC_MTK_MT6797, 20 },
+  { "MT6797T", "Helio X25", SOC_MTK_MT6797T, 20 },
+  { "MT6797X", "Helio X27", SOC_MTK_MT6797X, 20 },
+  { "MT6799", "Helio X30", SOC_MTK_MT6799, 10 },
+  { "MT9618", "Pentonic  700", SOC_MTK_MT9618, 7 },
+  { "MT9653", "Pentonic  700", SOC_MTK_MT9653, 7 },
+  { "MT9689", "Pentonic  700", SOC_MTK_MT9689, 7 },
+  { "MT9972", "Pentonic 1000", SOC_MTK_MT9972, 7 },
+  { "MT9902", "Pentonic 2000", SOC_MTK_MT9902, 7 },
+  { "MT9982", "Pentonic 2000", SOC_MTK_MT9982, 7 },
+  { "MT5327", "MT5327", SOC_MTK_MT5327, NA },
+  { "MT5329", "MT5329", SOC_MTK_MT5329, NA },
+  { "MT5366", "MT5366", SOC_MTK_MT5366, NA },
+  { "MT5389", "MT5389", SOC_MTK_MT5389, NA },
+  { "MT5395", "MT5395", SOC_MTK_MT5395, NA },
+  { "MT5396", "MT5396", SOC_MTK_MT5396, NA },
+  { "MT5398", "MT5398", SOC_MTK_MT5398, NA },
+  { "MT5505", "MT5505", SOC_MTK_MT5505, NA },
+  { "MT5561", "MT5561", SOC_MTK_MT5561, NA },
+  { "MT5580", "MT5580", SOC_MTK_MT5580, NA },
+  { "MT5582", "MT5582", SOC_MTK_MT5582, NA },
+  { "MT5592", "MT5592", SOC_MTK_MT5592, NA },
+  { "MT5595", "MT5595", SOC_MTK_MT5595, NA },
+  { "MT5596", "MT5596", SOC_MTK_MT5596, 28 },
+  { "MT5597", "MT5597", SOC_MTK_MT5597, 28 },
+  { "MT5895", "MT5895", SOC_MTK_MT5895, 28 },
+  { "MT5889", "MT5889", SOC_MTK_MT5889, 28 },
+  { "MT6515", "MT6515", SOC_MTK_MT6515, 40 },
+  { "MT6516", "MT6516", SOC_MTK_MT6516, 65 },
+  { "MT6517", "MT6517", SOC_MTK_MT6517, 40 },
+  { "MT6572", "MT6572", SOC_MTK_MT6572, 28 },
+  { "MT6572M", "MT6572M", SOC_MTK_MT6572M, 28 },
+  { "MT6573", "MT6573", SOC_MTK_MT6573, 65 },
+  { "MT6575", "MT6575", SOC_MTK_MT6575, 40 },
+  { "MT6577", "MT6577", SOC_MTK_MT6577, 40 },
+  { "MT6577T", "MT6577T", SOC_MTK_MT6577T, 40 },
+  { "MT6580", "MT6580", SOC_MTK_MT6580, 28 },
+  { "MT6582", "MT6582", SOC_MTK_MT6582, 28 },
+  { "MT6582M", "MT6582M", SOC_MTK_MT6582M, 28 },
+  { "MT6589", "MT6589", SOC_MTK_MT6589, 28 },
+  { "MT6589T", "MT6589T", SOC_MTK_MT6589T, 28 },
+  { "MT6592", "MT6592", SOC_MTK_MT6592, 28 },
+  { "MT6595", "MT6595", SOC_MTK_MT6595, 28 },
+  { "MT6732", "MT6732", SOC_MTK_MT6732, 28 },
+  { "MT6735", "MT6735", SOC_MTK_MT6735, 28 },
+  { "MT6735M", "MT6735M", SOC_MTK_MT6735M, 28 },
+  { "MT6735P", "MT6735P", SOC_MTK_MT6735P, 28 },
+  { "MT6737", "MT6737", SOC_MTK_MT6737, 28 },
+  { "MT6737M", "MT6737M", SOC_MTK_MT6737M, 28 },
+  { "MT6737T", "MT6737T", SOC_MTK_MT6737T, 28 },
+  { "MT6739", "MT6739", SOC_MTK_MT6739, 28 },
+  { "MT6750", "MT6750", SOC_MTK_MT6750, 28 },
+  { "MT6750S", "MT6750S", SOC_MTK_MT6750S, 28 },
+  { "MT6750T", "MT6750T", SOC_MTK_MT6750T, 28 },
+  { "MT6752", "MT6752", SOC_MTK_MT6752, 28 },
+  { "MT6753", "MT6753", SOC_MTK_MT6753, 28 },
+  { "MT6850", "MT6850", SOC_MTK_MT6850, 28 },
+  { "MT8121", "MT8121", SOC_MTK_MT8121, 40 },
+  { "MT8125", "MT8125", SOC_MTK_MT8125, 40 },
+  { "MT8127", "MT8127", SOC_MTK_MT8127, 32 },
+  { "MT8135", "MT8135", SOC_MTK_MT8135, 28 },
+  { "MT8163A", "MT8163A", SOC_MTK_MT8163A, 28 },
+  { "MT8163B", "MT8163B", SOC_MTK_MT8163B, 28 },
+  { "MT8167B", "MT8167B", SOC_MTK_MT8167B, 28 },
+  { "MT8173", "MT8173", SOC_MTK_MT8173, 28 },
+  { "MT8176", "MT8176", SOC_MTK_MT8176, 28 },
+  { "MT8321", "MT8321", SOC_MTK_MT8321, 28 },
+  { "MT8382", "MT8382", SOC_MTK_MT8382, 28 },
+  { "MT8581", "MT8581", SOC_MTK_MT8581, 28 },
+  { "MT8735", "MT8735", SOC_MTK_MT8735, 28 },
+  { "MT8765B", "MT8765B", SOC_MTK_MT8765B, 28 },
+  { "MT8783", "MT8783", SOC_MTK_MT8783, 28 },
+  { "MT9602", "MT9602", SOC_MTK_MT9602, 28 },
+  { "MT9612", "MT9612", SOC_MTK_MT9612, 28 },
+  { "MT9613", "MT9613", SOC_MTK_MT9613, 28 },
+  { "MT9615", "MT9615", SOC_MTK_MT9615, 28 },
+  { "MT9632", "MT9632", SOC_MTK_MT9632, 28 },
+  { "MT9638", "MT9638", SOC_MTK_MT9638, 28 },
+  { "MT9652", "MT9652", SOC_MTK_MT9652, 28 },
+  { "MT9675", "MT9675", SOC_MTK_MT9675, 28 },
+  { "MT9685", "MT9685", SOC_MTK_MT9685, 28 },
+  { "MT9950", "MT9950", SOC_MTK_MT9950, 28 },
+  { "MT9686", "MT9686", SOC_MTK_MT9686, 28 },
+};
+
+static const struct soc_trie_node SOC_TRIE_MEDIATEK[] = {
+  {    0,    1,   -1,   -1,    0 },
+  {  'M',    2,   -1,   -1,    0 },
+  {  'T',    3,   -1,   -1,    0 },
+  {  '6',    4,    8,   -1,    0 },
+  {  '9',    5,   21,   -1,    0 },
+  {  '8',    6,   -1,   -1,    0 },
+  {  '3',    7,   17,   -1,    0 },
+  {  'Z',   -1,   15,    0,    0 },
+  {  '8',    9,  112,   -1,    1 },
+  {  '7',   10,  194,   -1,    1 },
+  {  '9',   11,   78,   -1,    1 },
+  {  '8',   12,   20,   -1,    1 },
+  {  'Z',   13,   -1,   -1,    1 },
+  {  '/',   14,   -1,   -1,    1 },
+  {  'C',   -1,   16,    1,    1 },
+  {  'W',   -1,   -1,    2,    2 },
+  {  'T',   -1,   -1,    3,    3 },
+  {  '5',   18,   19,    5,    4 },
+  {  'W',   -1,   -1,    4,    4 },
+  {  '9',   -1,   -1,    6,    6 },
+  {  '6',   -1,   -1,    7,    7 },
+  {  '8',   22,   55,   -1,    8 },
+  {  '9',   23,   26,   -1,    8 },
+  {  '3',   24,   25,    9,    8 },
+  {  'Z',   -1,   -1,    8,    8 },
+  {  '1',   -1,   -1,   10,   10 },
+  {  '7',   27,   28,   -1,   11 },
+  {  '9',   -1,   35,   11,   11 },
+  {  '8',   29,   40,   -1,   12 },
+  {  '9',   32,   30,   12,   12 },
+  {  '5',   31,   33,   -1,   13 },
+  {  'Z',   -1,   -1,   13,   13 },
+  {  'Z',   -1,   -1,   14,   14 },
+  {  '3',   34,   -1,   -1,   15 },
+  {  'Z',   -1,   -1,   15,   15 },
+  {  '7',   36,   42,   -1,   16 },
+  {  'V',   37,   39,   -1,   16 },
+  {  '/',   38,   -1,   -1,   16 },
+  {  'Z',   -1,   -1,   16,   16 },
+  {  'T',   -1,   -1,   17,   17 },
+  {  '5',   41,   48,   -1,   18 },
+  {  '5',   -1,   43,   18,   18 },
+  {  '3',   -1,   54,   19,   19 },
+  {  '3',   44,  193,   -1,   20 },
+  {  'V',   45,   47,   27,   20 },
+  {  '/',   46,   -1,   -1,   20 },
+  {  'T',   -1,   -1,   20,   20 },
+  {  'T',   -1,   -1,   21,   21 },
+  {  '3',   49,   -1,   -1,   22 },
+  {  '3',   50,   -1,   26,   22 },
+  {  'P',   -1,   51,   22,   22 },
+  {  'G',   52,   53,   -1,   23 },
+  {  'P',   -1,   -1,   23,   23 },
+  {  'V',   -1,   -1,   24,   24 },
+  {  '5',   -1,   -1,   25,   25 },
+  {  '7',   56,  158,   -1,   28 },
+  {  '6',   57,   70,   -1,   28 },
+  {  '1',   58,   59,   29,   28 },
+  {  'D',   -1,   -1,   28,   28 },
+  {  '2',   60,   62,   46,   30 },
+  {  'D',   -1,   61,   30,   30 },
+  {  'G',   -1,   -1,   31,   31 },
+  {  '5',   63,   65,   51,   32 },
+  {  'G',   -1,   64,   32,   32 },
+  {  'H',   -1,   -1,   33,   33 },
+  {  '9',   66,   86,   -1,   34 },
+  {  'V',   -1,   67,   34,   34 },
+  {  'T',   -1,   68,   35,   35 },
+  {  'Z',   -1,   69,   36,   36 },
+  {  'H',   -1,   -1,   37,   37 },
+  {  '8',   71,   81,   -1,   38 },
+  {  '5',   72,   77,   -1,   38 },
+  {  'V',   73,   -1,   -1,   38 },
+  {  '/',   74,   -1,   -1,   38 },
+  {  'C',   75,   -1,   -1,   38 },
+  {  'C',   -1,   76,   38,   38 },
+  {  'D',   -1,   -1,   39,   39 },
+  {  '9',   -1,   -1,   40,   40 },
+  {  '8',   79,  218,   -1,   41 },
+  {  '1',   80,  223,   -1,   41 },
+  {  'V',   -1,   -1,   41,   41 },
+  {  '5',   82,   92,   -1,   42 },
+  {  '5',   83,   85,   42,   42 },
+  {  'M',   -1,   84,   43,   43 },
+  {  'T',   -1,   -1,   44,   44 },
+  {  '7',   89,   91,   45,   45 },
+  {  '3',   87,   94,   -1,   47 },
+  {  'V',   -1,   88,   47,   47 },
+  {  'T',   -1,   -1,   48,   48 },
+  {  'C',   90,   -1,   -1,   49 },
+  {  'D',   -1,   -1,   49,   49 },
+  {  '8',   -1,  188,   50,   50 },
+  {  '7',   93,  103,   -1,   52 },
+  {  '1',   95,   97,   52,   52 },
+  {  '8',   -1,   -1,   53,   53 },
+  {  'T',   -1,   96,   54,   54 },
+  {  'V',   -1,   -1,   55,   55 },
+  {  '9',   98,   -1,   -1,   56 },
+  {  'V',   99,   -1,   -1,   56 },
+  {  '/',  100,   -1,   -1,   56 },
+  {  'C',  101,   -1,   -1,   56 },
+  {  'U',   -1,  102,   56,   56 },
+  {  'V',   -1,   -1,   57,   57 },
+  {  '9',  104,  179,   -1,   58 },
+  {  '5',  105,  106,   58,   58 },
+  {  'T',   -1,   -1,   59,   59 },
+  {  '7',  107,  111,   60,   60 },
+  {  'M',   -1,  108,   61,   61 },
+  {  'D',   -1,  109,   62,   62 },
+  {  'T',   -1,  110,   63,   63 },
+  {  'X',   -1,   -1,   64,   64 },
+  {  '9',   -1,   -1,   65,   65 },
+  {  '9',  113,  127,   -1,   66 },
+  {  '6',  114,  120,   -1,   66 },
+  {  '1',  115,  116,   -1,   66 },
+  {  '8',   -1,  226,   66,   66 },
+  {  '5',  117,  118,   -1,   67 },
+  {  '3',   -1,  232,   67,   67 },
+  {  '8',  119,  224,   -1,   68 },
+  {  '9',   -1,  235,   68,   68 },
+  {  '9',  121,   -1,   -1,   69 },
+  {  '7',  122,  123,   -1,   69 },
+  {  '2',   -1,   -1,   69,   69 },
+  {  '0',  124,  125,   -1,   70 },
+  {  '2',   -1,   -1,   70,   70 },
+  {  '8',  126,  236,   -1,   71 },
+  {  '2',   -1,   -1,   71,   71 },
+  {  '5',  128,   -1,   -1,   72 },
+  {  '3',  129,  140,   -1,   72 },
+  {  '2',  130,  132,   -1,   72 },
+  {  '7',   -1,  131,   72,   72 },
+  {  '9',   -1,   -1,   73,   73 },
+  {  '6',  133,  134,   -1,   74 },
+  {  '6',   -1,   -1,   74,   74 },
+  {  '8',  135,  136,   -1,   75 },
+  {  '9',   -1,   -1,   75,   75 },
+  {  '9',  137,   -1,   -1,   76 },
+  {  '5',   -1,  138,   76,   76 },
+  {  '6',   -1,  139,   77,   77 },
+  {  '8',   -1,   -1,   78,   78 },
+  {  '5',  141,  153,   -1,   79 },
+  {  '0',  142,  143,   -1,   79 },
+  {  '5',   -1,   -1,   79,   79 },
+  {  '6',  144,  145,   -1,   80 },
+  {  '1',   -1,   -1,   80,   80 },
+  {  '8',  146,  148,   -1,   81 },
+  {  '0',   -1,  147,   81,   81 },
+  {  '2',   -1,   -1,   82,   82 },
+  {  '9',  149,   -1,   -1,   83 },
+  {  '2',   -1,  150,   83,   83 },
+  {  '5',   -1,  151,   84,   84 },
+  {  '6',   -1,  152,   85,   85 },
+  {  '7',   -1,   -1,   86,   86 },
+  {  '8',  154,   -1,   -1,   87 },
+  {  '9',  155,  156,   -1,   87 },
+  {  '5',   -1,   -1,   87,   87 },
+  {  '8',  157,   -1,   -1,   88 },
+  {  '9',   -1,   -1,   88,   88 },
+  {  '5',  159,   -1,   -1,   89 },
+  {  '1',  160,  163,   -1,   89 },
+  {  '5',   -1,  161,   89,   89 },
+  {  '6',   -1,  162,   90,   90 },
+  {  '7',   -1,   -1,   91,   91 },
+  {  '7',  164,  170,   -1,   92 },
+  {  '2',  165,  166,   92,   92 },
+  {  'M',   -1,   -1,   93,   93 },
+  {  '3',   -1,  167,   94,   94 },
+  {  '5',   -1,  168,   95,   95 },
+  {  '7',  169,   -1,   96,   96 },
+  {  'T',   -1,   -1,   97,   97 },
+  {  '8',  171,  176,   -1,   98 },
+  {  '0',   -1,  172,   98,   98 },
+  {  '2',  173,  174,   99,   99 },
+  {  'M',   -1,   -1,  100,  100 },
+  {  '9',  175,   -1,  101,  101 },
+  {  'T',   -1,   -1,  102,  102 },
+  {  '9',  177,   -1,   -1,  103 },
+  {  '2',   -1,  178,  103,  103 },
+  {  '5',   -1,   -1,  104,  104 },
+  {  '3',  180,   -1,   -1,  105 },
+  {  '2',   -1,  181,  105,  105 },
+  {  '5',  182,  184,  106,  106 },
+  {  'M',   -1,  183,  107,  107 },
+  {  'P',   -1,   -1,  108,  108 },
+  {  '7',  185,  187,  109,  109 },
+  {  'M',   -1,  186,  110,  110 },
+  {  'T',   -1,   -1,  111,  111 },
+  {  '9',   -1,   -1,  112,  112 },
+  {  '0',  189,  191,  113,  113 },
+  {  'S',   -1,  190,  114,  114 },
+  {  'T',   -1,   -1,  115,  115 },
+  {  '2',   -1,  192,  116,  116 },
+  {  '3',   -1,   -1,  117,  117 },
+  {  '0',   -1,   -1,  118,  118 },
+  {  '1',  195,  210,   -1,  119 },
+  {  '2',  196,  199,   -1,  119 },
+  {  '1',   -1,  197,  119,  119 },
+  {  '5',   -1,  198,  120,  120 },
+  {  '7',   -1,   -1,  121,  121 },
+  {  '3',  200,  201,   -1,  122 },
+  {  '5',   -1,   -1,  122,  122 },
+  {  '6',  202,  207,   -1,  123 },
+  {  '3',  203,  205,   -1,  123 },
+  {  'A',   -1,  204,  123,  123 },
+  {  'B',   -1,   -1,  124,  124 },
+  {  '7',  206,   -1,   -1,  125 },
+  {  'B',   -1,   -1,  125,  125 },
+  {  '7',  208,   -1,   -1,  126 },
+  {  '3',   -1,  209,  126,  126 },
+  {  '6',   -1,   -1,  127,  127 },
+  {  '3',  211,  215,   -1,  128 },
+  {  '2',  212,  213,   -1,  128 },
+  {  '1',   -1,   -1,  128,  128 },
+  {  '8',  214,   -1,   -1,  129 },
+  {  '2',   -1,   -1,  129,  129 },
+  {  '5',  216,   -1,   -1,  130 },
+  {  '8',  217,   -1,   -1,  130 },
+  {  '1',   -1,   -1,  130,  130 },
+  {  '3',  219,  220,   -1,  131 },
+  {  '5',   -1,   -1,  131,  131 },
+  {  '6',  221,   -1,   -1,  132 },
+  {  '5',  222,   -1,   -1,  132 },
+  {  'B',   -1,   -1,  132,  132 },
+  {  '3',   -1,   -1,  133,  133 },
+  {  '0',  225,  229,   -1,  134 },
+  {  '2',   -1,   -1,  134,  134 },
+  {  '2',   -1,  227,  135,  135 },
+  {  '3',   -1,  228,  136,  136 },
+  {  '5',   -1,   -1,  137,  137 },
+  {  '3',  230,  233,   -1,  138 },
+  {  '2',   -1,  231,  138,  138 },
+  {  '8',   -1,   -1,  139,  139 },
+  {  '2',   -1,   -1,  140,  140 },
+  {  '7',  234,   -1,   -1,  141 },
+  {  '5',   -1,   -1,  141,  141 },
+  {  '5',   -1,  238,  142,  142 },
+  {  '5',  237,   -1,   -1,  143 },
+  {  '0',   -1,   -1,  143,  143 },
+  {  '6',   -1,   -1,  144,  144 },
+};
+
+static const struct soc_index SOC_INDEX_MEDIATEK = { SOC_ENTRIES_MEDIATEK, SOC_TRIE_MEDIATEK, 145 };
+
+// qualcomm: 127 entries, 311 nodes
+static const struct soc_index_entry SOC_ENTRIES_QUALCOMM[] = {
+  { "QSD8650", "S1", SOC_SNAPD_QSD8650, 65 },
+  { "QSD8250", "S1", SOC_SNAPD_QSD8250, 65 },
+  { "MSM7627", "S1", SOC_SNAPD_MSM7627, 65 },
+  { "MSM7227", "S1", SOC_SNAPD_MSM7227, 65 },
+  { "MSM7627A", "S1", SOC_SNAPD_MSM7627A, 45 },
+  { "MSM7227A", "S1", SOC_SNAPD_MSM7227A, 45 },
+  { "MSM7625", "S1", SOC_SNAPD_MSM7625, 65 },
+  { "MSM7225", "S1", SOC_SNAPD_MSM7225, 65 },
+  { "MSM7625A", "S1", SOC_SNAPD_MSM7625A, 45 },
+  { "MSM7225A", "S1", SOC_SNAPD_MSM7225A, 45 },
+  { "MSM8655", "S2", SOC_SNAPD_MSM8655, 45 },
+  { "MSM8255", "S2", SOC_SNAPD_MSM8255, 45 },
+  { "APQ8055", "S2", SOC_SNAPD_APQ8055, 45 },
+  { "MSM7630", "S2", SOC_SNAPD_MSM7630, 45 },
+  { "MSM7230", "S2", SOC_SNAPD_MSM7230, 45 },
+  { "MSM8660", "S3", SOC_SNAPD_MSM8660, 45 },
+  { "MSM8260", "S3", SOC_SNAPD_MSM8260, 45 },
+  { "APQ8060", "S3", SOC_SNAPD_APQ8060, 45 },
+  { "MSM8225", "S4 Play", SOC_SNAPD_MSM8225, 45 },
+  { "MSM8625", "S4 Play", SOC_SNAPD_MSM8625, 45 },
+  { "APQ8060A", "S4 Plus", SOC_SNAPD_APQ8060A, 28 },
+  { "MSM8960", "S4 Plus", SOC_SNAPD_MSM8960, 28 },
+  { "MSM8260A", "S4 Plus", SOC_SNAPD_MSM8260A, 28 },
+  { "MSM8627", "S4 Plus", SOC_SNAPD_MSM8627, 28 },
+  { "MSM8227", "S4 Plus", SOC_SNAPD_MSM8227, 28 },
+  { "APQ8064", "S4 Pro", SOC_SNAPD_APQ8064, 28 },
+  { "MSM8960T", "S4 Pro", SOC_SNAPD_MSM8960T, 28 },
+  { "MSM8110", "200", SOC_SNAPD_MSM8110, 28 },
+  { "MSM8210", "200", SOC_SNAPD_MSM8210, 28 },
+  { "MSM8610", "200", SOC_SNAPD_MSM8610, 28 },
+  { "MSM8112", "200", SOC_SNAPD_MSM8112, 28 },
+  { "MSM8212", "200", SOC_SNAPD_MSM8212, 28 },
+  { "MSM8612", "200", SOC_SNAPD_MSM8612, 28 },
+  { "MSM8225Q", "200", SOC_SNAPD_MSM8225Q, 45 },
+  { "MSM8625Q", "200", SOC_SNAPD_MSM8625Q, 45 },
+  { "MSM8208", "208", SOC_SNAPD_MSM8208, 28 },
+  { "MSM8905", "205", SOC_SNAPD_MSM8905, 28 },
+  { "MSM8909", "210 / 212", SOC_SNAPD_MSM8909, 28 },
+  { "QM215", "215", SOC_SNAPD_QM215, 28 },
+  { "APQ8028", "400", SOC_SNAPD_APQ8028, 28 },
+  { "MSM8228", "400", SOC_SNAPD_MSM8228, 28 },
+  { "MSM8628", "400", SOC_SNAPD_MSM8628, 28 },
+  { "MSM8928", "400", SOC_SNAPD_MSM8928, 28 },
+  { "MSM8926", "400", SOC_SNAPD_MSM8926, 28 },
+  { "APQ8030AB", "400", SOC_SNAPD_APQ8030AB, 28 },
+  { "MSM8226", "400", SOC_SNAPD_MSM8226, 28 },
+  { "MSM8230AB", "400", SOC_SNAPD_MSM8230AB, 28 },
+  { "MSM8626", "400", SOC_SNAPD_MSM8626, 28 },
+  { "MSM8630", "400", SOC_SNAPD_MSM8630, 28 },
+  { "MSM8630AB", "400", SOC_SNAPD_MSM8630AB, 28 },
+  { "MSM8930", "400", SOC_SNAPD_MSM8930, 28 },
+  { "MSM8930AB", "400", SOC_SNAPD_MSM8930AB, 28 },
+  { "MSM8916", "410 / 412", SOC_SNAPD_MSM8916, 28 },
+  { "MSM8929", "415", SOC_SNAPD_MSM8929, 28 },
+  { "MSM8917", "425", SOC_SNAPD_MSM8917, 28 },
+  { "MSM8920", "427", SOC_SNAPD_MSM8920, 28 },
+  { "SDM429", "429", SOC_SNAPD_SDM429, 12 },
+  { "MSM8937", "430", SOC_SNAPD_MSM8937, 28 },
+  { "MSM8940", "435", SOC_SNAPD_MSM8940, 28 },
+  { "SDM439", "439", SOC_SNAPD_SDM439, 12 },
+  { "SDM450", "450", SOC_SNAPD_SDM450, 14 },
+  { "SM4250-AA", "460", SOC_SNAPD_SM4250_AA, 11 },
+  { "APQ8064T", "600", SOC_SNAPD_APQ8064T, 28 },
+  { "APQ8064M", "600", SOC_SNAPD_APQ8064M, 28 },
+  { "MSM8936", "610", SOC_SNAPD_MSM8936, 28 },
+  { "MSM8939", "615 / 616", SOC_SNAPD_MSM8939, 28 },
+  { "MSM8952", "617", SOC_SNAPD_MSM8952, 28 },
+  { "MSM8953", "625", SOC_SNAPD_MSM8953, 14 },
+  { "MSM8953 PRO", "626", SOC_SNAPD_MSM8953_PRO, 14 },
+  { "SDM630", "630", SOC_SNAPD_SDM630, 14 },
+  { "SDM632", "632", SOC_SNAPD_SDM632, 14 },
+  { "SDM636", "636", SOC_SNAPD_SDM636, 14 },
+  { "MSM8956", "650", SOC_SNAPD_MSM8956, 28 },
+  { "MSM8976", "652", SOC_SNAPD_MSM8976, 28 },
+  { "MSM8976 PRO", "653", SOC_SNAPD_MSM8976_PRO, 28 },
+  { "SDM660", "660", SOC_SNAPD_SDM660, 14 },
+  { "SM6115", "662", SOC_SNAPD_SM6115, 11 },
+  { "SM6125", "665", SOC_SNAPD_SM6125, 11 },
+  { "SDM670", "670", SOC_SNAPD_SDM670, 10 },
+  { "SM6150", "675", SOC_SNAPD_SM6150, 11 },
+  { "SM6350", "690", SOC_SNAPD_SM6350, 8 },
+  { "SDM710", "710", SOC_SNAPD_SDM710, 10 },
+  { "SDM712", "712", SOC_SNAPD_SDM712, 10 },
+  { "SM7125", "720G", SOC_SNAPD_SM7125, 8 },
+  { "SM7150-AA", "730", SOC_SNAPD_SM7150_AA, 8 },
+  { "SM7150-AB", "730G", SOC_SNAPD_SM7150_AB, 8 },
+  { "SDM730G", "730G", SOC_SNAPD_SM7150_AB, 8 },
+  { "SM7150-AC", "732G", SOC_SNAPD_SM7150_AC, 8 },
+  { "SM7225", "750G", SOC_SNAPD_SM7225, 8 },
+  { "SM7250-AA", "765", SOC_SNAPD_SM7250_AA, 7 },
+  { "SM7250-AB", "765G", SOC_SNAPD_SM7250_AB, 7 },
+  { "SM7250-AC", "768G", SOC_SNAPD_SM7250_AC, 7 },
+  { "MSM8974AA", "800", SOC_SNAPD_MSM8974AA, 28 },
+  { "MSM8974AB", "800", SOC_SNAPD_MSM8974AB, 28 },
+  { "MSM8974AC", "800", SOC_SNAPD_MSM8974AC, 28 },
+  { "MSM8974PRO-AB", "801", SOC_SNAPD_MSM8974PRO_AB, 28 },
+  { "MSM8974PRO-AC", "801", SOC_SNAPD_MSM8974PRO_AC, 28 },
+  { "APQ8084", "805", SOC_SNAPD_APQ8084, 28 },
+  { "MSM8992", "808", SOC_SNAPD_MSM8992, 20 },
+  { "MSM8994", "810", SOC_SNAPD_MSM8994, 20 },
+  { "MSM8996", "820", SOC_SNAPD_MSM8996, 14 },
+  { "MSM8996 PRO A", "821", SOC_SNAPD_MSM8996_PRO_A, 14 },
+  { "MSM8998", "835", SOC_SNAPD_MSM8998, 10 },
+  { "APQ8098", "835", SOC_SNAPD_APQ8098, 10 },
+  { "SDM845", "845", SOC_SNAPD_SDM845, 10 },
+  { "SDM850", "850", SOC_SNAPD_SDM850, 10 },
+  { "SM8150", "855", SOC_SNAPD_SM8150, 7 },
+  { "SM8150-AC", "855+", SOC_SNAPD_SM8150_AC, 7 },
+  { "SM8250", "865", SOC_SNAPD_SM8250, 7 },
+  { "SM8250-AB", "865+", SOC_SNAPD_SM8250_AB, 7 },
+  { "SM8350", "888", SOC_SNAPD_SM8350, 5 },
+  { "SM8350-AC", "888+", SOC_SNAPD_SM8350, 5 },
+  { "SM4375", "4 Gen 1", SOC_SNAPD_SM4375, 6 },
+  { "SM4450", "4 Gen 2", SOC_SNAPD_SM4450, 4 },
+  { "SM4635", "4s Gen 2", SOC_SNAPD_SM4635, 4 },
+  { "SM6375-AC", "6s Gen 3", SOC_SNAPD_SM6375_AC, 6 },
+  { "SM6450", "6 Gen 1", SOC_SNAPD_SM6450, 4 },
+  { "SM7435-AB", "7s Gen 2", SOC_SNAPD_SM7435_AB, 4 },
+  { "SM7450", "7 Gen 1", SOC_SNAPD_SM7450, 4 },
+  { "SM7475", "7+ Gen 2", SOC_SNAPD_SM7475, 4 },
+  { "SM7550-AB", "7 Gen 3", SOC_SNAPD_SM7550_AB, 4 },
+  { "SM7675-AB", "7+ Gen 3", SOC_SNAPD_SM7675_AB, 4 },
+  { "SM8450", "8 Gen 1", SOC_SNAPD_SM8450, 4 },
+  { "SM8475", "8+ Gen 1", SOC_SNAPD_SM8475, 4 },
+  { "SM8550-AB", "8 Gen 2", SOC_SNAPD_SM8550_AB, 4 },
+  { "SM8635", "8s Gen 3", SOC_SNAPD_SM8635, 4 },
+  { "SM8650-AB", "8 Gen 3", SOC_SNAPD_SM8650_AB, 4 },
+};
+
+static const struct soc_trie_node SOC_TRIE_QUALCOMM[] = {
+  {    0,    1,   -1,   -1,    0 },
+  {  'Q',    2,   11,   -1,    0 },
+  {  'S',    3,   81,   -1,    0 },
+  {  'D',    4,   -1,   -1,    0 },
+  {  '8',    5,   -1,   -1,    0 },
+  {  '6',    6,    8,   -1,    0 },
+  {  '5',    7,   -1,   -1,    0 },
+  {  '0',   -1,   -1,    0,    0 },
+  {  '2',    9,   -1,   -1,    1 },
+  {  '5',   10,   -1,   -1,    1 },
+  {  '0',   -1,   -1,    1,    1 },
+  {  'M',   12,   34,   -1,    2 },
+  {  'S',   13,   -1,   -1,    2 },
+  {  'M',   14,   -1,   -1,    2 },
+  {  '7',   15,   27,   -1,    2 },
+  {  '6',   16,   18,   -1,    2 },
+  {  '2',   17,   41,   -1,    2 },
+  {  '7',   21,   23,    2,    2 },
+  {  '2',   19,   -1,   -1,    3 },
+  {  '2',   20,   43,   -1,    3 },
+  {  '7',   22,   24,    3,    3 },
+  {  'A',   -1,   -1,    4,    4 },
+  {  'A',   -1,   -1,    5,    5 },
+  {  '5',   25,   -1,    6,    6 },
+  {  '5',   26,   -1,    7,    7 },
+  {  'A',   -1,   -1,    8,    8 },
+  {  'A',   -1,   -1,    9,    9 },
+  {  '8',   28,   -1,   -1,   10 },
+  {  '6',   29,   31,   -1,   10 },
+  {  '5',   30,   45,   -1,   10 },
+  {  '5',   -1,   -1,   10,   10 },
+  {  '2',   32,   56,   -1,   11 },
+  {  '5',   33,   47,   -1,   11 },
+  {  '5',   -1,   -1,   11,   11 },
+  {  'A',   35,  115,   -1,   12 },
+  {  'P',   36,   -1,   -1,   12 },
+  {  'Q',   37,   -1,   -1,   12 },
+  {  '8',   38,   -1,   -1,   12 },
+  {  '0',   39,   -1,   -1,   12 },
+  {  '5',   40,   49,   -1,   12 },
+  {  '5',   -1,   -1,   12,   12 },
+  {  '3',   42,   -1,   -1,   13 },
+  {  '0',   -1,   -1,   13,   13 },
+  {  '3',   44,   -1,   -1,   14 },
+  {  '0',   -1,   -1,   14,   14 },
+  {  '6',   46,   53,   -1,   15 },
+  {  '0',   -1,   -1,   15,   15 },
+  {  '6',   48,   51,   -1,   16 },
+  {  '0',   59,   -1,   16,   16 },
+  {  '6',   50,   85,   -1,   17 },
+  {  '0',   55,   62,   17,   17 },
+  {  '2',   52,   67,   -1,   18 },
+  {  '5',   74,   61,   18,   18 },
+  {  '2',   54,   69,   -1,   19 },
+  {  '5',   75,   60,   19,   19 },
+  {  'A',   -1,   -1,   20,   20 },
+  {  '9',   57,   64,   -1,   21 },
+  {  '6',   58,   78,   -1,   21 },
+  {  '0',   63,   -1,   21,   21 },
+  {  'A',   -1,   -1,   22,   22 },
+  {  '7',   -1,   88,   23,   23 },
+  {  '7',   -1,   87,   24,   24 },
+  {  '4',  136,   -1,   25,   25 },
+  {  'T',   -1,   -1,   26,   26 },
+  {  '1',   65,   -1,   -1,   27 },
+  {  '1',   66,   -1,   -1,   27 },
+  {  '0',   -1,   71,   27,   27 },
+  {  '1',   68,   76,   -1,   28 },
+  {  '0',   -1,   72,   28,   28 },
+  {  '1',   70,  102,   -1,   29 },
+  {  '0',   -1,   73,   29,   29 },
+  {  '2',   -1,   -1,   30,   30 },
+  {  '2',   -1,   -1,   31,   31 },
+  {  '2',   -1,   -1,   32,   32 },
+  {  'Q',   -1,   -1,   33,   33 },
+  {  'Q',   -1,   -1,   34,   34 },
+  {  '0',   77,   97,   -1,   35 },
+  {  '8',   -1,   -1,   35,   35 },
+  {  '0',   79,   89,   -1,   36 },
+  {  '5',   -1,   80,   36,   36 },
+  {  '9',   -1,   -1,   37,   37 },
+  {  'M',   82,   -1,   -1,   38 },
+  {  '2',   83,   -1,   -1,   38 },
+  {  '1',   84,   -1,   -1,   38 },
+  {  '5',   -1,   -1,   38,   38 },
+  {  '2',   86,   92,   -1,   39 },
+  {  '8',   -1,   -1,   39,   39 },
+  {  '8',   -1,   96,   40,   40 },
+  {  '8',   -1,  101,   41,   41 },
+  {  '2',   90,  106,   -1,   42 },
+  {  '8',   -1,   91,   42,   42 },
+  {  '6',   -1,  112,   43,   43 },
+  {  '3',   93,  214,   -1,   44 },
+  {  '0',   94,   -1,   -1,   44 },
+  {  'A',   95,   -1,   -1,   44 },
+  {  'B',   -1,   -1,   44,   44 },
+  {  '6',   -1,   -1,   45,   45 },
+  {  '3',   98,   -1,   -1,   46 },
+  {  '0',   99,   -1,   -1,   46 },
+  {  'A',  100,   -1,   -1,   46 },
+  {  'B',   -1,   -1,   46,   46 },
+  {  '6',   -1,   -1,   47,   47 },
+  {  '3',  103,   -1,   -1,   48 },
+  {  '0',  104,   -1,   48,   48 },
+  {  'A',  105,   -1,   -1,   49 },
+  {  'B',   -1,   -1,   49,   49 },
+  {  '3',  107,  110,   -1,   50 },
+  {  '0',  108,  121,   50,   50 },
+  {  'A',  109,   -1,   -1,   51 },
+  {  'B',   -1,   -1,   51,   51 },
+  {  '1',  111,  122,   -1,   52 },
+  {  '6',   -1,  113,   52,   52 },
+  {  '9',   -1,  114,   53,   53 },
+  {  '7',   -1,   -1,   54,   54 },
+  {  '0',   -1,   -1,   55,   55 },
+  {  'S',  116,   -1,   -1,   56 },
+  {  'D',  117,  128,   -1,   56 },
+  {  'M',  118,   -1,   -1,   56 },
+  {  '4',  119,  147,   -1,   56 },
+  {  '2',  120,  124,   -1,   56 },
+  {  '9',   -1,   -1,   56,   56 },
+  {  '7',   -1,  138,   57,   57 },
+  {  '4',  123,  140,   -1,   58 },
+  {  '0',   -1,   -1,   58,   58 },
+  {  '3',  125,  126,   -1,   59 },
+  {  '9',   -1,   -1,   59,   59 },
+  {  '5',  127,   -1,   -1,   60 },
+  {  '0',   -1,   -1,   60,   60 },
+  {  'M',  129,   -1,   -1,   61 },
+  {  '4',  130,  161,   -1,   61 },
+  {  '2',  131,  253,   -1,   61 },
+  {  '5',  132,   -1,   -1,   61 },
+  {  '0',  133,   -1,   -1,   61 },
+  {  '-',  134,   -1,   -1,   61 },
+  {  'A',  135,   -1,   -1,   61 },
+  {  'A',   -1,   -1,   61,   61 },
+  {  'T',   -1,  137,   62,   62 },
+  {  'M',   -1,   -1,   63,   63 },
+  {  '6',   -1,  139,   64,   64 },
+  {  '9',   -1,   -1,   65,   65 },
+  {  '5',  141,  153,   -1,   66 },
+  {  '2',   -1,  142,   66,   66 },
+  {  '3',  143,  152,   67,   67 },
+  {  ' ',  144,   -1,   -1,   68 },
+  {  'P',  145,   -1,   -1,   68 },
+  {  'R',  146,   -1,   -1,   68 },
+  {  'O',   -1,   -1,   68,   68 },
+  {  '6',  148,  174,   -1,   69 },
+  {  '3',  149,  159,   -1,   69 },
+  {  '0',   -1,  150,   69,   69 },
+  {  '2',   -1,  151,   70,   70 },
+  {  '6',   -1,   -1,   71,   71 },
+  {  '6',   -1,   -1,   72,   72 },
+  {  '7',  154,  216,   -1,   73 },
+  {  '6',  155,  202,   73,   73 },
+  {  ' ',  156,   -1,   -1,   74 },
+  {  'P',  157,   -1,   -1,   74 },
+  {  'R',  158,   -1,   -1,   74 },
+  {  'O',   -1,   -1,   74,   74 },
+  {  '6',  160,  167,   -1,   75 },
+  {  '0',   -1,   -1,   75,   75 },
+  {  '6',  162,  178,   -1,   76 },
+  {  '1',  163,  171,   -1,   76 },
+  {  '1',  164,  165,   -1,   76 },
+  {  '5',   -1,   -1,   76,   76 },
+  {  '2',  166,  169,   -1,   77 },
+  {  '5',   -1,   -1,   77,   77 },
+  {  '7',  168,   -1,   -1,   78 },
+  {  '0',   -1,   -1,   78,   78 },
+  {  '5',  170,   -1,   -1,   79 },
+  {  '0',   -1,   -1,   79,   79 },
+  {  '3',  172,  267,   -1,   80 },
+  {  '5',  173,  262,   -1,   80 },
+  {  '0',   -1,   -1,   80,   80 },
+  {  '7',  175,  229,   -1,   81 },
+  {  '1',  176,  188,   -1,   81 },
+  {  '0',   -1,  177,   81,   81 },
+  {  '2',   -1,   -1,   82,   82 },
+  {  '7',  179,  234,   -1,   83 },
+  {  '1',  180,  192,   -1,   83 },
+  {  '2',  181,  182,   -1,   83 },
+  {  '5',   -1,   -1,   83,   83 },
+  {  '5',  183,   -1,   -1,   84 },
+  {  '0',  184,   -1,   -1,   84 },
+  {  '-',  185,   -1,   -1,   84 },
+  {  'A',  186,   -1,   -1,   84 },
+  {  'A',   -1,  187,   84,   84 },
+  {  'B',   -1,  191,   85,   85 },
+  {  '3',  189,   -1,   -1,   86 },
+  {  '0',  190,   -1,   -1,   86 },
+  {  'G',   -1,   -1,   86,   86 },
+  {  'C',   -1,   -1,   87,   87 },
+  {  '2',  193,  270,   -1,   88 },
+  {  '2',  194,  195,   -1,   88 },
+  {  '5',   -1,   -1,   88,   88 },
+  {  '5',  196,   -1,   -1,   89 },
+  {  '0',  197,   -1,   -1,   89 },
+  {  '-',  198,   -1,   -1,   89 },
+  {  'A',  199,   -1,   -1,   89 },
+  {  'A',   -1,  200,   89,   89 },
+  {  'B',   -1,  201,   90,   90 },
+  {  'C',   -1,   -1,   91,   91 },
+  {  '4',  203,   -1,   -1,   92 },
+  {  'A',  204,  207,   -1,   92 },
+  {  'A',   -1,  205,   92,   92 },
+  {  'B',   -1,  206,   93,   93 },
+  {  'C',   -1,   -1,   94,   94 },
+  {  'P',  208,   -1,   -1,   95 },
+  {  'R',  209,   -1,   -1,   95 },
+  {  'O',  210,   -1,   -1,   95 },
+  {  '-',  211,   -1,   -1,   95 },
+  {  'A',  212,   -1,   -1,   95 },
+  {  'B',   -1,  213,   95,   95 },
+  {  'C',   -1,   -1,   96,   96 },
+  {  '8',  215,  227,   -1,   97 },
+  {  '4',   -1,   -1,   97,   97 },
+  {  '9',  217,   -1,   -1,   98 },
+  {  '2',   -1,  218,   98,   98 },
+  {  '4',   -1,  219,   99,   99 },
+  {  '6',  220,  226,  100,  100 },
+  {  ' ',  221,   -1,   -1,  101 },
+  {  'P',  222,   -1,   -1,  101 },
+  {  'R',  223,   -1,   -1,  101 },
+  {  'O',  224,   -1,   -1,  101 },
+  {  ' ',  225,   -1,   -1,  101 },
+  {  'A',   -1,   -1,  101,  101 },
+  {  '8',   -1,   -1,  102,  102 },
+  {  '9',  228,   -1,   -1,  103 },
+  {  '8',   -1,   -1,  103,  103 },
+  {  '8',  230,   -1,   -1,  104 },
+  {  '4',  231,  232,   -1,  104 },
+  {  '5',   -1,   -1,  104,  104 },
+  {  '5',  233,   -1,   -1,  105 },
+  {  '0',   -1,   -1,  105,  105 },
+  {  '8',  235,   -1,   -1,  106 },
+  {  '1',  236,  241,   -1,  106 },
+  {  '5',  237,   -1,   -1,  106 },
+  {  '0',  238,   -1,  106,  106 },
+  {  '-',  239,   -1,   -1,  107 },
+  {  'A',  240,   -1,   -1,  107 },
+  {  'C',   -1,   -1,  107,  107 },
+  {  '2',  242,  247,   -1,  108 },
+  {  '5',  243,   -1,   -1,  108 },
+  {  '0',  244,   -1,  108,  108 },
+  {  '-',  245,   -1,   -1,  109 },
+  {  'A',  246,   -1,   -1,  109 },
+  {  'B',   -1,   -1,  109,  109 },
+  {  '3',  248,  292,   -1,  110 },
+  {  '5',  249,   -1,   -1,  110 },
+  {  '0',  250,   -1,  110,  110 },
+  {  '-',  251,   -1,   -1,  111 },
+  {  'A',  252,   -1,   -1,  111 },
+  {  'C',   -1,   -1,  111,  111 },
+  {  '3',  254,  256,   -1,  112 },
+  {  '7',  255,   -1,   -1,  112 },
+  {  '5',   -1,   -1,  112,  112 },
+  {  '4',  257,  259,   -1,  113 },
+  {  '5',  258,   -1,   -1,  113 },
+  {  '0',   -1,   -1,  113,  113 },
+  {  '6',  260,   -1,   -1,  114 },
+  {  '3',  261,   -1,   -1,  114 },
+  {  '5',   -1,   -1,  114,  114 },
+  {  '7',  263,   -1,   -1,  115 },
+  {  '5',  264,   -1,   -1,  115 },
+  {  '-',  265,   -1,   -1,  115 },
+  {  'A',  266,   -1,   -1,  115 },
+  {  'C',   -1,   -1,  115,  115 },
+  {  '4',  268,   -1,   -1,  116 },
+  {  '5',  269,   -1,   -1,  116 },
+  {  '0',   -1,   -1,  116,  116 },
+  {  '4',  271,  280,   -1,  117 },
+  {  '3',  272,  276,   -1,  117 },
+  {  '5',  273,   -1,   -1,  117 },
+  {  '-',  274,   -1,   -1,  117 },
+  {  'A',  275,   -1,   -1,  117 },
+  {  'B',   -1,   -1,  117,  117 },
+  {  '5',  277,  278,   -1,  118 },
+  {  '0',   -1,   -1,  118,  118 },
+  {  '7',  279,   -1,   -1,  119 },
+  {  '5',   -1,   -1,  119,  119 },
+  {  '5',  281,  286,   -1,  120 },
+  {  '5',  282,   -1,   -1,  120 },
+  {  '0',  283,   -1,   -1,  120 },
+  {  '-',  284,   -1,   -1,  120 },
+  {  'A',  285,   -1,   -1,  120 },
+  {  'B',   -1,   -1,  120,  120 },
+  {  '6',  287,   -1,   -1,  121 },
+  {  '7',  288,   -1,   -1,  121 },
+  {  '5',  289,   -1,   -1,  121 },
+  {  '-',  290,   -1,   -1,  121 },
+  {  'A',  291,   -1,   -1,  121 },
+  {  'B',   -1,   -1,  121,  121 },
+  {  '4',  293,  297,   -1,  122 },
+  {  '5',  294,  295,   -1,  122 },
+  {  '0',   -1,   -1,  122,  122 },
+  {  '7',  296,   -1,   -1,  123 },
+  {  '5',   -1,   -1,  123,  123 },
+  {  '5',  298,  303,   -1,  124 },
+  {  '5',  299,   -1,   -1,  124 },
+  {  '0',  300,   -1,   -1,  124 },
+  {  '-',  301,   -1,   -1,  124 },
+  {  'A',  302,   -1,   -1,  124 },
+  {  'B',   -1,   -1,  124,  124 },
+  {  '6',  304,   -1,   -1,  125 },
+  {  '3',  305,  306,   -1,  125 },
+  {  '5',   -1,   -1,  125,  125 },
+  {  '5',  307,   -1,   -1,  126 },
+  {  '0',  308,   -1,   -1,  126 },
+  {  '-',  309,   -1,   -1,  126 },
+  {  'A',  310,   -1,   -1,  126 },
+  {  'B',   -1,   -1,  126,  126 },
+};
+
+static const struct soc_index SOC_INDEX_QUALCOMM = { SOC_ENTRIES_QUALCOMM, SOC_TRIE_QUALCOMM, 127 };
+
+// allwinner: 3 entries, 10 nodes
+static const struct soc_index_entry SOC_ENTRIES_ALLWINNER[] = {
+  { "sun4i", "A10", SOC_ALLWINNER_A10, 55 },
+  { "sun6i", "A31", SOC_ALLWINNER_A31, 40 },
+  { "sun7i", "A20", SOC_ALLWINNER_A20, 40 },
+};
+
+static const struct soc_trie_node SOC_TRIE_ALLWINNER[] = {
+  {    0,    1,   -1,   -1,    0 },
+  {  's',    2,   -1,   -1,    0 },
+  {  'u',    3,   -1,   -1,    0 },
+  {  'n',    4,   -1,   -1,    0 },
+  {  '4',    5,    6,   -1,    0 },
+  {  'i',   -1,   -1,    0,    0 },
+  {  '6',    7,    8,   -1,    1 },
+  {  'i',   -1,   -1,    1,    1 },
+  {  '7',    9,   -1,   -1,    2 },
+  {  'i',   -1,   -1,    2,    2 },
+};
+
+static const struct soc_index SOC_INDEX_ALLWINNER = { SOC_ENTRIES_ALLWINNER, SOC_TRIE_ALLWINNER, 3 };
+
+// devtree: 46 entries, 161 nodes
+static const struct soc_index_entry SOC_ENTRIES_DEVTREE[] = {
+  { "apple,t8103", "M1", SOC_APPLE_M1, 5 },
+  { "apple,t6000", "M1 Pro", SOC_APPLE_M1_PRO, 5 },
+  { "apple,t6001", "M1 Max", SOC_APPLE_M1_MAX, 5 },
+  { "apple,t6002", "M1 Ultra", SOC_APPLE_M1_ULTRA, 5 },
+  { "apple,t8112", "M2", SOC_APPLE_M2, 5 },
+  { "apple,t6020", "M2 Pro", SOC_APPLE_M2_PRO, 5 },
+  { "apple,t6021", "M2 Max", SOC_APPLE_M2_MAX, 5 },
+  { "apple,t6022", "M2 Ultra", SOC_APPLE_M2_ULTRA, 5 },
+  { "apple,t8122", "M3", SOC_APPLE_M3, 3 },
+  { "apple,t6030", "M3 Pro", SOC_APPLE_M3_PRO, 3 },
+  { "apple,t6031", "M3 Max", SOC_APPLE_M3_MAX, 3 },
+  { "apple,t6034", "M3 Max", SOC_APPLE_M3_MAX, 3 },
+  { "nvidia,tegra20", "Tegra 2", SOC_TEGRA_2, 40 },
+  { "nvidia,tegra30", "Tegra 3", SOC_TEGRA_3, 40 },
+  { "nvidia,tegra114", "Tegra 4", SOC_TEGRA_4, 28 },
+  { "nvidia,tegra124", "Tegra K1", SOC_TEGRA_K1, 28 },
+  { "nvidia,tegra132", "Tegra K1", SOC_TEGRA_K1, 28 },
+  { "nvidia,tegra210", "Tegra X1", SOC_TEGRA_X1, 20 },
+  { "nvidia,tegra186", "Tegra X2", SOC_TEGRA_X2, 16 },
+  { "nvidia,tegra194", "Tegra Xavier", SOC_TEGRA_XAVIER, 12 },
+  { "nvidia,tegra234", "Tegra Orin", SOC_TEGRA_ORIN, 8 },
+  { "qcom,sc8280", "8cx Gen 3", SOC_SNAPD_SC8280XP, 5 },
+  { "fsl,imx8qm", "i.MX 8QuadMax", SOC_NXP_IMX8QM, 28 },
+  { "fsl,imx8qp", "i.MX 8QuadPlus", SOC_NXP_IMX8QP, 28 },
+  { "fsl,imx8mp", "i.MX 8M Plus", SOC_NXP_IMX8MP, 14 },
+  { "fsl,imx8mn", "i.MX 8M Nano", SOC_NXP_IMX8MN, NA },
+  { "fsl,imx8mm", "i.MX 8M Mini", SOC_NXP_IMX8MM, NA },
+  { "fsl,imx8dxp", "i.MX 8DualXPlus", SOC_NXP_IMX8DXP, NA },
+  { "fsl,imx8qxp", "i.MX 8QuadXPlus", SOC_NXP_IMX8QXP, NA },
+  { "fsl,imx93", "i.MX 93", SOC_NXP_IMX93, NA },
+  { "amlogic,a311d", "A311D", SOC_AMLOGIC_A311D, 12 },
+  { "amlogic,a311d2", "A311D2", SOC_AMLOGIC_A311D2, 12 },
+  { "amlogic,s905w", "S905W", SOC_AMLOGIC_S905W, 28 },
+  { "amlogic,s905d", "S905D", SOC_AMLOGIC_S905D, 28 },
+  { "amlogic,s905x", "S905X", SOC_AMLOGIC_S905X, 28 },
+  { "amlogic,s805x", "S805X", SOC_AMLOGIC_S805X, 28 },
+  { "marvell,armada3700", "Armada 3700", SOC_MARVELL_A3700, 28 },
+  { "marvell,armada3710", "Armada 3710", SOC_MARVELL_A3710, 28 },
+  { "marvell,armada3720", "Armada 3720", SOC_MARVELL_A3720, 28 },
+  { "marvell,armada7200", "Armada 7200", SOC_MARVELL_A7200, 28 },
+  { "marvell,armada7400", "Armada 7400", SOC_MARVELL_A7400, 28 },
+  { "marvell,armada8020", "Armada 8020", SOC_MARVELL_A8020, 28 },
+  { "marvell,armada8040", "Armada 8040", SOC_MARVELL_A8040, 28 },
+  { "marvell,cn9130", "CN9130", SOC_MARVELL_CN9130, NA },
+  { "marvell,cn9131", "CN9131", SOC_MARVELL_CN9131, NA },
+  { "marvell,cn9132", "CN9132", SOC_MARVELL_CN9132, NA },
+};
+
+static const struct soc_trie_node SOC_TRIE_DEVTREE[] = {
+  {    0,    1,   -1,   -1,    0 },
+  {  'a',    2,   30,   -1,    0 },
+  {  'p',    3,   94,   -1,    0 },
+  {  'p',    4,   -1,   -1,    0 },
+  {  'l',    5,   -1,   -1,    0 },
+  {  'e',    6,   -1,   -1,    0 },
+  {  ',',    7,   -1,   -1,    0 },
+  {  't',    8,   -1,   -1,    0 },
+  {  '8',    9,   12,   -1,    0 },
+  {  '1',   10,   -1,   -1,    0 },
+  {  '0',   11,   18,   -1,    0 },
+  {  '3',   -1,   -1,    0,    0 },
+  {  '6',   13,   -1,   -1,    1 },
+  {  '0',   14,   -1,   -1,    1 },
+  {  '0',   15,   20,   -1,    1 },
+  {  '0',   -1,   16,    1,    1 },
+  {  '1',   -1,   17,    2,    2 },
+  {  '2',   -1,   -1,    3,    3 },
+  {  '1',   19,   24,   -1,    4 },
+  {  '2',   -1,   -1,    4,    4 },
+  {  '2',   21,   26,   -1,    5 },
+  {  '0',   -1,   22,    5,    5 },
+  {  '1',   -1,   23,    6,    6 },
+  {  '2',   -1,   -1,    7,    7 },
+  {  '2',   25,   -1,   -1,    8 },
+  {  '2',   -1,   -1,    8,    8 },
+  {  '3',   27,   -1,   -1,    9 },
+  {  '0',   -1,   28,    9,    9 },
+  {  '1',   -1,   29,   10,   10 },
+  {  '4',   -1,   -1,   11,   11 },
+  {  'n',   31,   61,   -1,   12 },
+  {  'v',   32,   -1,   -1,   12 },
+  {  'i',   33,   -1,   -1,   12 },
+  {  'd',   34,   -1,   -1,   12 },
+  {  'i',   35,   -1,   -1,   12 },
+  {  'a',   36,   -1,   -1,   12 },
+  {  ',',   37,   -1,   -1,   12 },
+  {  't',   38,   -1,   -1,   12 },
+  {  'e',   39,   -1,   -1,   12 },
+  {  'g',   40,   -1,   -1,   12 },
+  {  'r',   41,   -1,   -1,   12 },
+  {  'a',   42,   -1,   -1,   12 },
+  {  '2',   43,   44,   -1,   12 },
+  {  '0',   -1,   53,   12,   12 },
+  {  '3',   45,   46,   -1,   13 },
+  {  '0',   -1,   -1,   13,   13 },
+  {  '1',   47,   -1,   -1,   14 },
+  {  '1',   48,   49,   -1,   14 },
+  {  '4',   -1,   -1,   14,   14 },
+  {  '2',   50,   51,   -1,   15 },
+  {  '4',   -1,   -1,   15,   15 },
+  {  '3',   52,   55,   -1,   16 },
+  {  '2',   -1,   -1,   16,   16 },
+  {  '1',   54,   59,   -1,   17 },
+  {  '0',   -1,   -1,   17,   17 },
+  {  '8',   56,   57,   -1,   18 },
+  {  '6',   -1,   -1,   18,   18 },
+  {  '9',   58,   -1,   -1,   19 },
+  {  '4',   -1,   -1,   19,   19 },
+  {  '3',   60,   -1,   -1,   20 },
+  {  '4',   -1,   -1,   20,   20 },
+  {  'q',   62,   72,   -1,   21 },
+  {  'c',   63,   -1,   -1,   21 },
+  {  'o',   64,   -1,   -1,   21 },
+  {  'm',   65,   -1,   -1,   21 },
+  {  ',',   66,   -1,   -1,   21 },
+  {  's',   67,   -1,   -1,   21 },
+  {  'c',   68,   -1,   -1,   21 },
+  {  '8',   69,   -1,   -1,   21 },
+  {  '2',   70,   -1,   -1,   21 },
+  {  '8',   71,   -1,   -1,   21 },
+  {  '0',   -1,   -1,   21,   21 },
+  {  'f',   73,  118,   -1,   22 },
+  {  's',   74,   -1,   -1,   22 },
+  {  'l',   75,   -1,   -1,   22 },
+  {  ',',   76,   -1,   -1,   22 },
+  {  'i',   77,   -1,   -1,   22 },
+  {  'm',   78,   -1,   -1,   22 },
+  {  'x',   79,   -1,   -1,   22 },
+  {  '8',   80,   92,   -1,   22 },
+  {  'q',   81,   83,   -1,   22 },
+  {  'm',   -1,   82,   22,   22 },
+  {  'p',   -1,   90,   23,   23 },
+  {  'm',   84,   87,   -1,   24 },
+  {  'p',   -1,   85,   24,   24 },
+  {  'n',   -1,   86,   25,   25 },
+  {  'm',   -1,   -1,   26,   26 },
+  {  'd',   88,   -1,   -1,   27 },
+  {  'x',   89,   -1,   -1,   27 },
+  {  'p',   -1,   -1,   27,   27 },
+  {  'x',   91,   -1,   -1,   28 },
+  {  'p',   -1,   -1,   28,   28 },
+  {  '9',   93,   -1,   -1,   29 },
+  {  '3',   -1,   -1,   29,   29 },
+  {  'm',   95,   -1,   -1,   30 },
+  {  'l',   96,   -1,   -1,   30 },
+  {  'o',   97,   -1,   -1,   30 },
+  {  'g',   98,   -1,   -1,   30 },
+  {  'i',   99,   -1,   -1,   30 },
+  {  'c',  100,   -1,   -1,   30 },
+  {  ',',  101,   -1,   -1,   30 },
+  {  'a',  102,  107,   -1,   30 },
+  {  '3',  103,   -1,   -1,   30 },
+  {  '1',  104,   -1,   -1,   30 },
+  {  '1',  105,   -1,   -1,   30 },
+  {  'd',  106,   -1,   30,   30 },
+  {  '2',   -1,   -1,   31,   31 },
+  {  's',  108,   -1,   -1,   32 },
+  {  '9',  109,  114,   -1,   32 },
+  {  '0',  110,   -1,   -1,   32 },
+  {  '5',  111,   -1,   -1,   32 },
+  {  'w',   -1,  112,   32,   32 },
+  {  'd',   -1,  113,   33,   33 },
+  {  'x',   -1,   -1,   34,   34 },
+  {  '8',  115,   -1,   -1,   35 },
+  {  '0',  116,   -1,   -1,   35 },
+  {  '5',  117,   -1,   -1,   35 },
+  {  'x',   -1,   -1,   35,   35 },
+  {  'm',  119,   -1,   -1,   36 },
+  {  'a',  120,   -1,   -1,   36 },
+  {  'r',  121,   -1,   -1,   36 },
+  {  'v',  122,   -1,   -1,   36 },
+  {  'e',  123,   -1,   -1,   36 },
+  {  'l',  124,   -1,   -1,   36 },
+  {  'l',  125,   -1,   -1,   36 },
+  {  ',',  126,   -1,   -1,   36 },
+  {  'a',  127,  153,   -1,   36 },
+  {  'r',  128,   -1,   -1,   36 },
+  {  'm',  129,   -1,   -1,   36 },
+  {  'a',  130,   -1,   -1,   36 },
+  {  'd',  131,   -1,   -1,   36 },
+  {  'a',  132,   -1,   -1,   36 },
+  {  '3',  133,  140,   -1,   36 },
+  {  '7',  134,   -1,   -1,   36 },
+  {  '0',  135,  136,   -1,   36 },
+  {  '0',   -1,   -1,   36,   36 },
+  {  '1',  137,  138,   -1,   37 },
+  {  '0',   -1,   -1,   37,   37 },
+  {  '2',  139,   -1,   -1,   38 },
+  {  '0',   -1,   -1,   38,   38 },
+  {  '7',  141,  147,   -1,   39 },
+  {  '2',  142,  144,   -1,   39 },
+  {  '0',  143,   -1,   -1,   39 },
+  {  '0',   -1,   -1,   39,   39 },
+  {  '4',  145,   -1,   -1,   40 },
+  {  '0',  146,   -1,   -1,   40 },
+  {  '0',   -1,   -1,   40,   40 },
+  {  '8',  148,   -1,   -1,   41 },
+  {  '0',  149,   -1,   -1,   41 },
+  {  '2',  150,  151,   -1,   41 },
+  {  '0',   -1,   -1,   41,   41 },
+  {  '4',  152,   -1,   -1,   42 },
+  {  '0',   -1,   -1,   42,   42 },
+  {  'c',  154,   -1,   -1,   43 },
+  {  'n',  155,   -1,   -1,   43 },
+  {  '9',  156,   -1,   -1,   43 },
+  {  '1',  157,   -1,   -1,   43 },
+  {  '3',  158,   -1,   -1,   43 },
+  {  '0',   -1,  159,   43,   43 },
+  {  '1',   -1,  160,   44,   44 },
+  {  '2',   -1,   -1,   45,   45 },
+};
+
+static const struct soc_index SOC_INDEX_DEVTREE = { SOC_ENTRIES_DEVTREE, SOC_TRIE_DEVTREE, 46 };
+
+#endif
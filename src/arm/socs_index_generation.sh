@@ -0,0 +1,168 @@
+#!/bin/bash -u
+
+# Compiles the SoC tables in socs.def into one trie per table
+# and prints them as a C header. Usage:
+# ./socs_index_generation.sh > socs_index.h
+
+DEF_FILE="$(dirname "$0")/socs.def"
+
+awk '
+function parse_args(s,    i, c, n, tok, inq) {
+  n = 0; tok = ""; inq = 0
+  for(i=1; i <= length(s); i++) {
+    c = substr(s, i, 1)
+    if(inq) {
+      tok = tok c
+      if(c == "\"") inq = 0
+    }
+    else if(c == "\"") {
+      inq = 1; tok = tok c
+    }
+    else if(c == "," || c == ")") {
+      gsub(/^[ \t]+|[ \t]+$/, "", tok)
+      args[++n] = tok; tok = ""
+      if(c == ")") return n
+    }
+    else tok = tok c
+  }
+  return -1
+}
+
+function unquote(s) {
+  return substr(s, 2, length(s)-2)
+}
+
+function add_entry(t, pattern, name, model, process, kind) {
+  if(!(t in num_entries)) {
+    tables[++num_tables] = t
+    num_entries[t] = 0
+    table_kind[t] = kind
+  }
+  else if(table_kind[t] != kind) {
+    printf("%s:%d: table %s mixes DT_EQ with SOC_EQ entries\n", FILENAME, FNR, t) > "/dev/stderr"
+    failed = 1; exit 1
+  }
+  k = num_entries[t]++
+  e_pattern[t, k] = pattern
+  e_name[t, k] = name
+  e_model[t, k] = model
+  e_process[t, k] = process
+}
+
+function c_char(c) {
+  if(c == "\\" || c == "\047") return "\047\\" c "\047"
+  return "\047" c "\047"
+}
+
+/^[ \t]*(SOC_EQ|SOC_EXY_EQ|DT_EQ)\(/ {
+  line = $0
+  sub(/^[ \t]*/, "", line)
+  macro = substr(line, 1, index(line, "(")-1)
+  n = parse_args(substr(line, index(line, "(")+1))
+
+  if(macro == "SOC_EXY_EQ" && n == 4) {
+    add_entry(args[1], "exynos" unquote(args[2]), args[2], args[3], args[4], "prefix")
+    add_entry(args[1], "universal" unquote(args[2]), args[2], args[3], args[4], "prefix")
+  }
+  else if(macro != "SOC_EXY_EQ" && n == 5) {
+    add_entry(args[1], unquote(args[2]), args[3], args[4], args[5], macro == "DT_EQ" ? "substr" : "prefix")
+  }
+  else {
+    printf("%s:%d: malformed %s entry\n", FILENAME, FNR, macro) > "/dev/stderr"
+    failed = 1; exit 1
+  }
+}
+
+END {
+  if(failed) exit 1
+
+  print "// Generated by socs_index_generation.sh from socs.def, do not edit"
+  print "#ifndef __SOCS_INDEX__"
+  print "#define __SOCS_INDEX__"
+  print ""
+  print "struct soc_index_entry {"
+  print "  char* pattern;"
+  print "  char* name;"
+  print "  SOC model;"
+  print "  int32_t process;"
+  print "};"
+  print ""
+  print "// child and sibling link the nodes of the trie (-1 if none), term is"
+  print "// the first entry whose pattern ends at the node and min is the first"
+  print "// entry in the subtree rooted at the node (-1 if none)"
+  print "struct soc_trie_node {"
+  print "  char c;"
+  print "  int16_t child;"
+  print "  int16_t sibling;"
+  print "  int16_t term;"
+  print "  int16_t min;"
+  print "};"
+  print ""
+  print "struct soc_index {"
+  print "  const struct soc_index_entry* entries;"
+  print "  const struct soc_trie_node* nodes;"
+  print "  int num_entries;"
+  print "};"
+
+  for(ti=1; ti <= num_tables; ti++) {
+    t = tables[ti]
+    T = toupper(t)
+
+    # Build the trie. Node 0 is the root, and children are always
+    # created after their parent
+    delete nc; delete child; delete last; delete sibling; delete term; delete nmin
+    num_nodes = 1
+    child[0] = -1; sibling[0] = -1; term[0] = -1; nc[0] = ""
+
+    for(k=0; k < num_entries[t]; k++) {
+      node = 0
+      p = e_pattern[t, k]
+      for(i=1; i <= length(p); i++) {
+        c = substr(p, i, 1)
+        for(ch = child[node]; ch != -1 && nc[ch] != c; ch = sibling[ch]);
+        if(ch == -1) {
+          ch = num_nodes++
+          nc[ch] = c; child[ch] = -1; sibling[ch] = -1; term[ch] = -1
+          if(child[node] == -1) child[node] = ch
+          else sibling[last[node]] = ch
+          last[node] = ch
+        }
+        node = ch
+      }
+      if(term[node] == -1) term[node] = k
+    }
+
+    for(id = num_nodes-1; id >= 0; id--) {
+      m = term[id]
+      for(ch = child[id]; ch != -1; ch = sibling[ch]) {
+        if(nmin[ch] != -1 && (m == -1 || nmin[ch] < m)) m = nmin[ch]
+      }
+      nmin[id] = m
+    }
+
+    if(num_nodes > 32767) {
+      printf("table %s has too many nodes (%d)\n", t, num_nodes) > "/dev/stderr"
+      exit 1
+    }
+
+    print ""
+    printf("// %s: %d entries, %d nodes\n", t, num_entries[t], num_nodes)
+    printf("static const struct soc_index_entry SOC_ENTRIES_%s[] = {\n", T)
+    for(k=0; k < num_entries[t]; k++) {
+      printf("  { \"%s\", %s, %s, %s },\n", e_pattern[t, k], e_name[t, k], e_model[t, k], e_process[t, k])
+    }
+    print "};"
+    print ""
+    printf("static const struct soc_trie_node SOC_TRIE_%s[] = {\n", T)
+    for(id=0; id < num_nodes; id++) {
+      printf("  { %4s, %4d, %4d, %4d, %4d },\n", id == 0 ? "0" : c_char(nc[id]), child[id], sibling[id], term[id], nmin[id])
+    }
+    print "};"
+    print ""
+    printf("static const struct soc_index SOC_INDEX_%s = { SOC_ENTRIES_%s, SOC_TRIE_%s, %d };\n", T, T, T, num_entries[t])
+  }
+
+  print ""
+  print "#endif"
+}
+' "$DEF_FILE"
@@ -6,6 +6,8 @@
 
 #include "uarch.h"
 #include "../common/global.h"
+#include "../common/args.h"
+#include "../common/uarchdb.h"
 
 // Data not available
 #define NA                   -1
@@ -17,6 +19,7 @@ struct uarch {
   ISA isa;
   char* uarch_str;
   char* isa_str;
+  int32_t vpus; // NA if not given by the uarch database
   // int32_t process; process depends on SoC
 };
 
@@ -132,24 +135,131 @@ static char* isas_string[] = {
   [ISA_ARMv9_2_A] = "ARMv9.2",
 };
 
-#define UARCH_START if (false) {}
-#define CHECK_UARCH(arch, cpu, im_, p_, v_, r_, str, uarch, vendor) \
-   else if (im_ == im && p_ == p && (v_ == NA || v_ == v) && (r_ == NA || r_ == r)) fill_uarch(arch, cpu, str, uarch, vendor);
-#define UARCH_END else { printBugCheckRelease("Unknown microarchitecture detected: IM=0x%X P=0x%X V=0x%X R=0x%X", im, p, v, r); \
-fill_uarch(arch, cpu, "Unknown", UARCH_UNKNOWN, CPU_VENDOR_UNKNOWN); }
+// The signature packs the main ID register fields
+#define ARM_SIG(im, p, v, r)  (UARCH_DB_FIELD(im, 20, 8) | UARCH_DB_FIELD(p, 8, 12) | UARCH_DB_FIELD(v, 4, 4) | UARCH_DB_FIELD(r, 0, 4))
+#define ARM_MASK(im, p, v, r) (UARCH_DB_MASK(im, 20, 8) | UARCH_DB_MASK(p, 8, 12) | UARCH_DB_MASK(v, 4, 4) | UARCH_DB_MASK(r, 0, 4))
+
+#define UARCH_ENTRY(im, p, v, r, str, uarch, vendor) \
+  { ARM_MASK(im, p, v, r), ARM_SIG(im, p, v, r), uarch, str, NA, vendor, NA },
 
 void fill_uarch(struct uarch* arch, struct cpuInfo* cpu, char* str, MICROARCH u, VENDOR vendor) {
   arch->uarch = u;
   arch->isa = isas_uarch[arch->uarch];
+  arch->vpus = NA;
   cpu->cpu_vendor = vendor;
 
-  arch->uarch_str = emalloc(sizeof(char) * (strlen(str)+1));
+  arch->uarch_str = amalloc(sizeof(char) * (strlen(str)+1));
   strcpy(arch->uarch_str, str);
 
-  arch->isa_str = emalloc(sizeof(char) * (strlen(isas_string[arch->isa])+1));
+  arch->isa_str = amalloc(sizeof(char) * (strlen(isas_string[arch->isa])+1));
   strcpy(arch->isa_str, isas_string[arch->isa]);
 }
 
+// Used to parse the uarch database file
+static const char* uarch_names[] = {
+  [UARCH_UNKNOWN]      = "UNKNOWN",
+  [UARCH_ARM7]         = "ARM7",
+  [UARCH_ARM9]         = "ARM9",
+  [UARCH_ARM1136]      = "ARM1136",
+  [UARCH_ARM1156]      = "ARM1156",
+  [UARCH_ARM1176]      = "ARM1176",
+  [UARCH_ARM11MPCORE]  = "ARM11MPCORE",
+  [UARCH_CORTEX_A5]    = "CORTEX_A5",
+  [UARCH_CORTEX_A7]    = "CORTEX_A7",
+  [UARCH_CORTEX_A8]    = "CORTEX_A8",
+  [UARCH_CORTEX_A9]    = "CORTEX_A9",
+  [UARCH_CORTEX_A12]   = "CORTEX_A12",
+  [UARCH_CORTEX_A15]   = "CORTEX_A15",
+  [UARCH_CORTEX_A17]   = "CORTEX_A17",
+  [UARCH_CORTEX_A32]   = "CORTEX_A32",
+  [UARCH_CORTEX_A35]   = "CORTEX_A35",
+  [UARCH_CORTEX_A53]   = "CORTEX_A53",
+  [UARCH_CORTEX_A55r0] = "CORTEX_A55r0",
+  [UARCH_CORTEX_A55]   = "CORTEX_A55",
+  [UARCH_CORTEX_A57]   = "CORTEX_A57",
+  [UARCH_CORTEX_A65]   = "CORTEX_A65",
+  [UARCH_CORTEX_A72]   = "CORTEX_A72",
+  [UARCH_CORTEX_A73]   = "CORTEX_A73",
+  [UARCH_CORTEX_A75]   = "CORTEX_A75",
+  [UARCH_CORTEX_A76]   = "CORTEX_A76",
+  [UARCH_CORTEX_A77]   = "CORTEX_A77",
+  [UARCH_CORTEX_A78]   = "CORTEX_A78",
+  [UARCH_CORTEX_A78AE] = "CORTEX_A78AE",
+  [UARCH_CORTEX_A78C]  = "CORTEX_A78C",
+  [UARCH_CORTEX_A510]  = "CORTEX_A510",
+  [UARCH_CORTEX_A520]  = "CORTEX_A520",
+  [UARCH_CORTEX_A710]  = "CORTEX_A710",
+  [UARCH_CORTEX_A715]  = "CORTEX_A715",
+  [UARCH_CORTEX_A720]  = "CORTEX_A720",
+  [UARCH_CORTEX_A725]  = "CORTEX_A725",
+  [UARCH_CORTEX_X1]    = "CORTEX_X1",
+  [UARCH_CORTEX_X1C]   = "CORTEX_X1C",
+  [UARCH_CORTEX_X2]    = "CORTEX_X2",
+  [UARCH_CORTEX_X3]    = "CORTEX_X3",
+  [UARCH_CORTEX_X4]    = "CORTEX_X4",
+  [UARCH_CORTEX_X925]  = "CORTEX_X925",
+  [UARCH_NEOVERSE_N1]  = "NEOVERSE_N1",
+  [UARCH_NEOVERSE_N2]  = "NEOVERSE_N2",
+  [UARCH_NEOVERSE_E1]  = "NEOVERSE_E1",
+  [UARCH_NEOVERSE_V1]  = "NEOVERSE_V1",
+  [UARCH_NEOVERSE_V2]  = "NEOVERSE_V2",
+  [UARCH_NEOVERSE_V3]  = "NEOVERSE_V3",
+  [UARCH_SCORPION]     = "SCORPION",
+  [UARCH_KRAIT]        = "KRAIT",
+  [UARCH_KYRO]         = "KYRO",
+  [UARCH_FALKOR]       = "FALKOR",
+  [UARCH_SAPHIRA]      = "SAPHIRA",
+  [UARCH_DENVER]       = "DENVER",
+  [UARCH_DENVER2]      = "DENVER2",
+  [UARCH_CARMEL]       = "CARMEL",
+  [UARCH_EXYNOS_M1]    = "EXYNOS_M1",
+  [UARCH_EXYNOS_M2]    = "EXYNOS_M2",
+  [UARCH_EXYNOS_M3]    = "EXYNOS_M3",
+  [UARCH_EXYNOS_M4]    = "EXYNOS_M4",
+  [UARCH_EXYNOS_M5]    = "EXYNOS_M5",
+  [UARCH_SWIFT]        = "SWIFT",
+  [UARCH_CYCLONE]      = "CYCLONE",
+  [UARCH_TYPHOON]      = "TYPHOON",
+  [UARCH_TWISTER]      = "TWISTER",
+  [UARCH_HURRICANE]    = "HURRICANE",
+  [UARCH_MONSOON]      = "MONSOON",
+  [UARCH_MISTRAL]      = "MISTRAL",
+  [UARCH_VORTEX]       = "VORTEX",
+  [UARCH_TEMPEST]      = "TEMPEST",
+  [UARCH_LIGHTNING]    = "LIGHTNING",
+  [UARCH_THUNDER]      = "THUNDER",
+  [UARCH_ICESTORM]     = "ICESTORM",
+  [UARCH_FIRESTORM]    = "FIRESTORM",
+  [UARCH_BLIZZARD]     = "BLIZZARD",
+  [UARCH_AVALANCHE]    = "AVALANCHE",
+  [UARCH_SAWTOOTH]     = "SAWTOOTH",
+  [UARCH_EVEREST]      = "EVEREST",
+  [UARCH_THUNDERX]     = "THUNDERX",
+  [UARCH_THUNDERX2]    = "THUNDERX2",
+  [UARCH_PJ4]          = "PJ4",
+  [UARCH_BRAHMA_B15]   = "BRAHMA_B15",
+  [UARCH_BRAHMA_B53]   = "BRAHMA_B53",
+  [UARCH_XGENE]        = "XGENE",
+  [UARCH_TAISHAN_V110] = "TAISHAN_V110",
+  [UARCH_TAISHAN_V120] = "TAISHAN_V120",
+  [UARCH_TAISHAN_V200] = "TAISHAN_V200",
+  [UARCH_XIAOMI]       = "XIAOMI",
+};
+
+static const char* vendor_names[] = {
+  [CPU_VENDOR_ARM]      = "ARM",
+  [CPU_VENDOR_APPLE]    = "APPLE",
+  [CPU_VENDOR_BROADCOM] = "BROADCOM",
+  [CPU_VENDOR_CAVIUM]   = "CAVIUM",
+  [CPU_VENDOR_NVIDIA]   = "NVIDIA",
+  [CPU_VENDOR_APM]      = "APM",
+  [CPU_VENDOR_QUALCOMM] = "QUALCOMM",
+  [CPU_VENDOR_HUAWEI]   = "HUAWEI",
+  [CPU_VENDOR_SAMSUNG]  = "SAMSUNG",
+  [CPU_VENDOR_MARVELL]  = "MARVELL",
+  [CPU_VENDOR_PHYTIUM]  = "PHYTIUM",
+};
+
 /*
  * Codes are based on pytorch/cpuinfo, more precisely:
  * - https://github.com/pytorch/cpuinfo/blob/main/src/arm/uarch.c
@@ -158,135 +268,175 @@ void fill_uarch(struct uarch* arch, struct cpuInfo* cpu, char* str, MICROARCH u,
  * - https://elixir.bootlin.com/linux/latest/source/arch/arm/include/asm/cputype.h
  * - https://github.com/AsahiLinux/m1n1/blob/main/src/chickens.c
  */
-struct uarch* get_uarch_from_midr(uint32_t midr, struct cpuInfo* cpu) {
-  struct uarch* arch = emalloc(sizeof(struct uarch));
-  uint32_t im = midr_get_implementer(midr);
-  uint32_t p = midr_get_part(midr);
-  uint32_t v = midr_get_variant(midr);
-  uint32_t r = midr_get_revision(midr);
-
-  // ----------------------------------------------------------------------- //
-  // IM: Implementer                                                         //
-  // P:  Part                                                                //
-  // V:  Variant                                                             //
-  // R:  Revision                                                            //
-  // ----------------------------------------------------------------------- //
-  //                     IM   P      V   R                                   //
-  UARCH_START
-  CHECK_UARCH(arch, cpu, 'A', 0xB36, NA, NA, "ARM1136",               UARCH_ARM1136,      CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xB56, NA, NA, "ARM1156",               UARCH_ARM1156,      CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xB76, NA, NA, "ARM1176",               UARCH_ARM1176,      CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xB02, NA, NA, "ARM11 MPCore",          UARCH_ARM11MPCORE,  CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xC05, NA, NA, "Cortex-A5",             UARCH_CORTEX_A5,    CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xC07, NA, NA, "Cortex-A7",             UARCH_CORTEX_A7,    CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xC08, NA, NA, "Cortex-A8",             UARCH_CORTEX_A8,    CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xC09, NA, NA, "Cortex-A9",             UARCH_CORTEX_A9,    CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xC0C, NA, NA, "Cortex-A12",            UARCH_CORTEX_A12,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xC0E, NA, NA, "Cortex-A17",            UARCH_CORTEX_A17,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xC0D, NA, NA, "Cortex-A12",            UARCH_CORTEX_A12,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xC0F, NA, NA, "Cortex-A15",            UARCH_CORTEX_A15,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD01, NA, NA, "Cortex-A32",            UARCH_CORTEX_A32,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD03, NA, NA, "Cortex-A53",            UARCH_CORTEX_A53,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD04, NA, NA, "Cortex-A35",            UARCH_CORTEX_A35,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD05, NA,  0, "Cortex-A55",            UARCH_CORTEX_A55r0, CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD05, NA, NA, "Cortex-A55",            UARCH_CORTEX_A55,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD06, NA, NA, "Cortex-A65",            UARCH_CORTEX_A65,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD07, NA, NA, "Cortex-A57",            UARCH_CORTEX_A57,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD08, NA, NA, "Cortex-A72",            UARCH_CORTEX_A72,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD09, NA, NA, "Cortex-A73",            UARCH_CORTEX_A73,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD0A, NA, NA, "Cortex-A75",            UARCH_CORTEX_A75,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD0B, NA, NA, "Cortex-A76",            UARCH_CORTEX_A76,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD0C, NA, NA, "Neoverse N1",           UARCH_NEOVERSE_N1,  CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD0D, NA, NA, "Cortex-A77",            UARCH_CORTEX_A77,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD0E, NA, NA, "Cortex-A76",            UARCH_CORTEX_A76,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD40, NA, NA, "Neoverse V1",           UARCH_NEOVERSE_V1,  CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD41, NA, NA, "Cortex-A78",            UARCH_CORTEX_A78,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD42, NA, NA, "Cortex-A78AE",          UARCH_CORTEX_A78AE, CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD44, NA, NA, "Cortex-X1",             UARCH_CORTEX_X1,    CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD46, NA, NA, "Cortex‑A510",           UARCH_CORTEX_A510,  CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD47, NA, NA, "Cortex‑A710",           UARCH_CORTEX_A710,  CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD48, NA, NA, "Cortex-X2",             UARCH_CORTEX_X2,    CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD49, NA, NA, "Neoverse N2",           UARCH_NEOVERSE_N2,  CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD4A, NA, NA, "Neoverse E1",           UARCH_NEOVERSE_E1,  CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD4B, NA, NA, "Cortex-A78C",           UARCH_CORTEX_A78C,  CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD4C, NA, NA, "Cortex-X1C",            UARCH_CORTEX_X1C,   CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD4D, NA, NA, "Cortex-A715",           UARCH_CORTEX_A715,  CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD4E, NA, NA, "Cortex-X3",             UARCH_CORTEX_X3,    CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD4F, NA, NA, "Neoverse V2",           UARCH_NEOVERSE_V2,  CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD80, NA, NA, "Cortex-A520",           UARCH_CORTEX_A520,  CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD81, NA, NA, "Cortex-A720",           UARCH_CORTEX_A720,  CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD82, NA, NA, "Cortex-X4",             UARCH_CORTEX_X4,    CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD84, NA, NA, "Neoverse V3",           UARCH_NEOVERSE_V3,  CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD85, NA, NA, "Cortex-X925",           UARCH_CORTEX_X925,  CPU_VENDOR_ARM)
-  CHECK_UARCH(arch, cpu, 'A', 0xD87, NA, NA, "Cortex-A725",           UARCH_CORTEX_A725,  CPU_VENDOR_ARM)
-
-  CHECK_UARCH(arch, cpu, 'B', 0x00F, NA, NA, "Brahma B15",            UARCH_BRAHMA_B15,   CPU_VENDOR_BROADCOM)
-  CHECK_UARCH(arch, cpu, 'B', 0x100, NA, NA, "Brahma B53",            UARCH_BRAHMA_B53,   CPU_VENDOR_BROADCOM)
-  CHECK_UARCH(arch, cpu, 'B', 0x516, NA, NA, "ThunderX2",             UARCH_THUNDERX2,    CPU_VENDOR_CAVIUM)
-
-  CHECK_UARCH(arch, cpu, 'C', 0x0A0, NA, NA, "ThunderX",              UARCH_THUNDERX,     CPU_VENDOR_CAVIUM)
-  CHECK_UARCH(arch, cpu, 'C', 0x0A1, NA, NA, "ThunderX 88XX",         UARCH_THUNDERX,     CPU_VENDOR_CAVIUM)
-  CHECK_UARCH(arch, cpu, 'C', 0x0A2, NA, NA, "ThunderX 81XX",         UARCH_THUNDERX,     CPU_VENDOR_CAVIUM)
-  CHECK_UARCH(arch, cpu, 'C', 0x0A3, NA, NA, "ThunderX 81XX",         UARCH_THUNDERX,     CPU_VENDOR_CAVIUM)
-  CHECK_UARCH(arch, cpu, 'C', 0x0AF, NA, NA, "ThunderX2 99XX",        UARCH_THUNDERX2,    CPU_VENDOR_CAVIUM)
-
-  CHECK_UARCH(arch, cpu, 'H', 0xD01, NA, NA, "TaiShan v110",          UARCH_TAISHAN_V110, CPU_VENDOR_HUAWEI) // Kunpeng 920 series
-  CHECK_UARCH(arch, cpu, 'H', 0xD02,  2,  2, "TaiShan v120",          UARCH_TAISHAN_V120, CPU_VENDOR_HUAWEI) // Kiring 9000S Big cores (https://github.com/Dr-Noob/cpufetch/issues/259)
-  CHECK_UARCH(arch, cpu, 'H', 0xD02, NA, NA, "TaiShan v200",          UARCH_TAISHAN_V200, CPU_VENDOR_HUAWEI) // Kunpeng 930 series (found in openeuler: https://mailweb.openeuler.org/hyperkitty/list/kernel@openeuler.org/message/XQCV7NX2UKRIUWUFKRF4PO3QENCOUFR3)
-  CHECK_UARCH(arch, cpu, 'H', 0xD40, NA, NA, "Cortex-A76",            UARCH_CORTEX_A76,   CPU_VENDOR_ARM)    // Kirin 980 Big/Medium cores -> Cortex-A76
-  CHECK_UARCH(arch, cpu, 'H', 0xD42, NA, NA, "TaiShan v120",          UARCH_TAISHAN_V120, CPU_VENDOR_HUAWEI) // Kiring 9000S Small Cores (https://github.com/Dr-Noob/cpufetch/issues/259)
-
-  CHECK_UARCH(arch, cpu, 'N', 0x000, NA, NA, "Denver",                UARCH_DENVER,       CPU_VENDOR_NVIDIA)
-  CHECK_UARCH(arch, cpu, 'N', 0x003, NA, NA, "Denver2",               UARCH_DENVER2,      CPU_VENDOR_NVIDIA)
-  CHECK_UARCH(arch, cpu, 'N', 0x004, NA, NA, "Carmel",                UARCH_CARMEL,       CPU_VENDOR_NVIDIA)
-
-  CHECK_UARCH(arch, cpu, 'P', 0x000, NA, NA, "Xgene",                 UARCH_XGENE,        CPU_VENDOR_APM)
-
-  CHECK_UARCH(arch, cpu, 'Q', 0x00F, NA, NA, "Scorpion",              UARCH_SCORPION,     CPU_VENDOR_QUALCOMM)
-  CHECK_UARCH(arch, cpu, 'Q', 0x02D, NA, NA, "Scorpion",              UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
-  CHECK_UARCH(arch, cpu, 'Q', 0x04D,  1,  0, "Krait 200",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
-  CHECK_UARCH(arch, cpu, 'Q', 0x04D,  1,  4, "Krait 200",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
-  CHECK_UARCH(arch, cpu, 'Q', 0x04D,  2,  0, "Krait 300",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
-  CHECK_UARCH(arch, cpu, 'Q', 0x06F,  0,  1, "Krait 200",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
-  CHECK_UARCH(arch, cpu, 'Q', 0x06F,  0,  2, "Krait 200",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
-  CHECK_UARCH(arch, cpu, 'Q', 0x06F,  1,  0, "Krait 300",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
-  CHECK_UARCH(arch, cpu, 'Q', 0x06F,  2,  0, "Krait 400",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM) // Snapdragon 800 MSMxxxx
-  CHECK_UARCH(arch, cpu, 'Q', 0x06F,  2,  1, "Krait 400",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM) // Snapdragon 801 MSMxxxxPRO
-  CHECK_UARCH(arch, cpu, 'Q', 0x06F,  3,  1, "Krait 450",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
-  CHECK_UARCH(arch, cpu, 'Q', 0x201, NA, NA, "Kryo Silver",           UARCH_KYRO,         CPU_VENDOR_QUALCOMM) // Qualcomm Snapdragon 821: Low-power Kryo "Silver"
-  CHECK_UARCH(arch, cpu, 'Q', 0x205, NA, NA, "Kryo Gold",             UARCH_KYRO,         CPU_VENDOR_QUALCOMM) // Qualcomm Snapdragon 820 & 821: High-performance Kryo "Gold"
-  CHECK_UARCH(arch, cpu, 'Q', 0x211, NA, NA, "Kryo Silver",           UARCH_KYRO,         CPU_VENDOR_QUALCOMM) // Qualcomm Snapdragon 820: Low-power Kryo "Silver"
-  CHECK_UARCH(arch, cpu, 'Q', 0x800, 10, NA, "Kryo 260 / 280 Gold",   UARCH_CORTEX_A73,   CPU_VENDOR_ARM)      // Kryo 260 / Kryo 280 "Gold"
-  CHECK_UARCH(arch, cpu, 'Q', 0x801, 10, NA, "Kryo 260 / 280 Silver", UARCH_CORTEX_A53,   CPU_VENDOR_ARM)      // Kryo 260 / 280 "Silver"
-  CHECK_UARCH(arch, cpu, 'Q', 0x802, NA, NA, "Kryo 385 Gold",         UARCH_CORTEX_A75,   CPU_VENDOR_ARM)      // High-performance Kryo 385 "Gold" -> Cortex-A75
-  CHECK_UARCH(arch, cpu, 'Q', 0x803, NA, NA, "Kryo 385 Silver",       UARCH_CORTEX_A55r0, CPU_VENDOR_ARM)      // Low-power Kryo 385 "Silver" -> Cortex-A55r0
-  CHECK_UARCH(arch, cpu, 'Q', 0x804, NA, NA, "Kryo 485 Gold",         UARCH_CORTEX_A76,   CPU_VENDOR_ARM)      // High-performance Kryo 485 "Gold" / "Gold Prime" -> Cortex-A76
-  CHECK_UARCH(arch, cpu, 'Q', 0x805, NA, NA, "Kryo 485 Silver",       UARCH_CORTEX_A55,   CPU_VENDOR_ARM)      // Low-performance Kryo 485 "Silver" -> Cortex-A55
-  CHECK_UARCH(arch, cpu, 'Q', 0xC00, NA, NA, "Falkor",                UARCH_FALKOR,       CPU_VENDOR_QUALCOMM)
-  CHECK_UARCH(arch, cpu, 'Q', 0xC01, NA, NA, "Saphira",               UARCH_SAPHIRA,      CPU_VENDOR_QUALCOMM)
-
-  CHECK_UARCH(arch, cpu, 'S', 0x001, 1,  NA, "Exynos M1",             UARCH_EXYNOS_M1,    CPU_VENDOR_SAMSUNG)   // Exynos 8890
-  CHECK_UARCH(arch, cpu, 'S', 0x001, 4,  NA, "Exynos M2",             UARCH_EXYNOS_M2,    CPU_VENDOR_SAMSUNG)   // Exynos 8895
-  CHECK_UARCH(arch, cpu, 'S', 0x002, 1,  NA, "Exynos M3",             UARCH_EXYNOS_M3,    CPU_VENDOR_SAMSUNG)   // Exynos 9810
-  CHECK_UARCH(arch, cpu, 'S', 0x003, 1,  NA, "Exynos M4",             UARCH_EXYNOS_M4,    CPU_VENDOR_SAMSUNG)   // Exynos 9820
-  CHECK_UARCH(arch, cpu, 'S', 0x004, 1,  NA, "Exynos M5",             UARCH_EXYNOS_M5,    CPU_VENDOR_SAMSUNG)   // Exynos 9820 (this one looks wrong at uarch.c ...)
-
-  CHECK_UARCH(arch, cpu, 'p', 0x663, 1,  NA, "Xiaomi",                UARCH_XIAOMI,       CPU_VENDOR_PHYTIUM)   // From a fellow contributor (https://github.com/Dr-Noob/cpufetch/issues/125)
+// ----------------------------------------------------------------------- //
+// IM: Implementer                                                         //
+// P:  Part                                                                //
+// V:  Variant                                                             //
+// R:  Revision                                                            //
+// ----------------------------------------------------------------------- //
+static const struct uarch_db_entry uarch_table[] = {
+  //          IM   P      V   R
+  UARCH_ENTRY('A', 0xB36, NA, NA, "ARM1136",               UARCH_ARM1136,      CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xB56, NA, NA, "ARM1156",               UARCH_ARM1156,      CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xB76, NA, NA, "ARM1176",               UARCH_ARM1176,      CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xB02, NA, NA, "ARM11 MPCore",          UARCH_ARM11MPCORE,  CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xC05, NA, NA, "Cortex-A5",             UARCH_CORTEX_A5,    CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xC07, NA, NA, "Cortex-A7",             UARCH_CORTEX_A7,    CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xC08, NA, NA, "Cortex-A8",             UARCH_CORTEX_A8,    CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xC09, NA, NA, "Cortex-A9",             UARCH_CORTEX_A9,    CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xC0C, NA, NA, "Cortex-A12",            UARCH_CORTEX_A12,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xC0E, NA, NA, "Cortex-A17",            UARCH_CORTEX_A17,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xC0D, NA, NA, "Cortex-A12",            UARCH_CORTEX_A12,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xC0F, NA, NA, "Cortex-A15",            UARCH_CORTEX_A15,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD01, NA, NA, "Cortex-A32",            UARCH_CORTEX_A32,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD03, NA, NA, "Cortex-A53",            UARCH_CORTEX_A53,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD04, NA, NA, "Cortex-A35",            UARCH_CORTEX_A35,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD05, NA,  0, "Cortex-A55",            UARCH_CORTEX_A55r0, CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD05, NA, NA, "Cortex-A55",            UARCH_CORTEX_A55,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD06, NA, NA, "Cortex-A65",            UARCH_CORTEX_A65,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD07, NA, NA, "Cortex-A57",            UARCH_CORTEX_A57,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD08, NA, NA, "Cortex-A72",            UARCH_CORTEX_A72,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD09, NA, NA, "Cortex-A73",            UARCH_CORTEX_A73,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD0A, NA, NA, "Cortex-A75",            UARCH_CORTEX_A75,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD0B, NA, NA, "Cortex-A76",            UARCH_CORTEX_A76,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD0C, NA, NA, "Neoverse N1",           UARCH_NEOVERSE_N1,  CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD0D, NA, NA, "Cortex-A77",            UARCH_CORTEX_A77,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD0E, NA, NA, "Cortex-A76",            UARCH_CORTEX_A76,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD40, NA, NA, "Neoverse V1",           UARCH_NEOVERSE_V1,  CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD41, NA, NA, "Cortex-A78",            UARCH_CORTEX_A78,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD42, NA, NA, "Cortex-A78AE",          UARCH_CORTEX_A78AE, CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD44, NA, NA, "Cortex-X1",             UARCH_CORTEX_X1,    CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD46, NA, NA, "Cortex‑A510",           UARCH_CORTEX_A510,  CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD47, NA, NA, "Cortex‑A710",           UARCH_CORTEX_A710,  CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD48, NA, NA, "Cortex-X2",             UARCH_CORTEX_X2,    CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD49, NA, NA, "Neoverse N2",           UARCH_NEOVERSE_N2,  CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD4A, NA, NA, "Neoverse E1",           UARCH_NEOVERSE_E1,  CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD4B, NA, NA, "Cortex-A78C",           UARCH_CORTEX_A78C,  CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD4C, NA, NA, "Cortex-X1C",            UARCH_CORTEX_X1C,   CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD4D, NA, NA, "Cortex-A715",           UARCH_CORTEX_A715,  CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD4E, NA, NA, "Cortex-X3",             UARCH_CORTEX_X3,    CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD4F, NA, NA, "Neoverse V2",           UARCH_NEOVERSE_V2,  CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD80, NA, NA, "Cortex-A520",           UARCH_CORTEX_A520,  CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD81, NA, NA, "Cortex-A720",           UARCH_CORTEX_A720,  CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD82, NA, NA, "Cortex-X4",             UARCH_CORTEX_X4,    CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD84, NA, NA, "Neoverse V3",           UARCH_NEOVERSE_V3,  CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD85, NA, NA, "Cortex-X925",           UARCH_CORTEX_X925,  CPU_VENDOR_ARM)
+  UARCH_ENTRY('A', 0xD87, NA, NA, "Cortex-A725",           UARCH_CORTEX_A725,  CPU_VENDOR_ARM)
+
+  UARCH_ENTRY('B', 0x00F, NA, NA, "Brahma B15",            UARCH_BRAHMA_B15,   CPU_VENDOR_BROADCOM)
+  UARCH_ENTRY('B', 0x100, NA, NA, "Brahma B53",            UARCH_BRAHMA_B53,   CPU_VENDOR_BROADCOM)
+  UARCH_ENTRY('B', 0x516, NA, NA, "ThunderX2",             UARCH_THUNDERX2,    CPU_VENDOR_CAVIUM)
+
+  UARCH_ENTRY('C', 0x0A0, NA, NA, "ThunderX",              UARCH_THUNDERX,     CPU_VENDOR_CAVIUM)
+  UARCH_ENTRY('C', 0x0A1, NA, NA, "ThunderX 88XX",         UARCH_THUNDERX,     CPU_VENDOR_CAVIUM)
+  UARCH_ENTRY('C', 0x0A2, NA, NA, "ThunderX 81XX",         UARCH_THUNDERX,     CPU_VENDOR_CAVIUM)
+  UARCH_ENTRY('C', 0x0A3, NA, NA, "ThunderX 81XX",         UARCH_THUNDERX,     CPU_VENDOR_CAVIUM)
+  UARCH_ENTRY('C', 0x0AF, NA, NA, "ThunderX2 99XX",        UARCH_THUNDERX2,    CPU_VENDOR_CAVIUM)
+
+  UARCH_ENTRY('H', 0xD01, NA, NA, "TaiShan v110",          UARCH_TAISHAN_V110, CPU_VENDOR_HUAWEI) // Kunpeng 920 series
+  UARCH_ENTRY('H', 0xD02,  2,  2, "TaiShan v120",          UARCH_TAISHAN_V120, CPU_VENDOR_HUAWEI) // Kiring 9000S Big cores (https://github.com/Dr-Noob/cpufetch/issues/259)
+  UARCH_ENTRY('H', 0xD02, NA, NA, "TaiShan v200",          UARCH_TAISHAN_V200, CPU_VENDOR_HUAWEI) // Kunpeng 930 series (found in openeuler: https://mailweb.openeuler.org/hyperkitty/list/kernel@openeuler.org/message/XQCV7NX2UKRIUWUFKRF4PO3QENCOUFR3)
+  UARCH_ENTRY('H', 0xD40, NA, NA, "Cortex-A76",            UARCH_CORTEX_A76,   CPU_VENDOR_ARM)    // Kirin 980 Big/Medium cores -> Cortex-A76
+  UARCH_ENTRY('H', 0xD42, NA, NA, "TaiShan v120",          UARCH_TAISHAN_V120, CPU_VENDOR_HUAWEI) // Kiring 9000S Small Cores (https://github.com/Dr-Noob/cpufetch/issues/259)
+
+  UARCH_ENTRY('N', 0x000, NA, NA, "Denver",                UARCH_DENVER,       CPU_VENDOR_NVIDIA)
+  UARCH_ENTRY('N', 0x003, NA, NA, "Denver2",               UARCH_DENVER2,      CPU_VENDOR_NVIDIA)
+  UARCH_ENTRY('N', 0x004, NA, NA, "Carmel",                UARCH_CARMEL,       CPU_VENDOR_NVIDIA)
+
+  UARCH_ENTRY('P', 0x000, NA, NA, "Xgene",                 UARCH_XGENE,        CPU_VENDOR_APM)
+
+  UARCH_ENTRY('Q', 0x00F, NA, NA, "Scorpion",              UARCH_SCORPION,     CPU_VENDOR_QUALCOMM)
+  UARCH_ENTRY('Q', 0x02D, NA, NA, "Scorpion",              UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
+  UARCH_ENTRY('Q', 0x04D,  1,  0, "Krait 200",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
+  UARCH_ENTRY('Q', 0x04D,  1,  4, "Krait 200",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
+  UARCH_ENTRY('Q', 0x04D,  2,  0, "Krait 300",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
+  UARCH_ENTRY('Q', 0x06F,  0,  1, "Krait 200",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
+  UARCH_ENTRY('Q', 0x06F,  0,  2, "Krait 200",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
+  UARCH_ENTRY('Q', 0x06F,  1,  0, "Krait 300",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
+  UARCH_ENTRY('Q', 0x06F,  2,  0, "Krait 400",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM) // Snapdragon 800 MSMxxxx
+  UARCH_ENTRY('Q', 0x06F,  2,  1, "Krait 400",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM) // Snapdragon 801 MSMxxxxPRO
+  UARCH_ENTRY('Q', 0x06F,  3,  1, "Krait 450",             UARCH_KRAIT,        CPU_VENDOR_QUALCOMM)
+  UARCH_ENTRY('Q', 0x201, NA, NA, "Kryo Silver",           UARCH_KYRO,         CPU_VENDOR_QUALCOMM) // Qualcomm Snapdragon 821: Low-power Kryo "Silver"
+  UARCH_ENTRY('Q', 0x205, NA, NA, "Kryo Gold",             UARCH_KYRO,         CPU_VENDOR_QUALCOMM) // Qualcomm Snapdragon 820 & 821: High-performance Kryo "Gold"
+  UARCH_ENTRY('Q', 0x211, NA, NA, "Kryo Silver",           UARCH_KYRO,         CPU_VENDOR_QUALCOMM) // Qualcomm Snapdragon 820: Low-power Kryo "Silver"
+  UARCH_ENTRY('Q', 0x800, 10, NA, "Kryo 260 / 280 Gold",   UARCH_CORTEX_A73,   CPU_VENDOR_ARM)      // Kryo 260 / Kryo 280 "Gold"
+  UARCH_ENTRY('Q', 0x801, 10, NA, "Kryo 260 / 280 Silver", UARCH_CORTEX_A53,   CPU_VENDOR_ARM)      // Kryo 260 / 280 "Silver"
+  UARCH_ENTRY('Q', 0x802, NA, NA, "Kryo 385 Gold",         UARCH_CORTEX_A75,   CPU_VENDOR_ARM)      // High-performance Kryo 385 "Gold" -> Cortex-A75
+  UARCH_ENTRY('Q', 0x803, NA, NA, "Kryo 385 Silver",       UARCH_CORTEX_A55r0, CPU_VENDOR_ARM)      // Low-power Kryo 385 "Silver" -> Cortex-A55r0
+  UARCH_ENTRY('Q', 0x804, NA, NA, "Kryo 485 Gold",         UARCH_CORTEX_A76,   CPU_VENDOR_ARM)      // High-performance Kryo 485 "Gold" / "Gold Prime" -> Cortex-A76
+  UARCH_ENTRY('Q', 0x805, NA, NA, "Kryo 485 Silver",       UARCH_CORTEX_A55,   CPU_VENDOR_ARM)      // Low-performance Kryo 485 "Silver" -> Cortex-A55
+  UARCH_ENTRY('Q', 0xC00, NA, NA, "Falkor",                UARCH_FALKOR,       CPU_VENDOR_QUALCOMM)
+  UARCH_ENTRY('Q', 0xC01, NA, NA, "Saphira",               UARCH_SAPHIRA,      CPU_VENDOR_QUALCOMM)
+
+  UARCH_ENTRY('S', 0x001, 1,  NA, "Exynos M1",             UARCH_EXYNOS_M1,    CPU_VENDOR_SAMSUNG)   // Exynos 8890
+  UARCH_ENTRY('S', 0x001, 4,  NA, "Exynos M2",             UARCH_EXYNOS_M2,    CPU_VENDOR_SAMSUNG)   // Exynos 8895
+  UARCH_ENTRY('S', 0x002, 1,  NA, "Exynos M3",             UARCH_EXYNOS_M3,    CPU_VENDOR_SAMSUNG)   // Exynos 9810
+  UARCH_ENTRY('S', 0x003, 1,  NA, "Exynos M4",             UARCH_EXYNOS_M4,    CPU_VENDOR_SAMSUNG)   // Exynos 9820
+  UARCH_ENTRY('S', 0x004, 1,  NA, "Exynos M5",             UARCH_EXYNOS_M5,    CPU_VENDOR_SAMSUNG)   // Exynos 9820 (this one looks wrong at uarch.c ...)
+
+  UARCH_ENTRY('p', 0x663, 1,  NA, "Xiaomi",                UARCH_XIAOMI,       CPU_VENDOR_PHYTIUM)   // From a fellow contributor (https://github.com/Dr-Noob/cpufetch/issues/125)
                                                                                                                 // Also interesting: https://en.wikipedia.org/wiki/FeiTeng_(processor)
 
-  CHECK_UARCH(arch, cpu, 'a', 0x022, NA, NA, "Icestorm",              UARCH_ICESTORM,     CPU_VENDOR_APPLE)
-  CHECK_UARCH(arch, cpu, 'a', 0x023, NA, NA, "Firestorm",             UARCH_FIRESTORM,    CPU_VENDOR_APPLE)
-  CHECK_UARCH(arch, cpu, 'a', 0x024, NA, NA, "Icestorm",              UARCH_ICESTORM,     CPU_VENDOR_APPLE)     // https://github.com/Dr-Noob/cpufetch/issues/263
-  CHECK_UARCH(arch, cpu, 'a', 0x025, NA, NA, "Firestorm",             UARCH_FIRESTORM,    CPU_VENDOR_APPLE)     // https://github.com/Dr-Noob/cpufetch/issues/263
-  CHECK_UARCH(arch, cpu, 'a', 0x030, NA, NA, "Blizzard",              UARCH_BLIZZARD,     CPU_VENDOR_APPLE)
-  CHECK_UARCH(arch, cpu, 'a', 0x031, NA, NA, "Avalanche",             UARCH_AVALANCHE,    CPU_VENDOR_APPLE)
-  CHECK_UARCH(arch, cpu, 'a', 0x048, NA, NA, "Sawtooth",              UARCH_SAWTOOTH,     CPU_VENDOR_APPLE)
-  CHECK_UARCH(arch, cpu, 'a', 0x049, NA, NA, "Everest",               UARCH_EVEREST,      CPU_VENDOR_APPLE)
+  UARCH_ENTRY('a', 0x022, NA, NA, "Icestorm",              UARCH_ICESTORM,     CPU_VENDOR_APPLE)
+  UARCH_ENTRY('a', 0x023, NA, NA, "Firestorm",             UARCH_FIRESTORM,    CPU_VENDOR_APPLE)
+  UARCH_ENTRY('a', 0x024, NA, NA, "Icestorm",              UARCH_ICESTORM,     CPU_VENDOR_APPLE)     // https://github.com/Dr-Noob/cpufetch/issues/263
+  UARCH_ENTRY('a', 0x025, NA, NA, "Firestorm",             UARCH_FIRESTORM,    CPU_VENDOR_APPLE)     // https://github.com/Dr-Noob/cpufetch/issues/263
+  UARCH_ENTRY('a', 0x030, NA, NA, "Blizzard",              UARCH_BLIZZARD,     CPU_VENDOR_APPLE)
+  UARCH_ENTRY('a', 0x031, NA, NA, "Avalanche",             UARCH_AVALANCHE,    CPU_VENDOR_APPLE)
+  UARCH_ENTRY('a', 0x048, NA, NA, "Sawtooth",              UARCH_SAWTOOTH,     CPU_VENDOR_APPLE)
+  UARCH_ENTRY('a', 0x049, NA, NA, "Everest",               UARCH_EVEREST,      CPU_VENDOR_APPLE)
+
+  UARCH_ENTRY('V', 0x581, NA, NA, "PJ4",                   UARCH_PJ4,          CPU_VENDOR_MARVELL)
+  UARCH_ENTRY('V', 0x584, NA, NA, "PJ4B-MP",               UARCH_PJ4,          CPU_VENDOR_MARVELL)
+};
+
+// IMPLEMENTER PART VARIANT REVISION UARCH "Name" VENDOR [VPUS]
+static bool parse_uarch_db_entry(char** tok, int num_tokens, struct uarch_db_entry* entry) {
+  int64_t im, p, v, r, vpus = NA;
+
+  if(num_tokens != 7 && num_tokens != 8) {
+    printErr("Expected 7 or 8 fields, found %d", num_tokens);
+    return false;
+  }
+
+  if(!uarch_db_parse_int(tok[0], 0, 0xFF, &im) || !uarch_db_parse_int(tok[1], 0, 0xFFF, &p) ||
+     !uarch_db_parse_int(tok[2], 0, 0xF, &v) || !uarch_db_parse_int(tok[3], 0, 0xF, &r) ||
+     (num_tokens == 8 && !uarch_db_parse_int(tok[7], 1, 16, &vpus))) {
+    return false;
+  }
+
+  entry->uarch = uarch_db_parse_symbol(tok[4], uarch_names, sizeof(uarch_names) / sizeof(uarch_names[0]));
+  entry->vendor = uarch_db_parse_symbol(tok[6], vendor_names, sizeof(vendor_names) / sizeof(vendor_names[0]));
+  if(entry->uarch < 0 || entry->vendor < 0) return false;
 
-  CHECK_UARCH(arch, cpu, 'V', 0x581, NA, NA, "PJ4",                   UARCH_PJ4,          CPU_VENDOR_MARVELL)
-  CHECK_UARCH(arch, cpu, 'V', 0x584, NA, NA, "PJ4B-MP",               UARCH_PJ4,          CPU_VENDOR_MARVELL)
+  entry->mask = ARM_MASK(im, p, v, r);
+  entry->value = ARM_SIG(im, p, v, r);
+  entry->str = tok[5];
+  entry->vpus = vpus;
+  return true;
+}
 
-  UARCH_END
+struct uarch* get_uarch_from_midr(uint32_t midr, struct cpuInfo* cpu) {
+  static struct uarch_db* db = NULL;
+  struct uarch* arch = amalloc(sizeof(struct uarch));
+  int32_t im = midr_get_implementer(midr);
+  int32_t p = midr_get_part(midr);
+  int32_t v = midr_get_variant(midr);
+  int32_t r = midr_get_revision(midr);
+
+  if(db == NULL) {
+    db = uarch_db_build(uarch_table, sizeof(uarch_table) / sizeof(uarch_table[0]), get_uarch_db_file(), parse_uarch_db_entry);
+  }
+
+  const struct uarch_db_entry* entry = uarch_db_lookup(db, ARM_SIG(im, p, v, r));
+  if(entry == NULL) {
+    printBugCheckRelease("Unknown microarchitecture detected: IM=0x%X P=0x%X V=0x%X R=0x%X", im, p, v, r);
+    fill_uarch(arch, cpu, "Unknown", UARCH_UNKNOWN, CPU_VENDOR_UNKNOWN);
+  }
+  else {
+    fill_uarch(arch, cpu, entry->str, entry->uarch, entry->vendor);
+    arch->vpus = entry->vpus;
+  }
 
   return arch;
 }
@@ -330,6 +480,7 @@ int get_vpus_width(struct cpuInfo* cpu) {
 
 int get_number_of_vpus(struct cpuInfo* cpu) {
   MICROARCH ua = cpu->arch->uarch;
+  if(cpu->arch->vpus != NA) return cpu->arch->vpus;
 
   switch(ua) {
     case UARCH_CORTEX_X925: // [https://www.anandtech.com/show/21399/arm-unveils-2024-cpu-core-designs-cortex-x925-a725-and-a520-arm-v9-2-redefined-for-3nm-/2]
@@ -396,8 +547,3 @@ char* get_str_uarch(struct cpuInfo* cpu) {
 MICROARCH get_uarch(struct uarch* arch) {
   return arch->uarch;
 }
-
-void free_uarch_struct(struct uarch* arch) {
-  free(arch->uarch_str);
-  free(arch);
-}
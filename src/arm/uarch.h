@@ -109,7 +109,6 @@ int get_number_of_vpus(struct cpuInfo* cpu);
 int get_vpus_width(struct cpuInfo* cpu);
 bool has_fma_support(struct cpuInfo* cpu);
 char* get_str_uarch(struct cpuInfo* cpu);
-void free_uarch_struct(struct uarch* arch);
 MICROARCH get_uarch(struct uarch* arch);
 
 #endif
@@ -2,11 +2,21 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <errno.h>
 #include "args.h"
 #include "global.h"
 
 #define NUM_COLORS      5
 
+// Default --convergence, in percentage
+#define DEFAULT_FREQ_TOLERANCE   1.0
+#define DEFAULT_FREQ_CONFIDENCE 95.0
+// Default --soak, in seconds
+#define DEFAULT_SOAK_SECONDS    120
+// Default --low-noise trials
+#define DEFAULT_LOW_NOISE_TRIALS  5
+#define MAX_LOW_NOISE_TRIALS    100
+
 #define COLOR_STR_INTEL     "intel"
 #define COLOR_STR_INTEL_NEW "intel-new"
 #define COLOR_STR_AMD       "amd"
@@ -23,12 +33,34 @@ static const char *SYTLES_STR_LIST[] = {
   [STYLE_INVALID] = NULL
 };
 
+static const char *FIELDS_STR_LIST[] = {
+  [FIELD_NAME]       = "name",
+  [FIELD_HYPERVISOR] = "hypervisor",
+  [FIELD_UARCH]      = "uarch",
+  [FIELD_TECHNOLOGY] = "technology",
+  [FIELD_FREQUENCY]  = "frequency",
+  [FIELD_SOCKETS]    = "sockets",
+  [FIELD_CORES]      = "cores",
+  [FIELD_FEATURES]   = "features",
+  [FIELD_L1I]        = "l1i",
+  [FIELD_L1D]        = "l1d",
+  [FIELD_L2]         = "l2",
+  [FIELD_L3]         = "l3",
+  [FIELD_PEAK]       = "peak",
+  [FIELD_INVALID]    = NULL
+};
+
+#define FIELDS_ALL ((1U << FIELD_INVALID) - 1)
+
 struct args_struct {
   bool debug_flag;
   bool help_flag;
   bool raw_flag;
   bool accurate_pp;
   bool measure_max_frequency_flag;
+  bool cache_flag;
+  bool no_cache_flag;
+  bool refresh_cache_flag;
   bool full_cpu_name_flag;
   bool logo_long;
   bool logo_short;
@@ -36,6 +68,24 @@ struct args_struct {
   bool logo_intel_old;
   bool verbose_flag;
   bool version_flag;
+  bool trace_flag;
+  char* trace_file;
+  char* uarch_db_file;
+  double freq_tolerance;
+  double freq_confidence;
+  bool freq_map_flag;
+  char* freq_map_file;
+  bool turbo_curve_flag;
+  char* turbo_curve_file;
+  bool isa_freq_flag;
+  char* isa_freq_file;
+  bool soak_flag;
+  int soak_seconds;
+  char* soak_file;
+  bool timekeeping_flag;
+  bool low_noise_flag;
+  int low_noise_trials;
+  uint32_t fields;
   STYLE style;
   struct color** colors;
 };
@@ -52,6 +102,19 @@ const char args_chr[] = {
   /* [ARG_LOGO_INTEL_OLD]   = */ 4,
   /* [ARG_ACCURATE_PP]      = */ 5,
   /* [ARG_MEASURE_MAX_FREQ] = */ 6,
+  /* [ARG_CACHE]            = */ 7,
+  /* [ARG_NO_CACHE]         = */ 8,
+  /* [ARG_REFRESH_CACHE]    = */ 9,
+  /* [ARG_FIELDS]           = */ 'f',
+  /* [ARG_TRACE]            = */ 10,
+  /* [ARG_UARCH_DB]         = */ 11,
+  /* [ARG_CONVERGENCE]      = */ 12,
+  /* [ARG_FREQ_MAP]         = */ 13,
+  /* [ARG_TURBO_CURVE]      = */ 14,
+  /* [ARG_ISA_FREQ]         = */ 15,
+  /* [ARG_SOAK]             = */ 16,
+  /* [ARG_TIMEKEEPING]      = */ 17,
+  /* [ARG_LOW_NOISE]        = */ 18,
   /* [ARG_DEBUG]            = */ 'd',
   /* [ARG_VERBOSE]          = */ 'v',
   /* [ARG_VERSION]          = */ 'V',
@@ -69,6 +132,19 @@ const char *args_str[] = {
   /* [ARG_LOGO_INTEL_OLD]   = */ "logo-intel-old",
   /* [ARG_ACCURATE_PP]      = */ "accurate-pp",
   /* [ARG_MEASURE_MAX_FREQ] = */ "measure-max-freq",
+  /* [ARG_CACHE]            = */ "cache",
+  /* [ARG_NO_CACHE]         = */ "no-cache",
+  /* [ARG_REFRESH_CACHE]    = */ "refresh-cache",
+  /* [ARG_FIELDS]           = */ "fields",
+  /* [ARG_TRACE]            = */ "trace",
+  /* [ARG_UARCH_DB]         = */ "uarch-db",
+  /* [ARG_CONVERGENCE]      = */ "convergence",
+  /* [ARG_FREQ_MAP]         = */ "freq-map",
+  /* [ARG_TURBO_CURVE]      = */ "turbo-curve",
+  /* [ARG_ISA_FREQ]         = */ "isa-freq",
+  /* [ARG_SOAK]             = */ "soak",
+  /* [ARG_TIMEKEEPING]      = */ "timekeeping",
+  /* [ARG_LOW_NOISE]        = */ "low-noise",
   /* [ARG_DEBUG]            = */ "debug",
   /* [ARG_VERBOSE]          = */ "verbose",
   /* [ARG_VERSION]          = */ "version",
@@ -108,6 +184,102 @@ bool measure_max_frequency_flag(void) {
   return args.measure_max_frequency_flag;
 }
 
+// The cache is opt-in: --cache or --refresh-cache enable it,
+// and --no-cache always takes precedence
+bool use_cache(void) {
+  return (args.cache_flag || args.refresh_cache_flag) && !args.no_cache_flag;
+}
+
+bool refresh_cache(void) {
+  return args.refresh_cache_flag && !args.no_cache_flag;
+}
+
+// debug and raw always need everything
+bool field_enabled(int field) {
+  return args.debug_flag || args.raw_flag || (args.fields & (1U << field));
+}
+
+bool all_fields_enabled(void) {
+  return args.fields == FIELDS_ALL;
+}
+
+bool trace_enabled(void) {
+  return args.trace_flag;
+}
+
+// NULL if only the summary was requested
+char* get_trace_file(void) {
+  return args.trace_file;
+}
+
+// NULL if only the built-in table should be used
+char* get_uarch_db_file(void) {
+  return args.uarch_db_file;
+}
+
+// Relative half width of the confidence interval (e.g, 0.01)
+double get_freq_tolerance(void) {
+  return args.freq_tolerance / 100;
+}
+
+// Confidence level of the interval (e.g, 0.95)
+double get_freq_confidence(void) {
+  return args.freq_confidence / 100;
+}
+
+bool freq_map_enabled(void) {
+  return args.freq_map_flag;
+}
+
+// NULL if only the table was requested
+char* get_freq_map_file(void) {
+  return args.freq_map_file;
+}
+
+bool turbo_curve_enabled(void) {
+  return args.turbo_curve_flag;
+}
+
+// NULL if only the table was requested
+char* get_turbo_curve_file(void) {
+  return args.turbo_curve_file;
+}
+
+bool isa_freq_enabled(void) {
+  return args.isa_freq_flag;
+}
+
+// NULL if only the table was requested
+char* get_isa_freq_file(void) {
+  return args.isa_freq_file;
+}
+
+bool soak_enabled(void) {
+  return args.soak_flag;
+}
+
+int get_soak_seconds(void) {
+  return args.soak_seconds;
+}
+
+// NULL if only the table was requested
+char* get_soak_file(void) {
+  return args.soak_file;
+}
+
+bool timekeeping_enabled(void) {
+  return args.timekeeping_flag;
+}
+
+bool low_noise_enabled(void) {
+  return args.low_noise_flag;
+}
+
+// Number of trials of each measurement (1 without --low-noise)
+int get_low_noise_trials(void) {
+  return args.low_noise_flag ? args.low_noise_trials : 1;
+}
+
 bool show_full_cpu_name(void) {
   return args.full_cpu_name_flag;
 }
@@ -154,6 +326,94 @@ STYLE parse_style(char* style) {
   return i;
 }
 
+// Parses a comma separated list of fields (e.g, "name,cores,l3")
+bool parse_fields(char* optarg_str, uint32_t* fields) {
+  uint8_t fields_count = sizeof(FIELDS_STR_LIST) / sizeof(FIELDS_STR_LIST[0]);
+  char* str = emalloc(sizeof(char) * (strlen(optarg_str) + 1));
+  strcpy(str, optarg_str);
+  *fields = 0;
+
+  for(char* tok = strtok(str, ","); tok != NULL; tok = strtok(NULL, ",")) {
+    uint8_t i = 0;
+    // "soc" is what ARM and RISC-V show as the name
+    if(strcmp(tok, "soc") == 0) tok = (char *) FIELDS_STR_LIST[FIELD_NAME];
+
+    while(i != fields_count && (FIELDS_STR_LIST[i] == NULL || strcmp(FIELDS_STR_LIST[i], tok) != 0))
+      i++;
+
+    if(i == fields_count) {
+      printErr("Invalid field '%s'", tok);
+      free(str);
+      return false;
+    }
+    *fields |= 1U << i;
+  }
+
+  free(str);
+  if(*fields == 0) {
+    printErr("No fields were specified");
+    return false;
+  }
+  return true;
+}
+
+// Parses "TOL[,CONF]", both in percentage (e.g, "0.5,99")
+bool parse_convergence(char* optarg_str, double* tolerance, double* confidence) {
+  char* end;
+  *tolerance = strtod(optarg_str, &end);
+  if(end == optarg_str || !(*tolerance > 0 && *tolerance < 100)) {
+    printErr("Invalid tolerance '%s'; must be in range (0, 100)", optarg_str);
+    return false;
+  }
+
+  if(*end == ',') {
+    char* conf_str = end+1;
+    *confidence = strtod(conf_str, &end);
+    if(end == conf_str || !(*confidence >= 50 && *confidence < 100)) {
+      printErr("Invalid confidence '%s'; must be in range [50, 100)", conf_str);
+      return false;
+    }
+  }
+  if(*end != '\0') {
+    printErr("Invalid convergence '%s'", optarg_str);
+    return false;
+  }
+  return true;
+}
+
+// SECONDS[,FILE]
+bool parse_soak(char* optarg_str, int* seconds, char** file) {
+  char* end;
+  errno = 0;
+  long value = strtol(optarg_str, &end, 10);
+  if(end == optarg_str || errno != 0 || value <= 0 || value > 86400) {
+    printErr("Invalid soak duration '%s'; must be in range [1, 86400] seconds", optarg_str);
+    return false;
+  }
+  *seconds = value;
+
+  if(*end == ',' && *(end+1) != '\0') {
+    *file = end+1;
+  }
+  else if(*end != '\0') {
+    printErr("Invalid soak '%s'", optarg_str);
+    return false;
+  }
+  return true;
+}
+
+bool parse_low_noise(char* optarg_str, int* trials) {
+  char* end;
+  errno = 0;
+  long value = strtol(optarg_str, &end, 10);
+  if(end == optarg_str || *end != '\0' || errno != 0 || value < 2 || value > MAX_LOW_NOISE_TRIALS) {
+    printErr("Invalid number of trials '%s'; must be in range [2, %d]", optarg_str, MAX_LOW_NOISE_TRIALS);
+    return false;
+  }
+  *trials = value;
+  return true;
+}
+
 void free_colors_struct(struct color** cs) {
   for(int i=0; i < NUM_COLORS; i++) {
     free(cs[i]);
@@ -228,24 +488,25 @@ char* build_short_options(void) {
   char* str = (char *) ecalloc(len*2 + 1, sizeof(char));
 
 #ifdef ARCH_X86
-  sprintf(str, "%c:%c:%c%c%c%c%c%c%c%c%c%c%c%c",
-  c[ARG_STYLE], c[ARG_COLOR], c[ARG_HELP],
+  sprintf(str, "%c:%c:%c:%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c",
+  c[ARG_STYLE], c[ARG_COLOR], c[ARG_FIELDS], c[ARG_HELP],
   c[ARG_RAW], c[ARG_FULLCPUNAME],
   c[ARG_LOGO_SHORT], c[ARG_LOGO_LONG],
   c[ARG_LOGO_INTEL_NEW], c[ARG_LOGO_INTEL_OLD],
   c[ARG_ACCURATE_PP], c[ARG_MEASURE_MAX_FREQ],
+  c[ARG_CACHE], c[ARG_NO_CACHE], c[ARG_REFRESH_CACHE],
   c[ARG_DEBUG], c[ARG_VERBOSE],
   c[ARG_VERSION]);
 #elif ARCH_ARM
-  sprintf(str, "%c:%c:%c%c%c%c%c%c%c",
-  c[ARG_STYLE], c[ARG_COLOR], c[ARG_HELP],
+  sprintf(str, "%c:%c:%c:%c%c%c%c%c%c%c",
+  c[ARG_STYLE], c[ARG_COLOR], c[ARG_FIELDS], c[ARG_HELP],
   c[ARG_LOGO_SHORT], c[ARG_LOGO_LONG],
   c[ARG_MEASURE_MAX_FREQ],
   c[ARG_DEBUG], c[ARG_VERBOSE],
   c[ARG_VERSION]);
 #else
-  sprintf(str, "%c:%c:%c%c%c%c%c%c",
-  c[ARG_STYLE], c[ARG_COLOR], c[ARG_HELP],
+  sprintf(str, "%c:%c:%c:%c%c%c%c%c%c",
+  c[ARG_STYLE], c[ARG_COLOR], c[ARG_FIELDS], c[ARG_HELP],
   c[ARG_LOGO_SHORT], c[ARG_LOGO_LONG],
   c[ARG_DEBUG], c[ARG_VERBOSE],
   c[ARG_VERSION]);
@@ -260,8 +521,13 @@ bool parse_args(int argc, char* argv[]) {
   opterr = 0;
 
   bool color_flag = false;
+  bool fields_flag = false;
+  bool convergence_flag = false;
   args.debug_flag = false;
   args.accurate_pp = false;
+  args.cache_flag = false;
+  args.no_cache_flag = false;
+  args.refresh_cache_flag = false;
   args.full_cpu_name_flag = false;
   args.raw_flag = false;
   args.verbose_flag = false;
@@ -270,7 +536,25 @@ bool parse_args(int argc, char* argv[]) {
   args.logo_intel_new = false;
   args.logo_intel_old = false;
   args.help_flag = false;
+  args.trace_flag = false;
+  args.trace_file = NULL;
+  args.uarch_db_file = NULL;
+  args.freq_tolerance = DEFAULT_FREQ_TOLERANCE;
+  args.freq_confidence = DEFAULT_FREQ_CONFIDENCE;
+  args.freq_map_flag = false;
+  args.freq_map_file = NULL;
+  args.turbo_curve_flag = false;
+  args.turbo_curve_file = NULL;
+  args.isa_freq_flag = false;
+  args.isa_freq_file = NULL;
+  args.soak_flag = false;
+  args.soak_seconds = DEFAULT_SOAK_SECONDS;
+  args.soak_file = NULL;
+  args.timekeeping_flag = false;
+  args.low_noise_flag = false;
+  args.low_noise_trials = DEFAULT_LOW_NOISE_TRIALS;
   args.style = STYLE_EMPTY;
+  args.fields = FIELDS_ALL;
   args.colors = NULL;
 
   // Temporary enable verbose level to allow printing warnings inside parse_args
@@ -279,16 +563,35 @@ bool parse_args(int argc, char* argv[]) {
   const struct option long_options[] = {
     {args_str[ARG_STYLE],            required_argument, 0, args_chr[ARG_STYLE]            },
     {args_str[ARG_COLOR],            required_argument, 0, args_chr[ARG_COLOR]            },
+    {args_str[ARG_FIELDS],           required_argument, 0, args_chr[ARG_FIELDS]           },
+    {args_str[ARG_TRACE],            optional_argument, 0, args_chr[ARG_TRACE]            },
+#ifndef ARCH_RISCV
+    {args_str[ARG_UARCH_DB],         required_argument, 0, args_chr[ARG_UARCH_DB]         },
+#endif
     {args_str[ARG_HELP],             no_argument,       0, args_chr[ARG_HELP]             },
 #ifdef ARCH_X86
     {args_str[ARG_LOGO_INTEL_NEW],   no_argument,       0, args_chr[ARG_LOGO_INTEL_NEW]   },
     {args_str[ARG_LOGO_INTEL_OLD],   no_argument,       0, args_chr[ARG_LOGO_INTEL_OLD]   },
     {args_str[ARG_ACCURATE_PP],      no_argument,       0, args_chr[ARG_ACCURATE_PP]      },
     {args_str[ARG_MEASURE_MAX_FREQ], no_argument,       0, args_chr[ARG_MEASURE_MAX_FREQ] },
+    {args_str[ARG_CONVERGENCE],      required_argument, 0, args_chr[ARG_CONVERGENCE]      },
+    {args_str[ARG_FREQ_MAP],         optional_argument, 0, args_chr[ARG_FREQ_MAP]         },
+    {args_str[ARG_TURBO_CURVE],      optional_argument, 0, args_chr[ARG_TURBO_CURVE]      },
+    {args_str[ARG_ISA_FREQ],         optional_argument, 0, args_chr[ARG_ISA_FREQ]         },
+    {args_str[ARG_SOAK],             optional_argument, 0, args_chr[ARG_SOAK]             },
+    {args_str[ARG_TIMEKEEPING],      no_argument,       0, args_chr[ARG_TIMEKEEPING]      },
+    {args_str[ARG_LOW_NOISE],        optional_argument, 0, args_chr[ARG_LOW_NOISE]        },
     {args_str[ARG_FULLCPUNAME],      no_argument,       0, args_chr[ARG_FULLCPUNAME]      },
     {args_str[ARG_RAW],              no_argument,       0, args_chr[ARG_RAW]              },
+#ifdef __linux__
+    {args_str[ARG_CACHE],            no_argument,       0, args_chr[ARG_CACHE]            },
+    {args_str[ARG_NO_CACHE],         no_argument,       0, args_chr[ARG_NO_CACHE]         },
+    {args_str[ARG_REFRESH_CACHE],    no_argument,       0, args_chr[ARG_REFRESH_CACHE]    },
+#endif
 #elif ARCH_ARM
     {args_str[ARG_MEASURE_MAX_FREQ], no_argument,       0, args_chr[ARG_MEASURE_MAX_FREQ] },
+    {args_str[ARG_FREQ_MAP],         optional_argument, 0, args_chr[ARG_FREQ_MAP]         },
+    {args_str[ARG_LOW_NOISE],        optional_argument, 0, args_chr[ARG_LOW_NOISE]        },
 #endif
     {args_str[ARG_LOGO_SHORT],       no_argument,       0, args_chr[ARG_LOGO_SHORT]       },
     {args_str[ARG_LOGO_LONG],        no_argument,       0, args_chr[ARG_LOGO_LONG]        },
@@ -324,6 +627,60 @@ bool parse_args(int argc, char* argv[]) {
         return false;
       }
     }
+    else if(opt == args_chr[ARG_FIELDS]) {
+      if(fields_flag) {
+        printErr("Fields option specified more than once");
+        return false;
+      }
+      fields_flag = true;
+      if(!parse_fields(optarg, &args.fields)) {
+        return false;
+      }
+    }
+    else if(opt == args_chr[ARG_TRACE]) {
+      args.trace_flag = true;
+      args.trace_file = optarg;
+    }
+    else if(opt == args_chr[ARG_UARCH_DB]) {
+      if(args.uarch_db_file != NULL) {
+        printErr("Uarch database option specified more than once");
+        return false;
+      }
+      args.uarch_db_file = optarg;
+    }
+    else if(opt == args_chr[ARG_CONVERGENCE]) {
+      convergence_flag = true;
+      if(!parse_convergence(optarg, &args.freq_tolerance, &args.freq_confidence)) {
+        return false;
+      }
+    }
+    else if(opt == args_chr[ARG_FREQ_MAP]) {
+      args.freq_map_flag = true;
+      args.freq_map_file = optarg;
+    }
+    else if(opt == args_chr[ARG_TURBO_CURVE]) {
+      args.turbo_curve_flag = true;
+      args.turbo_curve_file = optarg;
+    }
+    else if(opt == args_chr[ARG_ISA_FREQ]) {
+      args.isa_freq_flag = true;
+      args.isa_freq_file = optarg;
+    }
+    else if(opt == args_chr[ARG_SOAK]) {
+      args.soak_flag = true;
+      if(optarg != NULL && !parse_soak(optarg, &args.soak_seconds, &args.soak_file)) {
+        return false;
+      }
+    }
+    else if(opt == args_chr[ARG_TIMEKEEPING]) {
+      args.timekeeping_flag = true;
+    }
+    else if(opt == args_chr[ARG_LOW_NOISE]) {
+      args.low_noise_flag = true;
+      if(optarg != NULL && !parse_low_noise(optarg, &args.low_noise_trials)) {
+        return false;
+      }
+    }
     else if(opt == args_chr[ARG_HELP]) {
       args.help_flag  = true;
     }
@@ -333,6 +690,15 @@ bool parse_args(int argc, char* argv[]) {
     else if(opt == args_chr[ARG_MEASURE_MAX_FREQ]) {
        args.measure_max_frequency_flag = true;
     }
+    else if(opt == args_chr[ARG_CACHE]) {
+       args.cache_flag = true;
+    }
+    else if(opt == args_chr[ARG_NO_CACHE]) {
+       args.no_cache_flag = true;
+    }
+    else if(opt == args_chr[ARG_REFRESH_CACHE]) {
+       args.refresh_cache_flag = true;
+    }
     else if(opt == args_chr[ARG_FULLCPUNAME]) {
        args.full_cpu_name_flag = true;
     }
@@ -391,8 +757,31 @@ bool parse_args(int argc, char* argv[]) {
     printWarn("%s option is valid only in Linux x86_64", args_str[ARG_ACCURATE_PP]);
     args.help_flag  = true;
   }
+  if(args.turbo_curve_flag) {
+    printWarn("%s option is valid only in Linux x86_64", args_str[ARG_TURBO_CURVE]);
+    args.help_flag  = true;
+  }
+  if(args.isa_freq_flag) {
+    printWarn("%s option is valid only in Linux x86_64", args_str[ARG_ISA_FREQ]);
+    args.help_flag  = true;
+  }
+  if(args.soak_flag) {
+    printWarn("%s option is valid only in Linux x86_64", args_str[ARG_SOAK]);
+    args.help_flag  = true;
+  }
+  if(args.low_noise_flag) {
+    printWarn("%s option is valid only in Linux", args_str[ARG_LOW_NOISE]);
+    args.help_flag  = true;
+  }
 #endif
 
+  if(convergence_flag && !args.accurate_pp && !args.turbo_curve_flag && !args.isa_freq_flag) {
+    printWarn("%s option has no effect without %s, %s or %s", args_str[ARG_CONVERGENCE], args_str[ARG_ACCURATE_PP], args_str[ARG_TURBO_CURVE], args_str[ARG_ISA_FREQ]);
+  }
+  if(args.freq_map_flag && !args.accurate_pp && !args.measure_max_frequency_flag) {
+    printWarn("%s option needs %s or %s to measure the frequency", args_str[ARG_FREQ_MAP], args_str[ARG_ACCURATE_PP], args_str[ARG_MEASURE_MAX_FREQ]);
+  }
+
   // Leave log level untouched after returning
   set_log_level(false);
 
@@ -30,11 +30,41 @@ enum {
   ARG_LOGO_INTEL_OLD,
   ARG_ACCURATE_PP,
   ARG_MEASURE_MAX_FREQ,
+  ARG_CACHE,
+  ARG_NO_CACHE,
+  ARG_REFRESH_CACHE,
+  ARG_FIELDS,
+  ARG_TRACE,
+  ARG_UARCH_DB,
+  ARG_CONVERGENCE,
+  ARG_FREQ_MAP,
+  ARG_TURBO_CURVE,
+  ARG_ISA_FREQ,
+  ARG_SOAK,
+  ARG_TIMEKEEPING,
+  ARG_LOW_NOISE,
   ARG_DEBUG,
   ARG_VERBOSE,
   ARG_VERSION
 };
 
+enum {
+  FIELD_NAME,
+  FIELD_HYPERVISOR,
+  FIELD_UARCH,
+  FIELD_TECHNOLOGY,
+  FIELD_FREQUENCY,
+  FIELD_SOCKETS,
+  FIELD_CORES,
+  FIELD_FEATURES,
+  FIELD_L1I,
+  FIELD_L1D,
+  FIELD_L2,
+  FIELD_L3,
+  FIELD_PEAK,
+  FIELD_INVALID
+};
+
 extern const char args_chr[];
 extern const char *args_str[];
 
@@ -45,6 +75,27 @@ bool parse_args(int argc, char* argv[]);
 bool show_help(void);
 bool accurate_pp(void);
 bool measure_max_frequency_flag(void);
+bool use_cache(void);
+bool refresh_cache(void);
+bool field_enabled(int field);
+bool all_fields_enabled(void);
+bool trace_enabled(void);
+char* get_trace_file(void);
+char* get_uarch_db_file(void);
+double get_freq_tolerance(void);
+double get_freq_confidence(void);
+bool freq_map_enabled(void);
+char* get_freq_map_file(void);
+bool turbo_curve_enabled(void);
+char* get_turbo_curve_file(void);
+bool isa_freq_enabled(void);
+char* get_isa_freq_file(void);
+bool soak_enabled(void);
+int get_soak_seconds(void);
+char* get_soak_file(void);
+bool timekeeping_enabled(void);
+bool low_noise_enabled(void);
+int get_low_noise_trials(void);
 bool show_full_cpu_name(void);
 bool show_logo_long(void);
 bool show_logo_short(void);
@@ -5,6 +5,7 @@
 #include <stdbool.h>
 
 #include "../common/global.h"
+#include "../common/args.h"
 #include "cpu.h"
 
 #ifdef ARCH_X86
@@ -23,9 +24,70 @@
 #define STRING_NONE       "None"
 #define STRING_MEGAHERZ   "MHz"
 #define STRING_GIGAHERZ   "GHz"
+#define STRING_ALL_CORE   " (all-core)"
 #define STRING_KILOBYTES  "KB"
 #define STRING_MEGABYTES  "MB"
 
+#define PROBE(p) (1U << (p))
+
+// Probes needed to compute each field. The vendor, uarch, hypervisor
+// and CPU name are always fetched, since they are cheap and some of
+// them are also needed to choose the logo
+static const uint32_t FIELD_PROBES[] = {
+#if defined(ARCH_ARM) || defined(ARCH_RISCV)
+  [FIELD_NAME]       = PROBE(PROBE_SOC),
+  [FIELD_TECHNOLOGY] = PROBE(PROBE_SOC),
+#else
+  [FIELD_NAME]       = 0,
+  [FIELD_TECHNOLOGY] = 0,
+#endif
+  [FIELD_HYPERVISOR] = 0,
+  [FIELD_UARCH]      = 0,
+  [FIELD_FREQUENCY]  = PROBE(PROBE_FREQUENCY),
+  [FIELD_SOCKETS]    = PROBE(PROBE_TOPOLOGY),
+  [FIELD_CORES]      = PROBE(PROBE_TOPOLOGY),
+  [FIELD_FEATURES]   = PROBE(PROBE_FEATURES),
+  // Cache sizes are multiplied by the number of caches,
+  // which is computed in the topology probe
+  [FIELD_L1I]        = PROBE(PROBE_CACHE) | PROBE(PROBE_TOPOLOGY),
+  [FIELD_L1D]        = PROBE(PROBE_CACHE) | PROBE(PROBE_TOPOLOGY),
+  [FIELD_L2]         = PROBE(PROBE_CACHE) | PROBE(PROBE_TOPOLOGY),
+  [FIELD_L3]         = PROBE(PROBE_CACHE) | PROBE(PROBE_TOPOLOGY),
+  [FIELD_PEAK]       = PROBE(PROBE_PEAK),
+};
+
+// Probes needed by each probe
+static const uint32_t PROBE_DEPS[] = {
+  [PROBE_FEATURES]  = 0,
+  [PROBE_FREQUENCY] = 0,
+  [PROBE_CACHE]     = 0,
+  [PROBE_TOPOLOGY]  = PROBE(PROBE_CACHE),
+  [PROBE_SOC]       = 0,
+  [PROBE_PEAK]      = PROBE(PROBE_TOPOLOGY) | PROBE(PROBE_FREQUENCY) | PROBE(PROBE_FEATURES),
+};
+
+bool probe_enabled(int probe) {
+  static bool init = false;
+  static uint32_t probes = 0;
+
+  if(!init) {
+    int nfields = sizeof(FIELD_PROBES) / sizeof(FIELD_PROBES[0]);
+    int nprobes = sizeof(PROBE_DEPS) / sizeof(PROBE_DEPS[0]);
+
+    for(int f=0; f < nfields; f++) {
+      if(field_enabled(f)) probes |= FIELD_PROBES[f];
+    }
+    // Dependencies always point to earlier probes, so
+    // walking the list backwards resolves them all
+    for(int p=nprobes-1; p >= 0; p--) {
+      if(probes & PROBE(p)) probes |= PROBE_DEPS[p];
+    }
+    init = true;
+  }
+
+  return probes & PROBE(probe);
+}
+
 VENDOR get_cpu_vendor(struct cpuInfo* cpu) {
   return cpu->cpu_vendor;
 }
@@ -53,7 +115,7 @@ char* get_str_cpu_name(struct cpuInfo* cpu, bool fcpuname) {
 }
 
 char* get_str_sockets(struct topology* topo) {
-  char* string = emalloc(sizeof(char) * 2);
+  char* string = amalloc(sizeof(char) * 2);
   int32_t sanity_ret = snprintf(string, 2, "%d", topo->sockets);
   if(sanity_ret < 0) {
     printBug("get_str_sockets: snprintf returned a negative value for input: '%d'", topo->sockets);
@@ -70,7 +132,7 @@ uint32_t get_nsockets(struct topology* topo) {
 int32_t get_value_as_smallest_unit(char ** str, uint32_t value) {
   int32_t ret;
   int max_len = 10; // Max is 8 for digits, 2 for units
-  *str = emalloc(sizeof(char)* (max_len + 1));
+  *str = amalloc(sizeof(char)* (max_len + 1));
 
   if(value/1024 >= 1024)
     ret = snprintf(*str, max_len, "%.4g"STRING_MEGABYTES, (double)value/(1<<20));
@@ -89,7 +151,7 @@ char* get_str_cache_two(int32_t cache_size, uint32_t physical_cores) {
 
   // tmp1_len for first output, 2 for ' (', tmp2_len for second output and 7 for ' Total)'
   uint32_t size = tmp1_len + 2 + tmp2_len + 7 + 1;
-  char* string = emalloc(sizeof(char) * size);
+  char* string = amalloc(sizeof(char) * size);
 
   if(tmp1_len < 0) {
     printBug("get_value_as_smallest_unit: snprintf failed for input: %d\n", cache_size);
@@ -105,9 +167,6 @@ char* get_str_cache_two(int32_t cache_size, uint32_t physical_cores) {
     return NULL;
   }
 
-  free(tmp1);
-  free(tmp2);
-
   return string;
 }
 
@@ -151,22 +210,23 @@ char* get_str_l3(struct cache* cach) {
 
 char* get_str_freq(struct frequency* freq) {
   //Max 3 digits and 3 for '(M/G)Hz' plus 1 for '\0'
-  uint32_t size = (1+5+1+3+1);
+  //(and the all-core note if measured)
+  uint32_t size = (1+5+1+3+strlen(STRING_ALL_CORE)+1);
   assert(strlen(STRING_UNKNOWN)+1 <= size);
-  char* string = ecalloc(size, sizeof(char));
+  char* string = acalloc(size, sizeof(char));
 
   if(freq->max == UNKNOWN_DATA || freq->max < 0) {
     snprintf(string,strlen(STRING_UNKNOWN)+1,STRING_UNKNOWN);
   }
   else if(freq->max >= 1000) {
     if (freq->measured)
-      snprintf(string,size,"~%.3f "STRING_GIGAHERZ,(float)(freq->max)/1000);
+      snprintf(string,size,"~%.3f "STRING_GIGAHERZ STRING_ALL_CORE,(float)(freq->max)/1000);
     else
       snprintf(string,size,"%.3f "STRING_GIGAHERZ,(float)(freq->max)/1000);
   }
   else {
     if (freq->measured)
-      snprintf(string,size,"~%d "STRING_MEGAHERZ,freq->max);
+      snprintf(string,size,"~%d "STRING_MEGAHERZ STRING_ALL_CORE,freq->max);
     else
       snprintf(string,size,"%d "STRING_MEGAHERZ,freq->max);
   }
@@ -178,7 +238,7 @@ char* get_str_peak_performance(int64_t flops) {
   char* str;
 
   if(flops == -1) {
-    str = emalloc(sizeof(char) * (strlen(STRING_UNKNOWN) + 1));
+    str = amalloc(sizeof(char) * (strlen(STRING_UNKNOWN) + 1));
     strncpy(str, STRING_UNKNOWN, strlen(STRING_UNKNOWN) + 1);
     return str;
   }
@@ -186,7 +246,7 @@ char* get_str_peak_performance(int64_t flops) {
   // 7 for digits (e.g, XXXX.XX), 7 for XFLOP/s
   double flopsd = (double) flops;
   uint32_t max_size = 7+1+7+1;
-  str = ecalloc(max_size, sizeof(char));
+  str = acalloc(max_size, sizeof(char));
 
   if(flopsd >= (double)1000000000000.0)
     snprintf(str, max_size, "%.2f TFLOP/s", flopsd/1000000000000);
@@ -208,18 +268,18 @@ void init_topology_struct(struct topology* topo, struct cache* cach) {
   topo->sockets = 0;
 #ifdef ARCH_X86
   topo->smt_available = 0;
-  topo->apic = ecalloc(1, sizeof(struct apic));
+  topo->apic = acalloc(1, sizeof(struct apic));
 #endif
 #endif
 }
 
 void init_cache_struct(struct cache* cach) {
-  cach->L1i = emalloc(sizeof(struct cach));
-  cach->L1d = emalloc(sizeof(struct cach));
-  cach->L2 = emalloc(sizeof(struct cach));
-  cach->L3 = emalloc(sizeof(struct cach));
+  cach->L1i = amalloc(sizeof(struct cach));
+  cach->L1d = amalloc(sizeof(struct cach));
+  cach->L2 = amalloc(sizeof(struct cach));
+  cach->L3 = amalloc(sizeof(struct cach));
 
-  cach->cach_arr = emalloc(sizeof(struct cach*) * 4);
+  cach->cach_arr = amalloc(sizeof(struct cach*) * 4);
   cach->cach_arr[0] = cach->L1i;
   cach->cach_arr[1] = cach->L1d;
   cach->cach_arr[2] = cach->L2;
@@ -231,26 +291,3 @@ void init_cache_struct(struct cache* cach) {
   cach->L2->exists = false;
   cach->L3->exists = false;
 }
-
-void free_cache_struct(struct cache* cach) {
-  for(int i=0; i < 4; i++) free(cach->cach_arr[i]);
-  free(cach->cach_arr);
-  free(cach);
-}
-
-void free_freq_struct(struct frequency* freq) {
-  free(freq);
-}
-
-void free_hv_struct(struct hypervisor* hv) {
-  free(hv);
-}
-
-void free_cpuinfo_struct(struct cpuInfo* cpu) {
-  free_uarch_struct(cpu->arch);
-  free_hv_struct(cpu->hv);
-  #ifdef ARCH_X86
-  free(cpu->cpu_name);
-  #endif
-  free(cpu);
-}
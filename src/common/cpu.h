@@ -51,6 +51,17 @@ enum {
   CORE_TYPE_UNKNOWN
 };
 
+// Expensive parts of the detection, which are
+// skipped if no requested field needs them
+enum {
+  PROBE_FEATURES,
+  PROBE_FREQUENCY,
+  PROBE_CACHE,
+  PROBE_TOPOLOGY,
+  PROBE_SOC,
+  PROBE_PEAK
+};
+
 #define UNKNOWN_DATA -1
 #define CPU_NAME_MAX_LENGTH 64
 
@@ -65,6 +76,14 @@ struct frequency {
   // Max frequency when running vectorized code.
   // Used only for peak performance computation.
   int32_t max_pp;
+  // Timekeeping, only filled with --timekeeping. tsc and crystal
+  // are in Hz (UNKNOWN_DATA if unknown), bus in MHz
+  int64_t tsc;
+  int tsc_source;
+  int64_t crystal;
+  bool invariant_tsc;
+  int32_t bus;
+  char* clocksource;
 #endif
 };
 
@@ -123,6 +142,7 @@ struct features {
   bool FMA3;
   bool FMA4;
   bool SHA;
+  bool AMX; // AMX-TILE and AMX-BF16
 #elif ARCH_PPC
   bool altivec;
 #elif ARCH_ARM
@@ -174,6 +194,8 @@ struct cpuInfo {
   bool hybrid_flag;
   // Core Type (P/E)
   uint32_t core_type;
+  // Per-core cpuid values, shared by all modules
+  struct cpuid_snapshot* cpuid_snap;
 #elif ARCH_PPC
   uint32_t pvr;
 #elif ARCH_ARM
@@ -206,6 +228,7 @@ char* get_str_sockets(struct topology* topo);
 uint32_t get_nsockets(struct topology* topo);
 #endif
 
+bool probe_enabled(int probe);
 VENDOR get_cpu_vendor(struct cpuInfo* cpu);
 int64_t get_freq(struct frequency* freq);
 #ifdef ARCH_X86
@@ -224,8 +247,5 @@ char* get_str_peak_performance(int64_t flops);
 void init_topology_struct(struct topology* topo, struct cache* cach);
 void init_cache_struct(struct cache* cach);
 
-void free_cache_struct(struct cache* cach);
-void free_freq_struct(struct frequency* freq);
-void free_cpuinfo_struct(struct cpuInfo* cpu);
 
 #endif
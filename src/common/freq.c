@@ -4,26 +4,69 @@
 
 #include <time.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 #include <errno.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
 #include <asm/unistd.h>
 #include <sys/ioctl.h>
 #include <linux/perf_event.h>
 
 #include "global.h"
 #include "cpu.h"
+#include "args.h"
+#include "freq.h"
+#include "freqmap.h"
+#include "measure.h"
+
+// The measurement is split in chunks to get the min and max frequency
+// of the core besides the mean
+#define MAX_FREQ_CHUNKS       8
+#define MAX_FREQ_KERNEL       "nop"
+// CPUs this much below the max of their cluster are reported
+#define MAX_FREQ_SLOW_PCT     5
+
+// The threads wait for each other (once all of them have arrived,
+// the main thread sets go) so that they measure at the same time
+struct max_freq_sync {
+  int arrived;
+  bool go;
+};
+
+// Per-CPU result of the measurement, which runs once for all of them
+struct max_freq_thread {
+  int cpu;
+  struct max_freq_sync* sync;
+  double min;
+  double mean;
+  double max;
+  // Only with --low-noise: the interval of the mean and the chunks kept
+  double ci;
+  int num_kept;
+  bool ok;
+};
+
+static struct max_freq_thread* max_freqs = NULL;
+static int max_freqs_num_cpus = 0;
 
 static long
 perf_event_open(struct perf_event_attr *hw_event, pid_t pid,
                 int cpu, int group_fd, unsigned long flags) {
     int ret;
+    TRACE_COUNT(TRACE_PERF_SYSCALLS, 1);
     ret = syscall(__NR_perf_event_open, hw_event, pid, cpu,
                     group_fd, flags);
     return ret;
 }
 
+static int perf_event_ioctl(int fd, unsigned long request) {
+    TRACE_COUNT(TRACE_PERF_SYSCALLS, 1);
+    return ioctl(fd, request, 0);
+}
+
 #define INSERT_ASM_ONCE __asm volatile("nop");
 #define INSERT_ASM_10_TIMES \
     INSERT_ASM_ONCE         \
@@ -70,13 +113,10 @@ void nop_function(uint64_t iters) {
   }
 }
 
-// Run the nop_function with the number of iterations specified and
-// measure both the time and number of cycles
-int measure_freq_iters(uint64_t iters, uint32_t core, double* freq) {
-  clockid_t clock = CLOCK_PROCESS_CPUTIME_ID;
-  struct timespec start, end;
+// Opens a cycles counter for the calling thread, which must be running
+// on core. The same counter is reused for every measurement of the thread
+static int open_cycles_counter(uint32_t core) {
   struct perf_event_attr pe;
-  uint64_t cycles;
   int fd;
   int pid = 0;
   memset(&pe, 0, sizeof(struct perf_event_attr));
@@ -94,24 +134,33 @@ int measure_freq_iters(uint64_t iters, uint32_t core, double* freq) {
       printErr("You may not have permission to collect stats.\n"\
       "Consider tweaking /proc/sys/kernel/perf_event_paranoid or running as root");
     }
-    return -1;
   }
+  return fd;
+}
+
+// Run the nop_function with the number of iterations specified and
+// measure both the time and number of cycles (with the counter fd)
+static int measure_freq_iters(int fd, uint64_t iters, double* freq) {
+  clockid_t clock = CLOCK_THREAD_CPUTIME_ID;
+  struct timespec start, end;
+  uint64_t cycles;
 
   if (clock_gettime(clock, &start) == -1) {
     perror("clock_gettime");
     return -1;
   }
-  if(ioctl(fd, PERF_EVENT_IOC_RESET, 0) == -1) {
+  if(perf_event_ioctl(fd, PERF_EVENT_IOC_RESET) == -1) {
     perror("ioctl");
     return -1;
   }
-  if(ioctl(fd, PERF_EVENT_IOC_ENABLE, 0) == -1) {
+  if(perf_event_ioctl(fd, PERF_EVENT_IOC_ENABLE) == -1) {
     perror("ioctl");
     return -1;
   }
 
   nop_function(iters);
 
+  TRACE_COUNT(TRACE_PERF_SYSCALLS, 1);
   ssize_t ret = read(fd, &cycles, sizeof(uint64_t));
   if (ret == -1) {
     perror("read");
@@ -121,7 +170,7 @@ int measure_freq_iters(uint64_t iters, uint32_t core, double* freq) {
     printErr("Read returned %d, expected %d", ret, sizeof(uint64_t));
     return -1;
   }
-  if(ioctl(fd, PERF_EVENT_IOC_DISABLE, 0) == -1) {
+  if(perf_event_ioctl(fd, PERF_EVENT_IOC_DISABLE) == -1) {
     perror("ioctl");
     return -1;
   }
@@ -147,49 +196,234 @@ uint64_t get_num_iters_from_freq(double frequency) {
   return freq_trunc * 1e7 * 1/osp_per_iter;
 }
 
+// Runs the iterations in MAX_FREQ_CHUNKS parts. All of them do the
+// same work, so the harmonic mean is the frequency of the whole run.
+// With --low-noise, the chunks are the trials (after an extra one that
+// is run first as a warm-up), and the mean is the one of the non-outliers
+static int measure_freq_chunks(int fd, uint64_t iters, struct max_freq_thread* t) {
+  int num_chunks = low_noise_enabled() ? get_low_noise_trials() : MAX_FREQ_CHUNKS;
+  double* freqs = emalloc(sizeof(double) * num_chunks);
+  double acc = 0.0;
+  double freq;
+  int ret = -1;
+
+  if (low_noise_enabled() && measure_freq_iters(fd, iters / num_chunks, &freq) == -1)
+    goto cleanup;
+
+  for (int i = 0; i < num_chunks; i++) {
+    if (measure_freq_iters(fd, iters / num_chunks, &freq) == -1)
+      goto cleanup;
+    if (freq <= 0.0) {
+      printErr("Frequency measurement yielded an invalid value: %f", freq);
+      goto cleanup;
+    }
+
+    freqs[i] = freq;
+    acc += 1 / freq;
+    if (i == 0 || freq < t->min) t->min = freq;
+    if (i == 0 || freq > t->max) t->max = freq;
+  }
+
+  t->mean = num_chunks / acc;
+  if (low_noise_enabled()) {
+    struct measure_summary summary;
+    measure_summarize(freqs, num_chunks, get_freq_confidence(), &summary);
+    t->mean = summary.hmean;
+    t->ci = summary.hci;
+    t->num_kept = summary.num_kept;
+    printWarn("CPU %d: %.0f +/- %.1f MHz (median=%.0f MAD=%.1f, kept %d of %d chunks)", t->cpu, summary.hmean, summary.hci,
+              summary.median, summary.mad, summary.num_kept, num_chunks);
+  }
+  ret = 0;
+
+cleanup:
+  free(freqs);
+  return ret;
+}
+
+// Runs in its own thread, pinned to t->cpu. The first run (a very rough
+// estimation of the frequency) computes a reasonable number of iterations,
+// so that the actual measurement takes about the same time in every core.
+// All the threads start it at the same time
+static void* max_freq_thread(void* arg) {
+  struct max_freq_thread* t = (struct max_freq_thread*) arg;
+  double estimation_freq;
+  uint64_t iters = 100000;
+  int fd = open_cycles_counter(t->cpu);
+
+  t->ok = fd != -1 && measure_freq_iters(fd, iters, &estimation_freq) != -1;
+  if (t->ok && estimation_freq <= 0.0) {
+    printErr("First frequency measurement yielded an invalid value: %f", estimation_freq);
+    t->ok = false;
+  }
+  if (t->ok) {
+    iters = get_num_iters_from_freq(estimation_freq);
+    printWarn("Running frequency measurement with %ld iterations on core %d...", iters, t->cpu);
+  }
+
+  __atomic_add_fetch(&t->sync->arrived, 1, __ATOMIC_RELEASE);
+  while (!__atomic_load_n(&t->sync->go, __ATOMIC_ACQUIRE))
+    sched_yield();
+  // Only after the wait, which would not let the main thread run
+  measure_set_priority(pthread_self(), 0);
+
+  if (t->ok)
+    t->ok = measure_freq_chunks(fd, iters, t) != -1;
+  if (fd != -1)
+    close(fd);
+  return NULL;
+}
+
+// Adds the frequency of all the CPUs that were measured (their harmonic
+// mean) to the --low-noise table
+static void add_max_freq_trials(int num_threads) {
+  double* freqs = emalloc(sizeof(double) * num_threads);
+  double* cis = emalloc(sizeof(double) * num_threads);
+  int kept = get_low_noise_trials();
+  int n = 0;
+
+  for (int i = 0; i < num_threads; i++) {
+    if (!max_freqs[i].ok) continue;
+    freqs[n] = max_freqs[i].mean;
+    cis[n] = max_freqs[i].ci;
+    if (max_freqs[i].num_kept < kept) kept = max_freqs[i].num_kept;
+    n++;
+  }
+
+  if (n > 0) {
+    double ci;
+    double freq = measure_harmonic_mean(freqs, cis, n, &ci);
+    freq_trials_add(MAX_FREQ_KERNEL, n, freq, ci, kept, get_low_noise_trials());
+  }
+  free(freqs);
+  free(cis);
+}
+
+// Measures all the CPUs at the same time, each one in its own thread
+// and with its own cycles counter
+static bool measure_max_frequency_all(int num_cpus) {
+  pthread_t* threads = emalloc(sizeof(pthread_t) * num_cpus);
+  struct max_freq_sync sync = { 0, false };
+  pthread_attr_t attr;
+  cpu_set_t cpus;
+  int ret;
+  int num_threads = 0;
+
+  max_freqs = ecalloc(num_cpus, sizeof(struct max_freq_thread));
+  max_freqs_num_cpus = num_cpus;
+
+  if ((ret = pthread_attr_init(&attr)) != 0) {
+    printErr("pthread_attr_init: %s", strerror(ret));
+    free(threads);
+    return false;
+  }
+
+  for (int i = 0; i < num_cpus; i++) {
+    max_freqs[i].cpu = i;
+    max_freqs[i].sync = &sync;
+
+    CPU_ZERO(&cpus);
+    CPU_SET(i, &cpus);
+    if ((ret = pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpus)) != 0 ||
+        (ret = pthread_create(&threads[i], &attr, max_freq_thread, &max_freqs[i])) != 0) {
+      // The rest of the CPUs are left unmeasured
+      printErr("Error creating thread for CPU %d: %s", i, strerror(ret));
+      break;
+    }
+    num_threads++;
+  }
+
+  while (__atomic_load_n(&sync.arrived, __ATOMIC_ACQUIRE) < num_threads)
+    sched_yield();
+
+  // The banner is only shown if some CPU is going to be measured
+  const char* frequency_banner = "cpufetch is measuring the max frequency...";
+  bool measuring = false;
+  for (int i = 0; i < num_threads; i++)
+    measuring = measuring || max_freqs[i].ok;
+  if (measuring) {
+    printf("%s", frequency_banner);
+    fflush(stdout);
+  }
+  __atomic_store_n(&sync.go, true, __ATOMIC_RELEASE);
+
+  for (int i = 0; i < num_threads; i++) {
+    if (pthread_join(threads[i], NULL) != 0)
+      printErr("Error joining thread");
+  }
+
+  // Clean screen once measurement is finished
+  if (measuring)
+    printf("\r%*c\r", (int) strlen(frequency_banner), ' ');
+
+  if (low_noise_enabled())
+    add_max_freq_trials(num_threads);
+
+  pthread_attr_destroy(&attr);
+  free(threads);
+  return true;
+}
+
 // Differences between x86 measure_frequency and this measure_max_frequency:
 // - measure_frequency employs all cores simultaneously whereas
-//   measure_max_frequency only employs 1.
+//   measure_max_frequency employs one thread per CPU, each one
+//   counting the cycles of its own CPU only.
 // - measure_frequency runs the computation and checks /proc/cpuinfo whereas
 //   measure_max_frequency does not rely on /proc/cpuinfo and simply
 //   counts cpu cycles to measure frequency.
 // - measure_frequency uses actual computation while measuring the frequency
 //   whereas measure_max_frequency uses nop instructions. This makes the former
 //   x86 dependant whereas the latter is architecture independant.
-int64_t measure_max_frequency(uint32_t core) {
-  if (!bind_to_cpu(core)) {
-    printErr("Failed binding the process to CPU %d", core);
+//
+// All the CPUs are measured at once in the first call, so the next
+// clusters just use the results of that one. As every CPU is loaded,
+// the result is the all-core max frequency (the single-core turbo
+// frequency may be higher)
+int64_t measure_max_frequency(int num_cpus, const bool* cluster) {
+  if (max_freqs == NULL && !measure_max_frequency_all(num_cpus))
     return UNKNOWN_DATA;
-  }
 
-  // First, get very rough estimation of clock cycle to
-  // compute a reasonable value for the iterations
-  double estimation_freq, frequency;
-  uint64_t iters = 100000;
-  if (measure_freq_iters(iters, core, &estimation_freq) == -1)
+  double frequency = 0.0;
+  for (int i = 0; i < num_cpus && i < max_freqs_num_cpus; i++) {
+    if (cluster[i] && max_freqs[i].ok && max_freqs[i].mean > frequency)
+      frequency = max_freqs[i].mean;
+  }
+  if (frequency <= 0.0)
     return UNKNOWN_DATA;
 
-  if (estimation_freq <= 0.0) {
-    printErr("First frequency measurement yielded an invalid value: %f", estimation_freq);
-    return UNKNOWN_DATA;
+  for (int i = 0; i < num_cpus && i < max_freqs_num_cpus; i++) {
+    if (cluster[i] && max_freqs[i].ok && max_freqs[i].mean < frequency * (100 - MAX_FREQ_SLOW_PCT) / 100)
+      printWarn("CPU %d reached %.0f MHz, more than %d%% below the max of its cluster (%.0f MHz)", i, max_freqs[i].mean, MAX_FREQ_SLOW_PCT, frequency);
   }
-  iters = get_num_iters_from_freq(estimation_freq);
-  printWarn("Running frequency measurement with %ld iterations on core %d...", iters, core);
 
-  // Now perform actual measurement
-  const char* frequency_banner = "cpufetch is measuring the max frequency...";
-  printf("%s", frequency_banner);
-  fflush(stdout);
-
-  if (measure_freq_iters(iters, core, &frequency) == -1)
-    return UNKNOWN_DATA;
-  
-  // Clean screen once measurement is finished
-  printf("\r%*c\r", (int) strlen(frequency_banner), ' ');
-  
   // Discard last digit in the frequency, which should help providing
   // more reliable and predictable values.
   return (((int) frequency + 5)/10) * 10;
 }
 
+bool measure_max_frequency_cpus(int num_cpus, double* freqs) {
+  if (max_freqs == NULL && !measure_max_frequency_all(num_cpus))
+    return false;
+
+  bool measured = false;
+  for (int i = 0; i < num_cpus; i++) {
+    freqs[i] = (i < max_freqs_num_cpus && max_freqs[i].ok) ? max_freqs[i].mean : 0.0;
+    measured = measured || freqs[i] > 0.0;
+  }
+  return measured;
+}
+
+// Adds every CPU measured by measure_max_frequency to the frequency map
+// (measuring them now if it was not called). core_types labels each of
+// them (it may be NULL if not hybrid)
+void measure_max_frequency_map(int num_cpus, const char** core_types) {
+  if (max_freqs == NULL && !measure_max_frequency_all(num_cpus))
+    return;
+
+  for (int i = 0; i < num_cpus && i < max_freqs_num_cpus; i++) {
+    if (max_freqs[i].ok && !freq_map_has(MAX_FREQ_KERNEL, i))
+      freq_map_add(MAX_FREQ_KERNEL, core_types == NULL ? NULL : core_types[i], i, max_freqs[i].min, max_freqs[i].mean, max_freqs[i].max);
+  }
+}
+
 #endif // #ifdef __linux__
@@ -1,6 +1,16 @@
 #ifndef __COMMON_FREQ__
 #define __COMMON_FREQ__
 
-int64_t measure_max_frequency(uint32_t core);
+#include <stdint.h>
+#include <stdbool.h>
+
+// Max frequency of the CPUs in cluster (cluster[i] is true if CPU i
+// belongs to it). All the CPUs are measured at once in the first call,
+// so this is the all-core max frequency, not the single-core one
+int64_t measure_max_frequency(int num_cpus, const bool* cluster);
+// Mean frequency measured in each CPU (0 if it could not be measured).
+// Returns false if no CPU could be measured
+bool measure_max_frequency_cpus(int num_cpus, double* freqs);
+void measure_max_frequency_map(int num_cpus, const char** core_types);
 
 #endif
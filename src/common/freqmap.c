@@ -0,0 +1,485 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "freqmap.h"
+#include "global.h"
+#include "udev.h"
+#include "args.h"
+
+#define FREQ_MAP_MAX_KERNELS   8
+#define FREQ_MAP_COLUMNS       4
+// CPUs whose mean is this much below the median of their group
+// (same kernel, socket and core type) are flagged in the table
+#define FREQ_MAP_SLOW_PCT      5
+
+struct freq_map_entry {
+  int kernel;
+  const char* core_type;
+  int socket;
+  int cpu;
+  double min;
+  double mean;
+  double max;
+};
+
+struct freq_curve_point {
+  int kernel;
+  int cores;
+  double freq;
+};
+
+struct freq_isa_entry {
+  const char* kernel;
+  const char* isa_class;
+  bool heavy;
+  int cores;
+  double single_core;
+  double all_core;
+  // Achieved with all cores, 0 if unknown
+  double flops_per_cycle;
+};
+
+struct freq_trials_entry {
+  const char* kernel;
+  int cores;
+  double freq;
+  double ci;
+  int kept;
+  int trials;
+};
+
+// Kernels are shared by the map and the curve
+static struct {
+  const char* kernels[FREQ_MAP_MAX_KERNELS];
+  int num_kernels;
+  struct freq_map_entry* entries;
+  int num_entries;
+  int max_entries;
+  struct freq_curve_point* points;
+  int num_points;
+  int max_points;
+  struct freq_isa_entry* isa;
+  int num_isa;
+  int max_isa;
+  struct freq_trials_entry* trials;
+  int num_trials;
+  int max_trials;
+} map;
+
+// physical_package_id may not be available (e.g, in containers)
+static int get_socket(int cpu) {
+  char path[_PATH_PACKAGE_MAX_LEN];
+  sprintf(path, "%s%s/cpu%d%s", _PATH_SYS_SYSTEM, _PATH_SYS_CPU, cpu, _PATH_TOPO_PACKAGE_ID_SYS);
+  if(access(path, F_OK) != 0) return 0;
+
+  long socket = get_long_from_file(path);
+  return socket < 0 ? 0 : socket;
+}
+
+static int get_kernel_idx(const char* kernel) {
+  for(int i=0; i < map.num_kernels; i++) {
+    if(strcmp(map.kernels[i], kernel) == 0) return i;
+  }
+  return -1;
+}
+
+static int add_kernel(const char* kernel) {
+  int k = get_kernel_idx(kernel);
+  if(k == -1) {
+    if(map.num_kernels == FREQ_MAP_MAX_KERNELS) {
+      printBug("add_kernel: Too many kernels (max is %d)", FREQ_MAP_MAX_KERNELS);
+      return -1;
+    }
+    k = map.num_kernels++;
+    map.kernels[k] = kernel;
+  }
+  return k;
+}
+
+void freq_map_add(const char* kernel, const char* core_type, int cpu, double min, double mean, double max) {
+  int k = add_kernel(kernel);
+  if(k == -1) return;
+
+  if(map.num_entries == map.max_entries) {
+    map.max_entries = map.max_entries == 0 ? 64 : map.max_entries * 2;
+    map.entries = erealloc(map.entries, sizeof(struct freq_map_entry) * map.max_entries);
+  }
+
+  struct freq_map_entry* e = &map.entries[map.num_entries++];
+  e->kernel = k;
+  e->core_type = core_type;
+  e->socket = get_socket(cpu);
+  e->cpu = cpu;
+  e->min = min;
+  e->mean = mean;
+  e->max = max;
+}
+
+bool freq_map_has(const char* kernel, int cpu) {
+  int k = get_kernel_idx(kernel);
+  for(int i=0; k != -1 && i < map.num_entries; i++) {
+    if(map.entries[i].kernel == k && map.entries[i].cpu == cpu) return true;
+  }
+  return false;
+}
+
+static int cmp_core_types(const char* a, const char* b) {
+  if(a == NULL || b == NULL) return (a != NULL) - (b != NULL);
+  return strcmp(a, b);
+}
+
+// Kernels are kept in the order in which they were run
+static int cmp_entries(const void* a, const void* b) {
+  const struct freq_map_entry* ea = a;
+  const struct freq_map_entry* eb = b;
+
+  if(ea->kernel != eb->kernel) return ea->kernel - eb->kernel;
+  if(ea->socket != eb->socket) return ea->socket - eb->socket;
+  int cmp = cmp_core_types(ea->core_type, eb->core_type);
+  if(cmp != 0) return cmp;
+  return ea->cpu - eb->cpu;
+}
+
+static int cmp_doubles(const void* a, const void* b) {
+  double da = *(const double*) a;
+  double db = *(const double*) b;
+  return (da > db) - (da < db);
+}
+
+// Returns the index past the last entry in the group of entries[first]
+static int group_end(int first) {
+  struct freq_map_entry* e = &map.entries[first];
+  int end = first + 1;
+
+  while(end < map.num_entries && map.entries[end].kernel == e->kernel && map.entries[end].socket == e->socket &&
+        cmp_core_types(map.entries[end].core_type, e->core_type) == 0) {
+    end++;
+  }
+  return end;
+}
+
+static double group_median(int first, int end) {
+  int n = end - first;
+  double* means = emalloc(sizeof(double) * n);
+  for(int i=0; i < n; i++) means[i] = map.entries[first + i].mean;
+  qsort(means, n, sizeof(double), cmp_doubles);
+
+  double median = n % 2 == 1 ? means[n/2] : (means[n/2 - 1] + means[n/2]) / 2;
+  free(means);
+  return median;
+}
+
+void print_freq_map(void) {
+  if(map.num_entries == 0) {
+    printWarn("No per-CPU frequency was measured, the frequency map is empty");
+    return;
+  }
+
+  qsort(map.entries, map.num_entries, sizeof(struct freq_map_entry), cmp_entries);
+  bool slow_found = false;
+
+  printf("\nFrequency map (MHz, cpu: mean min-max):\n");
+  for(int first=0; first < map.num_entries; ) {
+    struct freq_map_entry* e = &map.entries[first];
+    int end = group_end(first);
+    double median = group_median(first, end);
+
+    printf("%s, socket %d%s%s (%d CPUs, median %.0f):\n", map.kernels[e->kernel], e->socket,
+           e->core_type == NULL ? "" : ", ", e->core_type == NULL ? "" : e->core_type, end - first, median);
+    for(int i=first; i < end; i++) {
+      e = &map.entries[i];
+      bool slow = e->mean < median * (100 - FREQ_MAP_SLOW_PCT) / 100;
+      slow_found |= slow;
+
+      printf("  %4d: %4.0f %4.0f-%-4.0f%c", e->cpu, e->mean, e->min, e->max, slow ? '*' : ' ');
+      if((i - first) % FREQ_MAP_COLUMNS == FREQ_MAP_COLUMNS - 1 || i == end - 1) printf("\n");
+    }
+    first = end;
+  }
+
+  if(slow_found) printf("* More than %d%% below the median of its group\n", FREQ_MAP_SLOW_PCT);
+}
+
+// Writes the map as JSON, with the CPUs grouped by kernel,
+// socket and core type (null if the CPU is not hybrid)
+bool write_freq_map(const char* path) {
+  FILE* fp = fopen(path, "w");
+  if(fp == NULL) {
+    printErr("Unable to write frequency map to '%s': %s", path, strerror(errno));
+    return false;
+  }
+
+  qsort(map.entries, map.num_entries, sizeof(struct freq_map_entry), cmp_entries);
+
+  fprintf(fp, "{\"kernels\":[");
+  for(int i=0; i < map.num_entries; ) {
+    int k = map.entries[i].kernel;
+    fprintf(fp, "%s\n{\"kernel\":\"%s\",\"groups\":[", i == 0 ? "" : ",", map.kernels[k]);
+
+    for(int first=i; i < map.num_entries && map.entries[i].kernel == k; ) {
+      struct freq_map_entry* e = &map.entries[i];
+      int end = group_end(i);
+
+      fprintf(fp, "%s\n {\"socket\":%d,\"core_type\":", i == first ? "" : ",", e->socket);
+      if(e->core_type == NULL) fprintf(fp, "null");
+      else fprintf(fp, "\"%s\"", e->core_type);
+      fprintf(fp, ",\"cpus\":[");
+
+      for(int j=i; j < end; j++) {
+        e = &map.entries[j];
+        fprintf(fp, "%s\n  {\"cpu\":%d,\"min\":%.1f,\"mean\":%.1f,\"max\":%.1f}", j == i ? "" : ",", e->cpu, e->min, e->mean, e->max);
+      }
+      fprintf(fp, "]}");
+      i = end;
+    }
+    fprintf(fp, "]}");
+  }
+  fprintf(fp, "\n]}\n");
+
+  if(fclose(fp) != 0) {
+    printErr("Unable to write frequency map to '%s': %s", path, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+void freq_curve_add(const char* kernel, int cores, double freq) {
+  int k = add_kernel(kernel);
+  if(k == -1) return;
+
+  if(map.num_points == map.max_points) {
+    map.max_points = map.max_points == 0 ? 16 : map.max_points * 2;
+    map.points = erealloc(map.points, sizeof(struct freq_curve_point) * map.max_points);
+  }
+
+  struct freq_curve_point* p = &map.points[map.num_points++];
+  p->kernel = k;
+  p->cores = cores;
+  p->freq = freq;
+}
+
+// The map may have kernels that are not in the curve
+static bool curve_has_kernel(int kernel) {
+  for(int i=0; i < map.num_points; i++) {
+    if(map.points[i].kernel == kernel) return true;
+  }
+  return false;
+}
+
+// Frequency of the kernel with the fewest cores, which the
+// rest of the curve is relative to (0 if it has no points)
+static double curve_base_freq(int kernel) {
+  int cores = -1;
+  double freq = 0;
+  for(int i=0; i < map.num_points; i++) {
+    if(map.points[i].kernel == kernel && (cores == -1 || map.points[i].cores < cores)) {
+      cores = map.points[i].cores;
+      freq = map.points[i].freq;
+    }
+  }
+  return freq;
+}
+
+static int cmp_points(const void* a, const void* b) {
+  const struct freq_curve_point* pa = a;
+  const struct freq_curve_point* pb = b;
+
+  if(pa->cores != pb->cores) return pa->cores - pb->cores;
+  return pa->kernel - pb->kernel;
+}
+
+void print_freq_curve(void) {
+  if(map.num_points == 0) {
+    printWarn("No turbo curve was measured");
+    return;
+  }
+
+  qsort(map.points, map.num_points, sizeof(struct freq_curve_point), cmp_points);
+
+  printf("\nTurbo curve (MHz and ratio to the frequency with 1 active core):\n");
+  printf("%7s", "Cores");
+  for(int k=0; k < map.num_kernels; k++) {
+    if(curve_has_kernel(k)) printf(" %14s", map.kernels[k]);
+  }
+  printf("\n");
+
+  for(int i=0; i < map.num_points; ) {
+    int cores = map.points[i].cores;
+    printf("%7d", cores);
+    for(int k=0; k < map.num_kernels; k++) {
+      if(i < map.num_points && map.points[i].cores == cores && map.points[i].kernel == k) {
+        double base = curve_base_freq(k);
+        printf("    %5.0f (%.2f)", map.points[i].freq, base > 0 ? map.points[i].freq / base : 0.0);
+        i++;
+      }
+      else if(curve_has_kernel(k)) {
+        printf(" %14s", "-");
+      }
+    }
+    printf("\n");
+  }
+}
+
+// Writes the curve as JSON, with the points of each kernel in
+// increasing number of active cores
+bool write_freq_curve(const char* path) {
+  FILE* fp = fopen(path, "w");
+  if(fp == NULL) {
+    printErr("Unable to write turbo curve to '%s': %s", path, strerror(errno));
+    return false;
+  }
+
+  qsort(map.points, map.num_points, sizeof(struct freq_curve_point), cmp_points);
+
+  bool first_kernel = true;
+  fprintf(fp, "{\"kernels\":[");
+  for(int k=0; k < map.num_kernels; k++) {
+    if(!curve_has_kernel(k)) continue;
+    double base = curve_base_freq(k);
+    bool first = true;
+
+    fprintf(fp, "%s\n{\"kernel\":\"%s\",\"points\":[", first_kernel ? "" : ",", map.kernels[k]);
+    first_kernel = false;
+    for(int i=0; i < map.num_points; i++) {
+      struct freq_curve_point* p = &map.points[i];
+      if(p->kernel != k) continue;
+      fprintf(fp, "%s\n  {\"cores\":%d,\"freq\":%.1f,\"ratio\":%.3f}", first ? "" : ",", p->cores, p->freq, base > 0 ? p->freq / base : 0.0);
+      first = false;
+    }
+    fprintf(fp, "]}");
+  }
+  fprintf(fp, "\n]}\n");
+
+  if(fclose(fp) != 0) {
+    printErr("Unable to write turbo curve to '%s': %s", path, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+void freq_isa_add(const char* kernel, const char* isa_class, bool heavy, int cores, double single_core, double all_core, double flops_per_cycle) {
+  if(map.num_isa == map.max_isa) {
+    map.max_isa = map.max_isa == 0 ? 8 : map.max_isa * 2;
+    map.isa = erealloc(map.isa, sizeof(struct freq_isa_entry) * map.max_isa);
+  }
+
+  struct freq_isa_entry* e = &map.isa[map.num_isa++];
+  e->kernel = kernel;
+  e->isa_class = isa_class;
+  e->heavy = heavy;
+  e->cores = cores;
+  e->single_core = single_core;
+  e->all_core = all_core;
+  e->flops_per_cycle = flops_per_cycle;
+}
+
+// The ratios are relative to the first (narrowest) kernel with the same load
+static void print_isa_freq_cell(double freq, double base) {
+  if(freq <= 0) printf(" %14s", "-");
+  else printf("    %5.0f (%.2f)", freq, base > 0 ? freq / base : 0.0);
+}
+
+void print_freq_isa(void) {
+  if(map.num_isa == 0) {
+    printWarn("No ISA frequency was measured");
+    return;
+  }
+
+  char all_cores[32];
+  snprintf(all_cores, sizeof(all_cores), "All cores (%d)", map.isa[0].cores);
+
+  printf("\nISA frequency (MHz and ratio to %s):\n", map.isa[0].kernel);
+  printf("%-12s %-7s %-6s %14s %14s %11s\n", "Kernel", "Class", "Load", "1 core", all_cores, "FLOPs/cycle");
+  for(int i=0; i < map.num_isa; i++) {
+    struct freq_isa_entry* e = &map.isa[i];
+    printf("%-12s %-7s %-6s", e->kernel, e->isa_class, e->heavy ? "heavy" : "light");
+    print_isa_freq_cell(e->single_core, map.isa[0].single_core);
+    print_isa_freq_cell(e->all_core, map.isa[0].all_core);
+    if(e->flops_per_cycle > 0) printf(" %11.2f\n", e->flops_per_cycle);
+    else printf(" %11s\n", "-");
+  }
+}
+
+// Writes the table as JSON, with null for the frequencies that could
+// not be measured
+bool write_freq_isa(const char* path) {
+  FILE* fp = fopen(path, "w");
+  if(fp == NULL) {
+    printErr("Unable to write ISA frequency table to '%s': %s", path, strerror(errno));
+    return false;
+  }
+
+  fprintf(fp, "{\"kernels\":[");
+  for(int i=0; i < map.num_isa; i++) {
+    struct freq_isa_entry* e = &map.isa[i];
+    fprintf(fp, "%s\n{\"kernel\":\"%s\",\"class\":\"%s\",\"heavy\":%s,\"cores\":%d", i == 0 ? "" : ",",
+            e->kernel, e->isa_class, e->heavy ? "true" : "false", e->cores);
+    if(e->single_core > 0) fprintf(fp, ",\"single_core\":%.1f", e->single_core);
+    else fprintf(fp, ",\"single_core\":null");
+    if(e->all_core > 0) fprintf(fp, ",\"all_core\":%.1f", e->all_core);
+    else fprintf(fp, ",\"all_core\":null");
+    if(e->flops_per_cycle > 0) fprintf(fp, ",\"flops_per_cycle\":%.2f}", e->flops_per_cycle);
+    else fprintf(fp, ",\"flops_per_cycle\":null}");
+  }
+  fprintf(fp, "\n]}\n");
+
+  if(fclose(fp) != 0) {
+    printErr("Unable to write ISA frequency table to '%s': %s", path, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+void freq_trials_add(const char* kernel, int cores, double freq, double ci, int kept, int trials) {
+  if(map.num_trials == map.max_trials) {
+    map.max_trials = map.max_trials == 0 ? 8 : map.max_trials * 2;
+    map.trials = erealloc(map.trials, sizeof(struct freq_trials_entry) * map.max_trials);
+  }
+
+  struct freq_trials_entry* e = &map.trials[map.num_trials++];
+  e->kernel = kernel;
+  e->cores = cores;
+  e->freq = freq;
+  e->ci = ci;
+  e->kept = kept;
+  e->trials = trials;
+}
+
+void print_freq_trials(void) {
+  if(map.num_trials == 0) {
+    printWarn("No frequency was measured in low-noise mode");
+    return;
+  }
+
+  printf("\nLow-noise measurements (MHz, %g%% confidence interval):\n", get_freq_confidence() * 100);
+  printf("%-12s %5s %8s %8s %12s\n", "Kernel", "Cores", "Freq", "+/-", "Trials kept");
+  for(int i=0; i < map.num_trials; i++) {
+    struct freq_trials_entry* e = &map.trials[i];
+    char kept[32];
+    snprintf(kept, sizeof(kept), "%d/%d", e->kept, e->trials);
+    printf("%-12s %5d %8.0f %8.1f %12s\n", e->kernel, e->cores, e->freq, e->ci, kept);
+  }
+}
+
+void free_freq_map(void) {
+  free(map.entries);
+  free(map.points);
+  free(map.isa);
+  free(map.trials);
+  map.entries = NULL;
+  map.points = NULL;
+  map.isa = NULL;
+  map.trials = NULL;
+  map.num_trials = 0;
+  map.max_trials = 0;
+  map.num_entries = 0;
+  map.max_entries = 0;
+  map.num_points = 0;
+  map.max_points = 0;
+  map.num_isa = 0;
+  map.max_isa = 0;
+  map.num_kernels = 0;
+}
@@ -0,0 +1,35 @@
+#ifndef __FREQMAP__
+#define __FREQMAP__
+
+#include <stdbool.h>
+
+// Frequency of each logical CPU under load (min, mean and max of the
+// samples, in MHz) for each of the kernels that were run. kernel and
+// core_type (NULL if the CPU is not hybrid) must outlive the map
+void freq_map_add(const char* kernel, const char* core_type, int cpu, double min, double mean, double max);
+bool freq_map_has(const char* kernel, int cpu);
+void print_freq_map(void);
+bool write_freq_map(const char* path);
+
+// Sustained frequency (MHz) of a kernel with cores active cores
+void freq_curve_add(const char* kernel, int cores, double freq);
+void print_freq_curve(void);
+bool write_freq_curve(const char* path);
+
+// Sustained frequency (MHz) of a kernel with one and with cores active
+// cores (0 if it could not be measured), in the order they were run.
+// flops_per_cycle is the one achieved by each core with all of them
+// active (0 if unknown)
+void freq_isa_add(const char* kernel, const char* isa_class, bool heavy, int cores, double single_core, double all_core, double flops_per_cycle);
+void print_freq_isa(void);
+bool write_freq_isa(const char* path);
+
+// Result of one --low-noise measurement: the frequency (MHz) of a kernel
+// with cores active cores and the half width of its confidence interval.
+// kept is the fewest trials (of the trials run) kept by any of the cores
+void freq_trials_add(const char* kernel, int cores, double freq, double ci, int kept, int trials);
+void print_freq_trials(void);
+
+void free_freq_map(void);
+
+#endif
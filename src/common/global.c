@@ -14,6 +14,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
+#include <stdint.h>
 
 #include "global.h"
 
@@ -71,6 +73,53 @@ enum {
 };
 
 int LOG_LEVEL;
+bool TRACE_ENABLED = false;
+
+static const char* TRACE_PHASE_STR[] = {
+  [TRACE_PHASE_VENDOR]    = "vendor",
+  [TRACE_PHASE_FEATURES]  = "features",
+  [TRACE_PHASE_UARCH]     = "uarch",
+  [TRACE_PHASE_FREQUENCY] = "frequency",
+  [TRACE_PHASE_CACHE]     = "cache",
+  [TRACE_PHASE_TOPOLOGY]  = "topology",
+  [TRACE_PHASE_SOC]       = "soc",
+  [TRACE_PHASE_PEAK]      = "peak"
+};
+
+static const char* TRACE_COUNTER_STR[] = {
+  [TRACE_FILES_OPENED]  = "files",
+  [TRACE_BYTES_READ]    = "bytes",
+  [TRACE_CPUID]         = "cpuid",
+  [TRACE_BIND]          = "bind",
+  [TRACE_PERF_SYSCALLS] = "perf"
+};
+
+struct trace_event {
+  int phase;
+  double start;
+  double dur;
+  long counters[TRACE_COUNTER_COUNT];
+};
+
+static struct {
+  const char* json_path;
+  double origin;
+  // Phases can nest (e.g, the peak performance may measure the frequency),
+  // counters are accounted to the innermost one. The extra row keeps the
+  // ones that happen outside of any phase
+  int stack[TRACE_PHASE_COUNT];
+  int depth;
+  int current;
+  double start[TRACE_PHASE_COUNT];
+  long start_totals[TRACE_PHASE_COUNT][TRACE_COUNTER_COUNT];
+  double time[TRACE_PHASE_COUNT];
+  int calls[TRACE_PHASE_COUNT];
+  long counters[TRACE_PHASE_COUNT+1][TRACE_COUNTER_COUNT];
+  long totals[TRACE_COUNTER_COUNT];
+  struct trace_event* events;
+  int num_events;
+  int max_events;
+} trace;
 
 void printBugMessage(FILE *restrict stream) {
   #if defined(ARCH_X86) || defined(ARCH_PPC)
@@ -210,8 +259,98 @@ void* erealloc(void *ptr, size_t size) {
   return newptr;
 }
 
+// Per-run arena where the cpuInfo graph and the strings built to print it
+// are allocated. Memory is carved from chunks that are never reallocated,
+// and is only released at once by free_arena, so pointers returned by
+// amalloc must never be passed to free or erealloc. It is not thread safe
+#define ARENA_CHUNK_SIZE (64 * 1024)
+#define ARENA_ALIGN      16
+
+struct arena_chunk {
+  struct arena_chunk* next;
+  size_t size;
+  size_t used;
+};
+
+static struct arena_chunk* arena = NULL;
+
+// Header is padded so that the data that follows it is aligned
+#define ARENA_HEADER_SIZE ((sizeof(struct arena_chunk) + ARENA_ALIGN - 1) & ~((size_t) ARENA_ALIGN - 1))
+
+void* amalloc(size_t size) {
+  size = (size + ARENA_ALIGN - 1) & ~((size_t) ARENA_ALIGN - 1);
+
+  if(arena == NULL || arena->used + size > arena->size) {
+    // Big allocations get their own chunk
+    size_t chunk_size = size > ARENA_CHUNK_SIZE ? size : ARENA_CHUNK_SIZE;
+    struct arena_chunk* chunk = emalloc(ARENA_HEADER_SIZE + chunk_size);
+    chunk->size = chunk_size;
+    chunk->used = 0;
+
+    // Keep using the current chunk if it still has more room than the new one
+    if(arena != NULL && chunk->size - size < arena->size - arena->used) {
+      chunk->next = arena->next;
+      arena->next = chunk;
+      chunk->used = size;
+      return (char *) chunk + ARENA_HEADER_SIZE;
+    }
+    chunk->next = arena;
+    arena = chunk;
+  }
+
+  void* ptr = (char *) arena + ARENA_HEADER_SIZE + arena->used;
+  arena->used += size;
+  return ptr;
+}
+
+void* acalloc(size_t nmemb, size_t size) {
+  if(size != 0 && nmemb > SIZE_MAX / size) {
+    printErr("acalloc: Allocation size overflows");
+    exit(1);
+  }
+
+  void* ptr = amalloc(nmemb * size);
+  memset(ptr, 0, nmemb * size);
+  return ptr;
+}
+
+void free_arena(void) {
+  while(arena != NULL) {
+    struct arena_chunk* next = arena->next;
+    free(arena);
+    arena = next;
+  }
+}
+
+struct arena_mark get_arena_mark(void) {
+  struct arena_mark mark;
+  mark.chunk = arena;
+  mark.next = arena == NULL ? NULL : arena->next;
+  mark.used = arena == NULL ? 0 : arena->used;
+  return mark;
+}
+
+// Chunks allocated after the mark are either in front of mark.chunk or,
+// if they were inserted while it was still the current one, right after it
+void release_arena(struct arena_mark mark) {
+  while(arena != mark.chunk) {
+    struct arena_chunk* next = arena->next;
+    free(arena);
+    arena = next;
+  }
+  if(arena == NULL) return;
+
+  while(arena->next != mark.next) {
+    struct arena_chunk* next = arena->next->next;
+    free(arena->next);
+    arena->next = next;
+  }
+  arena->used = mark.used;
+}
+
 #ifndef __APPLE__
 bool bind_to_cpu(int cpu_id) {
+  TRACE_COUNT(TRACE_BIND, 1);
   #ifdef _WIN32
     HANDLE process = GetCurrentProcess();
     DWORD_PTR processAffinityMask = 1 << cpu_id;
@@ -238,6 +377,140 @@ bool bind_to_cpu(int cpu_id) {
 }
 #endif
 
+// Monotonic time in microseconds
+double get_time_us(void) {
+#ifdef _WIN32
+  LARGE_INTEGER freq;
+  LARGE_INTEGER now;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&now);
+  return (double) now.QuadPart * 1e6 / (double) freq.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+#endif
+}
+
+// Counters may be updated from the threads that
+// collect the cpuid of all cores in parallel
+void trace_add(int counter, long n) {
+  int phase = __atomic_load_n(&trace.current, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&trace.counters[phase][counter], n, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&trace.totals[counter], n, __ATOMIC_RELAXED);
+}
+
+void trace_phase_begin(int phase) {
+  if(trace.depth == TRACE_PHASE_COUNT) {
+    printBug("trace_phase_begin: Too many nested phases");
+    return;
+  }
+
+  trace.stack[trace.depth++] = phase;
+  __atomic_store_n(&trace.current, phase, __ATOMIC_RELAXED);
+  for(int i=0; i < TRACE_COUNTER_COUNT; i++)
+    trace.start_totals[phase][i] = __atomic_load_n(&trace.totals[i], __ATOMIC_RELAXED);
+  trace.start[phase] = get_time_us();
+}
+
+void trace_phase_end(int phase) {
+  double end = get_time_us();
+
+  if(trace.depth == 0 || trace.stack[trace.depth-1] != phase) {
+    printBug("trace_phase_end: Phase '%s' is not running", TRACE_PHASE_STR[phase]);
+    return;
+  }
+  trace.depth--;
+  __atomic_store_n(&trace.current, trace.depth == 0 ? TRACE_PHASE_COUNT : trace.stack[trace.depth-1], __ATOMIC_RELAXED);
+
+  trace.time[phase] += end - trace.start[phase];
+  trace.calls[phase]++;
+
+  if(trace.json_path == NULL) return;
+  if(trace.num_events == trace.max_events) {
+    trace.max_events = trace.max_events == 0 ? 32 : trace.max_events * 2;
+    trace.events = erealloc(trace.events, sizeof(struct trace_event) * trace.max_events);
+  }
+
+  struct trace_event* ev = &trace.events[trace.num_events++];
+  ev->phase = phase;
+  ev->start = trace.start[phase] - trace.origin;
+  ev->dur = end - trace.start[phase];
+  for(int i=0; i < TRACE_COUNTER_COUNT; i++)
+    ev->counters[i] = __atomic_load_n(&trace.totals[i], __ATOMIC_RELAXED) - trace.start_totals[phase][i];
+}
+
+// Writes the events in the Chrome trace event format,
+// which can be loaded in chrome://tracing or Perfetto
+bool write_trace_json(const char* path) {
+  FILE* fp = fopen(path, "w");
+  if(fp == NULL) {
+    printErr("Unable to write trace to '%s': %s", path, strerror(errno));
+    return false;
+  }
+
+  fprintf(fp, "{\"traceEvents\":[");
+  for(int i=0; i < trace.num_events; i++) {
+    struct trace_event* ev = &trace.events[i];
+    fprintf(fp, "%s\n{\"name\":\"%s\",\"cat\":\"cpufetch\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{",
+            i == 0 ? "" : ",", TRACE_PHASE_STR[ev->phase], ev->start, ev->dur);
+    for(int j=0; j < TRACE_COUNTER_COUNT; j++)
+      fprintf(fp, "%s\"%s\":%ld", j == 0 ? "" : ",", TRACE_COUNTER_STR[j], ev->counters[j]);
+    fprintf(fp, "}}");
+  }
+  fprintf(fp, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+  if(fclose(fp) != 0) {
+    printErr("Unable to write trace to '%s': %s", path, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+void print_trace_counters(long* counters) {
+  fprintf(stderr, " %8ld %10ld %8ld %6ld %6ld\n", counters[TRACE_FILES_OPENED], counters[TRACE_BYTES_READ],
+          counters[TRACE_CPUID], counters[TRACE_BIND], counters[TRACE_PERF_SYSCALLS]);
+}
+
+// Called at exit, so that the trace is also
+// printed when cpufetch fails
+void print_trace(void) {
+  double total = get_time_us() - trace.origin;
+
+  fprintf(stderr, "\n%-10s %6s %10s %8s %10s %8s %6s %6s\n", "Phase", "Calls", "Time (ms)", "Files", "Bytes", "CPUID", "Bind", "Perf");
+  for(int i=0; i < TRACE_PHASE_COUNT; i++) {
+    if(trace.calls[i] == 0) continue;
+    fprintf(stderr, "%-10s %6d %10.3f", TRACE_PHASE_STR[i], trace.calls[i], trace.time[i] / 1e3);
+    print_trace_counters(trace.counters[i]);
+  }
+  fprintf(stderr, "%-10s %6s %10s", "other", "-", "-");
+  print_trace_counters(trace.counters[TRACE_PHASE_COUNT]);
+  fprintf(stderr, "%-10s %6s %10.3f", "total", "-", total / 1e3);
+  print_trace_counters(trace.totals);
+
+  if(trace.json_path != NULL && write_trace_json(trace.json_path))
+    fprintf(stderr, "Trace written to '%s'\n", trace.json_path);
+
+  free(trace.events);
+}
+
+void init_trace(const char* json_path) {
+  memset(&trace, 0, sizeof(trace));
+  trace.json_path = json_path;
+  trace.current = TRACE_PHASE_COUNT;
+  trace.origin = get_time_us();
+  TRACE_ENABLED = true;
+  atexit(print_trace);
+}
+
+const char* get_version_str(void) {
+#ifdef GIT_FULL_VERSION
+  return GIT_FULL_VERSION;
+#else
+  return VERSION;
+#endif
+}
+
 void print_version(FILE *restrict stream) {
 #ifdef GIT_FULL_VERSION
   fprintf(stream, "cpufetch %s (%s %s)\n", GIT_FULL_VERSION, OS_STR, ARCH_STR);
@@ -19,9 +19,57 @@ char *strremove(char *str, const char *sub);
 void* emalloc(size_t size);
 void* ecalloc(size_t nmemb, size_t size);
 void* erealloc(void *ptr, size_t size);
+void* amalloc(size_t size);
+void* acalloc(size_t nmemb, size_t size);
+void free_arena(void);
+// Position of the arena, so that what was allocated after it
+// (e.g, a temporary structure) can be released with release_arena
+struct arena_mark {
+  struct arena_chunk* chunk;
+  struct arena_chunk* next;
+  size_t used;
+};
+struct arena_mark get_arena_mark(void);
+void release_arena(struct arena_mark mark);
 #ifndef __APPLE__
 bool bind_to_cpu(int cpu_id);
 #endif
+const char* get_version_str(void);
+double get_time_us(void);
+
+// Tracing of cpufetch's own detection (--trace). The hooks are
+// macros so that they only cost a branch when tracing is disabled
+enum {
+  TRACE_PHASE_VENDOR,
+  TRACE_PHASE_FEATURES,
+  TRACE_PHASE_UARCH,
+  TRACE_PHASE_FREQUENCY,
+  TRACE_PHASE_CACHE,
+  TRACE_PHASE_TOPOLOGY,
+  TRACE_PHASE_SOC,
+  TRACE_PHASE_PEAK,
+  TRACE_PHASE_COUNT
+};
+
+enum {
+  TRACE_FILES_OPENED,
+  TRACE_BYTES_READ,
+  TRACE_CPUID,
+  TRACE_BIND,
+  TRACE_PERF_SYSCALLS,
+  TRACE_COUNTER_COUNT
+};
+
+extern bool TRACE_ENABLED;
+
+#define TRACE_BEGIN(phase)    do { if(TRACE_ENABLED) trace_phase_begin(phase); } while(0)
+#define TRACE_END(phase)      do { if(TRACE_ENABLED) trace_phase_end(phase); } while(0)
+#define TRACE_COUNT(counter, n) do { if(TRACE_ENABLED) trace_add(counter, n); } while(0)
+
+void init_trace(const char* json_path);
+void trace_phase_begin(int phase);
+void trace_phase_end(int phase);
+void trace_add(int counter, long n);
 void print_version(FILE *restrict stream);
 
 #endif
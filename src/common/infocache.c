@@ -0,0 +1,413 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "infocache.h"
+#include "args.h"
+#include "global.h"
+#include "udev.h"
+#include "../x86/cpuid.h"
+#include "../x86/apic.h"
+#include "../x86/uarch.h"
+
+#define INFOCACHE_MAGIC        0x43465043 // "CPFC"
+#define INFOCACHE_FORMAT       3
+#define INFOCACHE_DIR          "cpufetch"
+#define INFOCACHE_FILE         "cpuinfo.bin"
+#define INFOCACHE_PATH_MAX_LEN 4096
+
+#define _PATH_BOOT_ID          "/proc/sys/kernel/random/boot_id"
+#define _PATH_CPUS_ONLINE      _PATH_SYS_SYSTEM _PATH_SYS_CPU "/online"
+#define _PATH_MICROCODE        _PATH_SYS_SYSTEM _PATH_SYS_CPU "/cpu0/microcode/version"
+#define CPUINFO_MICROCODE_STR  "microcode\t: "
+
+// Options that change the detected values (measured frequencies, uarch)
+#define INFOCACHE_OPT_ACCURATE_PP       (1 << 0)
+#define INFOCACHE_OPT_MEASURE_MAX_FREQ  (1 << 1)
+#define INFOCACHE_OPT_UARCH_DB          (1 << 2)
+
+struct infocache_buf {
+  char* data;
+  int len;
+  int cap;
+  int pos;
+  bool error;
+};
+
+struct infocache_key {
+  char* boot_id;
+  char* microcode;
+  char* online;
+  const char* version;
+  uint32_t options;
+  // --convergence tolerance and confidence, which
+  // the measured frequencies depend on
+  char convergence[32];
+};
+
+// Growable buffer for serialization
+void buf_put(struct infocache_buf* b, const void* src, int size) {
+  if(b->len + size > b->cap) {
+    b->cap = max(b->cap * 2, b->len + size);
+    b->data = erealloc(b->data, b->cap);
+  }
+  memcpy(b->data + b->len, src, size);
+  b->len += size;
+}
+
+void buf_get(struct infocache_buf* b, void* dst, int size) {
+  if(b->error || b->pos + size > b->len) {
+    b->error = true;
+    memset(dst, 0, size);
+    return;
+  }
+  memcpy(dst, b->data + b->pos, size);
+  b->pos += size;
+}
+
+void buf_put_u32(struct infocache_buf* b, uint32_t v) { buf_put(b, &v, sizeof(v)); }
+void buf_put_i32(struct infocache_buf* b, int32_t v)  { buf_put(b, &v, sizeof(v)); }
+void buf_put_i64(struct infocache_buf* b, int64_t v)  { buf_put(b, &v, sizeof(v)); }
+void buf_put_bool(struct infocache_buf* b, bool v)    { uint8_t x = v; buf_put(b, &x, sizeof(x)); }
+
+uint32_t buf_get_u32(struct infocache_buf* b) { uint32_t v; buf_get(b, &v, sizeof(v)); return v; }
+int32_t buf_get_i32(struct infocache_buf* b)  { int32_t v;  buf_get(b, &v, sizeof(v)); return v; }
+int64_t buf_get_i64(struct infocache_buf* b)  { int64_t v;  buf_get(b, &v, sizeof(v)); return v; }
+bool buf_get_bool(struct infocache_buf* b)    { uint8_t x;  buf_get(b, &x, sizeof(x)); return x != 0; }
+
+// Strings are stored as length + bytes; a length of -1 means NULL
+void buf_put_str(struct infocache_buf* b, const char* str) {
+  if(str == NULL) {
+    buf_put_i32(b, -1);
+    return;
+  }
+  int32_t len = strlen(str);
+  buf_put_i32(b, len);
+  buf_put(b, str, len);
+}
+
+char* buf_get_str(struct infocache_buf* b) {
+  int32_t len = buf_get_i32(b);
+  if(b->error || len == -1) return NULL;
+  if(len < 0 || b->pos + len > b->len) {
+    b->error = true;
+    return NULL;
+  }
+
+  char* str = amalloc(sizeof(char) * (len + 1));
+  buf_get(b, str, len);
+  str[len] = '\0';
+  return str;
+}
+
+// Returns the first line of the file (without the newline)
+char* read_key_file(char* path) {
+  int filelen;
+  char* buf;
+  if((buf = read_file(path, &filelen)) == NULL) {
+    return NULL;
+  }
+
+  char* nl = strchr(buf, '\n');
+  if(nl != NULL) *nl = '\0';
+  return buf;
+}
+
+char* get_microcode_revision(void) {
+  char* microcode = read_key_file(_PATH_MICROCODE);
+  if(microcode != NULL) return microcode;
+
+  // Older kernels only expose it in /proc/cpuinfo
+  return get_field_from_cpuinfo(CPUINFO_MICROCODE_STR);
+}
+
+bool get_infocache_key(struct infocache_key* key) {
+  key->boot_id = read_key_file(_PATH_BOOT_ID);
+  key->microcode = get_microcode_revision();
+  key->online = read_key_file(_PATH_CPUS_ONLINE);
+  key->version = get_version_str();
+  key->options = 0;
+  if(accurate_pp()) key->options |= INFOCACHE_OPT_ACCURATE_PP;
+  if(measure_max_frequency_flag()) key->options |= INFOCACHE_OPT_MEASURE_MAX_FREQ;
+  if(get_uarch_db_file() != NULL) key->options |= INFOCACHE_OPT_UARCH_DB;
+  snprintf(key->convergence, sizeof(key->convergence), "%g,%g", get_freq_tolerance() * 100, get_freq_confidence() * 100);
+
+  if(key->boot_id == NULL || key->online == NULL) {
+    printWarn("Unable to build the detection cache key");
+    return false;
+  }
+  // Some hypervisors hide the microcode revision
+  if(key->microcode == NULL) {
+    key->microcode = emalloc(sizeof(char) * (strlen(STRING_UNKNOWN) + 1));
+    strcpy(key->microcode, STRING_UNKNOWN);
+  }
+  return true;
+}
+
+void free_infocache_key(struct infocache_key* key) {
+  free(key->boot_id);
+  free(key->microcode);
+  free(key->online);
+}
+
+// $XDG_CACHE_HOME/cpufetch if set; otherwise a directory under /run,
+// which is cleared on reboot anyway
+bool get_infocache_path(char* path, bool create) {
+  char* base = getenv("XDG_CACHE_HOME");
+  char run_dir[INFOCACHE_PATH_MAX_LEN];
+
+  if(base == NULL || base[0] == '\0') {
+    base = getenv("XDG_RUNTIME_DIR");
+    if(base == NULL || base[0] == '\0') {
+      if(geteuid() == 0) {
+        base = "/run";
+      }
+      else {
+        snprintf(run_dir, INFOCACHE_PATH_MAX_LEN, "/run/user/%u", (unsigned) geteuid());
+        base = run_dir;
+      }
+    }
+  }
+
+  if(snprintf(path, INFOCACHE_PATH_MAX_LEN, "%s/%s", base, INFOCACHE_DIR) >= INFOCACHE_PATH_MAX_LEN) {
+    printWarn("Cache path is too long");
+    return false;
+  }
+  if(create && mkdir(path, 0755) == -1 && errno != EEXIST) {
+    printWarn("mkdir: %s: %s", path, strerror(errno));
+    return false;
+  }
+  strcat(path, "/" INFOCACHE_FILE);
+  return true;
+}
+
+void put_infocache_header(struct infocache_buf* b, struct infocache_key* key) {
+  buf_put_u32(b, INFOCACHE_MAGIC);
+  buf_put_u32(b, INFOCACHE_FORMAT);
+  // Guards against layout changes between builds of the same version
+  buf_put_u32(b, sizeof(struct features));
+  buf_put_str(b, key->version);
+  buf_put_str(b, key->boot_id);
+  buf_put_str(b, key->microcode);
+  buf_put_str(b, key->online);
+  buf_put_u32(b, key->options);
+  buf_put_str(b, key->convergence);
+}
+
+bool str_matches(struct infocache_buf* b, const char* expected) {
+  char* str = buf_get_str(b);
+  return str != NULL && strcmp(str, expected) == 0;
+}
+
+bool check_infocache_header(struct infocache_buf* b, struct infocache_key* key) {
+  if(buf_get_u32(b) != INFOCACHE_MAGIC) return false;
+  if(buf_get_u32(b) != INFOCACHE_FORMAT) return false;
+  if(buf_get_u32(b) != sizeof(struct features)) return false;
+  if(!str_matches(b, key->version)) return false;
+  if(!str_matches(b, key->boot_id)) return false;
+  if(!str_matches(b, key->microcode)) return false;
+  if(!str_matches(b, key->online)) return false;
+  if(buf_get_u32(b) != key->options) return false;
+  if(!str_matches(b, key->convergence)) return false;
+  return !b->error;
+}
+
+void put_cpu_module(struct infocache_buf* b, struct cpuInfo* cpu) {
+  buf_put_i32(b, cpu->cpu_vendor);
+  buf_put_u32(b, get_uarch_id(cpu->arch));
+  buf_put_str(b, get_str_uarch(cpu));
+  buf_put_i32(b, get_uarch_process(cpu->arch));
+  buf_put_i32(b, get_uarch_vpus(cpu->arch));
+  buf_put_bool(b, cpu->hv->present);
+  buf_put_i32(b, cpu->hv->present ? cpu->hv->hv_vendor : HV_VENDOR_INVALID);
+
+  buf_put_i32(b, cpu->freq->base);
+  buf_put_i32(b, cpu->freq->max);
+  buf_put_bool(b, cpu->freq->measured);
+  buf_put_i32(b, cpu->freq->max_pp);
+
+  buf_put(b, cpu->feat, sizeof(struct features));
+  buf_put_i64(b, cpu->peak_performance);
+  buf_put_u32(b, cpu->maxLevels);
+  buf_put_u32(b, cpu->maxExtendedLevels);
+  buf_put_bool(b, cpu->topology_extensions);
+  buf_put_bool(b, cpu->hybrid_flag);
+  buf_put_u32(b, cpu->core_type);
+  buf_put_u32(b, cpu->first_core_id);
+  buf_put_u32(b, cpu->module_id);
+
+  buf_put_bool(b, cpu->cach != NULL);
+  if(cpu->cach != NULL) {
+    buf_put_u32(b, cpu->cach->max_cache_level);
+    for(int i=0; i < 4; i++) {
+      buf_put_i32(b, cpu->cach->cach_arr[i]->size);
+      buf_put_u32(b, cpu->cach->cach_arr[i]->num_caches);
+      buf_put_bool(b, cpu->cach->cach_arr[i]->exists);
+    }
+  }
+
+  buf_put_bool(b, cpu->topo != NULL);
+  if(cpu->topo != NULL) {
+    buf_put_i32(b, cpu->topo->total_cores);
+    buf_put_i32(b, cpu->topo->physical_cores);
+    buf_put_i32(b, cpu->topo->logical_cores);
+    buf_put_u32(b, cpu->topo->sockets);
+    buf_put_u32(b, cpu->topo->smt_supported);
+    buf_put_u32(b, cpu->topo->smt_available);
+    buf_put_i32(b, cpu->topo->total_cores_module);
+  }
+}
+
+struct cpuInfo* get_cpu_module(struct infocache_buf* b) {
+  struct cpuInfo* cpu = acalloc(1, sizeof(struct cpuInfo));
+
+  cpu->cpu_vendor = buf_get_i32(b);
+  uint32_t uarch_id = buf_get_u32(b);
+  char* uarch_str = buf_get_str(b);
+  int32_t process = buf_get_i32(b);
+  int32_t vpus = buf_get_i32(b);
+  cpu->arch = new_uarch_struct(uarch_id, uarch_str != NULL ? uarch_str : STRING_UNKNOWN, process, vpus);
+
+  cpu->hv = amalloc(sizeof(struct hypervisor));
+  cpu->hv->present = buf_get_bool(b);
+  cpu->hv->hv_vendor = buf_get_i32(b);
+  cpu->hv->hv_name = get_hv_vendor_name(cpu->hv->hv_vendor);
+
+  cpu->freq = amalloc(sizeof(struct frequency));
+  cpu->freq->base = buf_get_i32(b);
+  cpu->freq->max = buf_get_i32(b);
+  cpu->freq->measured = buf_get_bool(b);
+  cpu->freq->max_pp = buf_get_i32(b);
+
+  cpu->feat = amalloc(sizeof(struct features));
+  buf_get(b, cpu->feat, sizeof(struct features));
+  cpu->peak_performance = buf_get_i64(b);
+  cpu->maxLevels = buf_get_u32(b);
+  cpu->maxExtendedLevels = buf_get_u32(b);
+  cpu->topology_extensions = buf_get_bool(b);
+  cpu->hybrid_flag = buf_get_bool(b);
+  cpu->core_type = buf_get_u32(b);
+  cpu->first_core_id = buf_get_u32(b);
+  cpu->module_id = buf_get_u32(b);
+
+  if(buf_get_bool(b)) {
+    cpu->cach = amalloc(sizeof(struct cache));
+    init_cache_struct(cpu->cach);
+    cpu->cach->max_cache_level = buf_get_u32(b);
+    for(int i=0; i < 4; i++) {
+      cpu->cach->cach_arr[i]->size = buf_get_i32(b);
+      cpu->cach->cach_arr[i]->num_caches = buf_get_u32(b);
+      cpu->cach->cach_arr[i]->exists = buf_get_bool(b);
+    }
+  }
+
+  if(buf_get_bool(b)) {
+    cpu->topo = amalloc(sizeof(struct topology));
+    init_topology_struct(cpu->topo, cpu->cach);
+    cpu->topo->total_cores = buf_get_i32(b);
+    cpu->topo->physical_cores = buf_get_i32(b);
+    cpu->topo->logical_cores = buf_get_i32(b);
+    cpu->topo->sockets = buf_get_u32(b);
+    cpu->topo->smt_supported = buf_get_u32(b);
+    cpu->topo->smt_available = buf_get_u32(b);
+    cpu->topo->total_cores_module = buf_get_i32(b);
+  }
+
+  return cpu;
+}
+
+struct cpuInfo* load_cpu_info_from_cache(void) {
+  char path[INFOCACHE_PATH_MAX_LEN];
+  struct infocache_key key;
+  struct infocache_buf b;
+  struct cpuInfo* cpu = NULL;
+
+  if(!get_infocache_path(path, false)) return NULL;
+  if(!get_infocache_key(&key)) {
+    free_infocache_key(&key);
+    return NULL;
+  }
+
+  memset(&b, 0, sizeof(struct infocache_buf));
+  if((b.data = read_file(path, &b.len)) == NULL) {
+    free_infocache_key(&key);
+    return NULL;
+  }
+
+  if(!check_infocache_header(&b, &key)) {
+    printWarn("Detection cache '%s' is stale, ignoring it", path);
+  }
+  else {
+    cpu = get_cpu_module(&b);
+    cpu->cpu_name = buf_get_str(&b);
+    cpu->num_cpus = buf_get_u32(&b);
+
+    struct cpuInfo* ptr = cpu;
+    for(int i=1; i < cpu->num_cpus && !b.error; i++) {
+      ptr->next_cpu = get_cpu_module(&b);
+      ptr = ptr->next_cpu;
+    }
+
+    if(b.error || cpu->num_cpus < 1 || cpu->topo == NULL) {
+      printWarn("Detection cache '%s' is corrupted, ignoring it", path);
+      cpu = NULL;
+    }
+  }
+
+  free(b.data);
+  free_infocache_key(&key);
+  return cpu;
+}
+
+bool save_cpu_info_to_cache(struct cpuInfo* cpu) {
+  char path[INFOCACHE_PATH_MAX_LEN];
+  char tmp_path[INFOCACHE_PATH_MAX_LEN + 8];
+  struct infocache_key key;
+  struct infocache_buf b;
+
+  // Do not cache incomplete results
+  if(cpu->topo == NULL || !all_fields_enabled()) return false;
+  if(!get_infocache_path(path, true)) return false;
+  if(!get_infocache_key(&key)) {
+    free_infocache_key(&key);
+    return false;
+  }
+
+  memset(&b, 0, sizeof(struct infocache_buf));
+  put_infocache_header(&b, &key);
+  put_cpu_module(&b, cpu);
+  buf_put_str(&b, cpu->cpu_name);
+  buf_put_u32(&b, cpu->num_cpus);
+
+  struct cpuInfo* ptr = cpu->next_cpu;
+  for(int i=1; i < cpu->num_cpus; i++, ptr = ptr->next_cpu) {
+    put_cpu_module(&b, ptr);
+  }
+  free_infocache_key(&key);
+
+  // Write to a temporary file and rename it so that concurrent
+  // runs never see a partially written cache
+  snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", path);
+  int fd = mkstemp(tmp_path);
+  if(fd == -1) {
+    printWarn("mkstemp: %s: %s", tmp_path, strerror(errno));
+    free(b.data);
+    return false;
+  }
+
+  bool ret = write(fd, b.data, b.len) == b.len;
+  if(close(fd) == -1) ret = false;
+  if(ret) ret = rename(tmp_path, path) == 0;
+  if(!ret) {
+    printWarn("Unable to write detection cache '%s': %s", path, strerror(errno));
+    unlink(tmp_path);
+  }
+
+  free(b.data);
+  return ret;
+}
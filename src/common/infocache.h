@@ -0,0 +1,11 @@
+#ifndef __INFOCACHE__
+#define __INFOCACHE__
+
+#include "cpu.h"
+
+// On-disk cache of the detected cpuInfo chain. Entries are only valid
+// for the same boot, microcode revision, online CPUs and cpufetch version
+struct cpuInfo* load_cpu_info_from_cache(void);
+bool save_cpu_info_to_cache(struct cpuInfo* cpu);
+
+#endif
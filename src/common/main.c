@@ -5,6 +5,16 @@
 #include "args.h"
 #include "printer.h"
 #include "global.h"
+#if defined(ARCH_X86) && defined(__linux__)
+  #include "infocache.h"
+#endif
+#ifdef __linux__
+  #include "udev.h"
+#endif
+#if (defined(ARCH_X86) || defined(ARCH_ARM)) && defined(__linux__)
+  #include "freqmap.h"
+  #include "soak.h"
+#endif
 
 void print_help(char *argv[]) {
   const char **t = args_str;
@@ -17,6 +27,7 @@ void print_help(char *argv[]) {
   printf("OPTIONS: \n");
   printf("  -%c, --%s %*s Set the color scheme (by default, cpufetch uses the system color scheme)\n", c[ARG_COLOR], t[ARG_COLOR], (int) (max_len-strlen(t[ARG_COLOR])), "");
   printf("  -%c, --%s %*s Set the style of CPU logo\n", c[ARG_STYLE], t[ARG_STYLE], (int) (max_len-strlen(t[ARG_STYLE])), "");
+  printf("  -%c, --%s %*s Only fetch and show the specified comma separated list of fields\n", c[ARG_FIELDS], t[ARG_FIELDS], (int) (max_len-strlen(t[ARG_FIELDS])), "");
 #ifdef ARCH_X86
   printf("  -%c, --%s %*s Print CPU model and cpuid levels (debug purposes)\n", c[ARG_DEBUG], t[ARG_DEBUG], (int) (max_len-strlen(t[ARG_DEBUG])), "");
 #elif ARCH_PPC
@@ -27,10 +38,24 @@ void print_help(char *argv[]) {
   printf("      --%s %*s Show the short version of the logo\n", t[ARG_LOGO_SHORT], (int) (max_len-strlen(t[ARG_LOGO_SHORT])), "");
   printf("      --%s %*s Show the long version of the logo\n", t[ARG_LOGO_LONG], (int) (max_len-strlen(t[ARG_LOGO_LONG])), "");
   printf("  -%c, --%s %*s Print extra information (if available) about how cpufetch tried fetching information\n", c[ARG_VERBOSE], t[ARG_VERBOSE], (int) (max_len-strlen(t[ARG_VERBOSE])), "");
+  printf("      --%s %*s Print the time spent and I/O done in each detection phase. With --%s=FILE, also write a Chrome trace to FILE\n", t[ARG_TRACE], (int) (max_len-strlen(t[ARG_TRACE])), "", t[ARG_TRACE]);
+#ifndef ARCH_RISCV
+  printf("      --%s %*s Read extra microarchitecture entries from the specified file, which take priority over the built-in ones\n", t[ARG_UARCH_DB], (int) (max_len-strlen(t[ARG_UARCH_DB])), "");
+#endif
 #ifdef ARCH_X86
 #ifdef __linux__
   printf("      --%s %*s Compute the peak performance accurately (measure the CPU frequency instead of using the maximum)\n", t[ARG_ACCURATE_PP], (int) (max_len-strlen(t[ARG_ACCURATE_PP])), "");
-  printf("      --%s %*s Measure the max CPU frequency instead of reading it\n", t[ARG_MEASURE_MAX_FREQ], (int) (max_len-strlen(t[ARG_MEASURE_MAX_FREQ])), "");
+  printf("      --%s %*s With --%s, stop measuring once the frequency is within TOL%% with CONF%% confidence (TOL[,CONF], default 1,95)\n", t[ARG_CONVERGENCE], (int) (max_len-strlen(t[ARG_CONVERGENCE])), "", t[ARG_ACCURATE_PP]);
+  printf("      --%s %*s Measure the all-core max CPU frequency instead of reading it\n", t[ARG_MEASURE_MAX_FREQ], (int) (max_len-strlen(t[ARG_MEASURE_MAX_FREQ])), "");
+  printf("      --%s %*s Show the frequency measured in each CPU under the main output. With --%s=FILE, also write it as JSON to FILE\n", t[ARG_FREQ_MAP], (int) (max_len-strlen(t[ARG_FREQ_MAP])), "", t[ARG_FREQ_MAP]);
+  printf("      --%s %*s Measure the frequency with 1, 2, 4, ... all cores active and use the all-core one for the peak performance. With --%s=FILE, also write it as JSON to FILE\n", t[ARG_TURBO_CURVE], (int) (max_len-strlen(t[ARG_TURBO_CURVE])), "", t[ARG_TURBO_CURVE]);
+  printf("      --%s %*s Measure the frequency of each instruction class (scalar, SSE, AVX, AVX512, AMX; with and without FMA) with one and all cores active, and use it for the peak performance. With --%s=FILE, also write it as JSON to FILE\n", t[ARG_ISA_FREQ], (int) (max_len-strlen(t[ARG_ISA_FREQ])), "", t[ARG_ISA_FREQ]);
+  printf("      --%s %*s Keep all cores busy for SECONDS (default 120) and show the frequency, power and temperature each second, and the steady state. Use --%s=SECONDS,FILE to also write it as JSON to FILE\n", t[ARG_SOAK], (int) (max_len-strlen(t[ARG_SOAK])), "", t[ARG_SOAK]);
+  printf("      --%s %*s Show the TSC, crystal and bus frequencies, whether the TSC is invariant, and the clock source of the kernel\n", t[ARG_TIMEKEEPING], (int) (max_len-strlen(t[ARG_TIMEKEEPING])), "");
+  printf("      --%s %*s Measure with less noise: real-time priority (if allowed), a longer warm-up, and TRIALS (default 5) repetitions of each measurement, rejecting the outliers (use --%s=TRIALS). The result and confidence interval of each measurement are printed at the end\n", t[ARG_LOW_NOISE], (int) (max_len-strlen(t[ARG_LOW_NOISE])), "", t[ARG_LOW_NOISE]);
+  printf("      --%s %*s Cache the detected information and reuse it in the next runs, until the next reboot or CPU change\n", t[ARG_CACHE], (int) (max_len-strlen(t[ARG_CACHE])), "");
+  printf("      --%s %*s Ignore the cache, even if --%s is specified\n", t[ARG_NO_CACHE], (int) (max_len-strlen(t[ARG_NO_CACHE])), "", t[ARG_CACHE]);
+  printf("      --%s %*s Fetch the information again and update the cache\n", t[ARG_REFRESH_CACHE], (int) (max_len-strlen(t[ARG_REFRESH_CACHE])), "");
 #endif // __linux__
   printf("      --%s %*s Show the old Intel logo\n", t[ARG_LOGO_INTEL_OLD], (int) (max_len-strlen(t[ARG_LOGO_INTEL_OLD])), "");
   printf("      --%s %*s Show the new Intel logo\n", t[ARG_LOGO_INTEL_NEW], (int) (max_len-strlen(t[ARG_LOGO_INTEL_NEW])), "");
@@ -39,7 +64,9 @@ void print_help(char *argv[]) {
 #endif // ARCH_X86
 #ifdef ARCH_ARM
 #ifdef __linux__
-  printf("      --%s %*s Measure the max CPU frequency instead of reading it\n", t[ARG_MEASURE_MAX_FREQ], (int) (max_len-strlen(t[ARG_MEASURE_MAX_FREQ])), "");
+  printf("      --%s %*s Measure the all-core max CPU frequency instead of reading it\n", t[ARG_MEASURE_MAX_FREQ], (int) (max_len-strlen(t[ARG_MEASURE_MAX_FREQ])), "");
+  printf("      --%s %*s Show the frequency measured in each CPU under the main output. With --%s=FILE, also write it as JSON to FILE\n", t[ARG_FREQ_MAP], (int) (max_len-strlen(t[ARG_FREQ_MAP])), "", t[ARG_FREQ_MAP]);
+  printf("      --%s %*s Measure with less noise: real-time priority (if allowed), a longer warm-up, and TRIALS (default 5) repetitions of each measurement, rejecting the outliers (use --%s=TRIALS). The result and confidence interval of each measurement are printed at the end\n", t[ARG_LOW_NOISE], (int) (max_len-strlen(t[ARG_LOW_NOISE])), "", t[ARG_LOW_NOISE]);
 #endif
 #endif
   printf("  -%c, --%s %*s Print this help and exit\n", c[ARG_HELP], t[ARG_HELP], (int) (max_len-strlen(t[ARG_HELP])), "");
@@ -62,6 +89,34 @@ void print_help(char *argv[]) {
   printf("  * \"retro\":     Old cpufetch style\n");
   printf("  * \"legacy\":    Fallback style for terminals that do not support colors\n");
 
+  printf("\nFIELDS: \n");
+  printf("  * \"name\":       CPU name (SoC name in ARM and RISC-V, also accepted as \"soc\")\n");
+  printf("  * \"hypervisor\", \"uarch\", \"technology\", \"frequency\", \"sockets\", \"cores\"\n");
+  printf("  * \"features\":   Vector instructions (x86), Altivec (PowerPC), features (ARM) or extensions (RISC-V)\n");
+  printf("  * \"l1i\", \"l1d\", \"l2\", \"l3\":  Cache sizes\n");
+  printf("  * \"peak\":       Peak performance\n");
+  printf("    Information that is not needed by the specified fields is not fetched, so it is faster\n");
+  printf("    than fetching everything. In ARM, if \"name\" and \"technology\" are not requested, the SoC\n");
+  printf("    is not detected and the generic logo is shown\n");
+
+#ifndef ARCH_RISCV
+  printf("\nUARCH DATABASE: \n");
+  printf("    The file given to --%s has one entry per line. Fields are separated by blanks, names with\n", t[ARG_UARCH_DB]);
+  printf("    spaces must be quoted and '#' starts a comment. Any field of the signature can be NA to match all values:\n");
+#ifdef ARCH_X86
+  printf("      VENDOR EF F EM M S UARCH \"Name\" PROCESS [VPUS]\n");
+  printf("    VENDOR is intel, amd or hygon, UARCH is the uarch symbol without the UARCH_ prefix (e.g., ZEN4)\n");
+  printf("    and PROCESS is measured in nanometers (or NA)\n");
+#elif ARCH_ARM
+  printf("      IMPLEMENTER PART VARIANT REVISION UARCH \"Name\" VENDOR [VPUS]\n");
+  printf("    IMPLEMENTER may be a character literal (e.g., 'A'), UARCH is the uarch symbol without the UARCH_\n");
+  printf("    prefix (e.g., CORTEX_A76) and VENDOR the vendor symbol without the CPU_VENDOR_ prefix (e.g., ARM)\n");
+#elif ARCH_PPC
+  printf("      MASK VALUE UARCH\n");
+  printf("    The entry matches if (PVR & MASK) == VALUE. UARCH is the uarch symbol without the UARCH_ prefix (e.g., POWER9)\n");
+#endif
+#endif
+
   printf("\nLOGOS: \n");
   printf("    cpufetch will try to adapt the logo size and the text to the terminal width. When the output (logo and text) is wider than\n");
   printf("    the terminal width, cpufetch will print a smaller version of the logo (if it exists). This behavior can be overridden by\n");
@@ -85,12 +140,25 @@ void print_help(char *argv[]) {
   printf("    CPU running AVX code. By default, this value is not fetched by cpufetch, but you can use the\n");
   printf("    --accurate-pp option, which will measure the AVX frequency and show a more precise estimation\n");
   printf("    (this option is only available in x86 architectures).\n");
+  printf("    The measurement stops as soon as the frequency of every core converges (see --convergence),\n");
+  printf("    which usually takes less than a second, and never takes more than 5 seconds. With\n");
+  printf("    --low-noise this limit applies to each trial, so the whole measurement may take longer.\n");
   printf("    To precisely measure peak performance, see: https://github.com/Dr-Noob/peakperf\n");
   printf("\n");
   printf("    Both --accurate-pp and --measure-max-freq measure the actual frequency of the CPU. However,\n");
   printf("    they differ slightly. The former measures the max frequency while running vectorized SSE/AVX\n");
   printf("    instructions and it is thus x86 only, whereas the latter simply measures the max clock cycle\n");
-  printf("    and is architecture independent.\n");
+  printf("    and is architecture independent. --measure-max-freq loads all the CPUs at the same time, so\n");
+  printf("    it reports the all-core max frequency, which may be lower than the single-core (turbo) one.\n");
+}
+
+// Everything reachable from cpu lives in the arena, and
+// the files read while detecting it may still be open
+static void free_run_state(void) {
+#ifdef __linux__
+  close_cached_files();
+#endif
+  free_arena();
 }
 
 int main(int argc, char* argv[]) {
@@ -108,33 +176,79 @@ int main(int argc, char* argv[]) {
   }
 
   set_log_level(verbose_enabled());
-
-  struct cpuInfo* cpu = get_cpu_info();
-  if(cpu == NULL)
+  if(trace_enabled())
+    init_trace(get_trace_file());
+
+  struct cpuInfo* cpu = NULL;
+#if defined(ARCH_X86) && defined(__linux__)
+  // debug, raw and the frequency tables always need to query the hardware
+  bool cache = use_cache() && !show_debug() && !show_raw() && !freq_map_enabled() && !turbo_curve_enabled() && !isa_freq_enabled() && !soak_enabled() && !timekeeping_enabled() && !low_noise_enabled();
+  if(cache && !refresh_cache())
+    cpu = load_cpu_info_from_cache();
+  if(cpu == NULL) {
+    cpu = get_cpu_info();
+    if(cpu != NULL && cache)
+      save_cpu_info_to_cache(cpu);
+  }
+#else
+  cpu = get_cpu_info();
+#endif
+  if(cpu == NULL) {
+    free_run_state();
     return EXIT_FAILURE;
+  }
 
+  int ret = EXIT_SUCCESS;
   if(show_debug()) {
     print_version(stdout);
     print_debug(cpu);
-    return EXIT_SUCCESS;
   }
-
   // TODO: This should be moved to the end of args.c
-  if(show_raw()) {
+  else if(show_raw()) {
   #ifdef ARCH_X86
     print_version(stdout);
     print_raw(cpu);
-    return EXIT_SUCCESS;
   #else
     printErr("raw option is valid only in x86_64");
-    return EXIT_FAILURE;
+    ret = EXIT_FAILURE;
   #endif
   }
-
-  if(print_cpufetch(cpu, get_style(), get_colors(), show_full_cpu_name())) {
-    return EXIT_SUCCESS;
+  else if(!print_cpufetch(cpu, get_style(), get_colors(), show_full_cpu_name())) {
+    ret = EXIT_FAILURE;
   }
+#if (defined(ARCH_X86) || defined(ARCH_ARM)) && defined(__linux__)
   else {
-    return EXIT_FAILURE;
+    if(freq_map_enabled()) {
+      print_freq_map();
+      if(get_freq_map_file() != NULL && !write_freq_map(get_freq_map_file()))
+        ret = EXIT_FAILURE;
+    }
+    if(turbo_curve_enabled()) {
+      print_freq_curve();
+      if(get_turbo_curve_file() != NULL && !write_freq_curve(get_turbo_curve_file()))
+        ret = EXIT_FAILURE;
+    }
+    if(isa_freq_enabled()) {
+      print_freq_isa();
+      if(get_isa_freq_file() != NULL && !write_freq_isa(get_isa_freq_file()))
+        ret = EXIT_FAILURE;
+    }
+    if(soak_enabled()) {
+      print_soak();
+      if(get_soak_file() != NULL && !write_soak(get_soak_file()))
+        ret = EXIT_FAILURE;
+    }
+    if(low_noise_enabled())
+      print_freq_trials();
+    free_freq_map();
+    free_soak();
   }
+#endif
+#ifdef ARCH_X86
+  if(ret == EXIT_SUCCESS && timekeeping_enabled() && !show_debug() && !show_raw())
+    print_timekeeping(cpu);
+#endif
+
+  free_run_state();
+  return ret;
 }
@@ -0,0 +1,127 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sched.h>
+
+#include "measure.h"
+#include "global.h"
+#include "args.h"
+
+// 1 / Phi^-1(3/4), so that the MAD estimates the standard
+// deviation if the values are normally distributed
+#define MAD_TO_SIGMA 1.4826
+
+static bool priority_warned = false;
+
+// Inverse of the standard normal CDF, by bisection
+double normal_quantile(double p) {
+  double lo = -10.0;
+  double hi = 10.0;
+  for(int i=0; i < 64; i++) {
+    double mid = (lo + hi) / 2;
+    if(erfc(-mid / sqrt(2)) / 2 < p) lo = mid;
+    else hi = mid;
+  }
+  return (lo + hi) / 2;
+}
+
+// Quantile of the Student's t distribution with dof degrees of freedom,
+// from the normal one (Cornish-Fisher expansion, A&S 26.7.5). It is
+// accurate enough for the confidence levels and dof used here
+double student_t_quantile(double z, int dof) {
+  double z2 = z * z;
+  double v = dof;
+  double g1 = (z2 + 1) * z / 4;
+  double g2 = ((5*z2 + 16)*z2 + 3) * z / 96;
+  double g3 = (((3*z2 + 19)*z2 + 17)*z2 - 15) * z / 384;
+  double g4 = ((((79*z2 + 776)*z2 + 1482)*z2 - 1920)*z2 - 945) * z / 92160;
+  return z + g1/v + g2/(v*v) + g3/(v*v*v) + g4/(v*v*v*v);
+}
+
+static int compare_double(const void* a, const void* b) {
+  double x = *(const double*) a;
+  double y = *(const double*) b;
+  return (x > y) - (x < y);
+}
+
+// Median of v (which is sorted in place)
+static double median(double* v, int n) {
+  qsort(v, n, sizeof(double), compare_double);
+  return n % 2 == 1 ? v[n/2] : (v[n/2 - 1] + v[n/2]) / 2;
+}
+
+bool measure_summarize(const double* values, int num_trials, double confidence, struct measure_summary* s) {
+  if(num_trials <= 0) return false;
+
+  double* tmp = emalloc(sizeof(double) * num_trials);
+  memcpy(tmp, values, sizeof(double) * num_trials);
+  s->num_trials = num_trials;
+  s->median = median(tmp, num_trials);
+  for(int i=0; i < num_trials; i++) tmp[i] = fabs(values[i] - s->median);
+  s->mad = median(tmp, num_trials);
+  free(tmp);
+
+  // With a MAD of 0 (e.g, most trials are equal) only those are kept
+  double limit = MEASURE_MAD_THRESHOLD * MAD_TO_SIGMA * s->mad;
+  double acc = 0.0;
+  double acc2 = 0.0;
+  double acc_inv = 0.0;
+  double acc_inv2 = 0.0;
+  s->num_kept = 0;
+  for(int i=0; i < num_trials; i++) {
+    if(fabs(values[i] - s->median) > limit) continue;
+    if(s->num_kept == 0 || values[i] < s->min) s->min = values[i];
+    if(s->num_kept == 0 || values[i] > s->max) s->max = values[i];
+    acc += values[i];
+    acc2 += values[i] * values[i];
+    acc_inv += 1 / values[i];
+    acc_inv2 += 1 / (values[i] * values[i]);
+    s->num_kept++;
+  }
+
+  // The harmonic mean is the inverse of the mean of the inverses,
+  // so its interval is the one of the latter scaled by hmean^2
+  int n = s->num_kept;
+  s->mean = acc / n;
+  s->hmean = n / acc_inv;
+  s->ci = 0.0;
+  s->hci = 0.0;
+  if(n > 1) {
+    double var = (acc2 - acc * acc / n) / (n - 1);
+    double var_inv = (acc_inv2 - acc_inv * acc_inv / n) / (n - 1);
+    double t = student_t_quantile(normal_quantile((1 + confidence) / 2), n - 1);
+    s->ci = t * sqrt(var > 0 ? var / n : 0);
+    s->hci = t * sqrt(var_inv > 0 ? var_inv / n : 0) * s->hmean * s->hmean;
+  }
+  return true;
+}
+
+double measure_harmonic_mean(const double* v, const double* ci, int len, double* mean_ci) {
+  double acc = 0.0;
+  for(int i=0; i < len; i++) acc += 1 / v[i];
+  double mean = len / acc;
+
+  acc = 0.0;
+  for(int i=0; i < len; i++) {
+    double w = mean * mean / (len * v[i] * v[i]);
+    acc += (w * ci[i]) * (w * ci[i]);
+  }
+  *mean_ci = sqrt(acc);
+  return mean;
+}
+
+void measure_set_priority(pthread_t thread, int boost) {
+  if(!low_noise_enabled()) return;
+
+  struct sched_param param;
+  memset(&param, 0, sizeof(struct sched_param));
+  param.sched_priority = sched_get_priority_min(SCHED_FIFO) + boost;
+
+  int ret = pthread_setschedparam(thread, SCHED_FIFO, &param);
+  if(ret != 0 && !__atomic_exchange_n(&priority_warned, true, __ATOMIC_RELAXED)) {
+    printWarn("Unable to use SCHED_FIFO (%s), measuring with the default priority", strerror(ret));
+  }
+}
@@ -0,0 +1,45 @@
+#ifndef __MEASURE__
+#define __MEASURE__
+
+#include <stdbool.h>
+#include <pthread.h>
+
+// Measurement discipline shared by the timed kernels. With --low-noise,
+// the measuring threads run with SCHED_FIFO, a longer warm-up is
+// discarded, and each value is the result of repeated trials, of which
+// the ones more than MEASURE_MAD_THRESHOLD robust standard deviations
+// (1.4826 * MAD) away from the median are rejected
+#define MEASURE_MAD_THRESHOLD     3.0
+#define LOW_NOISE_WARMUP_MS       500
+// SCHED_FIFO is only used in windows up to this long, so that
+// long runs (e.g, --soak) do not starve the rest of the system
+#define LOW_NOISE_FIFO_MAX_SECONDS 10
+
+struct measure_summary {
+  int num_trials;
+  int num_kept;
+  double median;
+  double mad;
+  // Over the kept trials. ci is the half width of the
+  // confidence interval of the mean (0 with only one)
+  double mean;
+  double ci;
+  // Same for the harmonic mean, for rates measured
+  // over the same amount of work (e.g, frequencies)
+  double hmean;
+  double hci;
+  double min;
+  double max;
+};
+
+double normal_quantile(double p);
+double student_t_quantile(double z, int dof);
+bool measure_summarize(const double* values, int num_trials, double confidence, struct measure_summary* s);
+// Harmonic mean of the len values of v. mean_ci is set to the half width
+// of its confidence interval, from the ones of each value (ci)
+double measure_harmonic_mean(const double* v, const double* ci, int len, double* mean_ci);
+// Gives thread the SCHED_FIFO priority boost levels above the minimum,
+// only with --low-noise. Without privileges, it is left as it was
+void measure_set_priority(pthread_t thread, int boost);
+
+#endif
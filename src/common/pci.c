@@ -1,133 +1,101 @@
 #define _GNU_SOURCE
 
-#include <sys/stat.h>
 #include <dirent.h>
 
 #include "udev.h"
 #include "global.h"
 #include "pci.h"
 
-#ifndef PATH_MAX
-  #define PATH_MAX 1024
-#endif
-
 #define PCI_PATH "/sys/bus/pci/devices/"
-#define MAX_LENGTH_PCI_DIR_NAME 1024
+#define MAX_LENGTH_PCI_ID_PATH 300
 
-// Return a list of PCI devices containing only
-// the sysfs path
-struct pci_devices * get_pci_paths(void) {
-  DIR *dirp;
+// Reads a PCI id (e.g., "0x10de") from the file at path, relative to
+// the PCI devices directory. Returns -1 if it cannot be read
+static int32_t read_pci_id(int dir_fd, const char* path) {
+  char buf[16];
+  int fd;
 
-  if ((dirp = opendir(PCI_PATH)) == NULL) {
-    perror("opendir");
-    return NULL;
+  if((fd = openat(dir_fd, path, O_RDONLY)) == -1) {
+    return -1;
   }
+  TRACE_COUNT(TRACE_FILES_OPENED, 1);
 
-  struct dirent *dp;
-  int numDirs = 0;  
-  errno = 0;
+  ssize_t bytes_read = read(fd, buf, sizeof(buf) - 1);
+  close(fd);
+  if(bytes_read <= 0) {
+    return -1;
+  }
+  TRACE_COUNT(TRACE_BYTES_READ, bytes_read);
+  buf[bytes_read] = '\0';
 
-  while ((dp = readdir(dirp)) != NULL) {
-    if (strcmp(dp->d_name, ".") != 0 && strcmp(dp->d_name, "..") != 0)
-      numDirs++;
-  }  
-  if (errno != 0) {
-    perror("readdir");
-    return NULL;
+  char* end;
+  errno = 0;
+  long id = strtol(buf, &end, 16);
+  if(errno != 0 || end == buf || id < 0 || id > UINT16_MAX) {
+    return -1;
   }
+  return (int32_t) id;
+}
 
-  rewinddir(dirp);
+// Scans the PCI devices looking for any of the num_ids ids, which are
+// sorted by priority. Returns the index in ids of the best one found,
+// or -1 if none is present.
+// Only the vendor file is read for every device; the device file is
+// read only when the vendor appears in ids, and the scan stops as soon
+// as the first (best) id is found
+int find_pci_device(const struct pci_id* ids, int num_ids) {
+  DIR *dirp;
 
-  struct pci_devices * pci = emalloc(sizeof(struct pci_devices));
-  pci->num_devices = numDirs;
-  pci->devices = emalloc(sizeof(struct pci_device) * pci->num_devices);
-  char * full_path = emalloc(PATH_MAX * sizeof(char));
-  struct stat stbuf;
-  int i = 0;
+  if ((dirp = opendir(PCI_PATH)) == NULL) {
+    perror("opendir");
+    return -1;
+  }
 
-  while ((dp = readdir(dirp)) != NULL) {
-    if (strcmp(dp->d_name, ".") == 0 || strcmp(dp->d_name, "..") == 0)
-      continue;
+  int dir_fd = dirfd(dirp);
+  int best = -1;
+  char path[MAX_LENGTH_PCI_ID_PATH];
+  struct dirent *dp;
 
-    if (strlen(dp->d_name) > MAX_LENGTH_PCI_DIR_NAME) {
+  while (best != 0) {
+    errno = 0;
+    if ((dp = readdir(dirp)) == NULL)
+      break;
+    if (dp->d_name[0] == '.')
+      continue;
+    // Devices are usually symlinks to the real sysfs directory
+    if (dp->d_type != DT_DIR && dp->d_type != DT_LNK && dp->d_type != DT_UNKNOWN)
+      continue;
+    if (strlen(dp->d_name) + strlen("/vendor") >= MAX_LENGTH_PCI_ID_PATH) {
       printErr("Directory name is too long: %s", dp->d_name);
-      return NULL;
+      continue;
     }
 
-    memset(full_path, 0, PATH_MAX * sizeof(char));
-    snprintf(full_path, min(strlen(PCI_PATH) + strlen(dp->d_name) + 1, PATH_MAX), "%s%s", PCI_PATH, dp->d_name);    
+    sprintf(path, "%s/vendor", dp->d_name);
+    int32_t vendor_id = read_pci_id(dir_fd, path);
+    if (vendor_id == -1)
+      continue;
 
-    if (stat(full_path, &stbuf) == -1) {
-      perror("stat");
-      return NULL;
+    int32_t device_id = -1;
+    for (int i=0; i < num_ids && (best == -1 || i < best); i++) {
+      if (ids[i].vendor_id != vendor_id)
+        continue;
+
+      if (device_id == -1) {
+        sprintf(path, "%s/device", dp->d_name);
+        if ((device_id = read_pci_id(dir_fd, path)) == -1) {
+          printWarn("Could not read '%s%s'", PCI_PATH, path);
+          break;
+        }
+      }
+      if (ids[i].device_id == device_id) {
+        best = i;
+      }
     }
-
-    if ((stbuf.st_mode & S_IFMT) == S_IFDIR) {
-      int strLen = min(MAX_LENGTH_PCI_DIR_NAME, strlen(dp->d_name)) + 1;
-      pci->devices[i] = emalloc(sizeof(struct pci_device));
-      pci->devices[i]->path = ecalloc(strLen, sizeof(char));
-      strncpy(pci->devices[i]->path, dp->d_name, strLen);
-      i++;
-    }        
   }
-  if (errno != 0) {
+  if (best != 0 && errno != 0) {
     perror("readdir");
-    return NULL;
   }
 
-  return pci;
-}
-
-// For each PCI device in the list pci, fetch its vendor and 
-// device id using sysfs (e.g., /sys/bus/pci/devices/XXX/{vendor/device})
-void populate_pci_devices(struct pci_devices * pci) {
-  int filelen;
-  char* buf;
-
-  for (int i=0; i < pci->num_devices; i++) {
-    struct pci_device* dev = pci->devices[i];
-    int path_size = strlen(PCI_PATH) + strlen(dev->path) + 2;
-
-    // Read vendor_id
-    char *vendor_id_path = emalloc(sizeof(char) * (path_size + strlen("vendor") + 1));
-    sprintf(vendor_id_path, "%s/%s/%s", PCI_PATH, dev->path, "vendor");
-
-    if ((buf = read_file(vendor_id_path, &filelen)) == NULL) {
-      printWarn("read_file: %s: %s\n", vendor_id_path, strerror(errno));
-      dev->vendor_id = 0;
-    }
-    else {
-      dev->vendor_id = strtol(buf, NULL, 16);
-    }
-
-    // Read device_id
-    char *device_id_path = emalloc(sizeof(char) * (path_size + strlen("device") + 1));
-    sprintf(device_id_path, "%s/%s/%s", PCI_PATH, dev->path, "device");
-
-    if ((buf = read_file(device_id_path, &filelen)) == NULL) {
-      printWarn("read_file: %s: %s\n", device_id_path, strerror(errno));
-      dev->device_id = 0;
-    }
-    else {
-      dev->device_id = strtol(buf, NULL, 16);
-    }
-
-    free(vendor_id_path);
-    free(device_id_path);
-  }
-}
-
-// Return a list of PCI devices that could be used to infer the SoC.
-// The criteria to determine which devices are suitable for this task
-// is decided in filter_pci_devices.
-struct pci_devices * get_pci_devices(void) {
-  struct pci_devices * pci = get_pci_paths();
-
-  if (pci == NULL)
-    return NULL;
-
-  populate_pci_devices(pci);  
-
-  return pci;
+  closedir(dirp);
+  return best;
 }
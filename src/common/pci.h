@@ -7,17 +7,11 @@
 #define PCI_DEVICE_TEGRA_X1 0x0faf
 #define PCI_DEVICE_ALTRA    0xe100
 
-struct pci_device {
-  char * path;
+struct pci_id {
   uint16_t vendor_id;
   uint16_t device_id;
 };
 
-struct pci_devices {
-  struct pci_device ** devices;
-  int num_devices;
-};
-
-struct pci_devices * get_pci_devices(void);
+int find_pci_device(const struct pci_id* ids, int num_ids);
 
 #endif
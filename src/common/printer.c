@@ -206,7 +206,7 @@ void setAttribute(struct ascii* art, int type, char* value) {
 }
 
 char* rgb_to_ansi(struct color* c, bool background, bool bold) {
-  char* str = emalloc(sizeof(char) * 100);
+  char* str = amalloc(sizeof(char) * 100);
   if(background) {
     snprintf(str, 44, "\x1b[48;2;%.3d;%.3d;%.3dm", c->R, c->G, c->B);
   }
@@ -221,14 +221,14 @@ char* rgb_to_ansi(struct color* c, bool background, bool bold) {
 }
 
 struct ascii* set_ascii(VENDOR vendor, STYLE style) {
-  struct ascii* art = emalloc(sizeof(struct ascii));
+  struct ascii* art = amalloc(sizeof(struct ascii));
 
   art->n_attributes_set = 0;
   art->additional_spaces = 0;
   art->vendor = vendor;
-  art->attributes = emalloc(sizeof(struct attribute *) * MAX_ATTRIBUTES);
+  art->attributes = amalloc(sizeof(struct attribute *) * MAX_ATTRIBUTES);
   for(uint32_t i=0; i < MAX_ATTRIBUTES; i++) {
-    art->attributes[i] = emalloc(sizeof(struct attribute));
+    art->attributes[i] = amalloc(sizeof(struct attribute));
     art->attributes[i]->type = 0;
     art->attributes[i]->value = NULL;
   }
@@ -510,7 +510,7 @@ void print_ascii_generic(struct ascii* art, uint32_t la, int32_t termw, bool use
       attr_to_print++;
 
 #ifdef ARCH_X86
-      if(attr_type == ATTRIBUTE_L3) {
+      if(attr_type == ATTRIBUTE_L3 || attr_type == ATTRIBUTE_PEAK) {
         add_space = false;
       }
       if(attr_type == ATTRIBUTE_CPU_NUM) {
@@ -561,70 +561,94 @@ bool print_cpufetch_x86(struct cpuInfo* cpu, STYLE s, struct color** cs, struct
   char* l1i, *l1d, *l2, *l3, *n_cores, *n_cores_dual, *sockets;
   l1i = l1d = l2 = l3 = n_cores = n_cores_dual = sockets = NULL;
 
-  char* cpu_name = get_str_cpu_name(cpu, fcpuname);
-  char* uarch = get_str_uarch(cpu);
-  char* pp = get_str_peak_performance(cpu->peak_performance);
-  char* manufacturing_process = get_str_process(cpu);
+  char* pp = NULL;
+  char* manufacturing_process = NULL;
   bool hybrid_architecture = cpu->next_cpu != NULL;
 
-  if(cpu->cach != NULL) {
+  if(cpu->cach != NULL && field_enabled(FIELD_L3)) {
     l3 = get_str_l3(cpu->cach);
   }
 
-  setAttribute(art, ATTRIBUTE_NAME, cpu_name);
-  if(cpu->hv->present) {
+  if(field_enabled(FIELD_NAME)) {
+    setAttribute(art, ATTRIBUTE_NAME, get_str_cpu_name(cpu, fcpuname));
+  }
+  if(cpu->hv->present && field_enabled(FIELD_HYPERVISOR)) {
     setAttribute(art, ATTRIBUTE_HYPERVISOR, cpu->hv->hv_name);
   }
-  setAttribute(art, ATTRIBUTE_UARCH, uarch);
-  setAttribute(art, ATTRIBUTE_TECHNOLOGY, manufacturing_process);
+  if(field_enabled(FIELD_UARCH)) {
+    setAttribute(art, ATTRIBUTE_UARCH, get_str_uarch(cpu));
+  }
+  if(field_enabled(FIELD_TECHNOLOGY)) {
+    manufacturing_process = get_str_process(cpu);
+    setAttribute(art, ATTRIBUTE_TECHNOLOGY, manufacturing_process);
+  }
+
+  // Fields that are shown for each module in hybrid architectures
+  bool module_fields = field_enabled(FIELD_FREQUENCY) || field_enabled(FIELD_SOCKETS) ||
+                       field_enabled(FIELD_CORES) || field_enabled(FIELD_FEATURES) ||
+                       field_enabled(FIELD_L1I) || field_enabled(FIELD_L1D) || field_enabled(FIELD_L2);
 
   struct cpuInfo* ptr = cpu;
   for(int i = 0; i < cpu->num_cpus; ptr = ptr->next_cpu, i++) {
-    char* max_frequency = get_str_freq(ptr->freq);
-    char* avx = get_str_avx(ptr);
-    char* sse = get_str_sse(ptr);
-    char* fma = get_str_fma(ptr);
-    char* cpu_num = emalloc(sizeof(char) * 9);
+    char* max_frequency = NULL;
+    char* avx = NULL;
+    char* sse = NULL;
+    char* fma = NULL;
+    char* cpu_num = amalloc(sizeof(char) * 9);
+
+    if(probe_enabled(PROBE_FREQUENCY) && field_enabled(FIELD_FREQUENCY)) {
+      max_frequency = get_str_freq(ptr->freq);
+    }
+    if(field_enabled(FIELD_FEATURES)) {
+      avx = get_str_avx(ptr);
+      sse = get_str_sse(ptr);
+      fma = get_str_fma(ptr);
+    }
 
-    if(ptr->topo != NULL) {
-      sockets = get_str_sockets(ptr->topo);
-      n_cores = get_str_topology(ptr, ptr->topo, false);
-      n_cores_dual = get_str_topology(ptr, ptr->topo, true);
+    // The topology is also probed for the caches, which do not need these
+    if(ptr->topo != NULL && probe_enabled(PROBE_TOPOLOGY)) {
+      if(field_enabled(FIELD_SOCKETS)) sockets = get_str_sockets(ptr->topo);
+      if(field_enabled(FIELD_CORES)) {
+        n_cores = get_str_topology(ptr, ptr->topo, false);
+        n_cores_dual = get_str_topology(ptr, ptr->topo, true);
+      }
     }
 
     if(ptr->cach != NULL) {
-      l1i = get_str_l1i(ptr->cach);
-      l1d = get_str_l1d(ptr->cach);
-      l2 = get_str_l2(ptr->cach);
+      if(field_enabled(FIELD_L1I)) l1i = get_str_l1i(ptr->cach);
+      if(field_enabled(FIELD_L1D)) l1d = get_str_l1d(ptr->cach);
+      if(field_enabled(FIELD_L2)) l2 = get_str_l2(ptr->cach);
     }
 
-    if(hybrid_architecture) {
+    if(hybrid_architecture && module_fields) {
       if(ptr->core_type == CORE_TYPE_EFFICIENCY) sprintf(cpu_num, "E-cores:");
       else if(ptr->core_type == CORE_TYPE_PERFORMANCE) sprintf(cpu_num, "P-cores:");
       else printBug("Found invalid core type!\n");
 
       setAttribute(art, ATTRIBUTE_CPU_NUM, cpu_num);
     }
-    setAttribute(art, ATTRIBUTE_FREQUENCY, max_frequency);
+    if(max_frequency != NULL) setAttribute(art, ATTRIBUTE_FREQUENCY, max_frequency);
     if(ptr->topo != NULL) {
       socket_num = get_nsockets(ptr->topo);
       if (socket_num > 1) {
-        setAttribute(art, ATTRIBUTE_SOCKETS, sockets);
-        setAttribute(art, ATTRIBUTE_NCORES, n_cores);
-        setAttribute(art, ATTRIBUTE_NCORES_DUAL, n_cores_dual);
+        if(field_enabled(FIELD_SOCKETS)) setAttribute(art, ATTRIBUTE_SOCKETS, sockets);
+        if(field_enabled(FIELD_CORES)) {
+          setAttribute(art, ATTRIBUTE_NCORES, n_cores);
+          setAttribute(art, ATTRIBUTE_NCORES_DUAL, n_cores_dual);
+        }
       }
-      else {
+      else if(field_enabled(FIELD_CORES)) {
         setAttribute(art, ATTRIBUTE_NCORES, n_cores);
       }
     }
 
     // Show the most modern vector instructions.
-    if (strcmp(avx, "No") == 0) {
+    if (avx != NULL && strcmp(avx, "No") == 0) {
       if (strcmp(sse, "No") != 0) {
         setAttribute(art, ATTRIBUTE_SSE, sse);
       }
     }
-    else {
+    else if (avx != NULL) {
       setAttribute(art, ATTRIBUTE_AVX, avx);
       setAttribute(art, ATTRIBUTE_FMA, fma);
     }
@@ -634,7 +658,10 @@ bool print_cpufetch_x86(struct cpuInfo* cpu, STYLE s, struct color** cs, struct
     if(l2 != NULL) setAttribute(art, ATTRIBUTE_L2, l2);
   }
   if(l3 != NULL) setAttribute(art, ATTRIBUTE_L3, l3);
-  setAttribute(art, ATTRIBUTE_PEAK, pp);
+  if(field_enabled(FIELD_PEAK)) {
+    pp = get_str_peak_performance(cpu->peak_performance);
+    setAttribute(art, ATTRIBUTE_PEAK, pp);
+  }
 
   // Step 3. Print output
   bool use_short = false;
@@ -651,24 +678,7 @@ bool print_cpufetch_x86(struct cpuInfo* cpu, STYLE s, struct color** cs, struct
 
   print_ascii_generic(art, longest_attribute, term->w, use_short, hybrid_architecture);
 
-  free(manufacturing_process);
-  free(sockets);
-  free(n_cores);
-  free(n_cores_dual);
-  free(l1i);
-  free(l1d);
-  free(l2);
-  free(l3);
-  free(pp);
-
-  free(art->attributes);
-  free(art);
-
   if(cs != NULL) free_colors_struct(cs);
-  if(cpu->cach != NULL) free_cache_struct(cpu->cach);
-  if(cpu->topo != NULL) free_topo_struct(cpu->topo);
-  free_freq_struct(cpu->freq);
-  free_cpuinfo_struct(cpu);
 
   return true;
 }
@@ -697,32 +707,34 @@ bool print_cpufetch_ppc(struct cpuInfo* cpu, STYLE s, struct color** cs, struct
   char* pp = get_str_peak_performance(cpu->peak_performance);
 
   // Step 2. Set attributes
-  if(cpu_name != NULL) {
+  if(cpu_name != NULL && field_enabled(FIELD_NAME)) {
     setAttribute(art, ATTRIBUTE_PART_NUMBER, cpu_name);
   }
-  setAttribute(art, ATTRIBUTE_UARCH, uarch);
-  if(cpu->hv->present) {
+  if(field_enabled(FIELD_UARCH)) setAttribute(art, ATTRIBUTE_UARCH, uarch);
+  if(cpu->hv->present && field_enabled(FIELD_HYPERVISOR)) {
     setAttribute(art, ATTRIBUTE_HYPERVISOR, cpu->hv->hv_name);
   }
-  setAttribute(art, ATTRIBUTE_TECHNOLOGY, manufacturing_process);
-  setAttribute(art, ATTRIBUTE_FREQUENCY, max_frequency);
+  if(field_enabled(FIELD_TECHNOLOGY)) setAttribute(art, ATTRIBUTE_TECHNOLOGY, manufacturing_process);
+  if(field_enabled(FIELD_FREQUENCY)) setAttribute(art, ATTRIBUTE_FREQUENCY, max_frequency);
   uint32_t socket_num = get_nsockets(cpu->topo);
   if (socket_num > 1) {
-    setAttribute(art, ATTRIBUTE_SOCKETS, sockets);
-    setAttribute(art, ATTRIBUTE_NCORES, n_cores);
-    setAttribute(art, ATTRIBUTE_NCORES_DUAL, n_cores_dual);
+    if(field_enabled(FIELD_SOCKETS)) setAttribute(art, ATTRIBUTE_SOCKETS, sockets);
+    if(field_enabled(FIELD_CORES)) {
+      setAttribute(art, ATTRIBUTE_NCORES, n_cores);
+      setAttribute(art, ATTRIBUTE_NCORES_DUAL, n_cores_dual);
+    }
   }
-  else {
+  else if(field_enabled(FIELD_CORES)) {
     setAttribute(art, ATTRIBUTE_NCORES, n_cores);
   }
-  setAttribute(art, ATTRIBUTE_ALTIVEC, altivec);
-  setAttribute(art, ATTRIBUTE_L1i, l1i);
-  setAttribute(art, ATTRIBUTE_L1d, l1d);
-  setAttribute(art, ATTRIBUTE_L2, l2);
-  if(l3 != NULL) {
+  if(field_enabled(FIELD_FEATURES)) setAttribute(art, ATTRIBUTE_ALTIVEC, altivec);
+  if(field_enabled(FIELD_L1I)) setAttribute(art, ATTRIBUTE_L1i, l1i);
+  if(field_enabled(FIELD_L1D)) setAttribute(art, ATTRIBUTE_L1d, l1d);
+  if(field_enabled(FIELD_L2)) setAttribute(art, ATTRIBUTE_L2, l2);
+  if(l3 != NULL && field_enabled(FIELD_L3)) {
     setAttribute(art, ATTRIBUTE_L3, l3);
   }
-  setAttribute(art, ATTRIBUTE_PEAK, pp);
+  if(field_enabled(FIELD_PEAK)) setAttribute(art, ATTRIBUTE_PEAK, pp);
 
   // Step 3. Print output
   bool use_short = false;
@@ -856,15 +868,38 @@ void print_ascii_arm(struct ascii* art, uint32_t la, int32_t termw, bool use_sho
   free(lbuf);
 }
 
+// Sets the attributes of one CPU of the SoC
+void set_cpu_attributes_arm(struct ascii* art, struct cpuInfo* cpu, char* features) {
+  if(field_enabled(FIELD_UARCH)) {
+    setAttribute(art, ATTRIBUTE_UARCH, get_str_uarch(cpu));
+  }
+  if(field_enabled(FIELD_FREQUENCY)) {
+    setAttribute(art, ATTRIBUTE_FREQUENCY, get_str_freq(cpu->freq));
+  }
+  if(field_enabled(FIELD_CORES)) {
+    setAttribute(art, ATTRIBUTE_NCORES, get_str_topology(cpu, cpu->topo, false));
+  }
+  if(features != NULL) {
+    setAttribute(art, ATTRIBUTE_FEATURES, features);
+  }
+}
+
 bool print_cpufetch_arm(struct cpuInfo* cpu, STYLE s, struct color** cs, struct terminal* term) {
-  struct ascii* art = set_ascii(get_soc_vendor(cpu->soc), s);
+  // If the SoC was not requested, it is not fetched and the generic logo is used
+  struct ascii* art = set_ascii(cpu->soc != NULL ? get_soc_vendor(cpu->soc) : SOC_VENDOR_UNKNOWN, s);
   if(art == NULL)
     return false;
 
-  char* manufacturing_process = get_str_process(cpu->soc);
-  char* soc_name = get_soc_name(cpu->soc);
-  char* features = get_str_features(cpu);
-  setAttribute(art, ATTRIBUTE_SOC, soc_name);
+  char* manufacturing_process = NULL;
+  char* features = NULL;
+  char* pp = NULL;
+
+  if(field_enabled(FIELD_NAME)) {
+    setAttribute(art, ATTRIBUTE_SOC, get_soc_name(cpu->soc));
+  }
+  if(field_enabled(FIELD_FEATURES)) {
+    features = get_str_features(cpu);
+  }
 
   // Currently no reliable way to identify the specific SoC on Windows
   // https://github.com/Dr-Noob/cpufetch/pull/273
@@ -873,44 +908,31 @@ bool print_cpufetch_arm(struct cpuInfo* cpu, STYLE s, struct color** cs, struct
   // In the case that the model is unknown but the vendor isn't (this is, when
   // guess_raw_soc_from_devtree succeeded), do not show the manufacturing process
   // (as it will be unknown)
-  if (cpu->soc->model != SOC_MODEL_UNKNOWN ||
-    (cpu->soc->model == SOC_MODEL_UNKNOWN && cpu->soc->vendor == SOC_VENDOR_UNKNOWN))
-  setAttribute(art, ATTRIBUTE_TECHNOLOGY, manufacturing_process);
+  if (field_enabled(FIELD_TECHNOLOGY) && (cpu->soc->model != SOC_MODEL_UNKNOWN ||
+    (cpu->soc->model == SOC_MODEL_UNKNOWN && cpu->soc->vendor == SOC_VENDOR_UNKNOWN))) {
+    manufacturing_process = get_str_process(cpu->soc);
+    setAttribute(art, ATTRIBUTE_TECHNOLOGY, manufacturing_process);
+  }
 #endif
 
   if(cpu->num_cpus == 1) {
-    char* uarch = get_str_uarch(cpu);
-    char* max_frequency = get_str_freq(cpu->freq);
-    char* n_cores = get_str_topology(cpu, cpu->topo, false);
-
-    setAttribute(art, ATTRIBUTE_UARCH, uarch);
-    setAttribute(art, ATTRIBUTE_FREQUENCY, max_frequency);
-    setAttribute(art, ATTRIBUTE_NCORES, n_cores);
-    if(features != NULL) {
-      setAttribute(art, ATTRIBUTE_FEATURES, features);
-    }
+    set_cpu_attributes_arm(art, cpu, features);
   }
   else {
     struct cpuInfo* ptr = cpu;
     for(int i = 0; i < cpu->num_cpus; ptr = ptr->next_cpu, i++) {
-      char* uarch = get_str_uarch(ptr);
-      char* max_frequency = get_str_freq(ptr->freq);
-      char* n_cores = get_str_topology(ptr, ptr->topo, false);
-      char* cpu_num = emalloc(sizeof(char) * 9);
+      char* cpu_num = amalloc(sizeof(char) * 9);
 
       sprintf(cpu_num, "CPU %d:", i+1);
       setAttribute(art, ATTRIBUTE_CPU_NUM, cpu_num);
-      setAttribute(art, ATTRIBUTE_UARCH, uarch);
-      setAttribute(art, ATTRIBUTE_FREQUENCY, max_frequency);
-      setAttribute(art, ATTRIBUTE_NCORES, n_cores);
-      if(features != NULL) {
-        setAttribute(art, ATTRIBUTE_FEATURES, features);
-      }
+      set_cpu_attributes_arm(art, ptr, features);
     }
   }
-  char* pp = get_str_peak_performance(cpu->peak_performance);
-  setAttribute(art, ATTRIBUTE_PEAK, pp);
-  if(cpu->hv->present) {
+  if(field_enabled(FIELD_PEAK)) {
+    pp = get_str_peak_performance(cpu->peak_performance);
+    setAttribute(art, ATTRIBUTE_PEAK, pp);
+  }
+  if(cpu->hv->present && field_enabled(FIELD_HYPERVISOR)) {
     setAttribute(art, ATTRIBUTE_HYPERVISOR, cpu->hv->hv_name);
   }
 
@@ -933,16 +955,7 @@ bool print_cpufetch_arm(struct cpuInfo* cpu, STYLE s, struct color** cs, struct
 
   print_ascii_arm(art, longest_attribute, term->w, use_short);
 
-  free(manufacturing_process);
-  free(pp);
-
-  free(art->attributes);
-  free(art);
-
   if(cs != NULL) free_colors_struct(cs);
-  free_cache_struct(cpu->cach);
-  free_topo_struct(cpu->topo);
-  free_cpuinfo_struct(cpu);
 
   return true;
 }
@@ -1050,15 +1063,19 @@ bool print_cpufetch_riscv(struct cpuInfo* cpu, STYLE s, struct color** cs, struc
   char* pp = get_str_peak_performance(cpu->peak_performance);
 
   // Step 2. Set attributes
-  setAttribute(art, ATTRIBUTE_SOC, soc_name);
-  setAttribute(art, ATTRIBUTE_TECHNOLOGY, manufacturing_process);
-  setAttribute(art, ATTRIBUTE_UARCH, uarch);
-  setAttribute(art, ATTRIBUTE_NCORES, n_cores);
-  setAttribute(art, ATTRIBUTE_FREQUENCY, max_frequency);
-  if(extensions != NULL) {
+  if(field_enabled(FIELD_NAME)) setAttribute(art, ATTRIBUTE_SOC, soc_name);
+  if(field_enabled(FIELD_TECHNOLOGY)) setAttribute(art, ATTRIBUTE_TECHNOLOGY, manufacturing_process);
+  if(field_enabled(FIELD_UARCH)) setAttribute(art, ATTRIBUTE_UARCH, uarch);
+  if(field_enabled(FIELD_CORES)) setAttribute(art, ATTRIBUTE_NCORES, n_cores);
+  if(field_enabled(FIELD_FREQUENCY)) setAttribute(art, ATTRIBUTE_FREQUENCY, max_frequency);
+  if(extensions != NULL && field_enabled(FIELD_FEATURES)) {
     setAttribute(art, ATTRIBUTE_EXTENSIONS, extensions);
   }
-  setAttribute(art, ATTRIBUTE_PEAK, pp);
+  else if(cpu->ext != NULL) {
+    // The list of extensions is printed below the attribute
+    memset(cpu->ext->mask, 0, sizeof(bool) * RISCV_ISA_EXT_ID_MAX);
+  }
+  if(field_enabled(FIELD_PEAK)) setAttribute(art, ATTRIBUTE_PEAK, pp);
 
   // Step 3. Print output
   bool use_short = false;
@@ -1080,7 +1097,7 @@ bool print_cpufetch_riscv(struct cpuInfo* cpu, STYLE s, struct color** cs, struc
 #endif
 
 struct terminal* get_terminal_size(void) {
-  struct terminal* term = emalloc(sizeof(struct terminal));
+  struct terminal* term = amalloc(sizeof(struct terminal));
 
 #ifdef _WIN32
   CONSOLE_SCREEN_BUFFER_INFO csbi;
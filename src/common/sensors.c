@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "sensors.h"
+#include "global.h"
+#include "udev.h"
+
+#define _PATH_POWERCAP          "/sys/class/powercap"
+#define _PATH_HWMON             "/sys/class/hwmon"
+#define _PATH_THERMAL           "/sys/class/thermal"
+
+#define SENSORS_MAX_ZONES       64
+#define SENSORS_PATH_MAX_LEN    512
+
+// The counter wraps around at max (0 if it does not)
+struct energy_counter {
+  char* path;
+  long long max;
+  long long last;
+};
+
+struct sensors {
+  struct energy_counter* energy;
+  int num_energy;
+  double joules;
+  char** temp_paths;
+  char** temp_names;
+  int num_temps;
+};
+
+static bool read_ll(char* path, long long* value) {
+  int len;
+  char* buf = read_file(path, &len);
+  if(buf == NULL) return false;
+
+  char* end;
+  errno = 0;
+  *value = strtoll(buf, &end, 10);
+  bool ok = errno == 0 && end != buf;
+  free(buf);
+  return ok;
+}
+
+// Returns the first line of path in a new buffer, or NULL
+static char* read_line(char* path) {
+  int len;
+  char* buf = read_file(path, &len);
+  if(buf == NULL) return NULL;
+
+  char* nl = strchr(buf, '\n');
+  if(nl != NULL) *nl = '\0';
+  return buf;
+}
+
+static char* copy_str(char* str) {
+  char* copy = emalloc(sizeof(char) * (strlen(str) + 1));
+  strcpy(copy, str);
+  return copy;
+}
+
+// energy_uj is usually only readable by root
+static void add_energy(struct sensors* s, char* path, long long max) {
+  long long value;
+  if(!read_ll(path, &value)) {
+    printWarn("Could not read '%s': %s", path, strerror(errno));
+    return;
+  }
+
+  s->energy = erealloc(s->energy, sizeof(struct energy_counter) * (s->num_energy + 1));
+  struct energy_counter* c = &s->energy[s->num_energy++];
+  c->path = copy_str(path);
+  c->max = max;
+  c->last = value;
+}
+
+// One zone per package (intel-rapl:N, named package-N). Their
+// subzones (intel-rapl:N:M) are part of them, and psys (if any)
+// covers more than the packages. AMD CPUs are exposed here too
+static void find_powercap(struct sensors* s, const char* root) {
+  char path[SENSORS_PATH_MAX_LEN];
+
+  for(int i=0; i < SENSORS_MAX_ZONES; i++) {
+    snprintf(path, sizeof(path), "%s%s/intel-rapl:%d/name", root, _PATH_POWERCAP, i);
+    char* name = read_line(path);
+    if(name == NULL) continue;
+
+    if(strncmp(name, "package", strlen("package")) == 0) {
+      long long max = 0;
+      snprintf(path, sizeof(path), "%s%s/intel-rapl:%d/max_energy_range_uj", root, _PATH_POWERCAP, i);
+      if(!read_ll(path, &max)) max = 0;
+      snprintf(path, sizeof(path), "%s%s/intel-rapl:%d/energy_uj", root, _PATH_POWERCAP, i);
+      add_energy(s, path, max);
+    }
+    free(name);
+  }
+}
+
+// Older kernels expose the AMD counters through the amd_energy hwmon
+// driver, with one EsocketN input per package
+static void find_amd_energy(struct sensors* s, const char* root) {
+  char path[SENSORS_PATH_MAX_LEN];
+
+  for(int i=0; i < SENSORS_MAX_ZONES; i++) {
+    snprintf(path, sizeof(path), "%s%s/hwmon%d/name", root, _PATH_HWMON, i);
+    char* name = read_line(path);
+    if(name == NULL) continue;
+    bool found = strcmp(name, "amd_energy") == 0;
+    free(name);
+    if(!found) continue;
+
+    for(int j=1; j < SENSORS_MAX_ZONES * 8; j++) {
+      snprintf(path, sizeof(path), "%s%s/hwmon%d/energy%d_label", root, _PATH_HWMON, i, j);
+      char* label = read_line(path);
+      if(label == NULL) break;
+      if(strncmp(label, "Esocket", strlen("Esocket")) == 0) {
+        snprintf(path, sizeof(path), "%s%s/hwmon%d/energy%d_input", root, _PATH_HWMON, i, j);
+        add_energy(s, path, 0);
+      }
+      free(label);
+    }
+  }
+}
+
+static void find_thermal(struct sensors* s, const char* root) {
+  char path[SENSORS_PATH_MAX_LEN];
+  long long temp;
+
+  for(int i=0; i < SENSORS_MAX_ZONES; i++) {
+    snprintf(path, sizeof(path), "%s%s/thermal_zone%d/type", root, _PATH_THERMAL, i);
+    char* type = read_line(path);
+    if(type == NULL) continue;
+
+    snprintf(path, sizeof(path), "%s%s/thermal_zone%d/temp", root, _PATH_THERMAL, i);
+    if(!read_ll(path, &temp)) {
+      free(type);
+      continue;
+    }
+
+    s->temp_paths = erealloc(s->temp_paths, sizeof(char *) * (s->num_temps + 1));
+    s->temp_names = erealloc(s->temp_names, sizeof(char *) * (s->num_temps + 1));
+    s->temp_paths[s->num_temps] = copy_str(path);
+    s->temp_names[s->num_temps] = type;
+    s->num_temps++;
+  }
+}
+
+struct sensors* sensors_open(const char* root) {
+  struct sensors* s = ecalloc(1, sizeof(struct sensors));
+
+  find_powercap(s, root);
+  if(s->num_energy == 0) find_amd_energy(s, root);
+  if(s->num_energy == 0) printWarn("No package energy counters were found, power will not be reported");
+
+  find_thermal(s, root);
+  if(s->num_temps == 0) printWarn("No thermal zones were found, temperature will not be reported");
+
+  return s;
+}
+
+bool sensors_read_energy(struct sensors* s, double* joules) {
+  if(s->num_energy == 0) return false;
+
+  long long* values = emalloc(sizeof(long long) * s->num_energy);
+  for(int i=0; i < s->num_energy; i++) {
+    struct energy_counter* c = &s->energy[i];
+    if(!read_ll(c->path, &values[i]) || (values[i] < c->last && c->max == 0)) {
+      printWarn("Could not read the energy from '%s'", c->path);
+      free(values);
+      return false;
+    }
+  }
+
+  for(int i=0; i < s->num_energy; i++) {
+    struct energy_counter* c = &s->energy[i];
+    long long delta = values[i] >= c->last ? values[i] - c->last : values[i] + (c->max - c->last);
+    s->joules += delta / 1000000.0;
+    c->last = values[i];
+  }
+
+  free(values);
+  *joules = s->joules;
+  return true;
+}
+
+int sensors_num_temps(struct sensors* s) {
+  return s->num_temps;
+}
+
+const char* sensors_temp_name(struct sensors* s, int i) {
+  return s->temp_names[i];
+}
+
+void sensors_read_temps(struct sensors* s, double* temps) {
+  long long temp;
+  for(int i=0; i < s->num_temps; i++) {
+    temps[i] = read_ll(s->temp_paths[i], &temp) ? temp / 1000.0 : NAN;
+  }
+}
+
+void sensors_close(struct sensors* s) {
+  for(int i=0; i < s->num_energy; i++) free(s->energy[i].path);
+  for(int i=0; i < s->num_temps; i++) {
+    free(s->temp_paths[i]);
+    free(s->temp_names[i]);
+  }
+  free(s->energy);
+  free(s->temp_paths);
+  free(s->temp_names);
+  free(s);
+}
@@ -0,0 +1,22 @@
+#ifndef __SENSORS__
+#define __SENSORS__
+
+#include <stdbool.h>
+
+// Package energy (RAPL, through powercap or the amd_energy hwmon
+// driver) and temperature (thermal zones) sensors. All the paths are
+// relative to root, which is "" for the running system, or a directory
+// with the same layout (e.g, a copy of some files of a given machine)
+struct sensors;
+
+struct sensors* sensors_open(const char* root);
+// Energy (J) consumed by all the packages since sensors_open.
+// Returns false if it is not available
+bool sensors_read_energy(struct sensors* s, double* joules);
+int sensors_num_temps(struct sensors* s);
+const char* sensors_temp_name(struct sensors* s, int i);
+// Temperature (C) of each zone, or NAN if it could not be read
+void sensors_read_temps(struct sensors* s, double* temps);
+void sensors_close(struct sensors* s);
+
+#endif
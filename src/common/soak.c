@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+
+#include "soak.h"
+#include "global.h"
+
+struct soak_sample {
+  double time;
+  // Mean, min and max of the cores that could be read
+  double freq;
+  double min;
+  double max;
+  double watts;
+  double* core_freq;
+  double* temps;
+};
+
+static struct {
+  int* cpus;
+  int num_cores;
+  char** zones;
+  int num_zones;
+  struct soak_sample* samples;
+  int num_samples;
+  int max_samples;
+  double gflops;
+} soak;
+
+struct soak_steady {
+  int first;
+  double freq;
+  double watts;
+  double settle_time;
+};
+
+void soak_begin(int* cpus, int num_cores, struct sensors* sensors) {
+  soak.num_cores = num_cores;
+  soak.cpus = emalloc(sizeof(int) * num_cores);
+  memcpy(soak.cpus, cpus, sizeof(int) * num_cores);
+
+  soak.num_zones = sensors_num_temps(sensors);
+  soak.zones = emalloc(sizeof(char *) * (soak.num_zones + 1));
+  for(int i=0; i < soak.num_zones; i++) {
+    const char* name = sensors_temp_name(sensors, i);
+    soak.zones[i] = emalloc(sizeof(char) * (strlen(name) + 1));
+    strcpy(soak.zones[i], name);
+  }
+  soak.gflops = NAN;
+}
+
+void soak_add(double time, double* core_freq, double watts, double* temps) {
+  if(soak.num_samples == soak.max_samples) {
+    soak.max_samples = soak.max_samples == 0 ? 128 : soak.max_samples * 2;
+    soak.samples = erealloc(soak.samples, sizeof(struct soak_sample) * soak.max_samples);
+  }
+
+  struct soak_sample* s = &soak.samples[soak.num_samples++];
+  s->time = time;
+  s->watts = watts;
+  s->core_freq = emalloc(sizeof(double) * soak.num_cores);
+  s->temps = emalloc(sizeof(double) * (soak.num_zones + 1));
+  memcpy(s->core_freq, core_freq, sizeof(double) * soak.num_cores);
+  memcpy(s->temps, temps, sizeof(double) * soak.num_zones);
+
+  double acc = 0.0;
+  int count = 0;
+  s->min = 0;
+  s->max = 0;
+  for(int i=0; i < soak.num_cores; i++) {
+    if(core_freq[i] <= 0) continue;
+    if(count == 0 || core_freq[i] < s->min) s->min = core_freq[i];
+    if(count == 0 || core_freq[i] > s->max) s->max = core_freq[i];
+    acc += 1 / core_freq[i];
+    count++;
+  }
+  s->freq = count > 0 ? count / acc : 0;
+}
+
+// Highest temperature of all the zones, or NAN
+static double max_temp(struct soak_sample* s) {
+  double temp = NAN;
+  for(int i=0; i < soak.num_zones; i++) {
+    if(!isnan(s->temps[i]) && (isnan(temp) || s->temps[i] > temp)) temp = s->temps[i];
+  }
+  return temp;
+}
+
+static bool get_steady(struct soak_steady* st) {
+  if(soak.num_samples == 0) return false;
+
+  int n = soak.num_samples * SOAK_STEADY_PCT / 100;
+  st->first = soak.num_samples - (n > 0 ? n : 1);
+
+  double freq = 0.0;
+  double watts = 0.0;
+  int num_freq = 0;
+  int num_watts = 0;
+  for(int i=st->first; i < soak.num_samples; i++) {
+    struct soak_sample* s = &soak.samples[i];
+    if(s->freq > 0) {
+      freq += s->freq;
+      num_freq++;
+    }
+    if(!isnan(s->watts)) {
+      watts += s->watts;
+      num_watts++;
+    }
+  }
+  if(num_freq == 0) return false;
+  st->freq = freq / num_freq;
+  st->watts = num_watts > 0 ? watts / num_watts : NAN;
+
+  // Time of the first sample after which it never leaves the band
+  int settled = soak.num_samples;
+  while(settled > 0 && fabs(soak.samples[settled-1].freq - st->freq) <= st->freq * SOAK_SETTLE_PCT / 100) settled--;
+  st->settle_time = settled < soak.num_samples ? soak.samples[settled].time : NAN;
+  return true;
+}
+
+bool soak_steady_core_freq(double* core_freq) {
+  struct soak_steady st;
+  if(!get_steady(&st)) return false;
+
+  for(int c=0; c < soak.num_cores; c++) {
+    double acc = 0.0;
+    int count = 0;
+    for(int i=st.first; i < soak.num_samples; i++) {
+      if(soak.samples[i].core_freq[c] <= 0) continue;
+      acc += soak.samples[i].core_freq[c];
+      count++;
+    }
+    if(count == 0) return false;
+    core_freq[c] = acc / count;
+  }
+  return true;
+}
+
+void soak_set_gflops(double gflops) {
+  soak.gflops = gflops;
+}
+
+static void print_value(const char* fmt, int width, double value) {
+  if(isnan(value)) printf(" %*s", width, "-");
+  else printf(fmt, value);
+}
+
+void print_soak(void) {
+  struct soak_steady st;
+  if(!get_steady(&st)) {
+    printWarn("The soak test did not produce any sample");
+    return;
+  }
+
+  printf("\nSoak test (MHz, W and C, one sample per second):\n");
+  printf("%6s %7s %7s %7s %8s %6s\n", "Time", "Freq", "Min", "Max", "Power", "Temp");
+  for(int i=0; i < soak.num_samples; i++) {
+    struct soak_sample* s = &soak.samples[i];
+    printf("%6.0f %7.0f %7.0f %7.0f", s->time, s->freq, s->min, s->max);
+    print_value(" %8.1f", 8, s->watts);
+    print_value(" %6.1f", 6, max_temp(s));
+    printf("\n");
+  }
+
+  printf("Steady state (last %d samples): %.0f MHz", soak.num_samples - st.first, st.freq);
+  if(!isnan(st.watts)) printf(", %.1f W", st.watts);
+  if(!isnan(soak.gflops)) printf(", %.2f GFLOP/s", soak.gflops);
+  if(!isnan(soak.gflops) && !isnan(st.watts) && st.watts > 0) printf(", %.2f GFLOP/s per W", soak.gflops / st.watts);
+  printf("\n");
+  if(!isnan(st.settle_time)) {
+    printf("Frequency within %d%% of the steady state after %.0f s\n", SOAK_SETTLE_PCT, st.settle_time);
+  }
+}
+
+static void write_value(FILE* fp, const char* fmt, double value) {
+  if(isnan(value)) fprintf(fp, "null");
+  else fprintf(fp, fmt, value);
+}
+
+// Writes the series as JSON, with null for the values
+// that could not be read
+bool write_soak(const char* path) {
+  FILE* fp = fopen(path, "w");
+  if(fp == NULL) {
+    printErr("Unable to write soak test to '%s': %s", path, strerror(errno));
+    return false;
+  }
+
+  struct soak_steady st;
+  bool steady = get_steady(&st);
+
+  fprintf(fp, "{\"cpus\":[");
+  for(int i=0; i < soak.num_cores; i++) fprintf(fp, "%s%d", i == 0 ? "" : ",", soak.cpus[i]);
+  fprintf(fp, "],\n\"zones\":[");
+  for(int i=0; i < soak.num_zones; i++) fprintf(fp, "%s\"%s\"", i == 0 ? "" : ",", soak.zones[i]);
+  fprintf(fp, "],\n\"samples\":[");
+
+  for(int i=0; i < soak.num_samples; i++) {
+    struct soak_sample* s = &soak.samples[i];
+    fprintf(fp, "%s\n {\"time\":%.3f,\"freq\":%.1f,\"power\":", i == 0 ? "" : ",", s->time, s->freq);
+    write_value(fp, "%.2f", s->watts);
+    fprintf(fp, ",\"temps\":[");
+    for(int j=0; j < soak.num_zones; j++) {
+      if(j > 0) fprintf(fp, ",");
+      write_value(fp, "%.1f", s->temps[j]);
+    }
+    fprintf(fp, "],\"cores\":[");
+    for(int j=0; j < soak.num_cores; j++) fprintf(fp, "%s%.1f", j == 0 ? "" : ",", s->core_freq[j]);
+    fprintf(fp, "]}");
+  }
+  fprintf(fp, "],\n\"steady\":");
+
+  if(!steady) {
+    fprintf(fp, "null");
+  }
+  else {
+    fprintf(fp, "{\"samples\":%d,\"freq\":%.1f,\"power\":", soak.num_samples - st.first, st.freq);
+    write_value(fp, "%.2f", st.watts);
+    fprintf(fp, ",\"gflops\":");
+    write_value(fp, "%.2f", soak.gflops);
+    fprintf(fp, ",\"gflops_per_watt\":");
+    write_value(fp, "%.3f", st.watts > 0 ? soak.gflops / st.watts : NAN);
+    fprintf(fp, ",\"settle_time\":");
+    write_value(fp, "%.0f", st.settle_time);
+    fprintf(fp, "}");
+  }
+  fprintf(fp, "}\n");
+
+  if(fclose(fp) != 0) {
+    printErr("Unable to write soak test to '%s': %s", path, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+void free_soak(void) {
+  for(int i=0; i < soak.num_samples; i++) {
+    free(soak.samples[i].core_freq);
+    free(soak.samples[i].temps);
+  }
+  for(int i=0; i < soak.num_zones; i++) free(soak.zones[i]);
+  free(soak.samples);
+  free(soak.zones);
+  free(soak.cpus);
+  memset(&soak, 0, sizeof(soak));
+}
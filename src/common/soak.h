@@ -0,0 +1,28 @@
+#ifndef __SOAK__
+#define __SOAK__
+
+#include <stdbool.h>
+#include "sensors.h"
+
+// Time series of a soak run (all cores loaded for minutes), one
+// sample per second. The steady state is the average of the last
+// SOAK_STEADY_PCT% of the samples
+#define SOAK_STEADY_PCT      25
+// The frequency is settled once it stays this close to the steady state
+#define SOAK_SETTLE_PCT       2
+
+void soak_begin(int* cpus, int num_cores, struct sensors* sensors);
+// core_freq and temps (NAN if missing) are copied. watts is NAN if
+// the energy could not be read, and core_freq is 0 for the cores
+// whose frequency could not be read
+void soak_add(double time, double* core_freq, double watts, double* temps);
+// Fills the steady-state frequency of each core, returning
+// false if there are not enough samples
+bool soak_steady_core_freq(double* core_freq);
+// Performance (GFLOP/s) at the steady-state frequency
+void soak_set_gflops(double gflops);
+void print_soak(void);
+bool write_soak(const char* path);
+void free_soak(void);
+
+#endif
@@ -42,12 +42,12 @@ char* get_str_process(struct system_on_chip* soc) {
   char* str;
 
   if(soc->process == UNKNOWN) {
-    str = emalloc(sizeof(char) * (strlen(STRING_UNKNOWN)+1));
+    str = amalloc(sizeof(char) * (strlen(STRING_UNKNOWN)+1));
     snprintf(str, strlen(STRING_UNKNOWN)+1, STRING_UNKNOWN);
   }
   else {
     int max_process_len = 5 + 1;
-    str = ecalloc(max_process_len, sizeof(char));
+    str = acalloc(max_process_len, sizeof(char));
     snprintf(str, max_process_len, "%dnm", soc->process);
   }
   return str;
@@ -70,12 +70,12 @@ void fill_soc(struct system_on_chip* soc, char* soc_name, SOC soc_model, int32_t
     soc->vendor = SOC_VENDOR_UNKNOWN;
     soc->model = SOC_MODEL_UNKNOWN;
     soc->process = UNKNOWN;
-    soc->raw_name = emalloc(sizeof(char) * (strlen(STRING_UNKNOWN)+1));
+    soc->raw_name = amalloc(sizeof(char) * (strlen(STRING_UNKNOWN)+1));
     snprintf(soc->raw_name, strlen(STRING_UNKNOWN)+1, STRING_UNKNOWN);
   }
   else {
     int len = strlen(soc_name) + strlen(soc_trademark_string[soc->vendor]) + 1;
-    soc->name = emalloc(sizeof(char) * len);
+    soc->name = amalloc(sizeof(char) * len);
     sprintf(soc->name, "%s%s", soc_trademark_string[soc->vendor], soc_name);
   }
 }
@@ -86,7 +86,7 @@ void fill_soc_raw(struct system_on_chip* soc, char* soc_name, VENDOR vendor) {
   soc->process = UNKNOWN;
 
   int len = strlen(soc_name) + strlen(soc_trademark_string[soc->vendor]) + 1;
-  soc->raw_name = emalloc(sizeof(char) * len);
+  soc->raw_name = amalloc(sizeof(char) * len);
   sprintf(soc->raw_name, "%s%s", soc_trademark_string[soc->vendor], soc_name);
 }
 
@@ -0,0 +1,245 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "uarchdb.h"
+#include "global.h"
+
+#define NA -1
+
+struct uarch_db_key {
+  uint64_t value;
+  int32_t index;
+};
+
+// All the entries sharing the same mask, sorted by (value, index)
+struct uarch_db_group {
+  uint64_t mask;
+  struct uarch_db_key* keys;
+  int num_keys;
+};
+
+struct uarch_db {
+  struct uarch_db_entry* entries;
+  int num_entries;
+  int num_file_entries;
+  struct uarch_db_group* groups;
+  int num_groups;
+};
+
+static int cmp_keys(const void* a, const void* b) {
+  const struct uarch_db_key* ka = a;
+  const struct uarch_db_key* kb = b;
+
+  if(ka->value != kb->value) return ka->value < kb->value ? -1 : 1;
+  return ka->index - kb->index;
+}
+
+// Splits the line in place. Tokens are separated by blanks, may be
+// quoted and '#' starts a comment. Returns -1 if the line is invalid
+static int tokenize(char* line, char** tokens) {
+  int n = 0;
+  char* p = line;
+
+  while(true) {
+    while(*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+    if(*p == '\0' || *p == '#') return n;
+    if(n == UARCH_DB_MAX_TOKENS) return -1;
+
+    if(*p == '"') {
+      tokens[n++] = ++p;
+      while(*p != '\0' && *p != '"') p++;
+      if(*p != '"') return -1;
+    }
+    else {
+      tokens[n++] = p;
+      while(*p != '\0' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n' && *p != '#') p++;
+      if(*p == '#') {
+        *p = '\0';
+        return n;
+      }
+    }
+    if(*p != '\0') *p++ = '\0';
+  }
+}
+
+// Reads the entries of the override file. Invalid lines are
+// reported and skipped, so the rest of the file is still used
+static struct uarch_db_entry* load_uarch_db_file(char* path, uarch_db_parse_fn parse, int* num_entries) {
+  FILE* fp = fopen(path, "r");
+  if(fp == NULL) {
+    printErr("Could not open uarch database '%s': %s", path, strerror(errno));
+    return NULL;
+  }
+
+  int capacity = 16;
+  struct uarch_db_entry* entries = emalloc(sizeof(struct uarch_db_entry) * capacity);
+  char* tokens[UARCH_DB_MAX_TOKENS];
+  char line[1024];
+  int line_num = 0;
+  *num_entries = 0;
+
+  while(fgets(line, sizeof(line), fp) != NULL) {
+    line_num++;
+    if(strchr(line, '\n') == NULL && !feof(fp)) {
+      printErr("%s:%d: Line is too long", path, line_num);
+      int c;
+      while((c = fgetc(fp)) != EOF && c != '\n');
+      continue;
+    }
+
+    int n = tokenize(line, tokens);
+    if(n == 0) continue;
+    if(n < 0) {
+      printErr("%s:%d: Unterminated string or too many fields", path, line_num);
+      continue;
+    }
+
+    struct uarch_db_entry e = { 0, 0, 0, NULL, NA, NA, NA };
+    if(!parse(tokens, n, &e)) {
+      printErr("%s:%d: Ignoring invalid entry", path, line_num);
+      continue;
+    }
+    if(e.str != NULL) {
+      char* str = amalloc(sizeof(char) * (strlen(e.str)+1));
+      strcpy(str, e.str);
+      e.str = str;
+    }
+
+    if(*num_entries == capacity) {
+      capacity *= 2;
+      entries = erealloc(entries, sizeof(struct uarch_db_entry) * capacity);
+    }
+    entries[(*num_entries)++] = e;
+  }
+
+  fclose(fp);
+  return entries;
+}
+
+// Indexes the table, with the entries of the file at path (if not
+// NULL) taking priority over it. Lookups return the first matching
+// entry, exactly like walking the table in order would
+struct uarch_db* uarch_db_build(const struct uarch_db_entry* table, int num_entries, char* path, uarch_db_parse_fn parse) {
+  struct uarch_db* db = amalloc(sizeof(struct uarch_db));
+  struct uarch_db_entry* file_entries = NULL;
+  int num_file_entries = 0;
+
+  if(path != NULL) {
+    file_entries = load_uarch_db_file(path, parse, &num_file_entries);
+  }
+
+  db->num_file_entries = num_file_entries;
+  db->num_entries = num_file_entries + num_entries;
+  db->entries = amalloc(sizeof(struct uarch_db_entry) * db->num_entries);
+  if(num_file_entries > 0) memcpy(db->entries, file_entries, sizeof(struct uarch_db_entry) * num_file_entries);
+  memcpy(db->entries + num_file_entries, table, sizeof(struct uarch_db_entry) * num_entries);
+  free(file_entries);
+
+  // There are just a few distinct masks, so a linear search is enough
+  int* group_of = emalloc(sizeof(int) * db->num_entries);
+  db->groups = amalloc(sizeof(struct uarch_db_group) * db->num_entries);
+  db->num_groups = 0;
+
+  for(int i=0; i < db->num_entries; i++) {
+    // Such an entry can never match, like in a plain walk of the table
+    if((db->entries[i].value & ~db->entries[i].mask) != 0) {
+      group_of[i] = -1;
+      continue;
+    }
+
+    int g = 0;
+    while(g < db->num_groups && db->groups[g].mask != db->entries[i].mask) g++;
+    if(g == db->num_groups) {
+      db->groups[g].mask = db->entries[i].mask;
+      db->groups[g].num_keys = 0;
+      db->num_groups++;
+    }
+    db->groups[g].num_keys++;
+    group_of[i] = g;
+  }
+
+  for(int g=0; g < db->num_groups; g++) {
+    db->groups[g].keys = amalloc(sizeof(struct uarch_db_key) * db->groups[g].num_keys);
+    db->groups[g].num_keys = 0;
+  }
+  for(int i=0; i < db->num_entries; i++) {
+    if(group_of[i] == -1) continue;
+    struct uarch_db_group* group = &db->groups[group_of[i]];
+    group->keys[group->num_keys].value = db->entries[i].value;
+    group->keys[group->num_keys].index = i;
+    group->num_keys++;
+  }
+  for(int g=0; g < db->num_groups; g++) {
+    qsort(db->groups[g].keys, db->groups[g].num_keys, sizeof(struct uarch_db_key), cmp_keys);
+  }
+
+  free(group_of);
+  return db;
+}
+
+const struct uarch_db_entry* uarch_db_lookup(const struct uarch_db* db, uint64_t sig) {
+  int32_t best = -1;
+
+  for(int g=0; g < db->num_groups; g++) {
+    const struct uarch_db_group* group = &db->groups[g];
+    uint64_t value = sig & group->mask;
+    int lo = 0;
+    int hi = group->num_keys;
+
+    // Find the first key with this value, which has the lowest index
+    while(lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if(group->keys[mid].value < value) lo = mid + 1;
+      else hi = mid;
+    }
+
+    if(lo < group->num_keys && group->keys[lo].value == value &&
+       (best == -1 || group->keys[lo].index < best)) {
+      best = group->keys[lo].index;
+    }
+  }
+
+  return best == -1 ? NULL : &db->entries[best];
+}
+
+bool uarch_db_is_override(const struct uarch_db* db, const struct uarch_db_entry* entry) {
+  return entry != NULL && entry - db->entries < db->num_file_entries;
+}
+
+// Accepts decimal or hex numbers, character literals ('A') and NA,
+// which is returned as -1 regardless of the range
+bool uarch_db_parse_int(char* tok, int64_t min, int64_t max, int64_t* value) {
+  if(strcmp(tok, "NA") == 0) {
+    *value = NA;
+    return true;
+  }
+  if(tok[0] == '\'' && tok[1] != '\0' && tok[2] == '\'' && tok[3] == '\0') {
+    *value = (unsigned char) tok[1];
+  }
+  else {
+    char* end;
+    errno = 0;
+    *value = strtoll(tok, &end, 0);
+    if(errno != 0 || end == tok || *end != '\0') {
+      printErr("Invalid number: '%s'", tok);
+      return false;
+    }
+  }
+
+  if(*value < min || *value > max) {
+    printErr("Value out of range [%lld, %lld]: '%s'", (long long) min, (long long) max, tok);
+    return false;
+  }
+  return true;
+}
+
+// Returns the index of tok in names (which may have holes), or -1
+int uarch_db_parse_symbol(char* tok, const char** names, int num_names) {
+  for(int i=0; i < num_names; i++) {
+    if(names[i] != NULL && strcmp(names[i], tok) == 0) return i;
+  }
+  printErr("Unknown symbol: '%s'", tok);
+  return -1;
+}
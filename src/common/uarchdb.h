@@ -0,0 +1,41 @@
+#ifndef __UARCHDB__
+#define __UARCHDB__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// An entry matches a CPU signature sig if (sig & mask) == value.
+// Each architecture packs its own signature (cpuid, MIDR or PVR)
+// and decides which of the other fields it uses
+struct uarch_db_entry {
+  uint64_t mask;
+  uint64_t value;
+  int32_t uarch;
+  char* str;
+  int32_t process;
+  int32_t vendor;
+  int32_t vpus;
+};
+
+// Pack a field of the signature and build its mask. NA (-1) fields
+// are left out of the mask, so they match any value
+#define UARCH_DB_FIELD(x, shift, bits) ((x) == -1 ? 0 : ((uint64_t) (x) & ((1 << (bits)) - 1)) << (shift))
+#define UARCH_DB_MASK(x, shift, bits)  ((x) == -1 ? 0 : (uint64_t) ((1 << (bits)) - 1) << (shift))
+
+#define UARCH_DB_MAX_TOKENS 16
+
+// Fills the entry from the tokens of one line of the override
+// file. Returns false (after printing why) if the line is invalid
+typedef bool (*uarch_db_parse_fn)(char** tokens, int num_tokens, struct uarch_db_entry* entry);
+
+struct uarch_db;
+
+struct uarch_db* uarch_db_build(const struct uarch_db_entry* table, int num_entries, char* path, uarch_db_parse_fn parse);
+const struct uarch_db_entry* uarch_db_lookup(const struct uarch_db* db, uint64_t sig);
+// Whether entry (returned by uarch_db_lookup) comes from the override file
+bool uarch_db_is_override(const struct uarch_db* db, const struct uarch_db_entry* entry);
+
+bool uarch_db_parse_int(char* tok, int64_t min, int64_t max, int64_t* value);
+int uarch_db_parse_symbol(char* tok, const char** names, int num_names);
+
+#endif
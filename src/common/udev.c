@@ -1,3 +1,8 @@
+// pread
+#define _GNU_SOURCE
+
+#include <sys/stat.h>
+
 #include "../common/global.h"
 #include "udev.h"
 #include "global.h"
@@ -14,7 +19,7 @@ int get_ncores_from_cpuinfo(void) {
 
   int filelen;
   char* buf;
-  if((buf = read_file(_PATH_CPUS_PRESENT, &filelen)) == NULL) {
+  if((buf = read_file_cached(_PATH_CPUS_PRESENT, &filelen)) == NULL) {
     printWarn("read_file: %s: %s\n", _PATH_CPUS_PRESENT, strerror(errno));
     return -1;
   }
@@ -42,46 +47,231 @@ int get_ncores_from_cpuinfo(void) {
     return -1;
   }
 
-  free(buf);
-
   return ncores;
 }
 
-char* read_file(char* path, int* len) {
+// Reads the whole content of fd into *buf, which has *buf_size bytes
+// and is doubled whenever it gets full. If positional, the file is read
+// with pread from the beginning, so that an open fd can be read again.
+// Returns the number of bytes read (the buffer is NULL terminated)
+static int read_fd(int fd, char** buf, int* buf_size, bool positional) {
+  int offset = 0;
+  ssize_t bytes_read;
+
+  while(true) {
+    if(offset + 1 >= *buf_size) {
+      *buf_size *= 2;
+      *buf = erealloc(*buf, sizeof(char) * (*buf_size));
+    }
+
+    if(positional)
+      bytes_read = pread(fd, *buf + offset, *buf_size - offset - 1, offset);
+    else
+      bytes_read = read(fd, *buf + offset, *buf_size - offset - 1);
+
+    if(bytes_read == -1 && errno == EINTR) continue;
+    if(bytes_read == -1) return -1;
+    if(bytes_read == 0) break;
+    offset += bytes_read;
+  }
+
+  (*buf)[offset] = '\0';
+  TRACE_COUNT(TRACE_BYTES_READ, offset);
+  return offset;
+}
+
+static int open_file(char* path) {
   int fd = open(path, O_RDONLY);
+  if(fd != -1) TRACE_COUNT(TRACE_FILES_OPENED, 1);
+  return fd;
+}
+
+// Returns the content of the file in a new buffer
+// that must be freed by the caller
+char* read_file(char* path, int* len) {
+  int fd = open_file(path);
 
   if(fd == -1) {
     return NULL;
   }
 
-  //File exists, read it
-  int bytes_read = 0;
-  int offset = 0;
-  int block = 1024;
-  int buf_size = block * 4;
+  // Regular files (and sysfs attributes, which report
+  // one page) can be read in one go, procfs reports 0
+  struct stat st;
+  int buf_size = 4096;
+  if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && st.st_size < INT32_MAX)
+    buf_size = st.st_size + 1;
   char* buf = emalloc(sizeof(char) * buf_size);
 
-  while ((bytes_read = read(fd, buf+offset, block)) > 0) {
-    offset += bytes_read;
-    if(offset + block > buf_size) {
-      buf = erealloc(buf, sizeof(char) * (buf_size + block));
-      buf_size += block;
+  int offset = read_fd(fd, &buf, &buf_size, false);
+  if (close(fd) == -1 || offset == -1) {
+    free(buf);
+    return NULL;
+  }
+
+  *len = offset;
+  return buf;
+}
+
+// Most of the files are small sysfs attributes that are parsed and
+// discarded right away, so they share this buffer instead of allocating.
+// It is not reentrant: a caller must be done with the content before
+// reading another file, and only one thread may use it
+static char* scratch_buf = NULL;
+static int scratch_size = 0;
+
+static char* get_scratch_buf(void) {
+  if(scratch_buf == NULL) {
+    scratch_size = 4096;
+    scratch_buf = emalloc(sizeof(char) * scratch_size);
+  }
+  return scratch_buf;
+}
+
+// Like read_file, but the content is stored in a shared buffer that must
+// not be freed and that is only valid until the next call to
+// read_file_scratch or read_file_cached
+char* read_file_scratch(char* path, int* len) {
+  int fd = open_file(path);
+
+  if(fd == -1) {
+    return NULL;
+  }
+
+  get_scratch_buf();
+  int offset = read_fd(fd, &scratch_buf, &scratch_size, false);
+  if (close(fd) == -1 || offset == -1) {
+    return NULL;
+  }
+
+  *len = offset;
+  return scratch_buf;
+}
+
+#define MAX_CACHED_FILES 64
+
+struct cached_file {
+  char* path;
+  int fd;
+};
+
+static struct cached_file cached_files[MAX_CACHED_FILES];
+static int num_cached_files = 0;
+
+// Like read_file_scratch, for files that are read several times: the fd is
+// kept open and the file is read again with pread, which sysfs and procfs
+// regenerate on every read from the beginning
+char* read_file_cached(char* path, int* len) {
+  int fd = -1;
+
+  for(int i=0; i < num_cached_files && fd == -1; i++) {
+    if(strcmp(cached_files[i].path, path) == 0) fd = cached_files[i].fd;
+  }
+
+  if(fd == -1) {
+    if(num_cached_files == MAX_CACHED_FILES) {
+      return read_file_scratch(path, len);
     }
+    if((fd = open_file(path)) == -1) {
+      return NULL;
+    }
+    cached_files[num_cached_files].path = emalloc(sizeof(char) * (strlen(path) + 1));
+    strcpy(cached_files[num_cached_files].path, path);
+    cached_files[num_cached_files].fd = fd;
+    num_cached_files++;
   }
-  buf[offset] = '\0';
 
-  if (close(fd) == -1) {
+  get_scratch_buf();
+  int offset = read_fd(fd, &scratch_buf, &scratch_size, true);
+  if (offset == -1) {
     return NULL;
   }
 
   *len = offset;
-  return buf;
+  return scratch_buf;
+}
+
+// Closes the files kept open by read_file_cached and
+// releases the buffer shared with read_file_scratch
+void close_cached_files(void) {
+  for(int i=0; i < num_cached_files; i++) {
+    close(cached_files[i].fd);
+    free(cached_files[i].path);
+  }
+  num_cached_files = 0;
+
+  free(scratch_buf);
+  scratch_buf = NULL;
+  scratch_size = 0;
+}
+
+// Returns the (non-negative) integer contained in path, or -1 on failure
+long get_long_from_file(char* path) {
+  int filelen;
+  char* buf;
+  if((buf = read_file_scratch(path, &filelen)) == NULL) {
+    printWarn("Could not open '%s'", path);
+    return -1;
+  }
+
+  char* end;
+  errno = 0;
+  long ret = strtol(buf, &end, 10);
+  if(errno != 0 || end == buf) {
+    printWarn("get_long_from_file: Invalid data was read from file '%s'", path);
+    ret = -1;
+  }
+
+  return ret;
+}
+
+// Parses a file containing a CPU list (e.g., shared_cpu_list or
+// thread_siblings_list, which look like "0-3,8-11"), returning the
+// number of CPUs in the list and storing the first CPU in first_cpu.
+// Returns -1 on failure.
+int get_cpu_list_from_file(char* path, int* first_cpu) {
+  int filelen;
+  char* buf;
+  if((buf = read_file_scratch(path, &filelen)) == NULL) {
+    printWarn("Could not open '%s'", path);
+    return -1;
+  }
+
+  int ncpus = 0;
+  char* ptr = buf;
+  char* end;
+  *first_cpu = -1;
+
+  while(*ptr != '\0' && *ptr != '\n') {
+    long start_cpu = strtol(ptr, &end, 10);
+    long end_cpu = start_cpu;
+    if(end == ptr) break;
+    ptr = end;
+
+    if(*ptr == '-') {
+      ptr++;
+      end_cpu = strtol(ptr, &end, 10);
+      if(end == ptr) break;
+      ptr = end;
+    }
+
+    if(*first_cpu == -1) *first_cpu = start_cpu;
+    ncpus += end_cpu - start_cpu + 1;
+
+    if(*ptr == ',') ptr++;
+  }
+
+  if(ncpus <= 0 || *first_cpu < 0) {
+    printWarn("get_cpu_list_from_file: Invalid data was read from file '%s'", path);
+    return -1;
+  }
+  return ncpus;
 }
 
 long get_freq_from_file(char* path) {
   int filelen;
   char* buf;
-  if((buf = read_file(path, &filelen)) == NULL) {
+  if((buf = read_file_scratch(path, &filelen)) == NULL) {
     printWarn("Could not open '%s'", path);
     return UNKNOWN_DATA;
   }
@@ -91,7 +281,6 @@ long get_freq_from_file(char* path) {
   long ret = strtol(buf, &end, 10);
   if(errno != 0) {
     printBug("strtol: %s", strerror(errno));
-    free(buf);
     return UNKNOWN_DATA;
   }
 
@@ -103,15 +292,13 @@ long get_freq_from_file(char* path) {
     return UNKNOWN_DATA;
   }
 
-  free(buf);
-
   return ret/1000;
 }
 
 long get_cache_size_from_file(char* path) {
   int filelen;
   char* buf;
-  if((buf = read_file(path, &filelen)) == NULL) {
+  if((buf = read_file_scratch(path, &filelen)) == NULL) {
     printWarn("Could not open '%s'", path);
     return -1;
   }
@@ -123,33 +310,161 @@ long get_cache_size_from_file(char* path) {
   long ret = strtol(buf, &end, 10);
   if(errno != 0) {
     printBug("strtol: %s", strerror(errno));
-    free(buf);
     return -1;
   }
 
-  free(buf);
-
   return ret * 1024;
 }
 
-char* get_field_from_cpuinfo(char* CPUINFO_FIELD) {
+// /proc/cpuinfo parsed once into an index of lines. Every line of
+// the file is NULL terminated in place, and every processor block is
+// stored as a range of lines, so that querying a field for a given
+// core does not require reading nor scanning the whole file again.
+struct cpuinfo_index {
+  char* buf;
+  char** lines;
+  int num_lines;
+  // Range of lines [block_start, block_end) for each processor block
+  int* block_start;
+  int* block_end;
+  int num_blocks;
+  // Maps the processor number to its block (-1 if not present)
+  int* core_block;
+  int num_cores;
+};
+
+static struct cpuinfo_index* cpuinfo_idx = NULL;
+
+bool is_processor_line(char* line) {
+  return strncmp(line, CPUINFO_PROCESSOR_STR, strlen(CPUINFO_PROCESSOR_STR)) == 0;
+}
+
+struct cpuinfo_index* build_cpuinfo_index(void) {
   int filelen;
   char* buf;
   if((buf = read_file(_PATH_CPUINFO, &filelen)) == NULL) {
-    printWarn("read_file: %s: %s:\n", _PATH_CPUINFO, strerror(errno));
+    printWarn("read_file: %s: %s", _PATH_CPUINFO, strerror(errno));
     return NULL;
   }
 
-  char* tmp1 = strstr(buf, CPUINFO_FIELD);
-  if(tmp1 == NULL) return NULL;
-  tmp1 = tmp1 + strlen(CPUINFO_FIELD);
-  char* tmp2 = strstr(tmp1, "\n");
+  struct cpuinfo_index* idx = emalloc(sizeof(struct cpuinfo_index));
+  idx->buf = buf;
+
+  // 1. Split the buffer in lines
+  int max_lines = 1;
+  for(int i=0; i < filelen; i++) {
+    max_lines += (buf[i] == '\n');
+  }
 
-  int strlen = (1 + (tmp2-tmp1));
-  char* hardware = ecalloc(strlen, sizeof(char));
-  strncpy(hardware, tmp1, tmp2-tmp1);
+  idx->lines = emalloc(sizeof(char *) * max_lines);
+  idx->num_lines = 0;
+  idx->num_blocks = 0;
+
+  char* ptr = buf;
+  while(ptr < buf + filelen) {
+    char* eol = memchr(ptr, '\n', (buf + filelen) - ptr);
+    if(eol != NULL) *eol = '\0';
+    idx->lines[idx->num_lines++] = ptr;
+    if(is_processor_line(ptr)) idx->num_blocks++;
+    ptr = (eol == NULL) ? buf + filelen : eol + 1;
+  }
 
-  return hardware;
+  // 2. Find the processor blocks. A block starts with a processor line
+  // and ends with the first empty line (or the next processor line)
+  idx->block_start = emalloc(sizeof(int) * (idx->num_blocks + 1));
+  idx->block_end = emalloc(sizeof(int) * (idx->num_blocks + 1));
+  int* block_core = emalloc(sizeof(int) * (idx->num_blocks + 1));
+  int max_core = -1;
+  int b = -1;
+
+  for(int i=0; i < idx->num_lines; i++) {
+    char* line = idx->lines[i];
+    if(is_processor_line(line)) {
+      if(b >= 0 && idx->block_end[b] == -1) idx->block_end[b] = i;
+      b++;
+      idx->block_start[b] = i;
+      idx->block_end[b] = -1;
+
+      // processor lines look like "processor\t: N"
+      char* sep = strchr(line, ':');
+      char* end;
+      errno = 0;
+      int core = (sep == NULL) ? -1 : (int) strtol(sep + 1, &end, 10);
+      if(sep == NULL || errno != 0 || end == sep + 1 || core < 0) {
+        printWarn("build_cpuinfo_index: Unable to parse processor line '%s', assuming %d", line, b);
+        core = b;
+      }
+      block_core[b] = core;
+      max_core = max(max_core, core);
+    }
+    else if(b >= 0 && idx->block_end[b] == -1 && *line == '\0') {
+      idx->block_end[b] = i;
+    }
+  }
+  if(b >= 0 && idx->block_end[b] == -1) idx->block_end[b] = idx->num_lines;
+
+  // 3. Map every processor number to its block
+  idx->num_cores = max_core + 1;
+  idx->core_block = emalloc(sizeof(int) * (idx->num_cores + 1));
+  for(int i=0; i < idx->num_cores; i++) idx->core_block[i] = -1;
+  for(int i=0; i < idx->num_blocks; i++) idx->core_block[block_core[i]] = i;
+
+  free(block_core);
+  return idx;
+}
+
+struct cpuinfo_index* get_cpuinfo_index(void) {
+  if(cpuinfo_idx == NULL) {
+    cpuinfo_idx = build_cpuinfo_index();
+  }
+  return cpuinfo_idx;
+}
+
+char* find_field_in_lines(struct cpuinfo_index* idx, int first, int last, char* CPUINFO_FIELD) {
+  size_t field_len = strlen(CPUINFO_FIELD);
+  for(int i=first; i < last; i++) {
+    if(strncmp(idx->lines[i], CPUINFO_FIELD, field_len) == 0)
+      return idx->lines[i] + field_len;
+  }
+  return NULL;
+}
+
+// Returns a pointer to the value of the field CPUINFO_FIELD (which must
+// include the separator, e.g., "Hardware\t: ") from /proc/cpuinfo. If
+// core is CPUINFO_ANY_CORE, the first occurrence in the file is returned,
+// otherwise only the block of the processor number core is inspected.
+// The returned string belongs to the index and must not be freed.
+char* get_cpuinfo_field(int32_t core, char* CPUINFO_FIELD) {
+  struct cpuinfo_index* idx = get_cpuinfo_index();
+  if(idx == NULL) return NULL;
+
+  if(core == CPUINFO_ANY_CORE) {
+    return find_field_in_lines(idx, 0, idx->num_lines, CPUINFO_FIELD);
+  }
+
+  if(core < 0 || core >= idx->num_cores || idx->core_block[core] == -1) {
+    return NULL;
+  }
+
+  int b = idx->core_block[core];
+  char* value = find_field_in_lines(idx, idx->block_start[b], idx->block_end[b], CPUINFO_FIELD);
+  if(value != NULL) return value;
+
+  // Some kernels (e.g., old ARM32 ones) print the fields shared by all cores
+  // only once, outside the processor blocks, so look for it there too
+  value = find_field_in_lines(idx, 0, idx->block_start[0], CPUINFO_FIELD);
+  if(value != NULL) return value;
+  return find_field_in_lines(idx, idx->block_end[idx->num_blocks-1], idx->num_lines, CPUINFO_FIELD);
+}
+
+char* get_field_from_cpuinfo(char* CPUINFO_FIELD) {
+  char* value = get_cpuinfo_field(CPUINFO_ANY_CORE, CPUINFO_FIELD);
+  if(value == NULL) return NULL;
+
+  char* field = ecalloc(strlen(value) + 1, sizeof(char));
+  strcpy(field, value);
+
+  return field;
 }
 
 long get_max_freq_from_file(uint32_t core) {
@@ -164,6 +479,22 @@ long get_min_freq_from_file(uint32_t core) {
   return get_freq_from_file(path);
 }
 
+// Clock source used by the kernel for the time (e.g, tsc or hpet), or NULL
+char* get_current_clocksource(void) {
+  int len;
+  char* buf = read_file(_PATH_CLOCKSOURCE, &len);
+  if(buf == NULL) {
+    printWarn("Could not open '%s'", _PATH_CLOCKSOURCE);
+    return NULL;
+  }
+
+  buf[strcspn(buf, "\n")] = '\0';
+  char* clocksource = amalloc(sizeof(char) * (strlen(buf) + 1));
+  strcpy(clocksource, buf);
+  free(buf);
+  return clocksource;
+}
+
 long get_l1i_cache_size(uint32_t core) {
   char path[_PATH_CACHE_MAX_LEN];
   sprintf(path, "%s%s/cpu%d%s%s",  _PATH_SYS_SYSTEM, _PATH_SYS_CPU, core, _PATH_CACHE_L1I, _PATH_CACHE_SIZE);
@@ -188,110 +519,161 @@ long get_l3_cache_size(uint32_t core) {
   return get_cache_size_from_file(path);
 }
 
-void add_shared_map(uint32_t** src, int src_idx, uint32_t** dst, int dst_idx, int n) {
-  for(int j=0; j < n; j++) {
-    dst[dst_idx][j] = src[src_idx][j];
+// Parses a cpumask as printed by the kernel (e.g., shared_cpu_map or
+// package_cpus): comma-separated groups of 32 bits in hexadecimal, with
+// the most significant group first. The mask is stored in mask, which must
+// have room for num_words 64-bit words (bit i is CPU i)
+static bool parse_cpumask(char* buf, uint64_t* mask, int num_words) {
+  memset(mask, 0, sizeof(uint64_t) * num_words);
+
+  int len = strlen(buf);
+  while(len > 0 && (buf[len-1] == '\n' || buf[len-1] == ' ')) len--;
+
+  // Walk the string backwards, so the bit position of every digit is
+  // known without looking ahead
+  int group = 0;
+  int digit = 0;
+  for(int i=len-1; i >= 0; i--) {
+    char c = buf[i];
+    int value;
+
+    if(c == ',') {
+      group++;
+      digit = 0;
+      continue;
+    }
+    if(c >= '0' && c <= '9') value = c - '0';
+    else if(c >= 'a' && c <= 'f') value = c - 'a' + 10;
+    else if(c >= 'A' && c <= 'F') value = c - 'A' + 10;
+    else return false;
+
+    if(digit >= 8) return false;
+    int bit = group * 32 + digit * 4;
+    if(bit / 64 >= num_words) return false;
+    mask[bit / 64] |= (uint64_t) value << (bit % 64);
+    digit++;
+  }
+
+  return len > 0;
+}
+
+// FNV-1a over the words of the mask
+static uint64_t hash_cpumask(uint64_t* mask, int num_words) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for(int i=0; i < num_words; i++) {
+    for(int j=0; j < 64; j += 8) {
+      hash ^= (mask[i] >> j) & 0xFF;
+      hash *= 0x100000001b3ULL;
+    }
   }
+  return hash;
 }
 
-bool maps_equal(uint32_t* map1, uint32_t* map2, int n) {
-  for(int i=0; i < n; i++) {
-    if(map1[i] != map2[i]) return false;
+// Stores in domains the list of CPUs of each of the num_unique masks.
+// All the lists share a single array, so only two allocations are made
+static void cpumasks_to_domains(uint64_t* masks, int num_unique, int num_words, struct cpu_domain** domains) {
+  int total_cpus = 0;
+  for(int i=0; i < num_unique * num_words; i++) {
+    for(uint64_t w = masks[i]; w != 0; w &= w - 1) total_cpus++;
   }
-  return true;
+
+  struct cpu_domain* d = amalloc(sizeof(struct cpu_domain) * (num_unique > 0 ? num_unique : 1));
+  int* cpus = amalloc(sizeof(int) * (total_cpus > 0 ? total_cpus : 1));
+  for(int i=0; i < num_unique; i++) {
+    uint64_t* mask = masks + (size_t) i * num_words;
+    d[i].cpus = cpus;
+    d[i].num_cpus = 0;
+    for(int j=0; j < num_words; j++) {
+      for(int k=0; k < 64 && mask[j] >> k != 0; k++) {
+        if((mask[j] >> k) & 1) d[i].cpus[d[i].num_cpus++] = j * 64 + k;
+      }
+    }
+    cpus += d[i].num_cpus;
+  }
+  *domains = d;
 }
 
-// Generic function to count the number of distinct
-// elements in the list of files passed in char** paths.
-// An element can be potentially anything.
-// We use this function to count:
-// - The number of caches
-// - The number of sockets
-int get_num_elements_from_files(char** paths, int num_paths) {
+// Generic function to find the distinct cpumasks in the list of
+// files passed in char** paths. An element can be potentially anything;
+// we use this function to find:
+// - The caches of a given level
+// - The sockets
+// Returns the number of elements (-1 on failure). If domains is not
+// NULL, it also stores there the list of CPUs spanned by each element,
+// in the order they are first seen
+int get_cpu_domains_from_files(char** paths, int num_paths, struct cpu_domain** domains) {
   int filelen;
   char* buf;
-  char* tmpbuf;
 
-  // 1. Count the number of bitmasks per file
-  if((buf = read_file(paths[0], &filelen)) == NULL) {
+  // 1. Count the number of 32-bit groups per file
+  if((buf = read_file_scratch(paths[0], &filelen)) == NULL) {
     printWarn("Could not open '%s'", paths[0]);
     return -1;
   }
-  int num_bitmasks = 1;
+  int num_groups = 1;
   for(int i=0; buf[i]; i++) {
-    num_bitmasks += (buf[i] == ',');
+    num_groups += (buf[i] == ',');
   }
+  int num_words = (num_groups + 1) / 2;
 
-  // 2. Read map from every core
-  uint32_t** maps = emalloc(sizeof(uint32_t *) * num_paths);
-  for(int i=0; i < num_paths; i++) {
-    maps[i] = emalloc(sizeof(uint32_t) * num_bitmasks);
+  // 2. Read the map from every core and insert it into an open-addressing
+  // hash set, so that every map is only compared with the ones that
+  // share its hash
+  int table_size = 1;
+  while(table_size < num_paths * 2) table_size <<= 1;
+  int* table = emalloc(sizeof(int) * table_size);
+  for(int i=0; i < table_size; i++) table[i] = -1;
 
-    if((buf = read_file(paths[i], &filelen)) == NULL) {
-      printWarn("Could not open '%s'", paths[i]);
-      return -1;
-    }
+  uint64_t* masks = emalloc(sizeof(uint64_t) * num_words * num_paths);
+  uint64_t* hashes = emalloc(sizeof(uint64_t) * num_paths);
+  int num_unique = 0;
 
-    for(int j=0; j < num_bitmasks; j++) {
-      char* end;
-      tmpbuf = emalloc(sizeof(char) * (strlen(buf) + 1));
-      memset(tmpbuf, 0, sizeof(char) * (strlen(buf) + 1));
-      char* commaend = strstr(buf, ",");
-      if(commaend == NULL) {
-        strcpy(tmpbuf, buf);
-      }
-      else {
-        strncpy(tmpbuf, buf, commaend-buf);
-      }
-      errno = 0;
-      long ret = strtol(tmpbuf, &end, 16);
-      if(errno != 0) {
-        printf("strtol: %s", strerror(errno));
-        free(buf);
-        return -1;
-      }
+  for(int i=0; i < num_paths; i++) {
+    uint64_t* mask = masks + (size_t) num_unique * num_words;
 
-      maps[i][j] = (uint32_t) ret;
-      buf = commaend + 1;
-      free(tmpbuf);
+    if((buf = read_file_scratch(paths[i], &filelen)) == NULL) {
+      printWarn("Could not open '%s'", paths[i]);
+      num_unique = -1;
+      break;
     }
-  }
-
-  // 2. Count number of different masks; this is the number of elements
-  int num_elements = 0;
-  bool found = false;
-  uint32_t** unique_maps = emalloc(sizeof(uint32_t *) * num_paths);
-  for(int i=0; i < num_paths; i++) {
-    unique_maps[i] = emalloc(sizeof(uint32_t) * num_bitmasks);
-    for(int j=0; j < num_bitmasks; j++) {
-      unique_maps[i][j] = 0;
+    if(!parse_cpumask(buf, mask, num_words)) {
+      printWarn("get_cpu_domains_from_files: Invalid data was read from file '%s'", paths[i]);
+      num_unique = -1;
+      break;
     }
-  }
 
-  for(int i=0; i < num_paths; i++) {
-    for(int j=0; j < num_paths && !found; j++) {
-      if(maps_equal(maps[i], unique_maps[j], num_bitmasks)) found = true;
+    uint64_t hash = hash_cpumask(mask, num_words);
+    int slot = hash & (table_size - 1);
+    bool found = false;
+    while(table[slot] != -1 && !found) {
+      int u = table[slot];
+      found = hashes[u] == hash && memcmp(masks + (size_t) u * num_words, mask, sizeof(uint64_t) * num_words) == 0;
+      slot = (slot + 1) & (table_size - 1);
     }
     if(!found) {
-      add_shared_map(maps, i, unique_maps, num_elements, num_bitmasks);
-      num_elements++;
+      // The mask was parsed right where the next unique one goes
+      table[slot] = num_unique;
+      hashes[num_unique] = hash;
+      num_unique++;
     }
-    found = false;
   }
 
-  return num_elements;
-}
+  if(num_unique >= 0 && domains != NULL) {
+    cpumasks_to_domains(masks, num_unique, num_words, domains);
+  }
 
-int get_num_caches_from_files(char** paths, int num_paths) {
-  return get_num_elements_from_files(paths, num_paths);
+  free(table);
+  free(masks);
+  free(hashes);
+  return num_unique;
 }
 
-int get_num_sockets_from_files(char** paths, int num_paths) {
-  return get_num_elements_from_files(paths, num_paths);
+static void free_paths(char** paths, int num_paths) {
+  for(int i=0; i < num_paths; i++) free(paths[i]);
+  free(paths);
 }
 
-int get_num_caches_by_level(struct cpuInfo* cpu, uint32_t level) {
-  char** paths = emalloc(sizeof(char *) * cpu->topo->total_cores);
+int get_cache_domains_by_level(struct cpuInfo* cpu, uint32_t level, struct cpu_domain** domains) {
   char* cache_path = NULL;
 
   if(level == 0) cache_path = _PATH_CACHE_L1I;
@@ -303,45 +685,45 @@ int get_num_caches_by_level(struct cpuInfo* cpu, uint32_t level) {
     return -1;
   }
 
+  char** paths = emalloc(sizeof(char *) * cpu->topo->total_cores);
   for(int i=0; i < cpu->topo->total_cores; i++) {
     paths[i] = emalloc(sizeof(char) * _PATH_CACHE_MAX_LEN);
     sprintf(paths[i], "%s%s/cpu%d%s%s",  _PATH_SYS_SYSTEM, _PATH_SYS_CPU, i, cache_path, _PATH_CACHE_SHARED_MAP);
   }
 
-  int ret = get_num_caches_from_files(paths, cpu->topo->total_cores);
-
-  for(int i=0; i < cpu->topo->total_cores; i++)
-    free(paths[i]);
-  free(paths);
-
+  int ret = get_cpu_domains_from_files(paths, cpu->topo->total_cores, domains);
+  free_paths(paths, cpu->topo->total_cores);
   return ret;
 }
 
-int get_num_sockets_package_cpus(struct topology* topo) {
-  // Get number of sockets using
+int get_socket_domains_package_cpus(struct topology* topo, struct cpu_domain** domains) {
+  // Get the sockets using
   // /sys/devices/system/cpu/cpu*/topology/package_cpus
 
   char** paths = emalloc(sizeof(char *) * topo->total_cores);
-
   for(int i=0; i < topo->total_cores; i++) {
     paths[i] = emalloc(sizeof(char) * _PATH_PACKAGE_MAX_LEN);
     sprintf(paths[i], "%s%s/cpu%d%s",  _PATH_SYS_SYSTEM, _PATH_SYS_CPU, i, _PATH_TOPO_PACKAGE_CPUS);
   }
 
-  int ret = get_num_sockets_from_files(paths, topo->total_cores);
+  int ret = get_cpu_domains_from_files(paths, topo->total_cores, domains);
+  free_paths(paths, topo->total_cores);
+  return ret;
+}
 
-  for(int i=0; i < topo->total_cores; i++)
-    free(paths[i]);
-  free(paths);
+int get_num_caches_by_level(struct cpuInfo* cpu, uint32_t level) {
+  return get_cache_domains_by_level(cpu, level, NULL);
+}
 
-  return ret;
+int get_num_sockets_package_cpus(struct topology* topo) {
+  return get_socket_domains_package_cpus(topo, NULL);
 }
 
 // Inspired in is_devtree_compatible from lscpu
 bool is_devtree_compatible(char* str) {
   int filelen;
   char* buf;
-  if((buf = read_file("/proc/device-tree/compatible", &filelen)) == NULL) {
+  if((buf = read_file_scratch("/proc/device-tree/compatible", &filelen)) == NULL) {
     return false;
   }
 
@@ -369,13 +751,8 @@ char* get_devtree_compatible(int *filelen) {
 // "str1,foo1.str2,foo2" (where . denotes the NULL byte, i.e., the separator),
 // then this function will return a list with two structs, the first one
 // containing str1 and foo1 and the other containing str2 and foo2.
-struct devtree** get_devtree_compatible_struct(int *num_vendors_ptr) {
-  int len;
-  char* dt = get_devtree_compatible(&len);
-  if (dt == NULL) {
-    return NULL;
-  }
-
+// dt and len are the contents of the file, as read by get_devtree_compatible.
+struct devtree** get_devtree_compatible_struct(char* dt, int len, int *num_vendors_ptr) {
   int num_vendors = 0;
   char* ptr = dt;
 
@@ -389,7 +766,7 @@ struct devtree** get_devtree_compatible_struct(int *num_vendors_ptr) {
     num_vendors++;
   }
 
-  struct devtree** vendors = emalloc(sizeof(struct devtree *) * num_vendors);
+  struct devtree** vendors = amalloc(sizeof(struct devtree *) * num_vendors);
   ptr = dt;
 
   for (int ptrpos = 0, i = 0; ptrpos < len; ptrpos = (ptr-dt), i++) {
@@ -409,9 +786,9 @@ struct devtree** get_devtree_compatible_struct(int *num_vendors_ptr) {
     int vendor_str_len = (comma_ptr-ptr)+1;
     int model_str_len = (end_ptr-(comma_ptr+2))+1;
 
-    vendors[i] = emalloc(sizeof(struct devtree));
-    vendors[i]->vendor = ecalloc(vendor_str_len, sizeof(char));
-    vendors[i]->model = ecalloc(model_str_len, sizeof(char));
+    vendors[i] = amalloc(sizeof(struct devtree));
+    vendors[i]->vendor = acalloc(vendor_str_len, sizeof(char));
+    vendors[i]->model = acalloc(model_str_len, sizeof(char));
 
     strncpy(vendors[i]->vendor, ptr, vendor_str_len);
     strncpy(vendors[i]->model, comma_ptr+2, model_str_len);
@@ -24,31 +24,61 @@
 #define _PATH_CACHE_L3          "/cache/index3"
 #define _PATH_CACHE_SIZE        "/size"
 #define _PATH_CACHE_SHARED_MAP  "/shared_cpu_map"
+#define _PATH_CACHE_INDEX       "/cache/index"
+#define _PATH_CACHE_LEVEL       "/level"
+#define _PATH_CACHE_TYPE        "/type"
+#define _PATH_CACHE_SHARED_LIST "/shared_cpu_list"
 #define _PATH_CPUS_PRESENT      _PATH_SYS_SYSTEM _PATH_SYS_CPU "/present"
 #define _PATH_TOPO_PACKAGE_CPUS "/topology/package_cpus"
+#define _PATH_TOPO_PACKAGE_ID_SYS "/topology/physical_package_id"
+#define _PATH_TOPO_DIE_ID_SYS   "/topology/die_id"
+#define _PATH_TOPO_CORE_ID_SYS  "/topology/core_id"
+#define _PATH_TOPO_THREAD_SIBL  "/topology/thread_siblings_list"
+#define _PATH_CLOCKSOURCE       _PATH_SYS_SYSTEM "/clocksource/clocksource0/current_clocksource"
+
+#define CPUINFO_PROCESSOR_STR   "processor"
+#define CPUINFO_ANY_CORE        -1
 
 #define _PATH_FREQUENCY_MAX_LEN 100
 #define _PATH_CACHE_MAX_LEN     200
 #define _PATH_PACKAGE_MAX_LEN   200
 
+// A set of CPUs sharing some resource (a cache, a socket...)
+struct cpu_domain {
+  int num_cpus;
+  int* cpus;
+};
+
 struct devtree {
   char* vendor;
   char* model;
 };
 
 char* read_file(char* path, int* len);
+// The content returned by these two is only valid until the next
+// call to any of them (see read_file_scratch)
+char* read_file_scratch(char* path, int* len);
+char* read_file_cached(char* path, int* len);
+void close_cached_files(void);
 long get_max_freq_from_file(uint32_t core);
 long get_min_freq_from_file(uint32_t core);
+char* get_current_clocksource(void);
 long get_l1i_cache_size(uint32_t core);
 long get_l1d_cache_size(uint32_t core);
 long get_l2_cache_size(uint32_t core);
 long get_l3_cache_size(uint32_t core);
+int get_cpu_domains_from_files(char** paths, int num_paths, struct cpu_domain** domains);
+int get_cache_domains_by_level(struct cpuInfo* cpu, uint32_t level, struct cpu_domain** domains);
+int get_socket_domains_package_cpus(struct topology* topo, struct cpu_domain** domains);
 int get_num_caches_by_level(struct cpuInfo* cpu, uint32_t level);
 int get_num_sockets_package_cpus(struct topology* topo);
 int get_ncores_from_cpuinfo(void);
+long get_long_from_file(char* path);
+int get_cpu_list_from_file(char* path, int* first_cpu);
+char* get_cpuinfo_field(int32_t core, char* CPUINFO_FIELD);
 char* get_field_from_cpuinfo(char* CPUINFO_FIELD);
 bool is_devtree_compatible(char* str);
 char* get_devtree_compatible(int *filelen);
-struct devtree** get_devtree_compatible_struct(int *num_vendors);
+struct devtree** get_devtree_compatible_struct(char* dt, int len, int *num_vendors);
 
 #endif
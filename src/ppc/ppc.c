@@ -26,7 +26,7 @@ static char *hv_vendors_name[] = {
 };
 
 struct cache* get_cache_info(struct cpuInfo* cpu) {
-  struct cache* cach = emalloc(sizeof(struct cache));
+  struct cache* cach = amalloc(sizeof(struct cache));
   init_cache_struct(cach);
 
   cach->L1i->size = get_l1i_cache_size(0);
@@ -59,7 +59,7 @@ struct cache* get_cache_info(struct cpuInfo* cpu) {
 }
 
 struct topology* get_topology_info(struct cache* cach) {
-  struct topology* topo = emalloc(sizeof(struct topology));
+  struct topology* topo = amalloc(sizeof(struct topology));
   init_topology_struct(topo, cach);
 
   // 1. Total cores detection
@@ -148,7 +148,7 @@ struct uarch* get_cpu_uarch(struct cpuInfo* cpu) {
 }
 
 struct frequency* get_frequency_info(void) {
-  struct frequency* freq = emalloc(sizeof(struct frequency));
+  struct frequency* freq = amalloc(sizeof(struct frequency));
 
   freq->measured = false;
   freq->max = get_max_freq_from_file(0);
@@ -190,7 +190,7 @@ int64_t get_peak_performance(struct cpuInfo* cpu, struct topology* topo, int64_t
 }
 
 struct hypervisor* get_hp_info(void) {
-  struct hypervisor* hv = emalloc(sizeof(struct hypervisor));
+  struct hypervisor* hv = amalloc(sizeof(struct hypervisor));
   hv->present = false;
 
   // Weird heuristic found in lscpu:
@@ -212,8 +212,8 @@ struct hypervisor* get_hp_info(void) {
 }
 
 struct cpuInfo* get_cpu_info(void) {
-  struct cpuInfo* cpu = emalloc(sizeof(struct cpuInfo));
-  struct features* feat = emalloc(sizeof(struct features));
+  struct cpuInfo* cpu = amalloc(sizeof(struct cpuInfo));
+  struct features* feat = amalloc(sizeof(struct features));
   cpu->feat = feat;
 
   bool *ptr = &(feat->AES);
@@ -222,7 +222,7 @@ struct cpuInfo* get_cpu_info(void) {
   }
 
   int len;
-  char* path = emalloc(sizeof(char) * (strlen(_PATH_DT) + strlen(_PATH_DT_PART) + 1));
+  char* path = amalloc(sizeof(char) * (strlen(_PATH_DT) + strlen(_PATH_DT_PART) + 1));
   sprintf(path, "%s%s", _PATH_DT, _PATH_DT_PART);
 
   if((cpu->cpu_name = read_file(path, &len)) == NULL) {
@@ -241,7 +241,7 @@ struct cpuInfo* get_cpu_info(void) {
 }
 
 char* get_str_altivec(struct cpuInfo* cpu) {
-  char* string = ecalloc(4, sizeof(char));
+  char* string = acalloc(4, sizeof(char));
 
   if(cpu->feat->altivec) strcpy(string, "Yes");
   else strcpy(string, "No");
@@ -253,7 +253,7 @@ char* get_str_topology(struct topology* topo, bool dual_socket) {
   char* string;
   if(topo->smt_supported > 1) {
     uint32_t size = 3+3+17+1;
-    string = emalloc(sizeof(char)*size);
+    string = amalloc(sizeof(char)*size);
     if(dual_socket)
       snprintf(string, size, "%d cores (%d threads)", topo->physical_cores * topo->sockets, topo->logical_cores * topo->sockets);
     else
@@ -261,7 +261,7 @@ char* get_str_topology(struct topology* topo, bool dual_socket) {
   }
   else {
     uint32_t size = 3+7+1;
-    string = emalloc(sizeof(char)*size);
+    string = amalloc(sizeof(char)*size);
     if(dual_socket)
       snprintf(string, size, "%d cores",topo->physical_cores * topo->sockets);
     else
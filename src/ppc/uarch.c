@@ -7,6 +7,8 @@
 
 #include "uarch.h"
 #include "../common/global.h"
+#include "../common/args.h"
+#include "../common/uarchdb.h"
 
 typedef uint32_t MICROARCH;
 
@@ -51,10 +53,39 @@ struct uarch {
   int32_t process; // measured in nanometers
 };
 
-#define UARCH_START if (false) {}
-#define CHECK_UARCH(arch, cpu_pvr, pvr_mask, pvr_value, uarch) \
-   else if ((cpu_pvr & pvr_mask) == pvr_value) fill_uarch(arch, uarch);
-#define UARCH_END else { printBug("Unknown microarchitecture detected: 0x%.8X", pvr); fill_uarch(arch, UARCH_UNKNOWN); }
+// Used to parse the uarch database file
+static const char* uarch_names[] = {
+  [UARCH_UNKNOWN]     = "UNKNOWN",
+  [UARCH_PPC604]      = "PPC604",
+  [UARCH_PPCG3]       = "PPCG3",
+  [UARCH_PPCG4]       = "PPCG4",
+  [UARCH_PPC405]      = "PPC405",
+  [UARCH_PPC603]      = "PPC603",
+  [UARCH_PPC440]      = "PPC440",
+  [UARCH_PPC470]      = "PPC470",
+  [UARCH_ESPRESSO]    = "ESPRESSO",
+  [UARCH_PPC970]      = "PPC970",
+  [UARCH_PPC970FX]    = "PPC970FX",
+  [UARCH_PPC970MP]    = "PPC970MP",
+  [UARCH_CELLBE]      = "CELLBE",
+  [UARCH_POWER5]      = "POWER5",
+  [UARCH_POWER5PLUS]  = "POWER5PLUS",
+  [UARCH_POWER6]      = "POWER6",
+  [UARCH_POWER7]      = "POWER7",
+  [UARCH_POWER7PLUS]  = "POWER7PLUS",
+  [UARCH_POWER8]      = "POWER8",
+  [UARCH_POWER8_DD21] = "POWER8_DD21",
+  [UARCH_POWER9]      = "POWER9",
+  [UARCH_POWER9_DD20] = "POWER9_DD20",
+  [UARCH_POWER9_DD21] = "POWER9_DD21",
+  [UARCH_POWER9_DD22] = "POWER9_DD22",
+  [UARCH_POWER9_DD23] = "POWER9_DD23",
+  [UARCH_POWER10]     = "POWER10",
+};
+
+// The signature is the PVR itself
+#define UARCH_ENTRY(pvr_mask, pvr_value, uarch) \
+  { pvr_mask, pvr_value, uarch, NULL, UNK, NA, NA },
 
 #define FILL_START if (false) {}
 #define FILL_UARCH(u, uarch, uarch_str, uarch_process) \
@@ -97,7 +128,7 @@ void fill_uarch(struct uarch* arch, MICROARCH u) {
   FILL_END
 
   if(fill) {
-    arch->uarch_str = emalloc(sizeof(char) * (strlen(str)+1));
+    arch->uarch_str = amalloc(sizeof(char) * (strlen(str)+1));
     strcpy(arch->uarch_str, str);
     arch->process= process;
   }
@@ -120,124 +151,160 @@ void fill_uarch(struct uarch* arch, MICROARCH u) {
  * This list may be incorrect, incomplete or overly simplified,
  * specially in the case of 32 bit entries
  */
-struct uarch* get_uarch_from_pvr(uint32_t pvr) {
-  struct uarch* arch = emalloc(sizeof(struct uarch));
-
-  UARCH_START
+static const struct uarch_db_entry uarch_table[] = {
   // 64 bit
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x00390000, UARCH_PPC970)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x003c0000, UARCH_PPC970FX)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x00440100, UARCH_PPC970MP)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x00440000, UARCH_PPC970MP)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x003a0000, UARCH_POWER5)
-  CHECK_UARCH(arch, pvr, 0xffffff00, 0x003b0300, UARCH_POWER5PLUS)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x003b0000, UARCH_POWER5)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x0f000001, UARCH_POWER5)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x003e0000, UARCH_POWER6)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x0f000002, UARCH_POWER6)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x0f000003, UARCH_POWER7)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x0f000004, UARCH_POWER8)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x0f000005, UARCH_POWER9)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x0f000006, UARCH_POWER10)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x003f0000, UARCH_POWER7)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x004A0000, UARCH_POWER7PLUS)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x004b0000, UARCH_POWER8_DD21)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x004c0000, UARCH_POWER8)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x004d0000, UARCH_POWER8)
-  CHECK_UARCH(arch, pvr, 0xffffefff, 0x004e0200, UARCH_POWER9_DD20)
-  CHECK_UARCH(arch, pvr, 0xffffefff, 0x004e0201, UARCH_POWER9_DD21)
-  CHECK_UARCH(arch, pvr, 0xffffefff, 0x004e0202, UARCH_POWER9_DD22)
-  CHECK_UARCH(arch, pvr, 0xffffefff, 0x004e0203, UARCH_POWER9_DD23)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x00800000, UARCH_POWER10)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x00700000, UARCH_CELLBE)
+  UARCH_ENTRY(0xffff0000, 0x00390000, UARCH_PPC970)
+  UARCH_ENTRY(0xffff0000, 0x003c0000, UARCH_PPC970FX)
+  UARCH_ENTRY(0xffffffff, 0x00440100, UARCH_PPC970MP)
+  UARCH_ENTRY(0xffff0000, 0x00440000, UARCH_PPC970MP)
+  UARCH_ENTRY(0xffff0000, 0x003a0000, UARCH_POWER5)
+  UARCH_ENTRY(0xffffff00, 0x003b0300, UARCH_POWER5PLUS)
+  UARCH_ENTRY(0xffff0000, 0x003b0000, UARCH_POWER5)
+  UARCH_ENTRY(0xffffffff, 0x0f000001, UARCH_POWER5)
+  UARCH_ENTRY(0xffff0000, 0x003e0000, UARCH_POWER6)
+  UARCH_ENTRY(0xffffffff, 0x0f000002, UARCH_POWER6)
+  UARCH_ENTRY(0xffffffff, 0x0f000003, UARCH_POWER7)
+  UARCH_ENTRY(0xffffffff, 0x0f000004, UARCH_POWER8)
+  UARCH_ENTRY(0xffffffff, 0x0f000005, UARCH_POWER9)
+  UARCH_ENTRY(0xffffffff, 0x0f000006, UARCH_POWER10)
+  UARCH_ENTRY(0xffff0000, 0x003f0000, UARCH_POWER7)
+  UARCH_ENTRY(0xffff0000, 0x004A0000, UARCH_POWER7PLUS)
+  UARCH_ENTRY(0xffff0000, 0x004b0000, UARCH_POWER8_DD21)
+  UARCH_ENTRY(0xffff0000, 0x004c0000, UARCH_POWER8)
+  UARCH_ENTRY(0xffff0000, 0x004d0000, UARCH_POWER8)
+  UARCH_ENTRY(0xffffefff, 0x004e0200, UARCH_POWER9_DD20)
+  UARCH_ENTRY(0xffffefff, 0x004e0201, UARCH_POWER9_DD21)
+  UARCH_ENTRY(0xffffefff, 0x004e0202, UARCH_POWER9_DD22)
+  UARCH_ENTRY(0xffffefff, 0x004e0203, UARCH_POWER9_DD23)
+  UARCH_ENTRY(0xffff0000, 0x00800000, UARCH_POWER10)
+  UARCH_ENTRY(0xffff0000, 0x00700000, UARCH_CELLBE)
   // 32 bit
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x00040000, UARCH_PPC604)
-  CHECK_UARCH(arch, pvr, 0xfffff000, 0x00090000, UARCH_PPC604)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x00090000, UARCH_PPC604)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x000a0000, UARCH_PPC604)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x00084202, UARCH_PPCG3)
-  CHECK_UARCH(arch, pvr, 0xfffffff0, 0x00080100, UARCH_PPCG3)
-  CHECK_UARCH(arch, pvr, 0xfffffff0, 0x00082200, UARCH_PPCG3)
-  CHECK_UARCH(arch, pvr, 0xfffffff0, 0x00082210, UARCH_PPCG3)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x00083214, UARCH_PPCG3)
-  CHECK_UARCH(arch, pvr, 0xfffff0e0, 0x00087000, UARCH_PPCG3)
-  CHECK_UARCH(arch, pvr, 0xfffff000, 0x00083000, UARCH_PPCG3)
-  CHECK_UARCH(arch, pvr, 0xffffff00, 0x70000100, UARCH_PPCG3)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x70000200, UARCH_PPCG3)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x70000000, UARCH_PPCG3)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x70020000, UARCH_PPCG3)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x00080000, UARCH_PPCG3)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x000c1101, UARCH_PPCG4)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x000c0000, UARCH_PPCG4)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x800c0000, UARCH_PPCG4)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x80000200, UARCH_PPCG4)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x80000201, UARCH_PPCG4)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x80000000, UARCH_PPCG4)
-  CHECK_UARCH(arch, pvr, 0xffffff00, 0x80010100, UARCH_PPCG4)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x80010200, UARCH_PPCG4)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x80010000, UARCH_PPCG4)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x80020100, UARCH_PPCG4)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x80020101, UARCH_PPCG4)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x80020000, UARCH_PPCG4)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x80030000, UARCH_PPCG4)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x80040000, UARCH_PPCG4)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x00030000, UARCH_PPC603)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x00060000, UARCH_PPC603)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x00070000, UARCH_PPC603)
-  CHECK_UARCH(arch, pvr, 0x7fff0000, 0x00810000, UARCH_PPC603)
-  CHECK_UARCH(arch, pvr, 0x7fff0000, 0x00820000, UARCH_PPC603)
-  CHECK_UARCH(arch, pvr, 0x7fff0000, 0x00830000, UARCH_PPC603)
-  CHECK_UARCH(arch, pvr, 0x7fff0000, 0x00840000, UARCH_PPC603)
-  CHECK_UARCH(arch, pvr, 0x7fff0000, 0x00850000, UARCH_PPC603)
-  CHECK_UARCH(arch, pvr, 0x7fff0000, 0x00860000, UARCH_PPC603)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x41810000, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x41610000, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x40B10000, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x41410000, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x50910000, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x51510000, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x41F10000, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x51210000, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff000f, 0x12910007, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff000f, 0x1291000d, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff000f, 0x1291000f, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff000f, 0x12910003, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff000f, 0x12910005, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff000f, 0x12910001, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff000f, 0x12910009, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff000f, 0x1291000b, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff000f, 0x12910000, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff000f, 0x12910002, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x41510000, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x7ff11432, UARCH_PPC405)
-  CHECK_UARCH(arch, pvr, 0xf0000fff, 0x40000850, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xf0000fff, 0x40000858, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xf0000fff, 0x400008d3, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xf0000ff7, 0x400008d4, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xf0000fff, 0x400008db, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xf0000ffb, 0x200008D0, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xf0000ffb, 0x200008D8, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xf0000fff, 0x40000440, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xf0000fff, 0x40000481, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xf0000fff, 0x50000850, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xf0000fff, 0x50000851, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xf0000fff, 0x50000892, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xf0000fff, 0x50000894, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xfff00fff, 0x53200891, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xfff00fff, 0x53400890, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xfff00fff, 0x53400891, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xffff0006, 0x13020002, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xffff0007, 0x13020004, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xffff0006, 0x13020000, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xffff0007, 0x13020005, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xffffff00, 0x13541800, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xfffffff0, 0x12C41C80, UARCH_PPC440)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x11a52080, UARCH_PPC470)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x7ff50000, UARCH_PPC470)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x00050000, UARCH_PPC470)
-  CHECK_UARCH(arch, pvr, 0xffff0000, 0x11a50000, UARCH_PPC470)
-  CHECK_UARCH(arch, pvr, 0xffffffff, 0x70010201, UARCH_ESPRESSO)
-  UARCH_END
+  UARCH_ENTRY(0xffff0000, 0x00040000, UARCH_PPC604)
+  UARCH_ENTRY(0xfffff000, 0x00090000, UARCH_PPC604)
+  UARCH_ENTRY(0xffff0000, 0x00090000, UARCH_PPC604)
+  UARCH_ENTRY(0xffff0000, 0x000a0000, UARCH_PPC604)
+  UARCH_ENTRY(0xffffffff, 0x00084202, UARCH_PPCG3)
+  UARCH_ENTRY(0xfffffff0, 0x00080100, UARCH_PPCG3)
+  UARCH_ENTRY(0xfffffff0, 0x00082200, UARCH_PPCG3)
+  UARCH_ENTRY(0xfffffff0, 0x00082210, UARCH_PPCG3)
+  UARCH_ENTRY(0xffffffff, 0x00083214, UARCH_PPCG3)
+  UARCH_ENTRY(0xfffff0e0, 0x00087000, UARCH_PPCG3)
+  UARCH_ENTRY(0xfffff000, 0x00083000, UARCH_PPCG3)
+  UARCH_ENTRY(0xffffff00, 0x70000100, UARCH_PPCG3)
+  UARCH_ENTRY(0xffffffff, 0x70000200, UARCH_PPCG3)
+  UARCH_ENTRY(0xffff0000, 0x70000000, UARCH_PPCG3)
+  UARCH_ENTRY(0xffff0000, 0x70020000, UARCH_PPCG3)
+  UARCH_ENTRY(0xffff0000, 0x00080000, UARCH_PPCG3)
+  UARCH_ENTRY(0xffffffff, 0x000c1101, UARCH_PPCG4)
+  UARCH_ENTRY(0xffff0000, 0x000c0000, UARCH_PPCG4)
+  UARCH_ENTRY(0xffff0000, 0x800c0000, UARCH_PPCG4)
+  UARCH_ENTRY(0xffffffff, 0x80000200, UARCH_PPCG4)
+  UARCH_ENTRY(0xffffffff, 0x80000201, UARCH_PPCG4)
+  UARCH_ENTRY(0xffff0000, 0x80000000, UARCH_PPCG4)
+  UARCH_ENTRY(0xffffff00, 0x80010100, UARCH_PPCG4)
+  UARCH_ENTRY(0xffffffff, 0x80010200, UARCH_PPCG4)
+  UARCH_ENTRY(0xffff0000, 0x80010000, UARCH_PPCG4)
+  UARCH_ENTRY(0xffffffff, 0x80020100, UARCH_PPCG4)
+  UARCH_ENTRY(0xffffffff, 0x80020101, UARCH_PPCG4)
+  UARCH_ENTRY(0xffff0000, 0x80020000, UARCH_PPCG4)
+  UARCH_ENTRY(0xffff0000, 0x80030000, UARCH_PPCG4)
+  UARCH_ENTRY(0xffff0000, 0x80040000, UARCH_PPCG4)
+  UARCH_ENTRY(0xffff0000, 0x00030000, UARCH_PPC603)
+  UARCH_ENTRY(0xffff0000, 0x00060000, UARCH_PPC603)
+  UARCH_ENTRY(0xffff0000, 0x00070000, UARCH_PPC603)
+  UARCH_ENTRY(0x7fff0000, 0x00810000, UARCH_PPC603)
+  UARCH_ENTRY(0x7fff0000, 0x00820000, UARCH_PPC603)
+  UARCH_ENTRY(0x7fff0000, 0x00830000, UARCH_PPC603)
+  UARCH_ENTRY(0x7fff0000, 0x00840000, UARCH_PPC603)
+  UARCH_ENTRY(0x7fff0000, 0x00850000, UARCH_PPC603)
+  UARCH_ENTRY(0x7fff0000, 0x00860000, UARCH_PPC603)
+  UARCH_ENTRY(0xffff0000, 0x41810000, UARCH_PPC405)
+  UARCH_ENTRY(0xffff0000, 0x41610000, UARCH_PPC405)
+  UARCH_ENTRY(0xffff0000, 0x40B10000, UARCH_PPC405)
+  UARCH_ENTRY(0xffff0000, 0x41410000, UARCH_PPC405)
+  UARCH_ENTRY(0xffff0000, 0x50910000, UARCH_PPC405)
+  UARCH_ENTRY(0xffff0000, 0x51510000, UARCH_PPC405)
+  UARCH_ENTRY(0xffff0000, 0x41F10000, UARCH_PPC405)
+  UARCH_ENTRY(0xffff0000, 0x51210000, UARCH_PPC405)
+  UARCH_ENTRY(0xffff000f, 0x12910007, UARCH_PPC405)
+  UARCH_ENTRY(0xffff000f, 0x1291000d, UARCH_PPC405)
+  UARCH_ENTRY(0xffff000f, 0x1291000f, UARCH_PPC405)
+  UARCH_ENTRY(0xffff000f, 0x12910003, UARCH_PPC405)
+  UARCH_ENTRY(0xffff000f, 0x12910005, UARCH_PPC405)
+  UARCH_ENTRY(0xffff000f, 0x12910001, UARCH_PPC405)
+  UARCH_ENTRY(0xffff000f, 0x12910009, UARCH_PPC405)
+  UARCH_ENTRY(0xffff000f, 0x1291000b, UARCH_PPC405)
+  UARCH_ENTRY(0xffff000f, 0x12910000, UARCH_PPC405)
+  UARCH_ENTRY(0xffff000f, 0x12910002, UARCH_PPC405)
+  UARCH_ENTRY(0xffff0000, 0x41510000, UARCH_PPC405)
+  UARCH_ENTRY(0xffff0000, 0x7ff11432, UARCH_PPC405)
+  UARCH_ENTRY(0xf0000fff, 0x40000850, UARCH_PPC440)
+  UARCH_ENTRY(0xf0000fff, 0x40000858, UARCH_PPC440)
+  UARCH_ENTRY(0xf0000fff, 0x400008d3, UARCH_PPC440)
+  UARCH_ENTRY(0xf0000ff7, 0x400008d4, UARCH_PPC440)
+  UARCH_ENTRY(0xf0000fff, 0x400008db, UARCH_PPC440)
+  UARCH_ENTRY(0xf0000ffb, 0x200008D0, UARCH_PPC440)
+  UARCH_ENTRY(0xf0000ffb, 0x200008D8, UARCH_PPC440)
+  UARCH_ENTRY(0xf0000fff, 0x40000440, UARCH_PPC440)
+  UARCH_ENTRY(0xf0000fff, 0x40000481, UARCH_PPC440)
+  UARCH_ENTRY(0xf0000fff, 0x50000850, UARCH_PPC440)
+  UARCH_ENTRY(0xf0000fff, 0x50000851, UARCH_PPC440)
+  UARCH_ENTRY(0xf0000fff, 0x50000892, UARCH_PPC440)
+  UARCH_ENTRY(0xf0000fff, 0x50000894, UARCH_PPC440)
+  UARCH_ENTRY(0xfff00fff, 0x53200891, UARCH_PPC440)
+  UARCH_ENTRY(0xfff00fff, 0x53400890, UARCH_PPC440)
+  UARCH_ENTRY(0xfff00fff, 0x53400891, UARCH_PPC440)
+  UARCH_ENTRY(0xffff0006, 0x13020002, UARCH_PPC440)
+  UARCH_ENTRY(0xffff0007, 0x13020004, UARCH_PPC440)
+  UARCH_ENTRY(0xffff0006, 0x13020000, UARCH_PPC440)
+  UARCH_ENTRY(0xffff0007, 0x13020005, UARCH_PPC440)
+  UARCH_ENTRY(0xffffff00, 0x13541800, UARCH_PPC440)
+  UARCH_ENTRY(0xfffffff0, 0x12C41C80, UARCH_PPC440)
+  UARCH_ENTRY(0xffffffff, 0x11a52080, UARCH_PPC470)
+  UARCH_ENTRY(0xffff0000, 0x7ff50000, UARCH_PPC470)
+  UARCH_ENTRY(0xffff0000, 0x00050000, UARCH_PPC470)
+  UARCH_ENTRY(0xffff0000, 0x11a50000, UARCH_PPC470)
+  UARCH_ENTRY(0xffffffff, 0x70010201, UARCH_ESPRESSO)
+};
+
+// MASK VALUE UARCH
+static bool parse_uarch_db_entry(char** tok, int num_tokens, struct uarch_db_entry* entry) {
+  int64_t mask, value;
+
+  if(num_tokens != 3) {
+    printErr("Expected 3 fields, found %d", num_tokens);
+    return false;
+  }
+
+  if(!uarch_db_parse_int(tok[0], 0, UINT32_MAX, &mask) || !uarch_db_parse_int(tok[1], 0, UINT32_MAX, &value)) {
+    return false;
+  }
+
+  entry->uarch = uarch_db_parse_symbol(tok[2], uarch_names, sizeof(uarch_names) / sizeof(uarch_names[0]));
+  if(entry->uarch < 0) return false;
+
+  // NA matches any PVR, just like a zero mask
+  entry->mask = mask == NA ? 0 : (uint64_t) mask;
+  entry->value = value == NA ? 0 : (uint64_t) value;
+  return true;
+}
+
+struct uarch* get_uarch_from_pvr(uint32_t pvr) {
+  static struct uarch_db* db = NULL;
+  struct uarch* arch = amalloc(sizeof(struct uarch));
+
+  if(db == NULL) {
+    db = uarch_db_build(uarch_table, sizeof(uarch_table) / sizeof(uarch_table[0]), get_uarch_db_file(), parse_uarch_db_entry);
+  }
+
+  const struct uarch_db_entry* entry = uarch_db_lookup(db, pvr);
+  if(entry == NULL) {
+    printBug("Unknown microarchitecture detected: 0x%.8X", pvr);
+    fill_uarch(arch, UARCH_UNKNOWN);
+  }
+  else {
+    fill_uarch(arch, entry->uarch);
+  }
 
   return arch;
 }
@@ -277,7 +344,7 @@ char* get_str_uarch(struct cpuInfo* cpu) {
 }
 
 char* get_str_process(struct cpuInfo* cpu) {
-  char* str = emalloc(sizeof(char) * (strlen(STRING_UNKNOWN)+1));
+  char* str = amalloc(sizeof(char) * (strlen(STRING_UNKNOWN)+1));
   int32_t process = cpu->arch->process;
 
   if(process == UNK) {
@@ -293,8 +360,3 @@ char* get_str_process(struct cpuInfo* cpu) {
 
   return str;
 }
-
-void free_uarch_struct(struct uarch* arch) {
-  free(arch->uarch_str);
-  free(arch);
-}
@@ -11,6 +11,5 @@ bool has_altivec(struct uarch* arch);
 bool is_power9(struct uarch* arch);
 char* get_str_uarch(struct cpuInfo* cpu);
 char* get_str_process(struct cpuInfo* cpu);
-void free_uarch_struct(struct uarch* arch);
 
 #endif
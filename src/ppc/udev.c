@@ -13,11 +13,11 @@ bool fill_array_from_sys(int *core_ids, int total_cores, char* SYS_PATH) {
   char* buf;
   char* end;
   char path[128];
-  memset(name, 0, sizeof(char) * 128);
+  memset(path, 0, sizeof(char) * 128);
 
   for(int i=0; i < total_cores; i++) {
     sprintf(path, "%s%s/cpu%d/%s", _PATH_SYS_SYSTEM, _PATH_SYS_CPU, i, SYS_PATH);
-    if((buf = read_file(path, &filelen)) == NULL) {
+    if((buf = read_file_scratch(path, &filelen)) == NULL) {
       printWarn("fill_array_from_sys: %s: %s", path, strerror(errno));
       return false;
     }
@@ -28,7 +28,6 @@ bool fill_array_from_sys(int *core_ids, int total_cores, char* SYS_PATH) {
       printWarn("fill_array_from_sys: %s:", strerror(errno));
       return false;
     }
-    free(buf);
   }
 
   return true;
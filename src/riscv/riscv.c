@@ -17,7 +17,7 @@
   }                                         \
 
 struct frequency* get_frequency_info(uint32_t core) {
-  struct frequency* freq = emalloc(sizeof(struct frequency));
+  struct frequency* freq = amalloc(sizeof(struct frequency));
 
   freq->measured = false;
   freq->base = UNKNOWN_DATA;
@@ -49,7 +49,7 @@ int parse_multi_letter_extension(struct extensions* ext, char* e) {
 
   int multi_letter_extension_len = multi_letter_extension_end-(e+1);
   bool maskset = false;
-  char* multi_letter_extension = emalloc(multi_letter_extension_len);
+  char* multi_letter_extension = amalloc(multi_letter_extension_len);
   strncpy(multi_letter_extension, e+1, multi_letter_extension_len);
   // This should be up-to-date with
   // https://elixir.bootlin.com/linux/latest/source/arch/riscv/kernel/cpufeature.c
@@ -151,8 +151,8 @@ bool valid_extension(char ext) {
 }
 
 struct extensions* get_extensions_from_str(char* str) {
-  struct extensions* ext = emalloc(sizeof(struct extensions));
-  ext->mask = ecalloc(RISCV_ISA_EXT_ID_MAX, sizeof(bool));
+  struct extensions* ext = amalloc(sizeof(struct extensions));
+  ext->mask = acalloc(RISCV_ISA_EXT_ID_MAX, sizeof(bool));
   ext->str = NULL;
 
   if(str == NULL) {
@@ -160,7 +160,7 @@ struct extensions* get_extensions_from_str(char* str) {
   }
 
   int len = strlen(str)+1;
-  ext->str = emalloc(len * sizeof(char));
+  ext->str = amalloc(len * sizeof(char));
   strncpy(ext->str, str, sizeof(char) * len);
 
   // Code inspired in Linux kernel (riscv_fill_hwcap):
@@ -222,15 +222,15 @@ bool is_mask_empty(bool* mask) {
 }
 
 struct cpuInfo* get_cpu_info(void) {
-  struct cpuInfo* cpu = malloc(sizeof(struct cpuInfo));
+  struct cpuInfo* cpu = amalloc(sizeof(struct cpuInfo));
   //init_cpu_info(cpu);
-  struct topology* topo = emalloc(sizeof(struct topology));
+  struct topology* topo = amalloc(sizeof(struct topology));
   topo->total_cores = get_ncores_from_cpuinfo();
   topo->cach = NULL;
   cpu->topo = topo;
 
   char* ext_str = get_extensions_from_cpuinfo();
-  cpu->hv = emalloc(sizeof(struct hypervisor));
+  cpu->hv = amalloc(sizeof(struct hypervisor));
   cpu->hv->present = false;
   cpu->ext = get_extensions_from_str(ext_str);
   if(cpu->ext->str != NULL && is_mask_empty(cpu->ext->mask)) return NULL;
@@ -245,7 +245,7 @@ struct cpuInfo* get_cpu_info(void) {
 //TODO: Might be worth refactoring with other archs
 char* get_str_topology(struct cpuInfo* cpu, struct topology* topo) {
   uint32_t size = 3+7+1;
-  char* string = emalloc(sizeof(char)*size);
+  char* string = amalloc(sizeof(char)*size);
   snprintf(string, size, "%d cores", topo->total_cores);
 
   return string;
@@ -75,7 +75,7 @@ struct system_on_chip* guess_soc_from_devtree(struct system_on_chip* soc) {
 }
 
 struct system_on_chip* get_soc(struct cpuInfo* cpu) {
-  struct system_on_chip* soc = emalloc(sizeof(struct system_on_chip));
+  struct system_on_chip* soc = amalloc(sizeof(struct system_on_chip));
   soc->raw_name = NULL;
   soc->vendor = SOC_VENDOR_UNKNOWN;
   soc->model = SOC_MODEL_UNKNOWN;
@@ -94,7 +94,7 @@ struct system_on_chip* get_soc(struct cpuInfo* cpu) {
   if(soc->model == SOC_MODEL_UNKNOWN) {
     // raw_name might not be NULL, but if we were unable to find
     // the exact SoC, just print "Unkwnown"
-    soc->raw_name = emalloc(sizeof(char) * (strlen(STRING_UNKNOWN)+1));
+    soc->raw_name = amalloc(sizeof(char) * (strlen(STRING_UNKNOWN)+1));
     snprintf(soc->raw_name, strlen(STRING_UNKNOWN)+1, STRING_UNKNOWN);
   }
 
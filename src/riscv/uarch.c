@@ -41,7 +41,7 @@ enum {
 void fill_uarch(struct uarch* arch, struct cpuInfo* cpu, char* str, MICROARCH u, VENDOR vendor) {
   arch->uarch = u;
   cpu->cpu_vendor = vendor;
-  arch->uarch_str = emalloc(sizeof(char) * (strlen(str)+1));
+  arch->uarch_str = amalloc(sizeof(char) * (strlen(str)+1));
   strcpy(arch->uarch_str, str);
 }
 
@@ -85,7 +85,7 @@ struct uarch* get_uarch_from_riscv_cpuinfo(struct cpuInfo* cpu, struct uarch* ar
 
 struct uarch* get_uarch(struct cpuInfo* cpu) {
   char* cpuinfo_str = get_uarch_from_cpuinfo();
-  struct uarch* arch = emalloc(sizeof(struct uarch));
+  struct uarch* arch = amalloc(sizeof(struct uarch));
   arch->uarch = UARCH_UNKNOWN;
   arch->ci = NULL;
 
@@ -115,8 +115,3 @@ char* get_str_uarch(struct cpuInfo* cpu) {
 char* get_arch_cpuinfo_str(struct cpuInfo* cpu) {
   return cpu->arch->cpuinfo_str;
 }
-
-void free_uarch_struct(struct uarch* arch) {
-  free(arch->uarch_str);
-  free(arch);
-}
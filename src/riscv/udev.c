@@ -50,45 +50,18 @@ char* get_field_from_devtree(int DEVTREE_FIELD) {
 }
 
 char* parse_cpuinfo_field(char* field_str) {
-  int filelen;
-  char* buf;
-  if((buf = read_file(_PATH_CPUINFO, &filelen)) == NULL) {
-    printWarn("read_file: %s: %s", _PATH_CPUINFO, strerror(errno));
-    return NULL;
-  }
-
-  char* tmp = strstr(buf, field_str);
-  if(tmp == NULL) {
+  char* ret = get_field_from_cpuinfo(field_str);
+  if(ret == NULL) {
     printWarn("parse_cpuinfo_field: Unable to find field %s", field_str);
     return NULL;
   }
 
-  tmp += strlen(field_str);
-  char* end = strstr(tmp, "\n");
-
-  if(end == NULL) {
-    printWarn("parse_cpuinfo_field: Unable to find newline after field %s", field_str);
-    return NULL;
-  }
-
-  int ret_strlen = (end-tmp);
-  char* ret = ecalloc(ret_strlen+1, sizeof(char));
-  strncpy(ret, tmp, sizeof(char) * ret_strlen);
-
   return ret;
 }
 
 unsigned long parse_cpuinfo_field_uint64(char* field_str) {
-  int filelen;
-  char* buf;
-  if((buf = read_file(_PATH_CPUINFO, &filelen)) == NULL) {
-    printWarn("read_file: %s: %s", _PATH_CPUINFO, strerror(errno));
-    return 0;
-  }
-
-  char* tmp = strstr(buf, field_str);
+  char* tmp = get_cpuinfo_field(CPUINFO_ANY_CORE, field_str);
   if(tmp == NULL) return 0;
-  tmp += strlen(field_str);
 
   char* end;
   errno = 0;
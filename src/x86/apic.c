@@ -18,6 +18,7 @@
 
 #include "apic.h"
 #include "cpuid_asm.h"
+#include "cpuid_percpu.h"
 #include "../common/global.h"
 
 /*
@@ -72,33 +73,52 @@ uint32_t get_apic_id(bool x2apic_id) {
   }
 }
 
+#ifndef __APPLE__
+// Returns the raw core type (leaf 0x1A) of core, reading it from
+// the snapshot if available or binding to the core otherwise
+int32_t get_core_type_id(struct cpuid_snapshot* snap, int core) {
+  struct cpuid_regs regs;
+  if(cpuid_snapshot_get(snap, core, 0x0000001A, 0, &regs)) {
+    return regs.eax >> 24 & 0xFF;
+  }
+
+  if(!bind_to_cpu(core)) {
+    return -1;
+  }
+  uint32_t eax = 0x0000001A;
+  uint32_t ebx = 0;
+  uint32_t ecx = 0;
+  uint32_t edx = 0;
+  cpuid(&eax, &ebx, &ecx, &edx);
+  return eax >> 24 & 0xFF;
+}
+#endif
+
 #ifdef __linux__
-int get_total_cores_module(int total_cores, int module) {
+int get_total_cores_module(struct cpuid_snapshot* snap, int total_cores, int module) {
   int total_modules = 2;
   int32_t current_module_idx = -1;
   bool end = false;
-  int32_t* core_types = emalloc(sizeof(uint32_t) * total_modules);
-  for(int i=0; i < total_modules; i++) core_types[i] = -1;
   int cores_in_module = 0;
   int i = 0;
 
-  // Get the original mask to restore it later
+  // Get the original mask to restore it later. get_core_type_id
+  // binds to the cores missing from the snapshot (if any)
   cpu_set_t original_mask;
   if(sched_getaffinity(0, sizeof(original_mask), &original_mask) == -1) {
     printWarn("sched_getaffinity: %s", strerror(errno));
-    return false;
+    return -1;
   }
 
+  int32_t* core_types = emalloc(sizeof(uint32_t) * total_modules);
+  for(int j=0; j < total_modules; j++) core_types[j] = -1;
+
   while(!end) {
-    if(!bind_to_cpu(i)) {
-      return -1;
+    int32_t core_type = get_core_type_id(snap, i);
+    if(core_type == -1) {
+      cores_in_module = -1;
+      break;
     }
-    uint32_t eax = 0x0000001A;
-    uint32_t ebx = 0;
-    uint32_t ecx = 0;
-    uint32_t edx = 0;
-    cpuid(&eax, &ebx, &ecx, &edx);
-    int32_t core_type = eax >> 24 & 0xFF;
     bool found = false;
 
     for(int j=0; j < total_modules && !found; j++) {
@@ -116,10 +136,12 @@ int get_total_cores_module(int total_cores, int module) {
     i++;
   }
 
+  free(core_types);
+
   // Reset the original affinity
   if (sched_setaffinity (0, sizeof(original_mask), &original_mask) == -1) {
     printWarn("sched_setaffinity: %s", strerror(errno));
-    return false;
+    return -1;
   }
 
   //printf("Module %d has %d cores\n", module, cores_in_module);
@@ -318,7 +340,25 @@ void add_apic_to_array(uint32_t apic, uint32_t* apic_ids, int n) {
   }
 }
 
-bool fill_apic_ids(uint32_t* apic_ids, int first_core, int n, bool x2apic_id) {
+bool fill_apic_ids_from_snapshot(struct cpuid_snapshot* snap, uint32_t* apic_ids, int first_core, int n, bool x2apic_id) {
+  struct cpuid_regs regs;
+  uint32_t leaf = x2apic_id ? 0x0000000B : 0x00000001;
+
+  for(int i=0; i < n; i++) {
+    if(!cpuid_snapshot_get(snap, first_core + i, leaf, 0, &regs)) {
+      return false;
+    }
+    apic_ids[i] = x2apic_id ? regs.edx : (regs.ebx >> 24);
+  }
+
+  return true;
+}
+
+bool fill_apic_ids(struct cpuid_snapshot* snap, uint32_t* apic_ids, int first_core, int n, bool x2apic_id) {
+  if(fill_apic_ids_from_snapshot(snap, apic_ids, first_core, n, x2apic_id)) {
+    return true;
+  }
+
 #ifdef __APPLE__
   // macOS extremely dirty approach...
   UNUSED(first_core);
@@ -336,6 +376,23 @@ bool fill_apic_ids(uint32_t* apic_ids, int first_core, int n, bool x2apic_id) {
   }
 #else
   #ifdef __linux__
+  // In Linux, the APIC IDs are read concurrently on every CPU by
+  // workers pinned to them, avoiding migrating the process to each CPU
+  struct cpuid_leaf leaf;
+  leaf.leaf = x2apic_id ? 0x0000000B : 0x00000001;
+  leaf.subleaf = 0;
+  struct cpuid_regs* regs = emalloc(sizeof(struct cpuid_regs) * n);
+
+  if(cpuid_on_cpus(first_core, n, &leaf, 1, regs)) {
+    for(int i=0; i < n; i++) {
+      apic_ids[i] = x2apic_id ? regs[i].edx : (regs[i].ebx >> 24);
+    }
+    free(regs);
+    return true;
+  }
+  free(regs);
+  printWarn("Failed to read APIC IDs concurrently, binding to every CPU instead");
+
   // In Linux we reset the affinity; first we get the original mask
   cpu_set_t original_mask;
   if(sched_getaffinity(0, sizeof(original_mask), &original_mask) == -1) {
@@ -398,22 +455,23 @@ bool get_topology_from_apic(struct cpuInfo* cpu, struct topology* topo) {
     cache_smt_id_apic[i] = emalloc(sizeof(uint32_t) * (topo->cach->max_cache_level));
     cache_id_apic[i] = emalloc(sizeof(uint32_t) * (topo->cach->max_cache_level));
   }
-  topo->apic->cache_select_mask = emalloc(sizeof(uint32_t) * (topo->cach->max_cache_level));
-  topo->apic->cache_id_apic = emalloc(sizeof(uint32_t) * (topo->cach->max_cache_level));
+  topo->apic->cache_select_mask = amalloc(sizeof(uint32_t) * (topo->cach->max_cache_level));
+  topo->apic->cache_id_apic = amalloc(sizeof(uint32_t) * (topo->cach->max_cache_level));
 
+  bool ret = false;
   if(x2apic_id) {
     if(!fill_topo_masks_x2apic(topo))
-      return false;
+      goto cleanup;
   }
   else {
     if(!fill_topo_masks_apic(topo))
-      return false;
+      goto cleanup;
   }
 
   get_cache_topology_from_apic(topo);
 
-  if(!fill_apic_ids(apic_ids, cpu->first_core_id, topo->total_cores_module, x2apic_id))
-    return false;
+  if(!fill_apic_ids(cpu->cpuid_snap, apic_ids, cpu->first_core_id, topo->total_cores_module, x2apic_id))
+    goto cleanup;
 
   for(int i=0; i < topo->total_cores_module; i++) {
     apic_id = apic_ids[i];
@@ -444,7 +502,7 @@ bool get_topology_from_apic(struct cpuInfo* cpu, struct topology* topo) {
   for(int i=0; i < topo->total_cores_module; i++)
     printf("[%2d] 0x%.8X\n", i, apic_smt[i]);*/
 
-  bool ret = build_topo_from_apic(apic_pkg, apic_smt, cache_id_apic, topo);
+  ret = build_topo_from_apic(apic_pkg, apic_smt, cache_id_apic, topo);
 
   // Assumption: If we cant get smt_available, we assume it is equal to smt_supported...
   if (!x2apic_id) {
@@ -452,6 +510,8 @@ bool get_topology_from_apic(struct cpuInfo* cpu, struct topology* topo) {
     topo->smt_supported = topo->smt_available;
   }
 
+cleanup:
+  free(apic_ids);
   free(apic_pkg);
   free(apic_core);
   free(apic_smt);
@@ -465,14 +525,22 @@ bool get_topology_from_apic(struct cpuInfo* cpu, struct topology* topo) {
   return ret;
 }
 
-uint32_t is_smt_enabled_amd(struct topology* topo) {
+uint32_t is_smt_enabled_amd(struct cpuid_snapshot* snap, struct topology* topo) {
+  struct cpuid_regs regs;
+  uint32_t id;
+  int i = 0;
+
+  // Read the APIC IDs from the snapshot if available
+  for(; i < topo->total_cores && cpuid_snapshot_get(snap, i, 0x00000001, 0, &regs); i++) {
+    id = (regs.ebx >> 24) & 1; // get the last bit
+    if(id == 1) return 2; // We assume there isn't any AMD CPU with more than 2th per core.
+  }
+  if(i == topo->total_cores) return 1;
+
 #ifdef __APPLE__
-  UNUSED(topo);
   return 1;
 #else
-  uint32_t id;
-
-  for(int i = 0; i < topo->total_cores; i++) {
+  for(; i < topo->total_cores; i++) {
     if(!bind_to_cpu(i)) {
       printErr("Failed binding to CPU %d", i);
       return false;
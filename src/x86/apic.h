@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include "cpuid.h"
+#include "cpuid_percpu.h"
 
 struct apic {
   uint32_t pkg_mask;
@@ -15,10 +16,14 @@ struct apic {
 };
 
 bool get_topology_from_apic(struct cpuInfo* cpu, struct topology* topo);
-uint32_t is_smt_enabled_amd(struct topology* topo);
+uint32_t is_smt_enabled_amd(struct cpuid_snapshot* snap, struct topology* topo);
+
+#ifndef __APPLE__
+int32_t get_core_type_id(struct cpuid_snapshot* snap, int core);
+#endif
 
 #ifdef __linux__
-int get_total_cores_module(int total_cores, int module);
+int get_total_cores_module(struct cpuid_snapshot* snap, int total_cores, int module);
 #endif
 
 #endif
@@ -24,7 +24,9 @@
 #include "../common/global.h"
 #include "../common/args.h"
 #include "apic.h"
+#include "cpuid_percpu.h"
 #include "uarch.h"
+#include "tsc.h"
 #include "freq/freq.h"
 
 #define CPU_VENDOR_INTEL_STRING "GenuineIntel"
@@ -91,7 +93,7 @@ char* get_str_cpu_name_internal(void) {
   uint32_t edx = 0;
   uint32_t c = 0;
 
-  char * name = ecalloc(CPU_NAME_MAX_LENGTH, sizeof(char));
+  char * name = acalloc(CPU_NAME_MAX_LENGTH, sizeof(char));
 
   for(int i=0; i < 3; i++) {
     eax = 0x80000002 + i;
@@ -133,7 +135,7 @@ char* get_str_cpu_name_internal(void) {
 
 bool abbreviate_intel_cpu_name(char** name) {
   char* old_name = *name;
-  char* new_name = ecalloc(strlen(old_name) + 1, sizeof(char));
+  char* new_name = acalloc(strlen(old_name) + 1, sizeof(char));
 
   char* old_name_ptr = old_name;
   char* new_name_ptr = new_name;
@@ -169,7 +171,6 @@ bool abbreviate_intel_cpu_name(char** name) {
   strremove(new_name, " Dual");
   strremove(new_name, " 0");
 
-  free(old_name);
   *name = new_name;
 
   return true;
@@ -254,8 +255,13 @@ int64_t get_peak_performance(struct cpuInfo* cpu, bool accurate_pp) {
   return total_flops;
 }
 
+char* get_hv_vendor_name(VENDOR hv_vendor) {
+  if(hv_vendor < 0 || hv_vendor > HV_VENDOR_INVALID) return hv_vendors_name[HV_VENDOR_INVALID];
+  return hv_vendors_name[hv_vendor];
+}
+
 struct hypervisor* get_hp_info(bool hv_present) {
-  struct hypervisor* hv = emalloc(sizeof(struct hypervisor));
+  struct hypervisor* hv = amalloc(sizeof(struct hypervisor));
   if(!hv_present) {
     hv->present = false;
     return hv;
@@ -300,13 +306,38 @@ struct hypervisor* get_hp_info(bool hv_present) {
   return hv;
 }
 
+struct hypervisor* get_hv_info(struct cpuInfo* cpu) {
+  bool hv_present = false;
+
+  if (cpu->maxLevels >= 0x00000001) {
+    uint32_t eax = 0x00000001;
+    uint32_t ebx = 0;
+    uint32_t ecx = 0;
+    uint32_t edx = 0;
+    cpuid(&eax, &ebx, &ecx, &edx);
+    hv_present = (ecx & (1U << 31)) != 0;
+  }
+
+  struct hypervisor* hv = get_hp_info(hv_present);
+  if(hv->present) {
+    // Hypervisor will likely mess up something and users will think that
+    // there is something wrong with cpufetch whereas actually cpufetch has
+    // nothing to do with it.
+    // https://github.com/Dr-Noob/cpufetch/issues/96
+    // https://github.com/Dr-Noob/cpufetch/issues/267
+    // https://github.com/Dr-Noob/cpufetch/issues/293
+    printWarn("You are running an hypervisor. Please note that it will likely tamper your results, so do not post an issue if you find anything incorrect");
+  }
+  return hv;
+}
+
 struct features* get_features_info(struct cpuInfo* cpu) {
   uint32_t eax = 0;
   uint32_t ebx = 0;
   uint32_t ecx = 0;
   uint32_t edx = 0;
 
-  struct features* feat = emalloc(sizeof(struct features));
+  struct features* feat = amalloc(sizeof(struct features));
 
   bool *ptr = &(feat->AES);
   for(uint32_t i = 0; i < sizeof(struct features)/sizeof(bool); i++, ptr++) {
@@ -329,19 +360,6 @@ struct features* get_features_info(struct cpuInfo* cpu) {
 
     feat->AVX    = (ecx & (1U << 28)) != 0;
     feat->FMA3   = (ecx & (1U << 12)) != 0;
-
-    bool hv_present = (ecx & (1U << 31)) != 0;
-    if((cpu->hv = get_hp_info(hv_present)) == NULL)
-      return NULL;
-    if(cpu->hv->present) {
-      // Hypervisor will likely mess up something and users will think that
-      // there is something wrong with cpufetch whereas actually cpufetch has
-      // nothing to do with it.
-      // https://github.com/Dr-Noob/cpufetch/issues/96
-      // https://github.com/Dr-Noob/cpufetch/issues/267
-      // https://github.com/Dr-Noob/cpufetch/issues/293
-      printWarn("You are running an hypervisor. Please note that it will likely tamper your results, so do not post an issue if you find anything incorrect");
-    }
   }
   else {
     printWarn("Can't read features information from cpuid (needed level is 0x%.8X, max is 0x%.8X)", 0x00000001, cpu->maxLevels);
@@ -353,6 +371,8 @@ struct features* get_features_info(struct cpuInfo* cpu) {
     cpuid(&eax, &ebx, &ecx, &edx);
     feat->AVX2         = (ebx & (1U <<  5)) != 0;
     feat->SHA          = (ebx & (1U << 29)) != 0;
+    feat->AMX          = ((edx & (1U << 24)) != 0) &&
+                         ((edx & (1U << 22)) != 0);
     feat->AVX512       = (((ebx & (1U << 16)) != 0) ||
                         ((ebx & (1U << 28)) != 0)  ||
                         ((ebx & (1U << 26)) != 0)  ||
@@ -379,9 +399,10 @@ struct features* get_features_info(struct cpuInfo* cpu) {
   return feat;
 }
 
-bool set_cpu_module(int m, int total_modules, int32_t* first_core) {
+bool set_cpu_module(struct cpuid_snapshot* snap, int m, int total_modules, int32_t* first_core) {
   if(total_modules > 1) {
     #ifdef __APPLE__
+    UNUSED(snap);
     UNUSED(m);
     printBug("Hybrid architectures are not supported under macOS");
     return false;
@@ -395,15 +416,10 @@ bool set_cpu_module(int m, int total_modules, int32_t* first_core) {
     int i = 0;
 
     while(core_id == -1) {
-      if(!bind_to_cpu(i)) {
+      int32_t core_type = get_core_type_id(snap, i);
+      if(core_type == -1) {
         return false;
       }
-      uint32_t eax = 0x0000001A;
-      uint32_t ebx = 0;
-      uint32_t ecx = 0;
-      uint32_t edx = 0;
-      cpuid(&eax, &ebx, &ecx, &edx);
-      int32_t core_type = eax >> 24 & 0xFF;
       bool found = false;
 
       for(int j=0; j < total_modules && !found; j++) {
@@ -419,6 +435,7 @@ bool set_cpu_module(int m, int total_modules, int32_t* first_core) {
 
       i++;
     }
+    free(core_types);
 
     *first_core = core_id;
 
@@ -437,14 +454,19 @@ bool set_cpu_module(int m, int total_modules, int32_t* first_core) {
   return true;
 }
 
-int32_t get_core_type(void) {
+int32_t get_core_type(struct cpuid_snapshot* snap, int core) {
   uint32_t eax = 0x0000001A;
   uint32_t ebx = 0;
   uint32_t ecx = 0;
   uint32_t edx = 0;
+  struct cpuid_regs regs;
 
-  eax = 0x0000001A;
-  cpuid(&eax, &ebx, &ecx, &edx);
+  if(cpuid_snapshot_get(snap, core, 0x0000001A, 0, &regs)) {
+    eax = regs.eax;
+  }
+  else {
+    cpuid(&eax, &ebx, &ecx, &edx);
+  }
 
   int32_t type = eax >> 24 & 0xFF;
   if(type == 0x20) return CORE_TYPE_EFFICIENCY;
@@ -455,6 +477,59 @@ int32_t get_core_type(void) {
   }
 }
 
+// Name of the core type in the frequency map (NULL if not hybrid)
+const char* get_str_core_type(struct cpuInfo* cpu, int core) {
+  if(!cpu->hybrid_flag) return NULL;
+
+  int32_t type = get_core_type(cpu->cpuid_snap, core);
+  if(type == CORE_TYPE_EFFICIENCY) return "E-core";
+  if(type == CORE_TYPE_PERFORMANCE) return "P-core";
+  return NULL;
+}
+
+// Ask the OS the total number of cores it sees
+int32_t get_total_cores_from_os(void) {
+  #ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+  #else
+    int32_t total_cores;
+    if((total_cores = sysconf(_SC_NPROCESSORS_ONLN)) == -1) {
+      printWarn("sysconf(_SC_NPROCESSORS_ONLN): %s", strerror(errno));
+    }
+    return total_cores;
+  #endif
+}
+
+// Captures the leaves that are needed from every core (and not only from
+// the first core of each module), so that the topology detection does not
+// need to migrate to every core once per pass.
+struct cpuid_snapshot* get_cpuid_snapshot_cpu(struct cpuInfo* cpu) {
+  struct cpuid_leaf leaves[3];
+  int nleaves = 0;
+  int32_t total_cores = get_total_cores_from_os();
+
+  if(total_cores <= 0) return NULL;
+  // Only the topology and the hybrid modules need it
+  if(!probe_enabled(PROBE_TOPOLOGY) && !cpu->hybrid_flag) return NULL;
+
+  if(cpu->maxLevels >= 0x00000001) {
+    leaves[nleaves].leaf = 0x00000001;
+    leaves[nleaves++].subleaf = 0;
+  }
+  if(cpu->maxLevels >= 0x0000000B) {
+    leaves[nleaves].leaf = 0x0000000B;
+    leaves[nleaves++].subleaf = 0;
+  }
+  if(cpu->hybrid_flag && cpu->maxLevels >= 0x0000001A) {
+    leaves[nleaves].leaf = 0x0000001A;
+    leaves[nleaves++].subleaf = 0;
+  }
+
+  return get_cpuid_snapshot(leaves, nleaves, total_cores);
+}
+
 #ifdef __linux__
 // Gets the max frequency for estimating the peak performance,
 // filling in the passed cpuInfo parameter with this information.
@@ -464,7 +539,7 @@ void fill_frequency_info_pp(struct cpuInfo* cpu) {
   struct cpuInfo* ptr = cpu;
 
   for (uint32_t i=0; i < cpu->num_cpus; i++) {
-    set_cpu_module(i, cpu->num_cpus, &unused);
+    set_cpu_module(cpu->cpuid_snap, i, cpu->num_cpus, &unused);
 
     ptr->freq->max_pp = measure_frequency(ptr, max_freq_pp_vec);
     ptr = ptr->next_cpu;
@@ -473,12 +548,14 @@ void fill_frequency_info_pp(struct cpuInfo* cpu) {
 #endif
 
 struct cpuInfo* get_cpu_info(void) {
-  struct cpuInfo* cpu = emalloc(sizeof(struct cpuInfo));
+  struct cpuInfo* cpu = amalloc(sizeof(struct cpuInfo));
   cpu->peak_performance = -1;
   cpu->next_cpu = NULL;
   cpu->topo = NULL;
   cpu->cach = NULL;
   cpu->feat = NULL;
+  cpu->freq = NULL;
+  cpu->cpuid_snap = NULL;
 
   cpu->num_cpus = 1;
   uint32_t eax = 0;
@@ -486,6 +563,7 @@ struct cpuInfo* get_cpu_info(void) {
   uint32_t ecx = 0;
   uint32_t edx = 0;
 
+  TRACE_BEGIN(TRACE_PHASE_VENDOR);
   //Get max cpuid level
   cpuid(&eax, &ebx, &ecx, &edx);
   cpu->maxLevels = eax;
@@ -504,6 +582,7 @@ struct cpuInfo* get_cpu_info(void) {
   else {
     cpu->cpu_vendor = CPU_VENDOR_INVALID;
     printErr("Unknown CPU vendor: %s", name);
+    TRACE_END(TRACE_PHASE_VENDOR);
     return NULL;
   }
 
@@ -539,14 +618,20 @@ struct cpuInfo* get_cpu_info(void) {
   }
 
   if(cpu->hybrid_flag) cpu->num_cpus = 2;
+  TRACE_END(TRACE_PHASE_VENDOR);
+
+  // The snapshot is mostly used to build the topology
+  TRACE_BEGIN(TRACE_PHASE_TOPOLOGY);
+  cpu->cpuid_snap = get_cpuid_snapshot_cpu(cpu);
+  TRACE_END(TRACE_PHASE_TOPOLOGY);
 
   struct cpuInfo* ptr = cpu;
   for(uint32_t i=0; i < cpu->num_cpus; i++) {
     int32_t first_core;
-    set_cpu_module(i, cpu->num_cpus, &first_core);
+    set_cpu_module(cpu->cpuid_snap, i, cpu->num_cpus, &first_core);
 
     if(i > 0) {
-      ptr->next_cpu = emalloc(sizeof(struct cpuInfo));
+      ptr->next_cpu = amalloc(sizeof(struct cpuInfo));
       ptr = ptr->next_cpu;
       ptr->next_cpu = NULL;
       ptr->peak_performance = -1;
@@ -559,48 +644,92 @@ struct cpuInfo* get_cpu_info(void) {
       ptr->maxLevels = cpu->maxLevels;
       ptr->maxExtendedLevels = cpu->maxExtendedLevels;
       ptr->hybrid_flag = cpu->hybrid_flag;
+      ptr->cpuid_snap = cpu->cpuid_snap;
     }
 
     if(cpu->hybrid_flag) {
       // Detect core type
-      eax = 0x0000001A;
-      cpuid(&eax, &ebx, &ecx, &edx);
-      ptr->core_type = get_core_type();
+      ptr->core_type = get_core_type(cpu->cpuid_snap, first_core);
     }
     ptr->first_core_id = first_core;
     ptr->module_id = i;
-    ptr->feat = get_features_info(ptr);
-
+    ptr->freq = NULL;
+    TRACE_BEGIN(TRACE_PHASE_FEATURES);
+    ptr->hv = get_hv_info(ptr);
+    if(probe_enabled(PROBE_FEATURES))
+      ptr->feat = get_features_info(ptr);
+    TRACE_END(TRACE_PHASE_FEATURES);
+
+    TRACE_BEGIN(TRACE_PHASE_UARCH);
     ptr->arch = get_cpu_uarch(ptr);
-    ptr->freq = get_frequency_info(ptr);
+    TRACE_END(TRACE_PHASE_UARCH);
+
+    if(probe_enabled(PROBE_FREQUENCY)) {
+      TRACE_BEGIN(TRACE_PHASE_FREQUENCY);
+      ptr->freq = get_frequency_info(ptr);
+      TRACE_END(TRACE_PHASE_FREQUENCY);
+    }
 
     if (cpu->cpu_name == NULL && ptr == cpu) {
       // If we couldnt read CPU name from cpuid, infer it now
       cpu->cpu_name = infer_cpu_name_from_uarch(cpu->arch);
     }
 
-    ptr->cach = get_cache_info(ptr);
-
-    if(cpu->hybrid_flag) {
-      ptr->topo = get_topology_info(ptr, ptr->cach, i);
+    if(probe_enabled(PROBE_CACHE)) {
+      TRACE_BEGIN(TRACE_PHASE_CACHE);
+      ptr->cach = get_cache_info(ptr);
+      TRACE_END(TRACE_PHASE_CACHE);
     }
-    else {
-      ptr->topo = get_topology_info(ptr, ptr->cach, -1);
+
+    if(probe_enabled(PROBE_TOPOLOGY)) {
+      TRACE_BEGIN(TRACE_PHASE_TOPOLOGY);
+      if(cpu->hybrid_flag) {
+        ptr->topo = get_topology_info(ptr, ptr->cach, i);
+      }
+      else {
+        ptr->topo = get_topology_info(ptr, ptr->cach, -1);
+      }
+      TRACE_END(TRACE_PHASE_TOPOLOGY);
+
+      // If topo is NULL, return early, as get_peak_performance
+      // requries non-NULL topology.
+      if(ptr->topo == NULL) return cpu;
     }
+  }
 
-    // If topo is NULL, return early, as get_peak_performance
-    // requries non-NULL topology.
-    if(ptr->topo == NULL) return cpu;
+#ifdef __linux__
+  // All the CPUs were measured at once, so the ones that
+  // are not in the frequency map yet just need to be added
+  int32_t total_cores;
+  if(freq_map_enabled() && measure_max_frequency_flag() && probe_enabled(PROBE_FREQUENCY) &&
+     (total_cores = get_total_cores_from_os()) > 0) {
+    const char** core_types = emalloc(sizeof(char *) * total_cores);
+    for(int i=0; i < total_cores; i++) core_types[i] = get_str_core_type(cpu, i);
+    measure_max_frequency_map(total_cores, core_types);
+    free(core_types);
   }
+#endif
+
+  if(!probe_enabled(PROBE_PEAK)) return cpu;
 
+  TRACE_BEGIN(TRACE_PHASE_PEAK);
 #ifdef __linux__
   // If accurate_pp is requested, we need to get the max frequency
   // after fetching the topology for all CPU modules, since the topology
-  // is required by fill_frequency_info_pp
-  if (accurate_pp()) fill_frequency_info_pp(cpu);
+  // is required by fill_frequency_info_pp. The longer measurements go
+  // last, so that their max_pp (the sustained frequency of the kernel
+  // that get_peak_performance assumes) takes precedence
+  bool measured_pp = accurate_pp() || turbo_curve_enabled() || isa_freq_enabled() || soak_enabled();
+  if (turbo_curve_enabled()) measure_turbo_curve(cpu);
+  if (isa_freq_enabled()) measure_isa_freq(cpu);
+  if (soak_enabled()) measure_soak(cpu, get_soak_seconds());
+  if (accurate_pp() && !turbo_curve_enabled() && !isa_freq_enabled() && !soak_enabled()) fill_frequency_info_pp(cpu);
+#else
+  bool measured_pp = accurate_pp();
 #endif
 
-  cpu->peak_performance = get_peak_performance(cpu, accurate_pp());
+  cpu->peak_performance = get_peak_performance(cpu, measured_pp);
+  TRACE_END(TRACE_PHASE_PEAK);
 
   return cpu;
 }
@@ -703,10 +832,232 @@ void get_topology_from_udev(struct topology* topo) {
 }
 #endif
 
+#ifdef __linux__
+int cmp_int64(const void* a, const void* b) {
+  int64_t x = *(const int64_t*) a;
+  int64_t y = *(const int64_t*) b;
+  return (x > y) - (x < y);
+}
+
+// Returns the number of distinct values in v (v is sorted in the process)
+int count_distinct(int64_t* v, int n) {
+  if(n == 0) return 0;
+
+  qsort(v, n, sizeof(int64_t), cmp_int64);
+  int distinct = 1;
+  for(int i=1; i < n; i++) {
+    if(v[i] != v[i-1]) distinct++;
+  }
+  return distinct;
+}
+
+// Maps a cache from sysfs to its index in cach_arr (-1 if unknown)
+int get_cache_arr_idx_from_sysfs(int core, int index) {
+  char path[_PATH_CACHE_MAX_LEN];
+  int filelen;
+  char* type;
+
+  sprintf(path, "%s%s/cpu%d%s%d%s", _PATH_SYS_SYSTEM, _PATH_SYS_CPU, core, _PATH_CACHE_INDEX, index, _PATH_CACHE_LEVEL);
+  long level = get_long_from_file(path);
+  if(level == -1) return -1;
+
+  sprintf(path, "%s%s/cpu%d%s%d%s", _PATH_SYS_SYSTEM, _PATH_SYS_CPU, core, _PATH_CACHE_INDEX, index, _PATH_CACHE_TYPE);
+  if((type = read_file_scratch(path, &filelen)) == NULL) {
+    printWarn("Could not open '%s'", path);
+    return -1;
+  }
+
+  int idx = -1;
+  if(level == 1 && strncmp(type, "Instruction", strlen("Instruction")) == 0) idx = 0;
+  else if(level == 1 && strncmp(type, "Data", strlen("Data")) == 0) idx = 1;
+  else if(level == 2 && strncmp(type, "Unified", strlen("Unified")) == 0) idx = 2;
+  else if(level == 3 && strncmp(type, "Unified", strlen("Unified")) == 0) idx = 3;
+
+  return idx;
+}
+
+// Counts the number of caches of each level shared by the cpus of the
+// module. Every cache is identified by the first CPU of its shared_cpu_list
+bool get_cache_topology_from_sysfs(int* cpus, struct topology* topo) {
+  char path[_PATH_CACHE_MAX_LEN];
+  int64_t* cache_ids = emalloc(sizeof(int64_t) * topo->total_cores_module);
+  int found = 0;
+
+  for(int index=0; ; index++) {
+    sprintf(path, "%s%s/cpu%d%s%d", _PATH_SYS_SYSTEM, _PATH_SYS_CPU, cpus[0], _PATH_CACHE_INDEX, index);
+    if(access(path, F_OK) != 0) break;
+
+    int idx = get_cache_arr_idx_from_sysfs(cpus[0], index);
+    if(idx == -1) continue;
+
+    for(int i=0; i < topo->total_cores_module; i++) {
+      int first_cpu;
+      sprintf(path, "%s%s/cpu%d%s%d%s", _PATH_SYS_SYSTEM, _PATH_SYS_CPU, cpus[i], _PATH_CACHE_INDEX, index, _PATH_CACHE_SHARED_LIST);
+      if(get_cpu_list_from_file(path, &first_cpu) == -1) {
+        free(cache_ids);
+        return false;
+      }
+      cache_ids[i] = first_cpu;
+    }
+
+    topo->cach->cach_arr[idx]->num_caches = count_distinct(cache_ids, topo->total_cores_module);
+    found++;
+  }
+
+  free(cache_ids);
+  return found > 0;
+}
+
+// Number of threads per core supported by the CPU, which may be
+// greater than smt_available if SMT is disabled
+uint32_t get_smt_supported_from_cpuid(struct cpuInfo* cpu, uint32_t smt_available) {
+  if(cpu->maxLevels >= 0x0000000B) {
+    uint32_t eax = 0x0000000B;
+    uint32_t ebx = 0;
+    uint32_t ecx = 0;
+    uint32_t edx = 0;
+    cpuid(&eax, &ebx, &ecx, &edx);
+
+    // Level type 1 is SMT
+    if(ebx != 0 && ((ecx >> 8) & 0xFF) == 1 && (ebx & 0xFFFF) >= smt_available) {
+      return ebx & 0xFFFF;
+    }
+  }
+  return smt_available;
+}
+
+// Fills cpus with the CPUs of the module, which are the ones with the
+// same core type as its first core in hybrid CPUs (the modules are not
+// necessarily numbered contiguously). The core types are read from the
+// snapshot, so that no code runs on the rest of the cores. Returns false
+// if they are not there or the number of CPUs found does not match
+bool get_module_cpus(struct cpuInfo* cpu, struct topology* topo, int* cpus) {
+  struct cpuid_regs regs;
+  int n = 0;
+
+  if(!cpu->hybrid_flag) {
+    for(; n < topo->total_cores_module; n++) cpus[n] = n;
+    return true;
+  }
+
+  if(!cpuid_snapshot_get(cpu->cpuid_snap, cpu->first_core_id, 0x0000001A, 0, &regs)) return false;
+  uint32_t type = regs.eax >> 24 & 0xFF;
+
+  for(int core=0; core < topo->total_cores; core++) {
+    if(!cpuid_snapshot_get(cpu->cpuid_snap, core, 0x0000001A, 0, &regs)) return false;
+    if((regs.eax >> 24 & 0xFF) != type) continue;
+    if(n == topo->total_cores_module) return false;
+    cpus[n++] = core;
+  }
+
+  return n == topo->total_cores_module;
+}
+
+// Fills the topology of the module using the topology exposed by Linux in
+// /sys/devices/system/cpu/cpuN/topology and cpuN/cache. Unlike the APIC
+// approach, this does not need to run any code on the rest of the cores.
+// Physical cores are the distinct (package_id, die_id, core_id) of the module
+bool get_topology_from_sysfs(struct cpuInfo* cpu, struct topology* topo) {
+  if (topo->cach == NULL) {
+    printWarn("get_topology_from_sysfs: cach is NULL");
+    return false;
+  }
+
+  int n = topo->total_cores_module;
+  int* cpus = emalloc(sizeof(int) * n);
+  int64_t* package_ids = emalloc(sizeof(int64_t) * n);
+  int64_t* core_ids = emalloc(sizeof(int64_t) * n);
+  char path[_PATH_PACKAGE_MAX_LEN];
+  int max_siblings = 0;
+  bool success = get_module_cpus(cpu, topo, cpus);
+
+  for(int i=0; i < n && success; i++) {
+    int core = cpus[i];
+    int first_cpu;
+
+    sprintf(path, "%s%s/cpu%d%s", _PATH_SYS_SYSTEM, _PATH_SYS_CPU, core, _PATH_TOPO_PACKAGE_ID_SYS);
+    long package_id = get_long_from_file(path);
+    sprintf(path, "%s%s/cpu%d%s", _PATH_SYS_SYSTEM, _PATH_SYS_CPU, core, _PATH_TOPO_CORE_ID_SYS);
+    long core_id = get_long_from_file(path);
+    // die_id is not available in old kernels, default to 0
+    sprintf(path, "%s%s/cpu%d%s", _PATH_SYS_SYSTEM, _PATH_SYS_CPU, core, _PATH_TOPO_DIE_ID_SYS);
+    long die_id = access(path, F_OK) == 0 ? get_long_from_file(path) : 0;
+    sprintf(path, "%s%s/cpu%d%s", _PATH_SYS_SYSTEM, _PATH_SYS_CPU, core, _PATH_TOPO_THREAD_SIBL);
+    int siblings = get_cpu_list_from_file(path, &first_cpu);
+
+    if(package_id < 0 || core_id < 0 || die_id < 0 || siblings <= 0) {
+      success = false;
+    }
+    else {
+      package_ids[i] = package_id;
+      // core_id is only unique inside a die
+      core_ids[i] = (((int64_t) package_id << 40) | ((int64_t) die_id << 20)) + core_id;
+      max_siblings = max(max_siblings, siblings);
+    }
+  }
+
+  if(success) {
+    int physical_cores = count_distinct(core_ids, n);
+    topo->sockets = count_distinct(package_ids, n);
+    topo->smt_available = max_siblings;
+    topo->smt_supported = get_smt_supported_from_cpuid(cpu, topo->smt_available);
+    topo->logical_cores = n / topo->sockets;
+    topo->physical_cores = physical_cores / topo->sockets;
+
+    success = get_cache_topology_from_sysfs(cpus, topo);
+  }
+
+  free(cpus);
+  free(package_ids);
+  free(core_ids);
+  return success;
+}
+
+// Computes the topology using APIC and compares it with the one
+// found using sysfs (only used in verbose mode). The APIC topology
+// is only needed here, so it is released from the arena afterwards
+void check_topology_from_apic(struct cpuInfo* cpu, struct topology* topo) {
+  struct arena_mark mark = get_arena_mark();
+  struct cache* cach = amalloc(sizeof(struct cache));
+  init_cache_struct(cach);
+  cach->max_cache_level = topo->cach->max_cache_level;
+  for(int i=0; i < 4; i++) {
+    cach->cach_arr[i]->size = topo->cach->cach_arr[i]->size;
+    cach->cach_arr[i]->exists = topo->cach->cach_arr[i]->exists;
+    cach->cach_arr[i]->num_caches = 0;
+  }
+
+  struct topology* apic_topo = amalloc(sizeof(struct topology));
+  init_topology_struct(apic_topo, cach);
+  apic_topo->total_cores = topo->total_cores;
+  apic_topo->total_cores_module = topo->total_cores_module;
+
+  if(!get_topology_from_apic(cpu, apic_topo)) {
+    printWarn("Unable to cross-check sysfs topology using APIC");
+  }
+  else {
+    if(apic_topo->sockets != topo->sockets)
+      printWarn("Topology mismatch: sockets is %d (sysfs) vs %d (APIC)", topo->sockets, apic_topo->sockets);
+    if(apic_topo->smt_available != topo->smt_available)
+      printWarn("Topology mismatch: smt_available is %d (sysfs) vs %d (APIC)", topo->smt_available, apic_topo->smt_available);
+    if(apic_topo->physical_cores != topo->physical_cores)
+      printWarn("Topology mismatch: physical_cores is %d (sysfs) vs %d (APIC)", topo->physical_cores, apic_topo->physical_cores);
+    if(apic_topo->logical_cores != topo->logical_cores)
+      printWarn("Topology mismatch: logical_cores is %d (sysfs) vs %d (APIC)", topo->logical_cores, apic_topo->logical_cores);
+    for(int i=0; i < topo->cach->max_cache_level; i++) {
+      if(cach->cach_arr[i]->exists && cach->cach_arr[i]->num_caches != topo->cach->cach_arr[i]->num_caches)
+        printWarn("Topology mismatch: num_caches[%d] is %d (sysfs) vs %d (APIC)", i, topo->cach->cach_arr[i]->num_caches, cach->cach_arr[i]->num_caches);
+    }
+  }
+
+  release_arena(mark);
+}
+#endif
+
 // Main reference: https://software.intel.com/content/www/us/en/develop/articles/intel-64-architecture-processor-topology-enumeration.html
 // Very interesting resource: https://wiki.osdev.org/Detecting_CPU_Topology_(80x86)
 struct topology* get_topology_info(struct cpuInfo* cpu, struct cache* cach, int module) {
-  struct topology* topo = emalloc(sizeof(struct topology));
+  struct topology* topo = amalloc(sizeof(struct topology));
   init_topology_struct(topo, cach);
 
   uint32_t eax = 0;
@@ -718,20 +1069,15 @@ struct topology* get_topology_info(struct cpuInfo* cpu, struct cache* cach, int
   // If we have one socket, it will be same as the cpuid,
   // but in dual socket it will not!
   // TODO: Replace by apic?
-  #ifdef _WIN32
-    SYSTEM_INFO info;
-    GetSystemInfo(&info);
-    topo->total_cores = info.dwNumberOfProcessors;
-  #else
-    if((topo->total_cores = sysconf(_SC_NPROCESSORS_ONLN)) == -1) {
-      printWarn("sysconf(_SC_NPROCESSORS_ONLN): %s", strerror(errno));
-      topo->total_cores = topo->logical_cores; // fallback
-    }
-  #endif
+  if((topo->total_cores = get_total_cores_from_os()) == -1) {
+    topo->total_cores = topo->logical_cores; // fallback
+  }
 
   if(cpu->hybrid_flag) {
     #ifdef __linux__
-      topo->total_cores_module = get_total_cores_module(topo->total_cores, module);
+      if((topo->total_cores_module = get_total_cores_module(cpu->cpuid_snap, topo->total_cores, module)) == -1) {
+        topo->total_cores_module = topo->total_cores; // fallback
+      }
     #else
       UNUSED(module);
       topo->total_cores_module = topo->total_cores;
@@ -744,7 +1090,20 @@ struct topology* get_topology_info(struct cpuInfo* cpu, struct cache* cach, int
   bool toporet = false;
   switch(cpu->cpu_vendor) {
     case CPU_VENDOR_INTEL:
-      if (cpu->maxLevels >= 0x00000004) {
+      #ifdef __linux__
+        // sysfs first: it does not need to run code on every core
+        toporet = get_topology_from_sysfs(cpu, topo);
+        if(toporet && verbose_enabled() && cpu->maxLevels >= 0x00000004) {
+          check_topology_from_apic(cpu, topo);
+        }
+        else if(!toporet) {
+          printWarn("Failed to retrieve topology from sysfs, using APIC...");
+        }
+      #endif
+      if (toporet) {
+        break;
+      }
+      else if (cpu->maxLevels >= 0x00000004) {
         toporet = get_topology_from_apic(cpu, topo);
       }
       else {
@@ -795,7 +1154,7 @@ struct topology* get_topology_info(struct cpuInfo* cpu, struct cache* cach, int
 
       if (cpu->maxLevels >= 0x00000001) {
         if(topo->smt_supported > 1)
-          topo->smt_available = is_smt_enabled_amd(topo);
+          topo->smt_available = is_smt_enabled_amd(cpu->cpuid_snap, topo);
         else
           topo->smt_available = 1;
       }
@@ -927,7 +1286,7 @@ struct cache* get_cache_info_general(struct cache* cach, uint32_t level) {
 }
 
 struct cache* get_cache_info(struct cpuInfo* cpu) {
-  struct cache* cach = emalloc(sizeof(struct cache));
+  struct cache* cach = amalloc(sizeof(struct cache));
   init_cache_struct(cach);
 
   uint32_t level;
@@ -965,8 +1324,47 @@ struct cache* get_cache_info(struct cpuInfo* cpu) {
   return cach;
 }
 
+// TSC (see tsc.c), whether it is invariant (ticks at a constant rate
+// in every P-state and C-state), bus clock and clock source of the kernel
+static void fill_timekeeping_info(struct cpuInfo* cpu, struct frequency* freq) {
+  struct tsc_info* tsc = get_tsc_info();
+  freq->tsc = tsc->hz > 0 ? (int64_t) tsc->hz : UNKNOWN_DATA;
+  freq->crystal = tsc->crystal_hz > 0 ? (int64_t) tsc->crystal_hz : UNKNOWN_DATA;
+  freq->tsc_source = tsc->source;
+
+  uint32_t eax = 0;
+  uint32_t ebx = 0;
+  uint32_t ecx = 0;
+  uint32_t edx = 0;
+
+  freq->invariant_tsc = false;
+  if(cpu->maxExtendedLevels >= 0x80000007) {
+    eax = 0x80000007;
+    cpuid(&eax, &ebx, &ecx, &edx);
+    freq->invariant_tsc = (edx >> 8) & 1;
+  }
+  else {
+    printWarn("Can't read invariant TSC from cpuid (needed extended level is 0x%.8X, max is 0x%.8X)", 0x80000007, cpu->maxExtendedLevels);
+  }
+
+  freq->bus = UNKNOWN_DATA;
+  if(cpu->maxLevels >= 0x00000016) {
+    eax = 0x00000016;
+    ebx = 0;
+    ecx = 0;
+    edx = 0;
+    cpuid(&eax, &ebx, &ecx, &edx);
+    if((ecx & 0xFFFF) != 0) freq->bus = ecx & 0xFFFF;
+  }
+
+  freq->clocksource = NULL;
+#ifdef __linux__
+  freq->clocksource = get_current_clocksource();
+#endif
+}
+
 struct frequency* get_frequency_info(struct cpuInfo* cpu) {
-  struct frequency* freq = emalloc(sizeof(struct frequency));
+  struct frequency* freq = amalloc(sizeof(struct frequency));
   freq->measured = false;
 
   if(cpu->maxLevels < 0x00000016) {
@@ -1030,12 +1428,19 @@ struct frequency* get_frequency_info(struct cpuInfo* cpu) {
     if (freq->max == UNKNOWN_DATA || measure_max_frequency_flag()) {
       if (freq->max == UNKNOWN_DATA)
         printWarn("All previous methods failed, measuring CPU frequency");
-      freq->max = measure_max_frequency(cpu->first_core_id);
+      // The cluster of a module are the cores of its type
+      int32_t total_cores = get_total_cores_from_os();
+      const char* core_type = get_str_core_type(cpu, cpu->first_core_id);
+      bool* cluster = emalloc(sizeof(bool) * max(total_cores, 1));
+      for(int i=0; i < total_cores; i++) cluster[i] = get_str_core_type(cpu, i) == core_type;
+      freq->max = total_cores > 0 ? measure_max_frequency(total_cores, cluster) : UNKNOWN_DATA;
       freq->measured = true;
+      free(cluster);
     }
   #endif
 
   freq->max_pp = UNKNOWN_DATA;
+  if(timekeeping_enabled()) fill_timekeeping_info(cpu, freq);
   return freq;
 }
 
@@ -1054,7 +1459,7 @@ char* get_str_topology(struct cpuInfo* cpu, struct topology* topo, bool dual_soc
   char* string;
 
   if(topo->logical_cores == UNKNOWN_DATA) {
-    string = emalloc(sizeof(char) * (strlen(STRING_UNKNOWN) + 1));
+    string = amalloc(sizeof(char) * (strlen(STRING_UNKNOWN) + 1));
     strcpy(string, STRING_UNKNOWN);
   }
   else {
@@ -1068,7 +1473,7 @@ char* get_str_topology(struct cpuInfo* cpu, struct topology* topo, bool dual_soc
     if(topo->smt_supported > 1) {
       // 4 for digits, 21 for ' cores (SMT disabled)' which is the longest possible output
       uint32_t max_size = 4+21+1;
-      string = emalloc(sizeof(char) * max_size);
+      string = amalloc(sizeof(char) * max_size);
 
       if(topo->smt_available > 1)
         snprintf(string, max_size, "%d %s (%d threads)", topo->physical_cores * topo_sockets, cores_str, topo->logical_cores * topo_sockets);
@@ -1081,7 +1486,7 @@ char* get_str_topology(struct cpuInfo* cpu, struct topology* topo, bool dual_soc
     }
     else {
       uint32_t max_size = 4+7+1;
-      string = emalloc(sizeof(char) * max_size);
+      string = amalloc(sizeof(char) * max_size);
       snprintf(string, max_size, "%d %s",topo->physical_cores * topo_sockets, cores_str);
     }
   }
@@ -1091,7 +1496,7 @@ char* get_str_topology(struct cpuInfo* cpu, struct topology* topo, bool dual_soc
 
 char* get_str_avx(struct cpuInfo* cpu) {
   //If all AVX are available, it will use up to 15
-  char* string = emalloc(sizeof(char)*17+1);
+  char* string = amalloc(sizeof(char)*17+1);
   if(!cpu->feat->AVX)
     snprintf(string,2+1,"No");
   else if(!cpu->feat->AVX2)
@@ -1113,7 +1518,7 @@ char* get_str_sse(struct cpuInfo* cpu) {
   uint32_t SSE4a_sl = 6;
   uint32_t SSE4_1_sl = 7;
   uint32_t SSE4_2_sl = 7;
-  char* string = emalloc(sizeof(char)*SSE_sl+SSE2_sl+SSE3_sl+SSSE3_sl+SSE4a_sl+SSE4_1_sl+SSE4_2_sl+1);
+  char* string = amalloc(sizeof(char)*SSE_sl+SSE2_sl+SSE3_sl+SSSE3_sl+SSE4a_sl+SSE4_1_sl+SSE4_2_sl+1);
 
   if(cpu->feat->SSE) {
       snprintf(string+last,SSE_sl+1,"SSE,");
@@ -1156,7 +1561,7 @@ char* get_str_sse(struct cpuInfo* cpu) {
 }
 
 char* get_str_fma(struct cpuInfo* cpu) {
-  char* string = emalloc(sizeof(char)*9+1);
+  char* string = amalloc(sizeof(char)*9+1);
   if(!cpu->feat->FMA3)
     snprintf(string,2+1,"No");
   else if(!cpu->feat->FMA4)
@@ -1188,30 +1593,98 @@ void print_debug(struct cpuInfo* cpu) {
     printf("- Hybrid Flag: %d\n", cpu->hybrid_flag);
   }
   printf("- CPUID dump: 0x%.8X\n", eax);
+}
 
-  free_cpuinfo_struct(cpu);
+void print_raw_regs(uint32_t reg, uint32_t reg2, struct cpuid_regs* regs) {
+  printf("  0x%.8X 0x%.2X: 0x%.8X 0x%.8X 0x%.8X 0x%.8X\n", reg, reg2, regs->eax, regs->ebx, regs->ecx, regs->edx);
 }
 
-void print_raw_level(uint32_t reg) {
-  uint32_t eax = reg;
-  uint32_t ebx = 0;
-  uint32_t ecx = 0;
-  uint32_t edx = 0;
+// Builds the list of leaves dumped by print_raw, in the order they are printed
+struct cpuid_leaf* get_raw_leaves(struct cpuInfo* cpu, int* nleaves) {
+  // Some CPUs and hypervisors report a max extended level below
+  // 0x80000000, which means that there are no extended levels
+  uint32_t num_extended = cpu->maxExtendedLevels >= 0x80000000 ? cpu->maxExtendedLevels - 0x80000000 + 1 : 0;
+  int max_leaves = (cpu->maxLevels + 1) + cpu->cach->max_cache_level + cpu->topo->smt_supported + 7 +
+                   num_extended + cpu->cach->max_cache_level;
+  struct cpuid_leaf* leaves = emalloc(sizeof(struct cpuid_leaf) * max_leaves);
+  int n = 0;
+
+  // Standard levels
+  for(uint32_t reg=0x00000000; reg <= cpu->maxLevels; reg++) {
+    if(reg == 0x00000004) {
+      for(uint32_t reg2=0x00000000; reg2 < cpu->cach->max_cache_level; reg2++) {
+        leaves[n].leaf = reg;
+        leaves[n++].subleaf = reg2;
+      }
+    }
+    else if(reg == 0x0000000B) {
+      for(uint32_t reg2=0x00000000; reg2 < cpu->topo->smt_supported; reg2++) {
+        leaves[n].leaf = reg;
+        leaves[n++].subleaf = reg2;
+      }
+    }
+    else {
+      leaves[n].leaf = reg;
+      leaves[n++].subleaf = 0x00;
+    }
+  }
 
-  cpuid(&eax, &ebx, &ecx, &edx);
+  // Hypervisor levels
+  for(uint32_t reg=0x40000000; reg <= 0x40000006; reg++) {
+    leaves[n].leaf = reg;
+    leaves[n++].subleaf = 0x00;
+  }
+
+  // Extended levels
+  for(uint32_t reg=0x80000000; reg <= cpu->maxExtendedLevels; reg++) {
+    if(reg == 0x8000001D) {
+      for(uint32_t reg2=0x00000000; reg2 < cpu->cach->max_cache_level; reg2++) {
+        leaves[n].leaf = reg;
+        leaves[n++].subleaf = reg2;
+      }
+    }
+    else {
+      leaves[n].leaf = reg;
+      leaves[n++].subleaf = 0x00;
+    }
+  }
 
-  printf("  0x%.8X 0x%.2X: 0x%.8X 0x%.8X 0x%.8X 0x%.8X\n", reg, 0x00, eax, ebx, ecx, edx);
+  *nleaves = n;
+  return leaves;
 }
 
-void print_raw_sublevel(uint32_t reg, uint32_t reg2) {
-  uint32_t eax = reg;
-  uint32_t ebx = 0;
-  uint32_t ecx = reg2;
-  uint32_t edx = 0;
+void print_timekeeping(struct cpuInfo* cpu) {
+  struct frequency* freq = cpu->freq;
+  if(freq == NULL) {
+    printWarn("Frequency was not fetched, timekeeping will not be shown");
+    return;
+  }
 
-  cpuid(&eax, &ebx, &ecx, &edx);
+  printf("\nTimekeeping:\n");
+  if(freq->tsc == UNKNOWN_DATA)
+    printf("  %-15s%s\n", "TSC:", STRING_UNKNOWN);
+  else
+    printf("  %-15s%.3f MHz (%s)\n", "TSC:", freq->tsc / 1000000.0, get_str_tsc_source(freq->tsc_source));
+
+  if(freq->crystal == UNKNOWN_DATA)
+    printf("  %-15s%s\n", "Crystal:", STRING_UNKNOWN);
+  else
+    printf("  %-15s%.3f MHz\n", "Crystal:", freq->crystal / 1000000.0);
+
+  printf("  %-15s%s\n", "Invariant TSC:", freq->invariant_tsc ? "Yes" : "No");
 
-  printf("  0x%.8X 0x%.2X: 0x%.8X 0x%.8X 0x%.8X 0x%.8X\n", reg, reg2, eax, ebx, ecx, edx);
+  if(freq->bus == UNKNOWN_DATA)
+    printf("  %-15s%s\n", "Bus clock:", STRING_UNKNOWN);
+  else
+    printf("  %-15s%d MHz\n", "Bus clock:", freq->bus);
+
+  // Reading hpet (or acpi_pm) traps to the hardware, so clock_gettime
+  // is about 100x slower than with the TSC. The kernel falls back to
+  // them when it finds the TSC unreliable
+  const char* cs = freq->clocksource;
+  bool slow = cs != NULL && (strcmp(cs, "hpet") == 0 || strcmp(cs, "acpi_pm") == 0);
+  printf("  %-15s%s%s\n", "Clocksource:", cs == NULL ? STRING_UNKNOWN : cs,
+         slow ? " (slow, clock_gettime is ~100x slower than with tsc)" : "");
 }
 
 void print_raw(struct cpuInfo* cpu) {
@@ -1219,9 +1692,17 @@ void print_raw(struct cpuInfo* cpu) {
   printf("  CPUID leaf sub   EAX        EBX        ECX        EDX       \n");
   printf("--------------------------------------------------------------\n");
 
+  int nleaves;
+  struct cpuid_leaf* leaves = get_raw_leaves(cpu, &nleaves);
+  struct cpuid_regs regs;
+
+  // Capture all the leaves from all the cores at once. If that is not
+  // possible, fall back to binding to each core and running cpuid
+  struct cpuid_snapshot* snap = get_cpuid_snapshot(leaves, nleaves, cpu->topo->total_cores);
+
   for(int c=0; c < cpu->topo->total_cores; c++) {
     #ifndef __APPLE__
-    if(!bind_to_cpu(c)) {
+    if(snap == NULL && !bind_to_cpu(c)) {
       printErr("Failed binding to CPU %d", c);
       return;
     }
@@ -1229,46 +1710,17 @@ void print_raw(struct cpuInfo* cpu) {
 
     printf("CPU %d:\n", c);
 
-    // Standard levels
-    for(uint32_t reg=0x00000000; reg <= cpu->maxLevels; reg++) {
-      if(reg == 0x00000004) {
-        for(uint32_t reg2=0x00000000; reg2 < cpu->cach->max_cache_level; reg2++) {
-          print_raw_sublevel(reg, reg2);
-        }
-      }
-      else if(reg == 0x0000000B) {
-        for(uint32_t reg2=0x00000000; reg2 < cpu->topo->smt_supported; reg2++) {
-          print_raw_sublevel(reg, reg2);
-        }
-      }
-      else {
-        print_raw_level(reg);
-      }
-    }
-
-    // Hypervisor levels
-    for(uint32_t reg=0x40000000; reg <= 0x40000006; reg++) {
-      print_raw_level(reg);
-    }
-
-    // Extended levels
-    for(uint32_t reg=0x80000000; reg <= cpu->maxExtendedLevels; reg++) {
-      if(reg == 0x8000001D) {
-        for(uint32_t reg2=0x00000000; reg2 < cpu->cach->max_cache_level; reg2++) {
-          print_raw_sublevel(reg, reg2);
-        }
-      }
-      else {
-        print_raw_level(reg);
+    for(int l=0; l < nleaves; l++) {
+      if(!cpuid_snapshot_get(snap, c, leaves[l].leaf, leaves[l].subleaf, &regs)) {
+        regs.eax = leaves[l].leaf;
+        regs.ebx = 0;
+        regs.ecx = leaves[l].subleaf;
+        regs.edx = 0;
+        cpuid(&regs.eax, &regs.ebx, &regs.ecx, &regs.edx);
       }
+      print_raw_regs(leaves[l].leaf, leaves[l].subleaf, &regs);
     }
-
   }
-}
 
-void free_topo_struct(struct topology* topo) {
-  free(topo->apic->cache_select_mask);
-  free(topo->apic->cache_id_apic);
-  free(topo->apic);
-  free(topo);
+  free(leaves);
 }
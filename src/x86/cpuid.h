@@ -7,16 +7,18 @@ struct cpuInfo* get_cpu_info(void);
 struct cache* get_cache_info(struct cpuInfo* cpu);
 struct frequency* get_frequency_info(struct cpuInfo* cpu);
 struct topology* get_topology_info(struct cpuInfo* cpu, struct cache* cach, int module);
+int64_t get_peak_performance(struct cpuInfo* cpu, bool accurate_pp);
 
 char* get_str_avx(struct cpuInfo* cpu);
 char* get_str_sse(struct cpuInfo* cpu);
 char* get_str_fma(struct cpuInfo* cpu);
 char* get_str_topology(struct cpuInfo* cpu, struct topology* topo, bool dual_socket);
 char* get_str_cpu_name_abbreviated(struct cpuInfo* cpu);
+const char* get_str_core_type(struct cpuInfo* cpu, int core);
+char* get_hv_vendor_name(VENDOR hv_vendor);
 
 void print_debug(struct cpuInfo* cpu);
 void print_raw(struct cpuInfo* cpu);
-
-void free_topo_struct(struct topology* topo);
+void print_timekeeping(struct cpuInfo* cpu);
 
 #endif
@@ -1,6 +1,8 @@
 #include "cpuid_asm.h"
+#include "../common/global.h"
 
 void cpuid(uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx) {
+        TRACE_COUNT(TRACE_CPUID, 1);
         __asm volatile("cpuid"
             : "=a" (*eax),
               "=b" (*ebx),
@@ -0,0 +1,191 @@
+#ifdef __linux__
+  #define _GNU_SOURCE
+  #include <sched.h>
+  #include <pthread.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cpuid_percpu.h"
+#include "cpuid_asm.h"
+#include "../common/global.h"
+
+#ifdef __linux__
+// The workers only run a few cpuid instructions, so there is no
+// need to give them the default (usually 8MB) stack
+#define WORKER_STACK_SIZE (64 * 1024)
+
+struct cpuid_worker {
+  struct cpuid_leaf* leaves;
+  int nleaves;
+  // Slot of this CPU in the output array (nleaves entries)
+  struct cpuid_regs* regs;
+};
+
+void* cpuid_worker_run(void* worker_ptr) {
+  struct cpuid_worker* worker = (struct cpuid_worker*) worker_ptr;
+
+  for(int l=0; l < worker->nleaves; l++) {
+    uint32_t eax = worker->leaves[l].leaf;
+    uint32_t ebx = 0;
+    uint32_t ecx = worker->leaves[l].subleaf;
+    uint32_t edx = 0;
+
+    cpuid(&eax, &ebx, &ecx, &edx);
+
+    worker->regs[l].eax = eax;
+    worker->regs[l].ebx = ebx;
+    worker->regs[l].ecx = ecx;
+    worker->regs[l].edx = edx;
+  }
+
+  return NULL;
+}
+
+// Runs the cpuid leaves specified in leaves on every CPU from first_core
+// to first_core+ncores-1. Instead of migrating the process to every CPU,
+// one worker is started per CPU, already pinned to it, so every CPU runs
+// its leaves concurrently. The results for the CPU first_core+i are stored
+// in regs[i*nleaves ... i*nleaves+nleaves-1], so regs must be preallocated
+// with ncores*nleaves entries.
+bool cpuid_on_cpus(int first_core, int ncores, struct cpuid_leaf* leaves, int nleaves, struct cpuid_regs* regs) {
+  pthread_t* threads = emalloc(sizeof(pthread_t) * ncores);
+  struct cpuid_worker* workers = emalloc(sizeof(struct cpuid_worker) * ncores);
+  pthread_attr_t attr;
+  cpu_set_t cpus;
+  int created = 0;
+  bool success = true;
+  int ret;
+
+  if ((ret = pthread_attr_init(&attr)) != 0) {
+    printWarn("pthread_attr_init: %s", strerror(ret));
+    free(threads);
+    free(workers);
+    return false;
+  }
+  if ((ret = pthread_attr_setstacksize(&attr, WORKER_STACK_SIZE)) != 0) {
+    printWarn("pthread_attr_setstacksize: %s", strerror(ret));
+  }
+
+  for(int i=0; i < ncores && success; i++) {
+    CPU_ZERO(&cpus);
+    CPU_SET(first_core + i, &cpus);
+    if ((ret = pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpus)) != 0) {
+      printWarn("pthread_attr_setaffinity_np: %s", strerror(ret));
+      success = false;
+      break;
+    }
+
+    workers[i].leaves = leaves;
+    workers[i].nleaves = nleaves;
+    workers[i].regs = regs + (i * nleaves);
+
+    if ((ret = pthread_create(&threads[i], &attr, cpuid_worker_run, &workers[i])) != 0) {
+      printWarn("pthread_create: Unable to start worker on CPU %d: %s", first_core + i, strerror(ret));
+      success = false;
+    }
+    else {
+      created++;
+    }
+  }
+
+  for(int i=0; i < created; i++) {
+    if ((ret = pthread_join(threads[i], NULL)) != 0) {
+      printWarn("pthread_join: %s", strerror(ret));
+      success = false;
+    }
+  }
+
+  pthread_attr_destroy(&attr);
+  free(threads);
+  free(workers);
+
+  return success;
+}
+#elif defined __APPLE__
+bool cpuid_on_cpus(int first_core, int ncores, struct cpuid_leaf* leaves, int nleaves, struct cpuid_regs* regs) {
+  // macOS does not allow binding threads to CPUs
+  UNUSED(first_core);
+  UNUSED(ncores);
+  UNUSED(leaves);
+  UNUSED(nleaves);
+  UNUSED(regs);
+  return false;
+}
+#else
+bool cpuid_on_cpus(int first_core, int ncores, struct cpuid_leaf* leaves, int nleaves, struct cpuid_regs* regs) {
+  for(int i=0; i < ncores; i++) {
+    if(!bind_to_cpu(first_core + i)) {
+      printWarn("Failed binding the process to CPU %d", first_core + i);
+      return false;
+    }
+
+    for(int l=0; l < nleaves; l++) {
+      struct cpuid_regs* r = regs + (i * nleaves) + l;
+      r->eax = leaves[l].leaf;
+      r->ebx = 0;
+      r->ecx = leaves[l].subleaf;
+      r->edx = 0;
+      cpuid(&r->eax, &r->ebx, &r->ecx, &r->edx);
+    }
+  }
+
+  return true;
+}
+#endif // #ifdef __linux__
+
+int cmp_cpuid_leaf(const void* a, const void* b) {
+  const struct cpuid_leaf* l1 = (const struct cpuid_leaf*) a;
+  const struct cpuid_leaf* l2 = (const struct cpuid_leaf*) b;
+
+  if(l1->leaf != l2->leaf) return l1->leaf < l2->leaf ? -1 : 1;
+  if(l1->subleaf != l2->subleaf) return l1->subleaf < l2->subleaf ? -1 : 1;
+  return 0;
+}
+
+// Captures the leaves specified in leaves on every CPU from 0 to ncores-1.
+// Returns NULL if they could not be captured (e.g., in macOS), in which
+// case callers must fall back to running cpuid themselves.
+struct cpuid_snapshot* get_cpuid_snapshot(struct cpuid_leaf* leaves, int nleaves, int ncores) {
+  if(nleaves <= 0 || ncores <= 0) return NULL;
+
+  struct cpuid_snapshot* snap = amalloc(sizeof(struct cpuid_snapshot));
+  snap->ncores = ncores;
+  snap->leaves = amalloc(sizeof(struct cpuid_leaf) * nleaves);
+  memcpy(snap->leaves, leaves, sizeof(struct cpuid_leaf) * nleaves);
+
+  // Sort the leaves and remove duplicates, so that lookups can
+  // be done with a binary search
+  qsort(snap->leaves, nleaves, sizeof(struct cpuid_leaf), cmp_cpuid_leaf);
+  snap->nleaves = 1;
+  for(int i=1; i < nleaves; i++) {
+    if(cmp_cpuid_leaf(&snap->leaves[i], &snap->leaves[snap->nleaves-1]) != 0) {
+      snap->leaves[snap->nleaves++] = snap->leaves[i];
+    }
+  }
+
+  snap->regs = amalloc(sizeof(struct cpuid_regs) * ncores * snap->nleaves);
+  if(!cpuid_on_cpus(0, ncores, snap->leaves, snap->nleaves, snap->regs)) {
+    printWarn("Unable to capture cpuid snapshot for %d CPUs", ncores);
+    return NULL;
+  }
+
+  return snap;
+}
+
+// Fills regs with the value of leaf and subleaf in CPU core. Returns false
+// if the snapshot does not exist or does not contain that value.
+bool cpuid_snapshot_get(struct cpuid_snapshot* snap, int core, uint32_t leaf, uint32_t subleaf, struct cpuid_regs* regs) {
+  if(snap == NULL || core < 0 || core >= snap->ncores) return false;
+
+  struct cpuid_leaf key;
+  key.leaf = leaf;
+  key.subleaf = subleaf;
+
+  struct cpuid_leaf* found = bsearch(&key, snap->leaves, snap->nleaves, sizeof(struct cpuid_leaf), cmp_cpuid_leaf);
+  if(found == NULL) return false;
+
+  *regs = snap->regs[core * snap->nleaves + (found - snap->leaves)];
+  return true;
+}
@@ -0,0 +1,34 @@
+#ifndef __CPUID_PERCPU__
+#define __CPUID_PERCPU__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+struct cpuid_leaf {
+  uint32_t leaf;
+  uint32_t subleaf;
+};
+
+struct cpuid_regs {
+  uint32_t eax;
+  uint32_t ebx;
+  uint32_t ecx;
+  uint32_t edx;
+};
+
+// Values of a set of cpuid leaves for every CPU, captured once
+// and then shared by every detection pass
+struct cpuid_snapshot {
+  int ncores;
+  int nleaves;
+  // Sorted by leaf and subleaf
+  struct cpuid_leaf* leaves;
+  // ncores * nleaves entries, indexed by CPU first
+  struct cpuid_regs* regs;
+};
+
+bool cpuid_on_cpus(int first_core, int ncores, struct cpuid_leaf* leaves, int nleaves, struct cpuid_regs* regs);
+struct cpuid_snapshot* get_cpuid_snapshot(struct cpuid_leaf* leaves, int nleaves, int ncores);
+bool cpuid_snapshot_get(struct cpuid_snapshot* snap, int core, uint32_t leaf, uint32_t subleaf, struct cpuid_regs* regs);
+
+#endif
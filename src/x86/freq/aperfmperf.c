@@ -0,0 +1,173 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <asm/unistd.h>
+#include <linux/perf_event.h>
+
+#include "../../common/global.h"
+#include "../../common/udev.h"
+#include "aperfmperf.h"
+
+#define MSR_IA32_MPERF      0xE7
+#define MSR_IA32_APERF      0xE8
+
+#define _PATH_PERF_MSR      "/sys/bus/event_source/devices/msr"
+#define _PATH_PERF_MSR_TYPE _PATH_PERF_MSR "/type"
+#define _PATH_PERF_APERF    _PATH_PERF_MSR "/events/aperf"
+#define _PATH_PERF_MPERF    _PATH_PERF_MSR "/events/mperf"
+
+enum {
+  BACKEND_PERF,
+  BACKEND_MSR
+};
+
+struct aperfmperf {
+  int backend;
+  int* cpus;
+  int num_cpus;
+  // perf: aperf (group leader) and mperf per cpu
+  // msr:  /dev/cpu/N/msr per cpu
+  int* fds;
+};
+
+static long perf_event_open(struct perf_event_attr *hw_event, pid_t pid, int cpu, int group_fd, unsigned long flags) {
+  TRACE_COUNT(TRACE_PERF_SYSCALLS, 1);
+  return syscall(__NR_perf_event_open, hw_event, pid, cpu, group_fd, flags);
+}
+
+// Parses the "event=0x01" files exported by the msr PMU
+static bool get_perf_msr_event(char* path, uint64_t* config) {
+  int len;
+  char* buf = read_file(path, &len);
+  if(buf == NULL) return false;
+
+  long long event;
+  int ret = sscanf(buf, "event=%lli", &event);
+  free(buf);
+  if(ret != 1 || event < 0) {
+    printWarn("Unable to parse perf event from %s", path);
+    return false;
+  }
+
+  *config = event;
+  return true;
+}
+
+static void close_fds(struct aperfmperf* am, int num_fds) {
+  for(int i=0; i < num_fds; i++) {
+    if(am->fds[i] >= 0) close(am->fds[i]);
+  }
+}
+
+// APERF and MPERF are opened in the same group so that
+// they are read at the same time
+static bool open_perf(struct aperfmperf* am) {
+  long type = get_long_from_file(_PATH_PERF_MSR_TYPE);
+  uint64_t aperf, mperf;
+  if(type < 0 || !get_perf_msr_event(_PATH_PERF_APERF, &aperf) || !get_perf_msr_event(_PATH_PERF_MPERF, &mperf)) {
+    printWarn("APERF/MPERF are not available through perf (msr PMU not found)");
+    return false;
+  }
+
+  struct perf_event_attr pe;
+  memset(&pe, 0, sizeof(struct perf_event_attr));
+  pe.size = sizeof(struct perf_event_attr);
+  pe.type = type;
+  pe.read_format = PERF_FORMAT_GROUP;
+
+  am->fds = emalloc(sizeof(int) * am->num_cpus * 2);
+  for(int i=0; i < am->num_cpus * 2; i++) am->fds[i] = -1;
+
+  for(int i=0; i < am->num_cpus; i++) {
+    pe.config = aperf;
+    am->fds[i*2] = perf_event_open(&pe, -1, am->cpus[i], -1, 0);
+    if(am->fds[i*2] >= 0) {
+      pe.config = mperf;
+      am->fds[i*2+1] = perf_event_open(&pe, -1, am->cpus[i], am->fds[i*2], 0);
+    }
+    if(am->fds[i*2] < 0 || am->fds[i*2+1] < 0) {
+      printWarn("perf_event_open (msr/aperf/, cpu %d): %s", am->cpus[i], strerror(errno));
+      close_fds(am, am->num_cpus * 2);
+      free(am->fds);
+      return false;
+    }
+  }
+
+  am->backend = BACKEND_PERF;
+  return true;
+}
+
+static bool read_msr(int fd, uint32_t msr, uint64_t* value) {
+  return pread(fd, value, sizeof(uint64_t), msr) == sizeof(uint64_t);
+}
+
+static bool open_msr(struct aperfmperf* am) {
+  char path[64];
+  uint64_t value;
+
+  am->fds = emalloc(sizeof(int) * am->num_cpus);
+  for(int i=0; i < am->num_cpus; i++) am->fds[i] = -1;
+
+  for(int i=0; i < am->num_cpus; i++) {
+    snprintf(path, sizeof(path), "/dev/cpu/%d/msr", am->cpus[i]);
+    TRACE_COUNT(TRACE_FILES_OPENED, 1);
+    am->fds[i] = open(path, O_RDONLY);
+    // Fails with EIO if the CPU (or the hypervisor) does not implement it
+    if(am->fds[i] < 0 || !read_msr(am->fds[i], MSR_IA32_APERF, &value)) {
+      printWarn("Unable to read APERF from %s: %s", path, strerror(errno));
+      close_fds(am, am->num_cpus);
+      free(am->fds);
+      return false;
+    }
+  }
+
+  am->backend = BACKEND_MSR;
+  return true;
+}
+
+struct aperfmperf* aperfmperf_open(int* cpus, int num_cpus) {
+  struct aperfmperf* am = emalloc(sizeof(struct aperfmperf));
+  am->cpus = cpus;
+  am->num_cpus = num_cpus;
+
+  if(!open_perf(am) && !open_msr(am)) {
+    free(am);
+    return NULL;
+  }
+  return am;
+}
+
+bool aperfmperf_read(struct aperfmperf* am, int idx, uint64_t* aperf, uint64_t* mperf) {
+  if(am->backend == BACKEND_PERF) {
+    struct {
+      uint64_t nr;
+      uint64_t values[2];
+    } data;
+
+    if(read(am->fds[idx*2], &data, sizeof(data)) != sizeof(data) || data.nr != 2) {
+      printWarn("read (msr/aperf/, cpu %d): %s", am->cpus[idx], strerror(errno));
+      return false;
+    }
+    *aperf = data.values[0];
+    *mperf = data.values[1];
+    return true;
+  }
+
+  if(!read_msr(am->fds[idx], MSR_IA32_APERF, aperf) || !read_msr(am->fds[idx], MSR_IA32_MPERF, mperf)) {
+    printWarn("pread (/dev/cpu/%d/msr): %s", am->cpus[idx], strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+void aperfmperf_close(struct aperfmperf* am) {
+  close_fds(am, am->backend == BACKEND_PERF ? am->num_cpus * 2 : am->num_cpus);
+  free(am->fds);
+  free(am);
+}
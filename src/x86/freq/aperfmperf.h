@@ -0,0 +1,16 @@
+#ifndef __APERFMPERF__
+#define __APERFMPERF__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// APERF/MPERF counters of each of the cpus, read through the perf msr
+// PMU or, if not available, through the msr device. They are read by
+// index in cpus, which must outlive the returned struct
+struct aperfmperf;
+
+struct aperfmperf* aperfmperf_open(int* cpus, int num_cpus);
+bool aperfmperf_read(struct aperfmperf* am, int idx, uint64_t* aperf, uint64_t* mperf);
+void aperfmperf_close(struct aperfmperf* am);
+
+#endif
@@ -2,191 +2,1008 @@
 #include <stdio.h>
 
 #include "../../common/global.h"
+#include "../../common/udev.h"
+#include "../../common/args.h"
+#include "../../common/freqmap.h"
+#include "../../common/sensors.h"
+#include "../../common/soak.h"
+#include "../../common/measure.h"
 #include "../uarch.h"
+#include "../cpuid.h"
+#include "../tsc.h"
 #include "freq.h"
 #include "freq_nov.h"
+#include "freq_sse.h"
 #include "freq_avx.h"
 #include "freq_avx512.h"
+#include "freq_amx.h"
+#include "aperfmperf.h"
 
 #include <immintrin.h>
+#include <x86intrin.h>
 #include <stdlib.h>
 #include <stdbool.h>
-#include <sys/time.h>
 #include <time.h>
+#include <math.h>
 #include <errno.h>
 #include <string.h>
+#include <unistd.h>
 #include <pthread.h>
+#include <sys/timerfd.h>
 
-#define MAX_NUMBER_THREADS         512
-#define FREQ_VECTOR_SIZE         1<<16
+// Time interval (CLOCK_MONOTONIC) in which the frequency is measured.
+// The compute threads keep the cores busy until it ends, or until
+// the sampler stops it because the frequency has converged. They
+// check it with the TSC (tsc_start and tsc_end), or with the clock
+// if the TSC frequency is unknown (tsc_end is 0)
+struct freq_window {
+  struct timespec start;
+  struct timespec end;
+  uint64_t tsc_start;
+  uint64_t tsc_end;
+  bool stop;
+};
 
-struct freq_thread {
+struct freq_sampler {
   // Inputs
-  struct cpuInfo* cpu;
-  bool end;
-  bool measure;
-  // Output
-  int32_t *max_pp;
+  struct freq_window* window;
+  int* cpus;
+  int num_cores;
+  double tolerance;
+  double confidence;
+  // Output, per core, in MHz. core_ci is the half width
+  // of the confidence interval of core_freq
+  double* core_freq;
+  double* core_ci;
+  double* core_min;
+  double* core_max;
+  // FLOP/s achieved by the kernel in each core, 0 if unknown
+  double* core_flops;
+  int epochs;
+  bool converged;
+  bool ok;
 };
 
-double vector_average_harmonic(double* v, int len) {
-  double acc = 0.0;
-  for(int i=0; i < len; i++) {
-    acc += 1 / v[i];
+// heavy kernels use FMAs (or AMX), which may lower
+// the frequency further than the light ones of their class.
+// lanes is the number of floats per instruction (0 for AMX)
+struct freq_kernel {
+  char* isa;
+  char* isa_class;
+  bool heavy;
+  int lanes;
+  char* desc;
+  void* (*compute)(void*);
+};
+
+enum {
+  KERNEL_NOV,
+  KERNEL_SSE,
+  KERNEL_AVX,
+  KERNEL_AVX_FMA,
+  KERNEL_AVX512,
+  KERNEL_AVX512_FMA,
+  KERNEL_AMX
+};
+
+// From the narrowest to the widest
+static const struct freq_kernel kernels[] = {
+  [KERNEL_NOV]        = { "No vector",  "Scalar", false,  1, "the frequency (no vector instructions)", compute_nov        },
+  [KERNEL_SSE]        = { "SSE",        "SSE",    false,  4, "the SSE frequency",                      compute_sse        },
+  [KERNEL_AVX]        = { "AVX2",       "AVX",    false,  8, "the AVX frequency",                      compute_avx        },
+  [KERNEL_AVX_FMA]    = { "AVX2 FMA",   "AVX",    true,   8, "the AVX frequency (FMA)",                compute_avx_fma    },
+  [KERNEL_AVX512]     = { "AVX512",     "AVX512", false, 16, "the AVX512 frequency",                   compute_avx512     },
+  [KERNEL_AVX512_FMA] = { "AVX512 FMA", "AVX512", true,  16, "the AVX512 frequency (FMA)",             compute_avx512_fma },
+  [KERNEL_AMX]        = { "AMX",        "AMX",    true,   0, "the AMX frequency",                      compute_amx        },
+};
+
+// Kernels below this percentage of the FLOPs per cycle assumed by
+// get_peak_performance are reported as not saturating the core
+#define KERNEL_SATURATION_PCT  90
+
+// Kernels of the turbo curve
+static const int curve_kernels[] = { KERNEL_NOV, KERNEL_AVX, KERNEL_AVX512 };
+
+// Running mean and variance of the estimate of each core (Welford)
+struct freq_stats {
+  int* n;
+  double* mean;
+  double* m2;
+  double* min;
+  double* max;
+};
+
+// Where the per-epoch estimates come from: the APERF/MPERF ratio
+// of each core or, if not available, its "cpu MHz" in /proc/cpuinfo
+struct freq_source {
+  struct aperfmperf* am;
+  uint64_t* aperf;
+  uint64_t* mperf;
+  // Indexed by cpu, not by core like the rest
+  double* mhz;
+  int num_mhz;
+};
+
+static void stats_init(struct freq_stats* st, int num_cores) {
+  st->n = ecalloc(num_cores, sizeof(int));
+  st->mean = ecalloc(num_cores, sizeof(double));
+  st->m2 = ecalloc(num_cores, sizeof(double));
+  st->min = ecalloc(num_cores, sizeof(double));
+  st->max = ecalloc(num_cores, sizeof(double));
+}
+
+static void stats_reset(struct freq_stats* st, int num_cores) {
+  memset(st->n, 0, sizeof(int) * num_cores);
+  memset(st->mean, 0, sizeof(double) * num_cores);
+  memset(st->m2, 0, sizeof(double) * num_cores);
+}
+
+static void stats_free(struct freq_stats* st) {
+  free(st->n);
+  free(st->mean);
+  free(st->m2);
+  free(st->min);
+  free(st->max);
+}
+
+static void stats_add(struct freq_stats* st, int i, double x) {
+  if(st->n[i] == 0 || x < st->min[i]) st->min[i] = x;
+  if(st->n[i] == 0 || x > st->max[i]) st->max[i] = x;
+  st->n[i]++;
+  double delta = x - st->mean[i];
+  st->mean[i] += delta / st->n[i];
+  st->m2[i] += delta * (x - st->mean[i]);
+}
+
+// Half width of the confidence interval of the mean of core i
+static double stats_ci(struct freq_stats* st, int i, double z) {
+  int n = st->n[i];
+  return student_t_quantile(z, n-1) * sqrt(st->m2[i] / (n-1) / n);
+}
+
+static bool stats_converged(struct freq_stats* st, int num_cores, double z, double tolerance) {
+  for(int i=0; i < num_cores; i++) {
+    if(st->n[i] < MEASURE_MIN_EPOCHS || stats_ci(st, i, z) > tolerance * st->mean[i]) return false;
   }
-  return len / acc;
+  return true;
 }
 
-void sleep_ms(int64_t ms) {
-  struct timespec ts;
-  ts.tv_sec = ms / 1000;
-  ts.tv_nsec = (ms % 1000) * 1000000;
-  nanosleep(&ts, &ts);
+static void timespec_add_ms(struct timespec* ts, int64_t ms) {
+  ts->tv_sec += ms / 1000;
+  ts->tv_nsec += (ms % 1000) * 1000000;
+  if(ts->tv_nsec >= 1000000000) {
+    ts->tv_sec++;
+    ts->tv_nsec -= 1000000000;
+  }
 }
 
-void* measure_freq(void *freq_ptr) {
-  struct freq_thread* freq = (struct freq_thread*) freq_ptr;
+static double timespec_diff_us(struct timespec* a, struct timespec* b) {
+  return (b->tv_sec - a->tv_sec) * 1000000.0 + (b->tv_nsec - a->tv_nsec) / 1000.0;
+}
 
-  char* end = NULL;
-  char* line = NULL;
-  size_t len = 0;
-  ssize_t read;
-  struct cpuInfo* cpu = freq->cpu;
+static bool freq_window_ended(struct freq_window* window) {
+  if(__atomic_load_n(&window->stop, __ATOMIC_RELAXED)) return true;
 
-  int v = 0;
-  double* freq_vector = malloc(sizeof(double) * FREQ_VECTOR_SIZE);
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return timespec_diff_us(&window->end, &now) >= 0;
+}
 
-  while(!freq->end) {
-    if(!freq->measure) continue;
+bool freq_thread_block(struct freq_thread* t, uint64_t flops) {
+  struct freq_window* window = t->window;
+  if(window->tsc_end == 0) return freq_window_ended(window);
 
-    FILE* fp = fopen("/proc/cpuinfo", "r");
-    if(fp == NULL) return NULL;
-    while ((read = getline(&line, &len, fp)) != -1) {
-      if((line = strstr(line, "cpu MHz")) != NULL) {
-        line = strstr(line, "\t: ");
-        if(line == NULL) return NULL;
-        line += sizeof("\t: ") - 1;
-        double f = strtold(line, &end);
-        if(errno != 0) {
-          printf("strtol: %s", strerror(errno));
-          return NULL;
-        }
+  // Unlike rdtsc, rdtscp waits for the block to finish
+  unsigned int aux;
+  uint64_t now = __rdtscp(&aux);
 
-        freq_vector[v] = f;
-        v++;
-      }
+  if(t->tsc_start == 0) {
+    if(now >= window->tsc_start) t->tsc_start = now;
+  }
+  else {
+    t->flops += flops;
+    t->tsc_end = now;
+  }
+  return __atomic_load_n(&window->stop, __ATOMIC_RELAXED) || now >= window->tsc_end;
+}
+
+static void freq_window_stop(struct freq_window* window) {
+  __atomic_store_n(&window->stop, true, __ATOMIC_RELAXED);
+}
+
+// Arms the timer to expire at ts (and then every interval_ms, if
+// not zero). Expirations are consumed by wait_timer
+static bool arm_timer(int tfd, struct timespec* ts, int64_t interval_ms) {
+  struct itimerspec its;
+  memset(&its, 0, sizeof(struct itimerspec));
+  its.it_value = *ts;
+  timespec_add_ms(&its.it_interval, interval_ms);
+
+  if(timerfd_settime(tfd, TFD_TIMER_ABSTIME, &its, NULL) == -1) {
+    printErr("timerfd_settime: %s", strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+static bool wait_timer(int tfd) {
+  uint64_t expirations;
+  if(read(tfd, &expirations, sizeof(uint64_t)) != sizeof(uint64_t)) {
+    printErr("read (timerfd): %s", strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+// Reads the "cpu MHz" of each core, in /proc/cpuinfo order
+static int read_cpuinfo_mhz(double* mhz, int max) {
+  int len;
+  char* buf = read_file(_PATH_CPUINFO, &len);
+  if(buf == NULL) {
+    printWarn("Could not open '%s'", _PATH_CPUINFO);
+    return 0;
+  }
+
+  int n = 0;
+  char* ptr = buf;
+  while(n < max && (ptr = strstr(ptr, "cpu MHz")) != NULL && (ptr = strchr(ptr, ':')) != NULL) {
+    mhz[n++] = strtod(ptr+1, &ptr);
+  }
+
+  free(buf);
+  return n;
+}
+
+// Adds to st the estimate of each core in the last epoch. With
+// APERF/MPERF it is the ratio since the previous call, so the
+// first one (with st set to NULL) just reads the counters
+static bool read_source(struct freq_source* src, int* cpus, int num_cores, struct freq_stats* st) {
+  if(src->am == NULL) {
+    int n = read_cpuinfo_mhz(src->mhz, src->num_mhz);
+    for(int i=0; i < num_cores; i++) {
+      if(cpus[i] < n && src->mhz[cpus[i]] > 0) stats_add(st, i, src->mhz[cpus[i]]);
     }
-    fclose(fp);
-    sleep_ms(500);
+    return n > 0;
   }
 
-  if (cpu->hybrid_flag) {
-    // We have an heterogeneous architecture. After measuring the
-    // frequency for all cores, we now need to compute the average
-    // independently for each CPU module.
-    struct cpuInfo* ptr = cpu;
-    double* freq_vector_ptr = freq_vector;
+  for(int i=0; i < num_cores; i++) {
+    uint64_t a, m;
+    if(!aperfmperf_read(src->am, i, &a, &m)) return false;
+    // MPERF does not advance if the core did not leave the idle state
+    if(st != NULL && m != src->mperf[i]) {
+      stats_add(st, i, (double) (a - src->aperf[i]) / (m - src->mperf[i]));
+    }
+    src->aperf[i] = a;
+    src->mperf[i] = m;
+  }
+  return true;
+}
+
+// Takes one estimate per core every MEASURE_EPOCH_MS, until all of
+// them converge or the window ends. The effective frequency of a
+// core is the TSC frequency scaled by the APERF/MPERF ratio, which
+// only accounts for the cycles in C0
+static bool sample_epochs(struct freq_sampler* s, struct freq_source* src, int tfd) {
+  struct freq_stats st;
+  stats_init(&st, s->num_cores);
+  double z = normal_quantile((1 + s->confidence) / 2);
+  struct timespec t0, t1, epoch;
+  uint64_t tsc0, tsc1;
+  bool ok = false;
+
+  if(!arm_timer(tfd, &s->window->start, 0) || !wait_timer(tfd)) goto cleanup;
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  tsc0 = __rdtsc();
+  if(src->am != NULL && !read_source(src, s->cpus, s->num_cores, NULL)) goto cleanup;
+
+  epoch = t0;
+  timespec_add_ms(&epoch, MEASURE_EPOCH_MS);
+  if(!arm_timer(tfd, &epoch, MEASURE_EPOCH_MS)) goto cleanup;
+
+  while(!s->converged && !freq_window_ended(s->window)) {
+    if(!wait_timer(tfd) || !read_source(src, s->cpus, s->num_cores, &st)) goto cleanup;
+    s->epochs++;
+    s->converged = stats_converged(&st, s->num_cores, z, s->tolerance);
+  }
 
-    for (int i=0; i < cpu->num_cpus; ptr = ptr->next_cpu, i++) {
-      freq->max_pp[i] = vector_average_harmonic(freq_vector_ptr, ptr->topo->total_cores_module);
-      printWarn("AVX2 measured freq=%d (module %d)", freq->max_pp[i], i);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  tsc1 = __rdtsc();
+  double scale = src->am == NULL ? 1.0 : (tsc1 - tsc0) / timespec_diff_us(&t0, &t1);
 
-      freq_vector_ptr = freq_vector_ptr + ptr->topo->total_cores_module;
+  for(int i=0; i < s->num_cores; i++) {
+    if(st.n[i] < 2) {
+      printWarn("Not enough frequency samples were read for core %d", s->cpus[i]);
+      goto cleanup;
     }
+    s->core_freq[i] = scale * st.mean[i];
+    s->core_ci[i] = scale * stats_ci(&st, i, z);
+    s->core_min[i] = scale * st.min[i];
+    s->core_max[i] = scale * st.max[i];
   }
-  else {
-    freq->max_pp[0] = vector_average_harmonic(freq_vector, v);
-    printWarn("AVX2 measured freq=%d\n", freq->max_pp[0]);
+  ok = true;
+
+cleanup:
+  stats_free(&st);
+  return ok;
+}
+
+static void open_source(struct freq_source* src, int* cpus, int num_cores) {
+  src->am = aperfmperf_open(cpus, num_cores);
+  src->aperf = emalloc(sizeof(uint64_t) * num_cores);
+  src->mperf = emalloc(sizeof(uint64_t) * num_cores);
+  src->num_mhz = 0;
+  for(int i=0; i < num_cores; i++) src->num_mhz = max(src->num_mhz, cpus[i] + 1);
+  src->mhz = emalloc(sizeof(double) * src->num_mhz);
+  if(src->am == NULL) {
+    printWarn("APERF/MPERF not available, sampling %s instead", _PATH_CPUINFO);
   }
+}
 
-  return NULL;
+static void close_source(struct freq_source* src) {
+  if(src->am != NULL) aperfmperf_close(src->am);
+  free(src->aperf);
+  free(src->mperf);
+  free(src->mhz);
 }
 
-int32_t measure_frequency(struct cpuInfo* cpu, int32_t *max_freq_pp_vec) {
-  if (cpu->hybrid_flag && cpu->module_id > 0) {
-    // We have a hybrid architecture and we have already
-    // measured the frequency for this module in a previous
-    // call to this function, so now just return it.
-    return max_freq_pp_vec[cpu->module_id];
+void* sample_freq(void* sampler_ptr) {
+  struct freq_sampler* s = (struct freq_sampler*) sampler_ptr;
+  s->ok = false;
+  s->converged = false;
+  s->epochs = 0;
+
+  int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+  if(tfd == -1) {
+    printErr("timerfd_create: %s", strerror(errno));
+    freq_window_stop(s->window);
+    return NULL;
   }
 
-  int ret;
-  int num_spaces;
-  struct freq_thread* freq_struct = malloc(sizeof(struct freq_thread));
-  freq_struct->end = false;
-  freq_struct->measure = false;
-  freq_struct->cpu = cpu;
-  freq_struct->max_pp = max_freq_pp_vec;
+  struct freq_source src;
+  open_source(&src, s->cpus, s->num_cores);
 
-  void* (*compute_function)(void*);
+  s->ok = sample_epochs(s, &src, tfd);
+  // Whether it converged or not, the compute threads are done
+  freq_window_stop(s->window);
 
-  if(cpu->feat->AVX512 && vpus_are_AVX512(cpu)) {
-    printf("cpufetch is measuring the AVX512 frequency...");
-    compute_function = compute_avx512;
-    num_spaces = 45;
+  close_source(&src);
+  close(tfd);
+  return NULL;
+}
+
+// Computes the average frequency of each module (or of the whole
+// CPU if it is not hybrid) from the frequency of each core
+static void fill_max_pp(struct cpuInfo* cpu, struct freq_sampler* s, int32_t* max_pp, char* isa) {
+  double mean_ci;
+
+  for(int i=0; s->ok && i < s->num_cores; i++) {
+    printWarn("%s measured freq=%.0f +/- %.1f (core %d)", isa, s->core_freq[i], s->core_ci[i], i);
   }
-  else if(cpu->feat->AVX || cpu->feat->AVX2) {
-    printf("cpufetch is measuring the AVX frequency...");
-    compute_function = compute_avx;
-    num_spaces = 42;
+  if(s->ok && !s->converged) {
+    printWarn("%s frequency did not converge to %.2f%% in %d seconds", isa, s->tolerance * 100, MEASURE_MAX_SECONDS);
+  }
+
+  if (cpu->hybrid_flag) {
+    struct cpuInfo* ptr = cpu;
+    double* core_freq_ptr = s->core_freq;
+    double* core_ci_ptr = s->core_ci;
+
+    for (uint32_t i=0; i < cpu->num_cpus; ptr = ptr->next_cpu, i++) {
+      max_pp[i] = s->ok ? measure_harmonic_mean(core_freq_ptr, core_ci_ptr, ptr->topo->total_cores_module, &mean_ci) : UNKNOWN_DATA;
+      if(s->ok) printWarn("%s measured freq=%d +/- %.1f (module %d, %g%% confidence, %d epochs)", isa, max_pp[i], mean_ci, i, s->confidence * 100, s->epochs);
+
+      core_freq_ptr = core_freq_ptr + ptr->topo->total_cores_module;
+      core_ci_ptr = core_ci_ptr + ptr->topo->total_cores_module;
+    }
   }
   else {
-    printf("cpufetch is measuring the frequency (no vector instructions)...");
-    compute_function = compute_nov;
-    num_spaces = 63;
+    max_pp[0] = s->ok ? measure_harmonic_mean(s->core_freq, s->core_ci, s->num_cores, &mean_ci) : UNKNOWN_DATA;
+    if(s->ok) printWarn("%s measured freq=%d +/- %.1f (%g%% confidence, %d epochs)", isa, max_pp[0], mean_ci, s->confidence * 100, s->epochs);
   }
+}
 
-  fflush(stdout);
+static void init_sampler(struct freq_sampler* s, int* cpus, int num_cores) {
+  s->cpus = cpus;
+  s->num_cores = num_cores;
+  s->tolerance = get_freq_tolerance();
+  s->confidence = get_freq_confidence();
+  s->core_freq = ecalloc(num_cores, sizeof(double));
+  s->core_ci = ecalloc(num_cores, sizeof(double));
+  s->core_min = ecalloc(num_cores, sizeof(double));
+  s->core_max = ecalloc(num_cores, sizeof(double));
+  s->core_flops = ecalloc(num_cores, sizeof(double));
+}
 
+static void free_sampler(struct freq_sampler* s) {
+  free(s->core_freq);
+  free(s->core_ci);
+  free(s->core_min);
+  free(s->core_max);
+  free(s->core_flops);
+}
+
+// FLOP/s achieved by each thread in the window (0 if unknown)
+static void get_threads_flops(struct freq_thread* threads, int num_cores, double tsc_hz, double* flops) {
+  for(int i=0; i < num_cores; i++) {
+    struct freq_thread* t = &threads[i];
+    flops[i] = (tsc_hz > 0 && t->tsc_end > t->tsc_start) ? t->flops / ((t->tsc_end - t->tsc_start) / tsc_hz) : 0;
+  }
+}
+
+// Runs compute_function in each of the cpus, and sampler_function
+// (which must stop the window once it is done) in another thread.
+// The window starts after MEASURE_WARMUP_MS (LOW_NOISE_WARMUP_MS with
+// --low-noise), which let the cores reach a steady frequency under load,
+// and lasts up to seconds since then.
+// If flops is not NULL, it is filled with the FLOP/s of each thread.
+// With --low-noise, the threads only run with SCHED_FIFO if the window
+// is not longer than LOW_NOISE_FIFO_MAX_SECONDS.
+// Returns false if the threads could not be run. In that case, the
+// threads already running are stopped and joined before returning,
+// since window and sampler may live in the stack of the caller
+static bool run_threads(void* (*compute_function)(void*), int* cpu_list, int num_cores,
+                        void* (*sampler_function)(void*), void* sampler, struct freq_window* window, int seconds,
+                        double* flops) {
+  int ret;
+  struct timespec t0, t1;
+  struct tsc_info* tsc = get_tsc_info();
+  struct freq_thread* threads;
+  pthread_t* compute_th = NULL;
   pthread_t freq_t;
-  if(pthread_create(&freq_t, NULL, measure_freq, freq_struct)) {
+  pthread_attr_t attr;
+  cpu_set_t cpus;
+  bool attr_ok = false;
+  bool sampler_running = false;
+  int num_running = 0;
+  bool ok = false;
+
+  if ((ret = posix_memalign((void **) &threads, FREQ_CACHE_LINE, sizeof(struct freq_thread) * num_cores)) != 0) {
+    printErr("posix_memalign: %s", strerror(ret));
+    return false;
+  }
+  memset(threads, 0, sizeof(struct freq_thread) * num_cores);
+  for(int i=0; i < num_cores; i++) threads[i].window = window;
+
+  int warmup_ms = low_noise_enabled() ? LOW_NOISE_WARMUP_MS : MEASURE_WARMUP_MS;
+  bool fifo = seconds <= LOW_NOISE_FIFO_MAX_SECONDS;
+  if(low_noise_enabled() && !fifo) {
+    printWarn("Not using SCHED_FIFO for a measurement of %d seconds (max is %d)", seconds, LOW_NOISE_FIFO_MAX_SECONDS);
+  }
+  uint64_t tsc0 = __rdtsc();
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  window->start = t0;
+  window->end = t0;
+  window->stop = false;
+  timespec_add_ms(&window->start, warmup_ms);
+  timespec_add_ms(&window->end, (int64_t) seconds * 1000);
+  window->tsc_start = tsc->hz > 0 ? tsc0 + (uint64_t) (tsc->hz * warmup_ms / 1000) : 0;
+  window->tsc_end = tsc->hz > 0 ? tsc0 + (uint64_t) (tsc->hz * seconds) : 0;
+
+  if(pthread_create(&freq_t, NULL, sampler_function, sampler)) {
     fprintf(stderr, "Error creating thread\n");
-    return -1;
+    goto cleanup;
   }
+  sampler_running = true;
+  // The sampler must be able to preempt the compute threads
+  if(fifo) measure_set_priority(freq_t, 1);
 
-  pthread_t* compute_th = malloc(sizeof(pthread_t) * cpu->topo->total_cores);
-  cpu_set_t cpus;
-  pthread_attr_t attr;
+  compute_th = emalloc(sizeof(pthread_t) * num_cores);
   if ((ret = pthread_attr_init(&attr)) != 0) {
     printErr("pthread_attr_init: %s", strerror(ret));
-    return -1;
+    goto cleanup;
   }
+  attr_ok = true;
 
-  for(int i=0; i < cpu->topo->total_cores; i++) {
+  for(int i=0; i < num_cores; i++) {
     // We might have called bind_to_cpu previously, binding the threads
     // to a specific core, so now we must make sure we run the new thread
     // on the correct core.
     CPU_ZERO(&cpus);
-    CPU_SET(i, &cpus);
+    CPU_SET(cpu_list[i], &cpus);
     if ((ret = pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpus)) != 0) {
       printErr("pthread_attr_setaffinity_np: %s", strerror(ret));
-      return -1;
+      goto cleanup;
     }
 
-    ret = pthread_create(&compute_th[i], &attr, compute_function, NULL);
+    ret = pthread_create(&compute_th[i], &attr, compute_function, &threads[i]);
 
     if(ret != 0) {
       fprintf(stderr, "Error creating thread\n");
-      return -1;
+      goto cleanup;
     }
+    num_running++;
+    if(fifo) measure_set_priority(compute_th[i], 0);
   }
+  ok = true;
 
-  sleep_ms(500);
-  freq_struct->measure = true;
+cleanup:
+  if(!ok) freq_window_stop(window);
 
-  for(int i=0; i < cpu->topo->total_cores; i++) {
+  for(int i=0; i < num_running; i++) {
     if(pthread_join(compute_th[i], NULL)) {
       fprintf(stderr, "Error joining thread\n");
-      return -1;
+      ok = false;
     }
-    freq_struct->end = true;
   }
 
-  if(pthread_join(freq_t, NULL)) {
+  if(sampler_running && pthread_join(freq_t, NULL)) {
     fprintf(stderr, "Error joining thread\n");
-    return -1;
+    ok = false;
+  }
+
+  if(ok) {
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printWarn("Frequency measurement took %.0f ms", timespec_diff_us(&t0, &t1) / 1000);
+    if(flops != NULL) get_threads_flops(threads, num_cores, tsc->hz, flops);
+  }
+
+  if(attr_ok) pthread_attr_destroy(&attr);
+  free(compute_th);
+  free(threads);
+  return ok;
+}
+
+// Runs the kernel in each of the cpus of the sampler until it has
+// measured their frequency. Returns false if the threads could not
+// be run; the measurement itself may still have failed (s->ok)
+static bool run_kernel_once(void* (*compute_function)(void*), struct freq_sampler* s) {
+  struct freq_window window;
+  s->window = &window;
+  return run_threads(compute_function, s->cpus, s->num_cores, sample_freq, s, &window, MEASURE_MAX_SECONDS, s->core_flops);
+}
+
+// Like run_kernel_once, but repeating the measurement in each of the
+// trials of --low-noise. The frequency of each core is then the mean
+// of its trials (without the outliers), and its interval the one of
+// that mean. The min and max are the ones of all the trials. The
+// result of all the cores is added to the --low-noise table as isa
+static bool run_kernel(void* (*compute_function)(void*), const char* isa, struct freq_sampler* s) {
+  int num_trials = get_low_noise_trials();
+  if(num_trials == 1) return run_kernel_once(compute_function, s);
+
+  int n = s->num_cores;
+  double* freqs = emalloc(sizeof(double) * num_trials * n);
+  double* flops = emalloc(sizeof(double) * num_trials * n);
+  double* core_min = emalloc(sizeof(double) * n);
+  double* core_max = emalloc(sizeof(double) * n);
+  double* column = emalloc(sizeof(double) * num_trials);
+  struct measure_summary summary;
+  struct freq_sampler trial;
+  int ok_trials = 0;
+  int min_kept = num_trials;
+  int epochs = 0;
+  bool converged = true;
+  bool ok = true;
+
+  init_sampler(&trial, s->cpus, n);
+  for(int t=0; ok && t < num_trials; t++) {
+    if(!(ok = run_kernel_once(compute_function, &trial))) break;
+    epochs += trial.epochs;
+    converged = converged && trial.converged;
+    if(!trial.ok) continue;
+
+    for(int c=0; c < n; c++) {
+      freqs[ok_trials * n + c] = trial.core_freq[c];
+      flops[ok_trials * n + c] = trial.core_flops[c];
+      if(ok_trials == 0 || trial.core_min[c] < core_min[c]) core_min[c] = trial.core_min[c];
+      if(ok_trials == 0 || trial.core_max[c] > core_max[c]) core_max[c] = trial.core_max[c];
+    }
+    ok_trials++;
+  }
+
+  s->ok = ok && ok_trials > 0;
+  s->epochs = epochs;
+  s->converged = converged;
+  for(int c=0; s->ok && c < n; c++) {
+    for(int t=0; t < ok_trials; t++) column[t] = freqs[t * n + c];
+    measure_summarize(column, ok_trials, s->confidence, &summary);
+    s->core_freq[c] = summary.mean;
+    s->core_ci[c] = summary.ci;
+    s->core_min[c] = core_min[c];
+    s->core_max[c] = core_max[c];
+    if(summary.num_kept < min_kept) min_kept = summary.num_kept;
+    printWarn("Core %d: median=%.0f MAD=%.1f, kept %d of %d trials", s->cpus[c], summary.median, summary.mad, summary.num_kept, ok_trials);
+
+    for(int t=0; t < ok_trials; t++) column[t] = flops[t * n + c];
+    measure_summarize(column, ok_trials, s->confidence, &summary);
+    s->core_flops[c] = summary.mean;
+  }
+  if(ok && ok_trials < num_trials) {
+    printWarn("Only %d of %d trials measured the frequency", ok_trials, num_trials);
+  }
+  if(s->ok) {
+    double mean_ci;
+    double freq = measure_harmonic_mean(s->core_freq, s->core_ci, n, &mean_ci);
+    freq_trials_add(isa, n, freq, mean_ci, min_kept, num_trials);
+  }
+
+  free_sampler(&trial);
+  free(freqs);
+  free(flops);
+  free(core_min);
+  free(core_max);
+  free(column);
+  return ok;
+}
+
+// Widest kernel with vectors as wide as the ones
+// assumed by get_peak_performance
+static int get_widest_kernel(struct cpuInfo* cpu) {
+  if(cpu->feat->AVX512 && vpus_are_AVX512(cpu)) return KERNEL_AVX512;
+  if(cpu->feat->AVX || cpu->feat->AVX2) return KERNEL_AVX;
+  return KERNEL_NOV;
+}
+
+// get_peak_performance also assumes FMAs, if available
+static int get_peak_kernel(struct cpuInfo* cpu) {
+  int k = get_widest_kernel(cpu);
+  if(!cpu->feat->FMA3) return k;
+  if(k == KERNEL_AVX512) return KERNEL_AVX512_FMA;
+  if(k == KERNEL_AVX) return KERNEL_AVX_FMA;
+  return k;
+}
+
+static bool kernel_supported(struct cpuInfo* cpu, int k) {
+  switch(k) {
+    case KERNEL_NOV:        return true;
+    case KERNEL_SSE:        return cpu->feat->SSE;
+    case KERNEL_AVX:        return cpu->feat->AVX || cpu->feat->AVX2;
+    case KERNEL_AVX_FMA:    return cpu->feat->AVX && cpu->feat->FMA3;
+    case KERNEL_AVX512:
+    case KERNEL_AVX512_FMA: return cpu->feat->AVX512;
+    case KERNEL_AMX:        return cpu->feat->AMX;
+    default:                return false;
+  }
+}
+
+// Module (or the whole CPU if it is not hybrid) of core c
+static struct cpuInfo* get_core_module(struct cpuInfo* cpu, int c) {
+  const char* type = get_str_core_type(cpu, c);
+  for(struct cpuInfo* ptr = cpu; ptr != NULL; ptr = ptr->next_cpu) {
+    if(get_str_core_type(ptr, ptr->first_core_id) == type) return ptr;
+  }
+  return cpu;
+}
+
+// FLOPs per cycle that get_peak_performance assumes for the kernel,
+// or 0 if it does not assume the width of the kernel
+static double get_assumed_flops_per_cycle(struct cpuInfo* cpu, int k) {
+  int widest = get_widest_kernel(cpu);
+  if(widest == KERNEL_NOV || (k != widest && k != get_peak_kernel(cpu))) return 0;
+
+  double fpc = get_number_of_vpus(cpu) * kernels[k].lanes * (kernels[k].heavy ? 2 : 1);
+  if(is_knights_landing(cpu)) fpc = fpc * 6 / 7;
+  return fpc;
+}
+
+// FLOPs per cycle achieved by the kernel in each core (from its FLOP/s
+// and the measured frequency), so that the assumption of the peak
+// performance is verified. Returns their mean, or 0 if unknown
+static double check_kernel_flops(struct cpuInfo* cpu, int k, struct freq_sampler* s) {
+  double acc = 0.0;
+  int count = 0;
+
+  for(int i=0; s->ok && i < s->num_cores; i++) {
+    if(s->core_flops[i] <= 0 || s->core_freq[i] <= 0) continue;
+
+    double fpc = s->core_flops[i] / (s->core_freq[i] * 1000000);
+    double assumed = get_assumed_flops_per_cycle(get_core_module(cpu, s->cpus[i]), k);
+    printWarn("%s achieved %.2f FLOPs/cycle (core %d)", kernels[k].isa, fpc, s->cpus[i]);
+    if(assumed > 0 && fpc < assumed * KERNEL_SATURATION_PCT / 100) {
+      printWarn("%s does not saturate core %d: %.2f FLOPs/cycle, but the peak performance assumes %.0f", kernels[k].isa, s->cpus[i], fpc, assumed);
+    }
+    acc += fpc;
+    count++;
+  }
+
+  return count > 0 ? acc / count : 0;
+}
+
+int32_t measure_frequency(struct cpuInfo* cpu, int32_t *max_freq_pp_vec) {
+  if (cpu->hybrid_flag && cpu->module_id > 0) {
+    // We have a hybrid architecture and we have already
+    // measured the frequency for this module in a previous
+    // call to this function, so now just return it.
+    return max_freq_pp_vec[cpu->module_id];
+  }
+
+  int k = get_widest_kernel(cpu);
+  const struct freq_kernel* kernel = &kernels[k];
+  int* cpus = emalloc(sizeof(int) * cpu->topo->total_cores);
+  for(int i=0; i < cpu->topo->total_cores; i++) cpus[i] = i;
+
+  struct freq_sampler sampler;
+  init_sampler(&sampler, cpus, cpu->topo->total_cores);
+
+  int len = printf("cpufetch is measuring %s...", kernel->desc);
+  fflush(stdout);
+
+  int32_t freq = -1;
+  if(run_kernel(kernel->compute, kernel->isa, &sampler)) {
+    fill_max_pp(cpu, &sampler, max_freq_pp_vec, kernel->isa);
+    check_kernel_flops(cpu, k, &sampler);
+    for(int i=0; sampler.ok && freq_map_enabled() && i < sampler.num_cores; i++) {
+      freq_map_add(kernel->isa, get_str_core_type(cpu, i), i, sampler.core_min[i], sampler.core_freq[i], sampler.core_max[i]);
+    }
+    freq = max_freq_pp_vec[0];
+  }
+  free_sampler(&sampler);
+  free(cpus);
+
+  printf("\r%*c", len, ' ');
+  return freq;
+}
+
+// Orders the CPUs to load one thread per physical core, taking them
+// in turns from each socket and core type so that each step of the
+// curve is spread across them. Returns the number of physical cores
+static int get_turbo_curve_cpus(struct cpuInfo* cpu, int total_cores, int* order) {
+  int* group_of = emalloc(sizeof(int) * total_cores);
+  long* group_socket = emalloc(sizeof(long) * total_cores);
+  const char** group_type = emalloc(sizeof(char *) * total_cores);
+  int* next = ecalloc(total_cores, sizeof(int));
+  char path[_PATH_PACKAGE_MAX_LEN];
+  int num_groups = 0;
+  int num_cores = 0;
+
+  for(int c=0; c < total_cores; c++) {
+    int first_cpu;
+    group_of[c] = -1;
+    sprintf(path, "%s%s/cpu%d%s", _PATH_SYS_SYSTEM, _PATH_SYS_CPU, c, _PATH_TOPO_THREAD_SIBL);
+    if(get_cpu_list_from_file(path, &first_cpu) > 0 && first_cpu != c) continue;
+
+    sprintf(path, "%s%s/cpu%d%s", _PATH_SYS_SYSTEM, _PATH_SYS_CPU, c, _PATH_TOPO_PACKAGE_ID_SYS);
+    long socket = access(path, F_OK) == 0 ? get_long_from_file(path) : 0;
+    const char* type = get_str_core_type(cpu, c);
+
+    int g = 0;
+    while(g < num_groups && (group_socket[g] != socket || group_type[g] != type)) g++;
+    if(g == num_groups) {
+      group_socket[g] = socket;
+      group_type[g] = type;
+      num_groups++;
+    }
+    group_of[c] = g;
+    num_cores++;
+  }
+
+  for(int n=0; n < num_cores; ) {
+    for(int g=0; g < num_groups; g++) {
+      while(next[g] < total_cores && group_of[next[g]] != g) next[g]++;
+      if(next[g] < total_cores) order[n++] = next[g]++;
+    }
+  }
+
+  free(group_of);
+  free(group_socket);
+  free(group_type);
+  free(next);
+  return num_cores;
+}
+
+// Sets the max_pp of each module to the harmonic mean of the
+// frequency of its cores (core_freq[i] is the one of cpus[i])
+static void set_modules_max_pp(struct cpuInfo* cpu, double* core_freq, int* cpus, int num_cores) {
+  for(struct cpuInfo* ptr = cpu; ptr != NULL; ptr = ptr->next_cpu) {
+    const char* type = get_str_core_type(ptr, ptr->first_core_id);
+    double acc = 0.0;
+    int count = 0;
+    for(int i=0; i < num_cores; i++) {
+      if(get_str_core_type(cpu, cpus[i]) != type) continue;
+      acc += 1 / core_freq[i];
+      count++;
+    }
+    if(count > 0) ptr->freq->max_pp = count / acc;
+  }
+}
+
+// Measures the sustained frequency of the kernel with n active cores
+// (the first n in order). Returns 0 if it could not be measured. If
+// fpc is not NULL, it is set to the mean FLOPs per cycle of the cores
+static double measure_kernel(struct cpuInfo* cpu, int k, int* order, int n, struct freq_sampler* sampler, double* fpc) {
+  init_sampler(sampler, order, n);
+  int len = printf("cpufetch is measuring %s with %d %s...", kernels[k].desc, n, n == 1 ? "core" : "cores");
+  fflush(stdout);
+
+  bool ok = run_kernel(kernels[k].compute, kernels[k].isa, sampler) && sampler->ok;
+  printf("\r%*c\r", len, ' ');
+  if(!ok) return 0;
+
+  double mean_ci;
+  double freq = measure_harmonic_mean(sampler->core_freq, sampler->core_ci, n, &mean_ci);
+  printWarn("%s measured freq=%.0f +/- %.1f with %d cores", kernels[k].isa, freq, mean_ci, n);
+  double mean_fpc = check_kernel_flops(cpu, k, sampler);
+  if(fpc != NULL) *fpc = mean_fpc;
+  return freq;
+}
+
+// Measures the sustained frequency of each kernel with 1, 2, 4, ... N
+// active cores. The all-core frequency of the widest kernel is then
+// the max_pp of each module, like in measure_frequency
+void measure_turbo_curve(struct cpuInfo* cpu) {
+  int total_cores = cpu->topo->total_cores;
+  int* order = emalloc(sizeof(int) * total_cores);
+  int num_cores = get_turbo_curve_cpus(cpu, total_cores, order);
+  int widest = get_widest_kernel(cpu);
+  struct freq_sampler sampler;
+
+  for(struct cpuInfo* ptr = cpu; ptr != NULL; ptr = ptr->next_cpu) {
+    ptr->freq->max_pp = UNKNOWN_DATA;
+  }
+
+  for(int c=0; c < (int) (sizeof(curve_kernels) / sizeof(curve_kernels[0])) && curve_kernels[c] <= widest; c++) {
+    int k = curve_kernels[c];
+    for(int n=1; n <= num_cores; n = (n == num_cores || n*2 < num_cores) ? n*2 : num_cores) {
+      double freq = measure_kernel(cpu, k, order, n, &sampler, NULL);
+      if(freq > 0) freq_curve_add(kernels[k].isa, n, freq);
+      if(freq > 0 && k == widest && n == num_cores) set_modules_max_pp(cpu, sampler.core_freq, order, sampler.num_cores);
+      free_sampler(&sampler);
+    }
+  }
+
+  free(order);
+}
+
+// Measures the sustained frequency of each supported kernel with one
+// and with all cores active. The all-core frequency of the kernel that
+// get_peak_performance assumes is then the max_pp of each module
+void measure_isa_freq(struct cpuInfo* cpu) {
+  int total_cores = cpu->topo->total_cores;
+  int* order = emalloc(sizeof(int) * total_cores);
+  int num_cores = get_turbo_curve_cpus(cpu, total_cores, order);
+  int peak = get_peak_kernel(cpu);
+  bool amx = cpu->feat->AMX && request_amx_permission();
+  struct freq_sampler sampler;
+
+  for(struct cpuInfo* ptr = cpu; ptr != NULL; ptr = ptr->next_cpu) {
+    ptr->freq->max_pp = UNKNOWN_DATA;
+  }
+
+  for(int k=0; k < (int) (sizeof(kernels) / sizeof(kernels[0])); k++) {
+    if(!kernel_supported(cpu, k) || (k == KERNEL_AMX && !amx)) continue;
+
+    double fpc = 0;
+    double single_core = measure_kernel(cpu, k, order, 1, &sampler, &fpc);
+    double all_core = single_core;
+    if(num_cores > 1) {
+      free_sampler(&sampler);
+      all_core = measure_kernel(cpu, k, order, num_cores, &sampler, &fpc);
+    }
+
+    if(k == peak && all_core > 0) set_modules_max_pp(cpu, sampler.core_freq, order, sampler.num_cores);
+    free_sampler(&sampler);
+    freq_isa_add(kernels[k].isa, kernels[k].isa_class, kernels[k].heavy, num_cores, single_core, all_core, fpc);
+  }
+
+  free(order);
+}
+
+struct soak_sampler {
+  struct freq_window* window;
+  int* cpus;
+  int num_cores;
+  int seconds;
+  struct sensors* sensors;
+  bool ok;
+};
+
+// Adds one sample per SOAK_EPOCH_MS to the soak series, with the
+// frequency of each core, the package power and the temperatures
+static bool sample_soak_epochs(struct soak_sampler* s, struct freq_source* src, int tfd) {
+  struct freq_stats st;
+  stats_init(&st, s->num_cores);
+  double* core_freq = emalloc(sizeof(double) * s->num_cores);
+  double* temps = emalloc(sizeof(double) * (sensors_num_temps(s->sensors) + 1));
+  struct timespec t_start, t0, t1, epoch;
+  uint64_t tsc0, tsc1;
+  double e0, e1;
+  bool ok = false;
+
+  if(!arm_timer(tfd, &s->window->start, 0) || !wait_timer(tfd)) goto cleanup;
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  t_start = t0;
+  tsc0 = __rdtsc();
+  if(src->am != NULL && !read_source(src, s->cpus, s->num_cores, NULL)) goto cleanup;
+  bool energy = sensors_read_energy(s->sensors, &e0);
+
+  epoch = t0;
+  timespec_add_ms(&epoch, SOAK_EPOCH_MS);
+  if(!arm_timer(tfd, &epoch, SOAK_EPOCH_MS)) goto cleanup;
+
+  // The window is only stopped before the end if run_threads failed
+  for(int i=0; i < s->seconds * 1000 / SOAK_EPOCH_MS && !__atomic_load_n(&s->window->stop, __ATOMIC_RELAXED); i++) {
+    stats_reset(&st, s->num_cores);
+    if(!wait_timer(tfd) || !read_source(src, s->cpus, s->num_cores, &st)) goto cleanup;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    tsc1 = __rdtsc();
+
+    double us = timespec_diff_us(&t0, &t1);
+    double scale = src->am == NULL ? 1.0 : (tsc1 - tsc0) / us;
+    for(int j=0; j < s->num_cores; j++) {
+      core_freq[j] = st.n[j] > 0 ? scale * st.mean[j] : 0;
+    }
+
+    double watts = NAN;
+    if(energy && (energy = sensors_read_energy(s->sensors, &e1))) {
+      watts = (e1 - e0) / (us / 1000000);
+      e0 = e1;
+    }
+    sensors_read_temps(s->sensors, temps);
+    soak_add(timespec_diff_us(&t_start, &t1) / 1000000, core_freq, watts, temps);
+
+    t0 = t1;
+    tsc0 = tsc1;
+  }
+  ok = true;
+
+cleanup:
+  stats_free(&st);
+  free(core_freq);
+  free(temps);
+  return ok;
+}
+
+void* sample_soak(void* sampler_ptr) {
+  struct soak_sampler* s = (struct soak_sampler*) sampler_ptr;
+  s->ok = false;
+
+  int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+  if(tfd == -1) {
+    printErr("timerfd_create: %s", strerror(errno));
+    freq_window_stop(s->window);
+    return NULL;
+  }
+
+  struct freq_source src;
+  open_source(&src, s->cpus, s->num_cores);
+
+  s->ok = sample_soak_epochs(s, &src, tfd);
+  freq_window_stop(s->window);
+
+  close_source(&src);
+  close(tfd);
+  return NULL;
+}
+
+// Keeps all the cores busy with the kernel that get_peak_performance
+// assumes for the given seconds. The steady-state frequency of each
+// module is then its max_pp, which also gives the GFLOP/s per W
+void measure_soak(struct cpuInfo* cpu, int seconds) {
+  const struct freq_kernel* kernel = &kernels[get_peak_kernel(cpu)];
+  int total_cores = cpu->topo->total_cores;
+  int* cpus = emalloc(sizeof(int) * total_cores);
+  double* core_freq = emalloc(sizeof(double) * total_cores);
+  for(int i=0; i < total_cores; i++) cpus[i] = i;
+
+  struct freq_window window;
+  struct soak_sampler sampler;
+  sampler.window = &window;
+  sampler.cpus = cpus;
+  sampler.num_cores = total_cores;
+  sampler.seconds = seconds;
+  sampler.sensors = sensors_open("");
+  soak_begin(cpus, total_cores, sampler.sensors);
+
+  for(struct cpuInfo* ptr = cpu; ptr != NULL; ptr = ptr->next_cpu) {
+    ptr->freq->max_pp = UNKNOWN_DATA;
+  }
+
+  int len = printf("cpufetch is measuring %s for %d seconds...", kernel->desc, seconds);
+  fflush(stdout);
+
+  // The sampler stops the window, the extra second is just a margin
+  bool ok = run_threads(kernel->compute, cpus, total_cores, sample_soak, &sampler, &window, seconds + 1, NULL) && sampler.ok;
+  printf("\r%*c\r", len, ' ');
+
+  if(ok && soak_steady_core_freq(core_freq)) {
+    set_modules_max_pp(cpu, core_freq, cpus, total_cores);
+    int64_t flops = get_peak_performance(cpu, true);
+    if(flops > 0) soak_set_gflops(flops / 1000000000.0);
   }
 
-  printf("\r%*c", num_spaces, ' ');
-  return max_freq_pp_vec[0];
+  sensors_close(sampler.sensors);
+  free(core_freq);
+  free(cpus);
 }
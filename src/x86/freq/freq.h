@@ -5,9 +5,39 @@
 #include "../../common/cpu.h"
 #include "../../common/global.h"
 
-#define MEASURE_TIME_SECONDS         5
-#define LOOP_ITERS           100000000
+// The frequency is sampled every MEASURE_EPOCH_MS until it converges
+// (after MEASURE_MIN_EPOCHS at least) or MEASURE_MAX_SECONDS elapse.
+// The kernels check the deadline (a TSC read) every LOOP_ITERS, which
+// takes a fraction of a millisecond, so they stop right after
+#define MEASURE_MAX_SECONDS          5
+#define MEASURE_WARMUP_MS          100
+#define MEASURE_EPOCH_MS            20
+#define MEASURE_MIN_EPOCHS           5
+#define LOOP_ITERS              100000
+// The soak test samples once per SOAK_EPOCH_MS instead
+#define SOAK_EPOCH_MS             1000
+#define FREQ_CACHE_LINE             64
+
+struct freq_window;
+
+// Argument of the compute kernels, one per thread. Each thread only
+// writes its own, which is padded to a cache line so that they do
+// not share one. flops are the ones done between tsc_start and
+// tsc_end, which are taken after a block (the first one, once the
+// window started)
+struct freq_thread {
+  struct freq_window* window;
+  uint64_t flops;
+  uint64_t tsc_start;
+  uint64_t tsc_end;
+} __attribute__((aligned(FREQ_CACHE_LINE)));
 
 int32_t measure_frequency(struct cpuInfo* cpu, int32_t *max_freq_pp_vec);
+void measure_turbo_curve(struct cpuInfo* cpu);
+void measure_isa_freq(struct cpuInfo* cpu);
+void measure_soak(struct cpuInfo* cpu, int seconds);
+// Called by the kernels after each block, with the FLOPs done in it.
+// Returns true once they must stop
+bool freq_thread_block(struct freq_thread* t, uint64_t flops);
 
 #endif
@@ -0,0 +1,100 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <immintrin.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "freq.h"
+
+#define ARCH_REQ_XCOMP_PERM  0x1023
+#define XFEATURE_XTILEDATA   18
+
+// Each TDPBF16PS takes much longer than a vector add
+#define AMX_LOOP_ITERS       (LOOP_ITERS / 16)
+
+#define TILE_ROWS            16
+#define TILE_BYTES           64
+// Each TDPBF16PS multiplies a 16x32 by a 32x16 (bf16) matrix
+#define AMX_TILE_FLOPS       (TILE_ROWS * TILE_ROWS * (TILE_BYTES / 2) * 2)
+
+// Palette 1 tile configuration, as loaded by LDTILECFG
+struct tile_config {
+  uint8_t palette_id;
+  uint8_t start_row;
+  uint8_t reserved[14];
+  uint16_t colsb[16];
+  uint8_t rows[16];
+};
+
+// Linux does not let a process use AMX until it asks for it
+bool request_amx_permission(void) {
+  if(syscall(SYS_arch_prctl, ARCH_REQ_XCOMP_PERM, XFEATURE_XTILEDATA) != 0) {
+    printWarn("arch_prctl(ARCH_REQ_XCOMP_PERM): %s", strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+void* compute_amx(void * pthread_arg) {
+  struct freq_thread* t = (struct freq_thread*) pthread_arg;
+  bool end = false;
+
+  // bf16 1.0 in every element of A and B
+  uint16_t a[TILE_ROWS * TILE_BYTES / 2];
+  uint16_t b[TILE_ROWS * TILE_BYTES / 2];
+  float c[TILE_ROWS * TILE_BYTES / 4];
+
+  for(int i=0; i < TILE_ROWS * TILE_BYTES / 2; i++) {
+    a[i] = 0x3F80;
+    b[i] = 0x3F80;
+  }
+
+  struct tile_config cfg;
+  memset(&cfg, 0, sizeof(struct tile_config));
+  cfg.palette_id = 1;
+  for(int i=0; i < 6; i++) {
+    cfg.rows[i] = TILE_ROWS;
+    cfg.colsb[i] = TILE_BYTES;
+  }
+  _tile_loadconfig(&cfg);
+
+  // Tiles 0-3 accumulate, 4 and 5 hold A and B
+  _tile_loadd(4, a, TILE_BYTES);
+  _tile_loadd(5, b, TILE_BYTES);
+
+  while(!end) {
+    _tile_zero(0);
+    _tile_zero(1);
+    _tile_zero(2);
+    _tile_zero(3);
+
+    for(uint64_t i=0; i < AMX_LOOP_ITERS; i++) {
+      _tile_dpbf16ps(0, 4, 5);
+      _tile_dpbf16ps(1, 4, 5);
+      _tile_dpbf16ps(2, 4, 5);
+      _tile_dpbf16ps(3, 4, 5);
+    }
+
+    end = freq_thread_block(t, AMX_LOOP_ITERS * 4 * AMX_TILE_FLOPS);
+  }
+
+  _tile_stored(0, c, TILE_BYTES);
+  _tile_release();
+
+  FILE* fp = fopen("/dev/null", "w");
+  if(fp == NULL) {
+    printf("fopen: %s", strerror(errno));
+  }
+  else {
+    fprintf(fp, "%f", c[0]);
+    fclose(fp);
+  }
+
+  return NULL;
+}
@@ -0,0 +1,9 @@
+#ifndef __FREQ_AMX__
+#define __FREQ_AMX__
+
+#include <stdbool.h>
+
+bool request_amx_permission(void);
+void* compute_amx(void * pthread_arg);
+
+#endif
@@ -2,5 +2,6 @@
 #define __FREQ_AVX__
 
 void* compute_avx(void * pthread_arg);
+void* compute_avx_fma(void * pthread_arg);
 
 #endif
@@ -2,5 +2,6 @@
 #define __FREQ_AVX512__
 
 void* compute_avx512(void * pthread_arg);
+void* compute_avx512_fma(void * pthread_arg);
 
 #endif
@@ -2,33 +2,39 @@
 #include <immintrin.h>
 #include <stdlib.h>
 #include <stdbool.h>
-#include <sys/time.h>
-#include <time.h>
 #include <errno.h>
 #include <string.h>
 #include <pthread.h>
 #include <stdint.h>
 #include "freq.h"
 
+// Scalar adds, with as many independent chains as the vector kernels.
+// It is built without vectorization, so they stay scalar
 void* compute_nov(void * pthread_arg) {
-  UNUSED(pthread_arg);
+  struct freq_thread* t = (struct freq_thread*) pthread_arg;
   bool end = false;
 
-  struct timeval begin, now;
+  float a[8];
+  float b[8];
 
-  float a = 1.5;
-  float b = 1.2;
-  float c = 0.0;
+  for(int i=0; i < 8; i++) {
+    a[i] = 1.5;
+    b[i] = 1.2;
+  }
 
-  gettimeofday(&begin, NULL);
   while(!end) {
     for(uint64_t i=0; i < LOOP_ITERS; i++) {
-      c = a * b;
+      a[0] = a[0] + b[0];
+      a[1] = a[1] + b[1];
+      a[2] = a[2] + b[2];
+      a[3] = a[3] + b[3];
+      a[4] = a[4] + b[4];
+      a[5] = a[5] + b[5];
+      a[6] = a[6] + b[6];
+      a[7] = a[7] + b[7];
     }
 
-    gettimeofday(&now, NULL);
-    double elapsed = (now.tv_sec - begin.tv_sec) + ((now.tv_usec - begin.tv_usec)/1000000.0);
-    end = elapsed >= (double) MEASURE_TIME_SECONDS;
+    end = freq_thread_block(t, LOOP_ITERS * 8);
   }
 
   FILE* fp = fopen("/dev/null", "w");
@@ -36,7 +42,8 @@ void* compute_nov(void * pthread_arg) {
     printf("fopen: %s", strerror(errno));
   }
   else {
-    fprintf(fp, "%f", c);
+    for(int i=0; i < 8; i++)
+      fprintf(fp, "%f", a[i]);
     fclose(fp);
   }
 
@@ -0,0 +1,6 @@
+#ifndef __FREQ_SSE__
+#define __FREQ_SSE__
+
+void* compute_sse(void * pthread_arg);
+
+#endif
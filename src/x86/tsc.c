@@ -0,0 +1,134 @@
+#ifndef _WIN32
+  #define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdint.h>
+#include <time.h>
+#include <x86intrin.h>
+
+#include "tsc.h"
+#include "cpuid_asm.h"
+#include "../common/global.h"
+
+#define TSC_CALIBRATION_MS    50
+#define HV_LEAF_TIMING        0x40000010
+
+static struct tsc_info tsc;
+static bool tsc_init = false;
+
+static const char* tsc_source_str[] = {
+  [TSC_SOURCE_UNKNOWN]     = "Unknown",
+  [TSC_SOURCE_CPUID]       = "CPUID",
+  [TSC_SOURCE_CPUID_BASE]  = "CPUID (base frequency)",
+  [TSC_SOURCE_HYPERVISOR]  = "Hypervisor",
+  [TSC_SOURCE_CALIBRATED]  = "Calibrated"
+};
+
+// Leaf 0x15 gives the TSC/crystal ratio and, usually, the crystal
+// frequency. When the latter is missing, it is derived from the base
+// frequency in leaf 0x16, which is the TSC frequency (like Linux does)
+static bool get_tsc_from_cpuid(struct tsc_info* t) {
+  uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+  cpuid(&eax, &ebx, &ecx, &edx);
+  uint32_t max_level = eax;
+  if(max_level < 0x15) return false;
+
+  eax = 0x15; ebx = 0; ecx = 0; edx = 0;
+  cpuid(&eax, &ebx, &ecx, &edx);
+  uint32_t denominator = eax;
+  uint32_t numerator = ebx;
+  uint32_t crystal = ecx;
+  if(denominator == 0 || numerator == 0) return false;
+
+  if(crystal != 0) {
+    t->crystal_hz = crystal;
+    t->hz = (double) crystal * numerator / denominator;
+    t->source = TSC_SOURCE_CPUID;
+    return true;
+  }
+
+  if(max_level < 0x16) return false;
+  eax = 0x16; ebx = 0; ecx = 0; edx = 0;
+  cpuid(&eax, &ebx, &ecx, &edx);
+  if((eax & 0xFFFF) == 0) return false;
+
+  t->hz = (eax & 0xFFFF) * 1000000.0;
+  t->crystal_hz = t->hz * denominator / numerator;
+  t->source = TSC_SOURCE_CPUID_BASE;
+  return true;
+}
+
+// VMware and KVM (if the VMM sets it) report the TSC frequency in kHz
+static bool get_tsc_from_hypervisor(struct tsc_info* t) {
+  uint32_t eax = 1, ebx = 0, ecx = 0, edx = 0;
+  cpuid(&eax, &ebx, &ecx, &edx);
+  if(!((ecx >> 31) & 1)) return false;
+
+  eax = 0x40000000; ebx = 0; ecx = 0; edx = 0;
+  cpuid(&eax, &ebx, &ecx, &edx);
+  if(eax < HV_LEAF_TIMING) return false;
+
+  eax = HV_LEAF_TIMING; ebx = 0; ecx = 0; edx = 0;
+  cpuid(&eax, &ebx, &ecx, &edx);
+  if(eax == 0) return false;
+
+  t->hz = eax * 1000.0;
+  t->source = TSC_SOURCE_HYPERVISOR;
+  return true;
+}
+
+#ifndef _WIN32
+static double timespec_diff_ns(struct timespec* a, struct timespec* b) {
+  return (b->tv_sec - a->tv_sec) * 1000000000.0 + (b->tv_nsec - a->tv_nsec);
+}
+
+// Counts the TSC ticks while CLOCK_MONOTONIC_RAW (not slewed by NTP)
+// advances TSC_CALIBRATION_MS. Each timestamp is taken between two
+// TSC reads, so the error is bounded by the time between them
+static bool calibrate_tsc(struct tsc_info* t) {
+#ifdef CLOCK_MONOTONIC_RAW
+  clockid_t clock = CLOCK_MONOTONIC_RAW;
+#else
+  clockid_t clock = CLOCK_MONOTONIC;
+#endif
+  struct timespec t0, t1, now;
+  unsigned int aux;
+
+  uint64_t tsc0 = __rdtscp(&aux);
+  if(clock_gettime(clock, &t0) == -1) return false;
+  tsc0 = (tsc0 + __rdtscp(&aux)) / 2;
+
+  do {
+    if(clock_gettime(clock, &now) == -1) return false;
+  } while(timespec_diff_ns(&t0, &now) < TSC_CALIBRATION_MS * 1000000.0);
+
+  uint64_t tsc1 = __rdtscp(&aux);
+  clock_gettime(clock, &t1);
+  tsc1 = (tsc1 + __rdtscp(&aux)) / 2;
+
+  t->hz = (tsc1 - tsc0) / timespec_diff_ns(&t0, &t1) * 1000000000.0;
+  t->source = TSC_SOURCE_CALIBRATED;
+  return t->hz > 0;
+}
+#endif
+
+struct tsc_info* get_tsc_info(void) {
+  if(tsc_init) return &tsc;
+  tsc_init = true;
+
+  tsc.hz = 0;
+  tsc.crystal_hz = 0;
+  tsc.source = TSC_SOURCE_UNKNOWN;
+
+  if(get_tsc_from_cpuid(&tsc) || get_tsc_from_hypervisor(&tsc)) return &tsc;
+#ifndef _WIN32
+  if(calibrate_tsc(&tsc)) return &tsc;
+#endif
+
+  printWarn("Unable to find the TSC frequency");
+  return &tsc;
+}
+
+const char* get_str_tsc_source(int source) {
+  return tsc_source_str[source];
+}
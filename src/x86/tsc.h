@@ -0,0 +1,26 @@
+#ifndef __TSC__
+#define __TSC__
+
+#include <stdbool.h>
+
+enum {
+  TSC_SOURCE_UNKNOWN,
+  TSC_SOURCE_CPUID,       // Crystal clock (leaf 0x15)
+  TSC_SOURCE_CPUID_BASE,  // Crystal derived from the base frequency (leaf 0x16)
+  TSC_SOURCE_HYPERVISOR,  // Timing leaf of the hypervisor (0x40000010)
+  TSC_SOURCE_CALIBRATED   // Measured against CLOCK_MONOTONIC_RAW
+};
+
+struct tsc_info {
+  double hz;
+  // Nominal frequency of the core crystal clock, 0 if unknown
+  double crystal_hz;
+  int source;
+};
+
+// TSC frequency, from CPUID if it is enumerated there or calibrated
+// otherwise. It is only computed in the first call
+struct tsc_info* get_tsc_info(void);
+const char* get_str_tsc_source(int source);
+
+#endif
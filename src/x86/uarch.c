@@ -5,6 +5,8 @@
 
 #include "uarch.h"
 #include "../common/global.h"
+#include "../common/args.h"
+#include "../common/uarchdb.h"
 
 /*
  * - cpuid codes are based on Todd Allen's cpuid program
@@ -129,324 +131,446 @@ struct uarch {
   MICROARCH uarch;
   char* uarch_str;
   int32_t process; // measured in nanometers
+  int32_t vpus;    // NA if not given by the uarch database
 };
 
-#define UARCH_START if (false) {}
-#define CHECK_UARCH(arch, ef_, f_, em_, m_, s_, str, uarch, process) \
-   else if (ef_ == ef && f_ == f && (em_ == NA || em_ == em) && (m_ == NA || m_ == m) && (s_ == NA || s_ == s)) fill_uarch(arch, str, uarch, process);
-#define UARCH_END else { printBugCheckRelease("Unknown microarchitecture detected: M=0x%X EM=0x%X F=0x%X EF=0x%X S=0x%X", m, em, f, ef, s); \
-fill_uarch(arch, STRING_UNKNOWN, UARCH_UNKNOWN, UNK); }
+// Used to parse the uarch database file
+static const char* uarch_names[] = {
+  [UARCH_UNKNOWN]         = "UNKNOWN",
+  [UARCH_I486]            = "I486",
+  [UARCH_P5]              = "P5",
+  [UARCH_P5_MMX]          = "P5_MMX",
+  [UARCH_P6_PRO]          = "P6_PRO",
+  [UARCH_P6_PENTIUM_II]   = "P6_PENTIUM_II",
+  [UARCH_P6_PENTIUM_III]  = "P6_PENTIUM_III",
+  [UARCH_DOTHAN]          = "DOTHAN",
+  [UARCH_YONAH]           = "YONAH",
+  [UARCH_MEROM]           = "MEROM",
+  [UARCH_PENYR]           = "PENYR",
+  [UARCH_NEHALEM]         = "NEHALEM",
+  [UARCH_WESTMERE]        = "WESTMERE",
+  [UARCH_BONNELL]         = "BONNELL",
+  [UARCH_SALTWELL]        = "SALTWELL",
+  [UARCH_SANDY_BRIDGE]    = "SANDY_BRIDGE",
+  [UARCH_SILVERMONT]      = "SILVERMONT",
+  [UARCH_IVY_BRIDGE]      = "IVY_BRIDGE",
+  [UARCH_HASWELL]         = "HASWELL",
+  [UARCH_BROADWELL]       = "BROADWELL",
+  [UARCH_AIRMONT]         = "AIRMONT",
+  [UARCH_KABY_LAKE]       = "KABY_LAKE",
+  [UARCH_COMET_LAKE]      = "COMET_LAKE",
+  [UARCH_ROCKET_LAKE]     = "ROCKET_LAKE",
+  [UARCH_AMBER_LAKE]      = "AMBER_LAKE",
+  [UARCH_WHISKEY_LAKE]    = "WHISKEY_LAKE",
+  [UARCH_SKYLAKE]         = "SKYLAKE",
+  [UARCH_CASCADE_LAKE]    = "CASCADE_LAKE",
+  [UARCH_COOPER_LAKE]     = "COOPER_LAKE",
+  [UARCH_KNIGHTS_LANDING] = "KNIGHTS_LANDING",
+  [UARCH_KNIGHTS_MILL]    = "KNIGHTS_MILL",
+  [UARCH_GOLDMONT]        = "GOLDMONT",
+  [UARCH_PALM_COVE]       = "PALM_COVE",
+  [UARCH_SUNNY_COVE]      = "SUNNY_COVE",
+  [UARCH_GOLDMONT_PLUS]   = "GOLDMONT_PLUS",
+  [UARCH_TREMONT]         = "TREMONT",
+  [UARCH_LAKEMONT]        = "LAKEMONT",
+  [UARCH_COFFEE_LAKE]     = "COFFEE_LAKE",
+  [UARCH_ITANIUM]         = "ITANIUM",
+  [UARCH_KNIGHTS_FERRY]   = "KNIGHTS_FERRY",
+  [UARCH_KNIGHTS_CORNER]  = "KNIGHTS_CORNER",
+  [UARCH_WILLAMETTE]      = "WILLAMETTE",
+  [UARCH_NORTHWOOD]       = "NORTHWOOD",
+  [UARCH_PRESCOTT]        = "PRESCOTT",
+  [UARCH_CEDAR_MILL]      = "CEDAR_MILL",
+  [UARCH_ITANIUM2]        = "ITANIUM2",
+  [UARCH_ICE_LAKE]        = "ICE_LAKE",
+  [UARCH_SAPPHIRE_RAPIDS] = "SAPPHIRE_RAPIDS",
+  [UARCH_TIGER_LAKE]      = "TIGER_LAKE",
+  [UARCH_ALDER_LAKE]      = "ALDER_LAKE",
+  [UARCH_RAPTOR_LAKE]     = "RAPTOR_LAKE",
+  [UARCH_AM486]           = "AM486",
+  [UARCH_AM5X86]          = "AM5X86",
+  [UARCH_SSA5]            = "SSA5",
+  [UARCH_K5]              = "K5",
+  [UARCH_K6]              = "K6",
+  [UARCH_K7]              = "K7",
+  [UARCH_K8]              = "K8",
+  [UARCH_K10]             = "K10",
+  [UARCH_PUMA_2008]       = "PUMA_2008",
+  [UARCH_BOBCAT]          = "BOBCAT",
+  [UARCH_BULLDOZER]       = "BULLDOZER",
+  [UARCH_PILEDRIVER]      = "PILEDRIVER",
+  [UARCH_STEAMROLLER]     = "STEAMROLLER",
+  [UARCH_EXCAVATOR]       = "EXCAVATOR",
+  [UARCH_JAGUAR]          = "JAGUAR",
+  [UARCH_PUMA_2014]       = "PUMA_2014",
+  [UARCH_ZEN]             = "ZEN",
+  [UARCH_ZEN_PLUS]        = "ZEN_PLUS",
+  [UARCH_ZEN2]            = "ZEN2",
+  [UARCH_ZEN3]            = "ZEN3",
+  [UARCH_ZEN3_PLUS]       = "ZEN3_PLUS",
+  [UARCH_ZEN4]            = "ZEN4",
+  [UARCH_ZEN4C]           = "ZEN4C",
+  [UARCH_ZEN5]            = "ZEN5",
+  [UARCH_ZEN5C]           = "ZEN5C",
+};
+
+// The signature packs the vendor and the cpuid fields
+#define X86_SIG(vendor, ef, f, em, m, s) \
+  (UARCH_DB_FIELD(vendor, 24, 8) | UARCH_DB_FIELD(ef, 16, 8) | UARCH_DB_FIELD(f, 12, 4) | UARCH_DB_FIELD(em, 8, 4) | UARCH_DB_FIELD(m, 4, 4) | UARCH_DB_FIELD(s, 0, 4))
+#define X86_MASK(vendor, ef, f, em, m, s) \
+  (UARCH_DB_MASK(vendor, 24, 8) | UARCH_DB_MASK(ef, 16, 8) | UARCH_DB_MASK(f, 12, 4) | UARCH_DB_MASK(em, 8, 4) | UARCH_DB_MASK(m, 4, 4) | UARCH_DB_MASK(s, 0, 4))
+
+#define UARCH_ENTRY(vendor, ef, f, em, m, s, str, uarch, process) \
+  { X86_MASK(CPU_VENDOR_##vendor, ef, f, em, m, s), X86_SIG(CPU_VENDOR_##vendor, ef, f, em, m, s), uarch, str, process, CPU_VENDOR_##vendor, NA },
 
 void fill_uarch(struct uarch* arch, char* str, MICROARCH u, uint32_t process) {
-  arch->uarch_str = emalloc(sizeof(char) * (strlen(str)+1));
+  arch->uarch_str = amalloc(sizeof(char) * (strlen(str)+1));
   strcpy(arch->uarch_str, str);
   arch->uarch = u;
   arch->process= process;
+  arch->vpus = NA;
 }
 
-// Inspired in Todd Allen's decode_uarch_intel
-struct uarch* get_uarch_from_cpuid_intel(uint32_t ef, uint32_t f, uint32_t em, uint32_t m, int s) {
-  struct uarch* arch = emalloc(sizeof(struct uarch));
-
-  // EF: Extended Family                                                             //
-  // F:  Family                                                                      //
-  // EM: Extended Model                                                              //
-  // M: Model                                                                        //
-  // S: Stepping                                                                     //
-  // ------------------------------------------------------------------------------- //
-  //                EF  F  EM   M   S                                                //
-  UARCH_START
-  CHECK_UARCH(arch, 0,  4,  0,  0, NA, "i80486DX",          UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch, 0,  4,  0,  1, NA, "i80486DX-50",       UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch, 0,  4,  0,  2, NA, "i80486SX",          UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch, 0,  4,  0,  3, NA, "i80486DX2",         UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch, 0,  4,  0,  4, NA, "i80486SL",          UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch, 0,  4,  0,  5, NA, "i80486SX2",         UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch, 0,  4,  0,  7, NA, "i80486DX2WB",       UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch, 0,  4,  0,  8, NA, "i80486DX4",         UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch, 0,  4,  0,  9, NA, "i80486DX4WB",       UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch, 0,  5,  0,  0, NA, "P5",                UARCH_P5,              800)
-  CHECK_UARCH(arch, 0,  5,  0,  1, NA, "P5",                UARCH_P5,              800)
-  CHECK_UARCH(arch, 0,  5,  0,  2, NA, "P54C",              UARCH_P5,              UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch, 0,  5,  0,  3, NA, "P24T (Overdrive)",  UARCH_P5,              600) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch, 0,  5,  0,  4, NA, "P55C (MMX)",        UARCH_P5_MMX,          350) // https://www.cpu-world.com/CPUs/Pentium/TYPE-Pentium%20MMX.html
-  CHECK_UARCH(arch, 0,  5,  0,  7, NA, "P54C",              UARCH_P5,              350) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch, 0,  5,  0,  8, NA, "Tillamook",         UARCH_P5_MMX,          250) // http://instlatx64.atw.hu./
-  CHECK_UARCH(arch, 0,  5,  0,  9,  0, "Lakemont",          UARCH_LAKEMONT,         32)
-  CHECK_UARCH(arch, 0,  5,  0,  9, NA, "P5 (MMX)",          UARCH_P5_MMX,          UNK)
-  CHECK_UARCH(arch, 0,  5,  0, 10,  0, "Lakemont",          UARCH_LAKEMONT,         32)
-  CHECK_UARCH(arch, 0,  6,  0,  1,  1, "P6",                UARCH_P6_PRO,          UNK)
-  CHECK_UARCH(arch, 0,  6,  0,  1,  2, "P6",                UARCH_P6_PRO,          UNK)
-  CHECK_UARCH(arch, 0,  6,  0,  1,  6, "P6",                UARCH_P6_PRO,          350)
-  CHECK_UARCH(arch, 0,  6,  0,  1,  7, "P6",                UARCH_P6_PRO,          350)
-  CHECK_UARCH(arch, 0,  6,  0,  1,  9, "P6",                UARCH_P6_PRO,          350)
-  CHECK_UARCH(arch, 0,  6,  0,  0, NA, "P6 (Pentium II)",   UARCH_P6_PENTIUM_II,   UNK)
-  CHECK_UARCH(arch, 0,  6,  0,  1, NA, "P6 (Pentium II)",   UARCH_P6_PENTIUM_II,   UNK) // process depends on core
-  CHECK_UARCH(arch, 0,  6,  0,  2, NA, "P6 (Pentium II)",   UARCH_P6_PENTIUM_II,   UNK)
-  CHECK_UARCH(arch, 0,  6,  0,  3, NA, "P6 (Klamath)",      UARCH_P6_PENTIUM_II,   350) // http://instlatx64.atw.hu.
-  CHECK_UARCH(arch, 0,  6,  0,  4, NA, "P6 (Pentium II)",   UARCH_P6_PENTIUM_II,   UNK)
-  CHECK_UARCH(arch, 0,  6,  0,  5, NA, "P6 (Deschutes)",    UARCH_P6_PENTIUM_II,   250) // http://instlatx64.atw.hu.
-  CHECK_UARCH(arch, 0,  6,  0,  6, NA, "P6 (Dixon)",        UARCH_P6_PENTIUM_II,   UNK) // http://instlatx64.atw.hu.
-  CHECK_UARCH(arch, 0,  6,  0,  7, NA, "P6 (Katmai)",       UARCH_P6_PENTIUM_III,  250) // Core names from: https://en.wikichip.org/wiki/intel/cpuid. NOTE: Xeon core names are different! https://www.techpowerup.com/cpu-specs/?generation=Intel+Pentium+III+Xeon
-  CHECK_UARCH(arch, 0,  6,  0,  8, NA, "P6 (Coppermine)",   UARCH_P6_PENTIUM_III,  180) // Also: https://en.wikipedia.org/wiki/Pentium_III
-  CHECK_UARCH(arch, 0,  6,  0,  9, NA, "P6 (Pentium M)",    UARCH_P6_PENTIUM_III,  130)
-  CHECK_UARCH(arch, 0,  6,  0, 10, NA, "P6 (Coppermine T)", UARCH_P6_PENTIUM_III,  180)
-  CHECK_UARCH(arch, 0,  6,  0, 11, NA, "P6 (Tualatin)",     UARCH_P6_PENTIUM_III,  130)
-  CHECK_UARCH(arch, 0,  6,  0, 13, NA, "Dothan",            UARCH_DOTHAN,          UNK)  // process depends on core
-  CHECK_UARCH(arch, 0,  6,  0, 14, NA, "Yonah",             UARCH_YONAH,            65)
-  CHECK_UARCH(arch, 0,  6,  0, 15, NA, "Merom",             UARCH_MEROM,            65)
-  CHECK_UARCH(arch, 0,  6,  1,  5, NA, "Dothan",            UARCH_DOTHAN,           90)
-  CHECK_UARCH(arch, 0,  6,  1,  6, NA, "Merom",             UARCH_MEROM,            65)
-  CHECK_UARCH(arch, 0,  6,  1,  7, NA, "Penryn",            UARCH_PENYR,            45)
-  CHECK_UARCH(arch, 0,  6,  1, 10, NA, "Nehalem",           UARCH_NEHALEM,          45)
-  CHECK_UARCH(arch, 0,  6,  1, 12, NA, "Bonnell",           UARCH_BONNELL,          45)
-  CHECK_UARCH(arch, 0,  6,  1, 13, NA, "Penryn",            UARCH_PENYR,            45)
-  CHECK_UARCH(arch, 0,  6,  1, 14, NA, "Nehalem",           UARCH_NEHALEM,          45)
-  CHECK_UARCH(arch, 0,  6,  1, 15, NA, "Nehalem",           UARCH_NEHALEM,          45)
-  CHECK_UARCH(arch, 0,  6,  2,  5, NA, "Westmere",          UARCH_WESTMERE,         32)
-  CHECK_UARCH(arch, 0,  6,  2 , 6, NA, "Bonnell",           UARCH_BONNELL,          45)
-  CHECK_UARCH(arch, 0,  6,  2,  7, NA, "Saltwell",          UARCH_SALTWELL,         32)
-  CHECK_UARCH(arch, 0,  6,  2, 10, NA, "Sandy Bridge",      UARCH_SANDY_BRIDGE,     32)
-  CHECK_UARCH(arch, 0,  6,  2, 12, NA, "Westmere",          UARCH_WESTMERE,         32)
-  CHECK_UARCH(arch, 0,  6,  2, 13, NA, "Sandy Bridge",      UARCH_SANDY_BRIDGE,     32)
-  CHECK_UARCH(arch, 0,  6,  2, 14, NA, "Nehalem",           UARCH_NEHALEM,          45)
-  CHECK_UARCH(arch, 0,  6,  2, 15, NA, "Westmere",          UARCH_WESTMERE,         32)
-  CHECK_UARCH(arch, 0,  6,  3,  5, NA, "Saltwell",          UARCH_SALTWELL,         14)
-  CHECK_UARCH(arch, 0,  6,  3,  6, NA, "Saltwell",          UARCH_SALTWELL,         32)
-  CHECK_UARCH(arch, 0,  6,  3,  7, NA, "Silvermont",        UARCH_SILVERMONT,       22)
-  CHECK_UARCH(arch, 0,  6,  3, 10, NA, "Ivy Bridge",        UARCH_IVY_BRIDGE,       22)
-  CHECK_UARCH(arch, 0,  6,  3, 12, NA, "Haswell",           UARCH_HASWELL,          22)
-  CHECK_UARCH(arch, 0,  6,  3, 13, NA, "Broadwell",         UARCH_BROADWELL,        14)
-  CHECK_UARCH(arch, 0,  6,  3, 14, NA, "Ivy Bridge",        UARCH_IVY_BRIDGE,       22)
-  CHECK_UARCH(arch, 0,  6,  3, 15, NA, "Haswell",           UARCH_HASWELL,          22)
-  CHECK_UARCH(arch, 0,  6,  4,  5, NA, "Haswell",           UARCH_HASWELL,          22)
-  CHECK_UARCH(arch, 0,  6,  4,  6, NA, "Haswell",           UARCH_HASWELL,          22)
-  CHECK_UARCH(arch, 0,  6,  4,  7, NA, "Broadwell",         UARCH_BROADWELL,        14)
-  CHECK_UARCH(arch, 0,  6,  4, 10, NA, "Silvermont",        UARCH_SILVERMONT,       22) // no docs, but /proc/cpuinfo seen in wild
-  CHECK_UARCH(arch, 0,  6,  4, 12, NA, "Airmont",           UARCH_AIRMONT,          14)
-  CHECK_UARCH(arch, 0,  6,  4, 13, NA, "Silvermont",        UARCH_SILVERMONT,       22)
-  CHECK_UARCH(arch, 0,  6,  4, 14,  8, "Kaby Lake",         UARCH_KABY_LAKE,        14)
-  CHECK_UARCH(arch, 0,  6,  4, 14, NA, "Skylake",           UARCH_SKYLAKE,          14)
-  CHECK_UARCH(arch, 0,  6,  4, 15, NA, "Broadwell",         UARCH_BROADWELL,        14)
-  CHECK_UARCH(arch, 0,  6,  5,  5,  6, "Cascade Lake",      UARCH_CASCADE_LAKE,     14) // no docs, but example from Greg Stewart
-  CHECK_UARCH(arch, 0,  6,  5,  5,  7, "Cascade Lake",      UARCH_CASCADE_LAKE,     14)
-  CHECK_UARCH(arch, 0,  6,  5,  5, 10, "Cooper Lake",       UARCH_COOPER_LAKE,      14)
-  CHECK_UARCH(arch, 0,  6,  5,  5, NA, "Skylake",           UARCH_SKYLAKE,          14)
-  CHECK_UARCH(arch, 0,  6,  5,  6, NA, "Broadwell",         UARCH_BROADWELL,        14)
-  CHECK_UARCH(arch, 0,  6,  5,  7, NA, "Knights Landing",   UARCH_KNIGHTS_LANDING,  14)
-  CHECK_UARCH(arch, 0,  6,  5, 10, NA, "Silvermont",        UARCH_SILVERMONT,       22) // no spec update; only MSR_CPUID_table* so far
-  CHECK_UARCH(arch, 0,  6,  5, 12, NA, "Goldmont",          UARCH_GOLDMONT,         14)
-  CHECK_UARCH(arch, 0,  6,  5, 13, NA, "Silvermont",        UARCH_SILVERMONT,       22) // no spec update; only MSR_CPUID_table* so far
-  CHECK_UARCH(arch, 0,  6,  5, 14,  8, "Kaby Lake",         UARCH_KABY_LAKE,        14)
-  CHECK_UARCH(arch, 0,  6,  5, 14, NA, "Skylake",           UARCH_SKYLAKE,          14)
-  CHECK_UARCH(arch, 0,  6,  5, 15, NA, "Goldmont",          UARCH_GOLDMONT,         14)
-  CHECK_UARCH(arch, 0,  6,  6,  6, NA, "Palm Cove",         UARCH_PALM_COVE,        10) // no spec update; only MSR_CPUID_table* so far
-  CHECK_UARCH(arch, 0,  6,  6, 10, NA, "Sunny Cove",        UARCH_SUNNY_COVE,       10) // no spec update; only MSR_CPUID_table* so far
-  CHECK_UARCH(arch, 0,  6,  6, 12, NA, "Sunny Cove",        UARCH_SUNNY_COVE,       10) // no spec update; only MSR_CPUID_table* so far
-  CHECK_UARCH(arch, 0,  6,  7,  5, NA, "Airmont",           UARCH_AIRMONT,          14) // no spec update; whispers & rumors
-  CHECK_UARCH(arch, 0,  6,  7, 10, NA, "Goldmont Plus",     UARCH_GOLDMONT_PLUS,    14)
-  CHECK_UARCH(arch, 0,  6,  7, 13, NA, "Sunny Cove",        UARCH_SUNNY_COVE,       10) // no spec update; only MSR_CPUID_table* so far
-  CHECK_UARCH(arch, 0,  6,  7, 14, NA, "Ice Lake",          UARCH_ICE_LAKE,         10)
-  CHECK_UARCH(arch, 0,  6,  8,  5, NA, "Knights Mill",      UARCH_KNIGHTS_MILL,     14) // no spec update; only MSR_CPUID_table* so far
-  CHECK_UARCH(arch, 0,  6,  8,  6, NA, "Tremont",           UARCH_TREMONT,          10) // LX*
-  CHECK_UARCH(arch, 0,  6,  8, 10, NA, "Tremont",           UARCH_TREMONT,          10) // no spec update; only geekbench.com example
-  CHECK_UARCH(arch, 0,  6,  8, 12, NA, "Tiger Lake",        UARCH_TIGER_LAKE,       10) // instlatx64
-  CHECK_UARCH(arch, 0,  6,  8, 13, NA, "Tiger Lake",        UARCH_TIGER_LAKE,       10) // instlatx64
-  // CHECK_UARCH(arch, 0,  6,  8, 14,  9, ...) It is not possible to determine uarch only from CPUID dump (can be Kaby Lake or Amber Lake)
-  // CHECK_UARCH(arch, 0,  6,  8, 14, 10, ...) It is not possible to determine uarch only from CPUID dump (can be Kaby Lake R or Coffee Lake U)
-  CHECK_UARCH(arch, 0,  6,  8, 14, 11, "Whiskey Lake",      UARCH_WHISKEY_LAKE,     14) // wikichip
-  // CHECK_UARCH(arch, 0,  6,  8, 14, 12, ...) It is not possible to determine uarch only from CPUID dump (can be Comet Lake U or Whiskey Lake U)
-  CHECK_UARCH(arch, 0,  6,  8, 15,  8, "Sapphire Rapids",   UARCH_SAPPHIRE_RAPIDS,   7) // wikichip
-  CHECK_UARCH(arch, 0,  6,  9,  6, NA, "Tremont",           UARCH_TREMONT,          10) // LX*
-  CHECK_UARCH(arch, 0,  6,  9,  7, NA, "Alder Lake",        UARCH_ALDER_LAKE,       10) // instlatx64 (Alder Lake-S)
-  CHECK_UARCH(arch, 0,  6,  9, 10, NA, "Alder Lake",        UARCH_ALDER_LAKE,       10) // instlatx64 (Alder Lake-P)
-  CHECK_UARCH(arch, 0,  6,  9, 12, NA, "Tremont",           UARCH_TREMONT,          10) // LX*
-  CHECK_UARCH(arch, 0,  6,  9, 13, NA, "Sunny Cove",        UARCH_SUNNY_COVE,       10) // LX*
-  CHECK_UARCH(arch, 0,  6,  9, 14,  9, "Kaby Lake",         UARCH_KABY_LAKE,        14)
-  CHECK_UARCH(arch, 0,  6,  9, 14, 10, "Coffee Lake",       UARCH_COFFEE_LAKE,      14)
-  CHECK_UARCH(arch, 0,  6,  9, 14, 11, "Coffee Lake",       UARCH_COFFEE_LAKE,      14)
-  CHECK_UARCH(arch, 0,  6,  9, 14, 12, "Coffee Lake",       UARCH_COFFEE_LAKE,      14)
-  CHECK_UARCH(arch, 0,  6,  9, 14, 13, "Coffee Lake",       UARCH_COFFEE_LAKE,      14)
-  CHECK_UARCH(arch, 0,  6, 10,  5, NA, "Comet Lake",        UARCH_COMET_LAKE,       14) // wikichip
-  CHECK_UARCH(arch, 0,  6, 10,  6, NA, "Comet Lake",        UARCH_COMET_LAKE,       14) // instlatx64.atw.hu (i7-10710U)
-  CHECK_UARCH(arch, 0,  6, 10,  7, NA, "Rocket Lake",       UARCH_ROCKET_LAKE,      14) // instlatx64.atw.hu (i7-11700K)
-  CHECK_UARCH(arch, 0,  6, 11,  7, NA, "Raptor Lake",       UARCH_RAPTOR_LAKE,      10) // instlatx64.atw.hu (i5-13600K)
-  CHECK_UARCH(arch, 0,  6, 11, 10, NA, "Raptor Lake",       UARCH_RAPTOR_LAKE,      10) // instlatx64.atw.hu (i7-1370P)
-  CHECK_UARCH(arch, 0,  6, 11, 14, NA, "Alder Lake",        UARCH_ALDER_LAKE,       10) // instlatx64.atw.hu (Alder Lake-N)
-  CHECK_UARCH(arch, 0,  6, 11, 15, NA, "Raptor Lake",       UARCH_RAPTOR_LAKE,      10) // instlatx64.atw.hu (i5-13500)
-  CHECK_UARCH(arch, 0, 11,  0,  0, NA, "Knights Ferry",     UARCH_KNIGHTS_FERRY,    45) // found only on en.wikichip.org
-  CHECK_UARCH(arch, 0, 11,  0,  1, NA, "Knights Corner",    UARCH_KNIGHTS_CORNER,   22)
-  CHECK_UARCH(arch, 0, 15,  0,  0, NA, "Willamette",        UARCH_WILLAMETTE,      180)
-  CHECK_UARCH(arch, 0, 15,  0,  1, NA, "Willamette",        UARCH_WILLAMETTE,      180)
-  CHECK_UARCH(arch, 0, 15,  0,  2, NA, "Northwood",         UARCH_NORTHWOOD,       130)
-  CHECK_UARCH(arch, 0, 15,  0,  3, NA, "Prescott",          UARCH_PRESCOTT,         90)
-  CHECK_UARCH(arch, 0, 15,  0,  4, NA, "Prescott",          UARCH_PRESCOTT,         90)
-  CHECK_UARCH(arch, 0, 15,  0,  6, NA, "Cedar Mill",        UARCH_CEDAR_MILL,       65)
-  CHECK_UARCH(arch, 1, 15,  0,  0, NA, "Itanium2",          UARCH_ITANIUM2,        180)
-  CHECK_UARCH(arch, 1, 15,  0,  1, NA, "Itanium2",          UARCH_ITANIUM2,        130)
-  CHECK_UARCH(arch, 1, 15,  0,  2, NA, "Itanium2",          UARCH_ITANIUM2,        130)
-  UARCH_END
-  return arch;
+// EF: Extended Family                                                               //
+// F:  Family                                                                        //
+// EM: Extended Model                                                                //
+// M: Model                                                                          //
+// S: Stepping                                                                       //
+// --------------------------------------------------------------------------------- //
+static const struct uarch_db_entry uarch_table[] = {
+  // Inspired in Todd Allen's decode_uarch_intel
+  //                  EF  F  EM   M   S
+  UARCH_ENTRY(INTEL, 0,  4,  0,  0, NA, "i80486DX",          UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(INTEL, 0,  4,  0,  1, NA, "i80486DX-50",       UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(INTEL, 0,  4,  0,  2, NA, "i80486SX",          UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(INTEL, 0,  4,  0,  3, NA, "i80486DX2",         UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(INTEL, 0,  4,  0,  4, NA, "i80486SL",          UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(INTEL, 0,  4,  0,  5, NA, "i80486SX2",         UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(INTEL, 0,  4,  0,  7, NA, "i80486DX2WB",       UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(INTEL, 0,  4,  0,  8, NA, "i80486DX4",         UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(INTEL, 0,  4,  0,  9, NA, "i80486DX4WB",       UARCH_I486,            UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(INTEL, 0,  5,  0,  0, NA, "P5",                UARCH_P5,              800)
+  UARCH_ENTRY(INTEL, 0,  5,  0,  1, NA, "P5",                UARCH_P5,              800)
+  UARCH_ENTRY(INTEL, 0,  5,  0,  2, NA, "P54C",              UARCH_P5,              UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(INTEL, 0,  5,  0,  3, NA, "P24T (Overdrive)",  UARCH_P5,              600) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(INTEL, 0,  5,  0,  4, NA, "P55C (MMX)",        UARCH_P5_MMX,          350) // https://www.cpu-world.com/CPUs/Pentium/TYPE-Pentium%20MMX.html
+  UARCH_ENTRY(INTEL, 0,  5,  0,  7, NA, "P54C",              UARCH_P5,              350) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(INTEL, 0,  5,  0,  8, NA, "Tillamook",         UARCH_P5_MMX,          250) // http://instlatx64.atw.hu./
+  UARCH_ENTRY(INTEL, 0,  5,  0,  9,  0, "Lakemont",          UARCH_LAKEMONT,         32)
+  UARCH_ENTRY(INTEL, 0,  5,  0,  9, NA, "P5 (MMX)",          UARCH_P5_MMX,          UNK)
+  UARCH_ENTRY(INTEL, 0,  5,  0, 10,  0, "Lakemont",          UARCH_LAKEMONT,         32)
+  UARCH_ENTRY(INTEL, 0,  6,  0,  1,  1, "P6",                UARCH_P6_PRO,          UNK)
+  UARCH_ENTRY(INTEL, 0,  6,  0,  1,  2, "P6",                UARCH_P6_PRO,          UNK)
+  UARCH_ENTRY(INTEL, 0,  6,  0,  1,  6, "P6",                UARCH_P6_PRO,          350)
+  UARCH_ENTRY(INTEL, 0,  6,  0,  1,  7, "P6",                UARCH_P6_PRO,          350)
+  UARCH_ENTRY(INTEL, 0,  6,  0,  1,  9, "P6",                UARCH_P6_PRO,          350)
+  UARCH_ENTRY(INTEL, 0,  6,  0,  0, NA, "P6 (Pentium II)",   UARCH_P6_PENTIUM_II,   UNK)
+  UARCH_ENTRY(INTEL, 0,  6,  0,  1, NA, "P6 (Pentium II)",   UARCH_P6_PENTIUM_II,   UNK) // process depends on core
+  UARCH_ENTRY(INTEL, 0,  6,  0,  2, NA, "P6 (Pentium II)",   UARCH_P6_PENTIUM_II,   UNK)
+  UARCH_ENTRY(INTEL, 0,  6,  0,  3, NA, "P6 (Klamath)",      UARCH_P6_PENTIUM_II,   350) // http://instlatx64.atw.hu.
+  UARCH_ENTRY(INTEL, 0,  6,  0,  4, NA, "P6 (Pentium II)",   UARCH_P6_PENTIUM_II,   UNK)
+  UARCH_ENTRY(INTEL, 0,  6,  0,  5, NA, "P6 (Deschutes)",    UARCH_P6_PENTIUM_II,   250) // http://instlatx64.atw.hu.
+  UARCH_ENTRY(INTEL, 0,  6,  0,  6, NA, "P6 (Dixon)",        UARCH_P6_PENTIUM_II,   UNK) // http://instlatx64.atw.hu.
+  UARCH_ENTRY(INTEL, 0,  6,  0,  7, NA, "P6 (Katmai)",       UARCH_P6_PENTIUM_III,  250) // Core names from: https://en.wikichip.org/wiki/intel/cpuid. NOTE: Xeon core names are different! https://www.techpowerup.com/cpu-specs/?generation=Intel+Pentium+III+Xeon
+  UARCH_ENTRY(INTEL, 0,  6,  0,  8, NA, "P6 (Coppermine)",   UARCH_P6_PENTIUM_III,  180) // Also: https://en.wikipedia.org/wiki/Pentium_III
+  UARCH_ENTRY(INTEL, 0,  6,  0,  9, NA, "P6 (Pentium M)",    UARCH_P6_PENTIUM_III,  130)
+  UARCH_ENTRY(INTEL, 0,  6,  0, 10, NA, "P6 (Coppermine T)", UARCH_P6_PENTIUM_III,  180)
+  UARCH_ENTRY(INTEL, 0,  6,  0, 11, NA, "P6 (Tualatin)",     UARCH_P6_PENTIUM_III,  130)
+  UARCH_ENTRY(INTEL, 0,  6,  0, 13, NA, "Dothan",            UARCH_DOTHAN,          UNK)  // process depends on core
+  UARCH_ENTRY(INTEL, 0,  6,  0, 14, NA, "Yonah",             UARCH_YONAH,            65)
+  UARCH_ENTRY(INTEL, 0,  6,  0, 15, NA, "Merom",             UARCH_MEROM,            65)
+  UARCH_ENTRY(INTEL, 0,  6,  1,  5, NA, "Dothan",            UARCH_DOTHAN,           90)
+  UARCH_ENTRY(INTEL, 0,  6,  1,  6, NA, "Merom",             UARCH_MEROM,            65)
+  UARCH_ENTRY(INTEL, 0,  6,  1,  7, NA, "Penryn",            UARCH_PENYR,            45)
+  UARCH_ENTRY(INTEL, 0,  6,  1, 10, NA, "Nehalem",           UARCH_NEHALEM,          45)
+  UARCH_ENTRY(INTEL, 0,  6,  1, 12, NA, "Bonnell",           UARCH_BONNELL,          45)
+  UARCH_ENTRY(INTEL, 0,  6,  1, 13, NA, "Penryn",            UARCH_PENYR,            45)
+  UARCH_ENTRY(INTEL, 0,  6,  1, 14, NA, "Nehalem",           UARCH_NEHALEM,          45)
+  UARCH_ENTRY(INTEL, 0,  6,  1, 15, NA, "Nehalem",           UARCH_NEHALEM,          45)
+  UARCH_ENTRY(INTEL, 0,  6,  2,  5, NA, "Westmere",          UARCH_WESTMERE,         32)
+  UARCH_ENTRY(INTEL, 0,  6,  2 , 6, NA, "Bonnell",           UARCH_BONNELL,          45)
+  UARCH_ENTRY(INTEL, 0,  6,  2,  7, NA, "Saltwell",          UARCH_SALTWELL,         32)
+  UARCH_ENTRY(INTEL, 0,  6,  2, 10, NA, "Sandy Bridge",      UARCH_SANDY_BRIDGE,     32)
+  UARCH_ENTRY(INTEL, 0,  6,  2, 12, NA, "Westmere",          UARCH_WESTMERE,         32)
+  UARCH_ENTRY(INTEL, 0,  6,  2, 13, NA, "Sandy Bridge",      UARCH_SANDY_BRIDGE,     32)
+  UARCH_ENTRY(INTEL, 0,  6,  2, 14, NA, "Nehalem",           UARCH_NEHALEM,          45)
+  UARCH_ENTRY(INTEL, 0,  6,  2, 15, NA, "Westmere",          UARCH_WESTMERE,         32)
+  UARCH_ENTRY(INTEL, 0,  6,  3,  5, NA, "Saltwell",          UARCH_SALTWELL,         14)
+  UARCH_ENTRY(INTEL, 0,  6,  3,  6, NA, "Saltwell",          UARCH_SALTWELL,         32)
+  UARCH_ENTRY(INTEL, 0,  6,  3,  7, NA, "Silvermont",        UARCH_SILVERMONT,       22)
+  UARCH_ENTRY(INTEL, 0,  6,  3, 10, NA, "Ivy Bridge",        UARCH_IVY_BRIDGE,       22)
+  UARCH_ENTRY(INTEL, 0,  6,  3, 12, NA, "Haswell",           UARCH_HASWELL,          22)
+  UARCH_ENTRY(INTEL, 0,  6,  3, 13, NA, "Broadwell",         UARCH_BROADWELL,        14)
+  UARCH_ENTRY(INTEL, 0,  6,  3, 14, NA, "Ivy Bridge",        UARCH_IVY_BRIDGE,       22)
+  UARCH_ENTRY(INTEL, 0,  6,  3, 15, NA, "Haswell",           UARCH_HASWELL,          22)
+  UARCH_ENTRY(INTEL, 0,  6,  4,  5, NA, "Haswell",           UARCH_HASWELL,          22)
+  UARCH_ENTRY(INTEL, 0,  6,  4,  6, NA, "Haswell",           UARCH_HASWELL,          22)
+  UARCH_ENTRY(INTEL, 0,  6,  4,  7, NA, "Broadwell",         UARCH_BROADWELL,        14)
+  UARCH_ENTRY(INTEL, 0,  6,  4, 10, NA, "Silvermont",        UARCH_SILVERMONT,       22) // no docs, but /proc/cpuinfo seen in wild
+  UARCH_ENTRY(INTEL, 0,  6,  4, 12, NA, "Airmont",           UARCH_AIRMONT,          14)
+  UARCH_ENTRY(INTEL, 0,  6,  4, 13, NA, "Silvermont",        UARCH_SILVERMONT,       22)
+  UARCH_ENTRY(INTEL, 0,  6,  4, 14,  8, "Kaby Lake",         UARCH_KABY_LAKE,        14)
+  UARCH_ENTRY(INTEL, 0,  6,  4, 14, NA, "Skylake",           UARCH_SKYLAKE,          14)
+  UARCH_ENTRY(INTEL, 0,  6,  4, 15, NA, "Broadwell",         UARCH_BROADWELL,        14)
+  UARCH_ENTRY(INTEL, 0,  6,  5,  5,  6, "Cascade Lake",      UARCH_CASCADE_LAKE,     14) // no docs, but example from Greg Stewart
+  UARCH_ENTRY(INTEL, 0,  6,  5,  5,  7, "Cascade Lake",      UARCH_CASCADE_LAKE,     14)
+  UARCH_ENTRY(INTEL, 0,  6,  5,  5, 10, "Cooper Lake",       UARCH_COOPER_LAKE,      14)
+  UARCH_ENTRY(INTEL, 0,  6,  5,  5, NA, "Skylake",           UARCH_SKYLAKE,          14)
+  UARCH_ENTRY(INTEL, 0,  6,  5,  6, NA, "Broadwell",         UARCH_BROADWELL,        14)
+  UARCH_ENTRY(INTEL, 0,  6,  5,  7, NA, "Knights Landing",   UARCH_KNIGHTS_LANDING,  14)
+  UARCH_ENTRY(INTEL, 0,  6,  5, 10, NA, "Silvermont",        UARCH_SILVERMONT,       22) // no spec update; only MSR_CPUID_table* so far
+  UARCH_ENTRY(INTEL, 0,  6,  5, 12, NA, "Goldmont",          UARCH_GOLDMONT,         14)
+  UARCH_ENTRY(INTEL, 0,  6,  5, 13, NA, "Silvermont",        UARCH_SILVERMONT,       22) // no spec update; only MSR_CPUID_table* so far
+  UARCH_ENTRY(INTEL, 0,  6,  5, 14,  8, "Kaby Lake",         UARCH_KABY_LAKE,        14)
+  UARCH_ENTRY(INTEL, 0,  6,  5, 14, NA, "Skylake",           UARCH_SKYLAKE,          14)
+  UARCH_ENTRY(INTEL, 0,  6,  5, 15, NA, "Goldmont",          UARCH_GOLDMONT,         14)
+  UARCH_ENTRY(INTEL, 0,  6,  6,  6, NA, "Palm Cove",         UARCH_PALM_COVE,        10) // no spec update; only MSR_CPUID_table* so far
+  UARCH_ENTRY(INTEL, 0,  6,  6, 10, NA, "Sunny Cove",        UARCH_SUNNY_COVE,       10) // no spec update; only MSR_CPUID_table* so far
+  UARCH_ENTRY(INTEL, 0,  6,  6, 12, NA, "Sunny Cove",        UARCH_SUNNY_COVE,       10) // no spec update; only MSR_CPUID_table* so far
+  UARCH_ENTRY(INTEL, 0,  6,  7,  5, NA, "Airmont",           UARCH_AIRMONT,          14) // no spec update; whispers & rumors
+  UARCH_ENTRY(INTEL, 0,  6,  7, 10, NA, "Goldmont Plus",     UARCH_GOLDMONT_PLUS,    14)
+  UARCH_ENTRY(INTEL, 0,  6,  7, 13, NA, "Sunny Cove",        UARCH_SUNNY_COVE,       10) // no spec update; only MSR_CPUID_table* so far
+  UARCH_ENTRY(INTEL, 0,  6,  7, 14, NA, "Ice Lake",          UARCH_ICE_LAKE,         10)
+  UARCH_ENTRY(INTEL, 0,  6,  8,  5, NA, "Knights Mill",      UARCH_KNIGHTS_MILL,     14) // no spec update; only MSR_CPUID_table* so far
+  UARCH_ENTRY(INTEL, 0,  6,  8,  6, NA, "Tremont",           UARCH_TREMONT,          10) // LX*
+  UARCH_ENTRY(INTEL, 0,  6,  8, 10, NA, "Tremont",           UARCH_TREMONT,          10) // no spec update; only geekbench.com example
+  UARCH_ENTRY(INTEL, 0,  6,  8, 12, NA, "Tiger Lake",        UARCH_TIGER_LAKE,       10) // instlatx64
+  UARCH_ENTRY(INTEL, 0,  6,  8, 13, NA, "Tiger Lake",        UARCH_TIGER_LAKE,       10) // instlatx64
+  // UARCH_ENTRY(INTEL, 0,  6,  8, 14,  9, ...) It is not possible to determine uarch only from CPUID dump (can be Kaby Lake or Amber Lake)
+  // UARCH_ENTRY(INTEL, 0,  6,  8, 14, 10, ...) It is not possible to determine uarch only from CPUID dump (can be Kaby Lake R or Coffee Lake U)
+  UARCH_ENTRY(INTEL, 0,  6,  8, 14, 11, "Whiskey Lake",      UARCH_WHISKEY_LAKE,     14) // wikichip
+  // UARCH_ENTRY(INTEL, 0,  6,  8, 14, 12, ...) It is not possible to determine uarch only from CPUID dump (can be Comet Lake U or Whiskey Lake U)
+  UARCH_ENTRY(INTEL, 0,  6,  8, 15,  8, "Sapphire Rapids",   UARCH_SAPPHIRE_RAPIDS,   7) // wikichip
+  UARCH_ENTRY(INTEL, 0,  6,  9,  6, NA, "Tremont",           UARCH_TREMONT,          10) // LX*
+  UARCH_ENTRY(INTEL, 0,  6,  9,  7, NA, "Alder Lake",        UARCH_ALDER_LAKE,       10) // instlatx64 (Alder Lake-S)
+  UARCH_ENTRY(INTEL, 0,  6,  9, 10, NA, "Alder Lake",        UARCH_ALDER_LAKE,       10) // instlatx64 (Alder Lake-P)
+  UARCH_ENTRY(INTEL, 0,  6,  9, 12, NA, "Tremont",           UARCH_TREMONT,          10) // LX*
+  UARCH_ENTRY(INTEL, 0,  6,  9, 13, NA, "Sunny Cove",        UARCH_SUNNY_COVE,       10) // LX*
+  UARCH_ENTRY(INTEL, 0,  6,  9, 14,  9, "Kaby Lake",         UARCH_KABY_LAKE,        14)
+  UARCH_ENTRY(INTEL, 0,  6,  9, 14, 10, "Coffee Lake",       UARCH_COFFEE_LAKE,      14)
+  UARCH_ENTRY(INTEL, 0,  6,  9, 14, 11, "Coffee Lake",       UARCH_COFFEE_LAKE,      14)
+  UARCH_ENTRY(INTEL, 0,  6,  9, 14, 12, "Coffee Lake",       UARCH_COFFEE_LAKE,      14)
+  UARCH_ENTRY(INTEL, 0,  6,  9, 14, 13, "Coffee Lake",       UARCH_COFFEE_LAKE,      14)
+  UARCH_ENTRY(INTEL, 0,  6, 10,  5, NA, "Comet Lake",        UARCH_COMET_LAKE,       14) // wikichip
+  UARCH_ENTRY(INTEL, 0,  6, 10,  6, NA, "Comet Lake",        UARCH_COMET_LAKE,       14) // instlatx64.atw.hu (i7-10710U)
+  UARCH_ENTRY(INTEL, 0,  6, 10,  7, NA, "Rocket Lake",       UARCH_ROCKET_LAKE,      14) // instlatx64.atw.hu (i7-11700K)
+  UARCH_ENTRY(INTEL, 0,  6, 11,  7, NA, "Raptor Lake",       UARCH_RAPTOR_LAKE,      10) // instlatx64.atw.hu (i5-13600K)
+  UARCH_ENTRY(INTEL, 0,  6, 11, 10, NA, "Raptor Lake",       UARCH_RAPTOR_LAKE,      10) // instlatx64.atw.hu (i7-1370P)
+  UARCH_ENTRY(INTEL, 0,  6, 11, 14, NA, "Alder Lake",        UARCH_ALDER_LAKE,       10) // instlatx64.atw.hu (Alder Lake-N)
+  UARCH_ENTRY(INTEL, 0,  6, 11, 15, NA, "Raptor Lake",       UARCH_RAPTOR_LAKE,      10) // instlatx64.atw.hu (i5-13500)
+  UARCH_ENTRY(INTEL, 0, 11,  0,  0, NA, "Knights Ferry",     UARCH_KNIGHTS_FERRY,    45) // found only on en.wikichip.org
+  UARCH_ENTRY(INTEL, 0, 11,  0,  1, NA, "Knights Corner",    UARCH_KNIGHTS_CORNER,   22)
+  UARCH_ENTRY(INTEL, 0, 15,  0,  0, NA, "Willamette",        UARCH_WILLAMETTE,      180)
+  UARCH_ENTRY(INTEL, 0, 15,  0,  1, NA, "Willamette",        UARCH_WILLAMETTE,      180)
+  UARCH_ENTRY(INTEL, 0, 15,  0,  2, NA, "Northwood",         UARCH_NORTHWOOD,       130)
+  UARCH_ENTRY(INTEL, 0, 15,  0,  3, NA, "Prescott",          UARCH_PRESCOTT,         90)
+  UARCH_ENTRY(INTEL, 0, 15,  0,  4, NA, "Prescott",          UARCH_PRESCOTT,         90)
+  UARCH_ENTRY(INTEL, 0, 15,  0,  6, NA, "Cedar Mill",        UARCH_CEDAR_MILL,       65)
+  UARCH_ENTRY(INTEL, 1, 15,  0,  0, NA, "Itanium2",          UARCH_ITANIUM2,        180)
+  UARCH_ENTRY(INTEL, 1, 15,  0,  1, NA, "Itanium2",          UARCH_ITANIUM2,        130)
+  UARCH_ENTRY(INTEL, 1, 15,  0,  2, NA, "Itanium2",          UARCH_ITANIUM2,        130)
+
+  // Inspired in Todd Allen's decode_uarch_amd
+  //                 EF  F  EM   M   S
+  UARCH_ENTRY(AMD,  0,  4,  0,  3, NA, "Am486DX2",    UARCH_AM486,      UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(AMD,  0,  4,  0,  7, NA, "Am486DX2WB",  UARCH_AM486,      UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(AMD,  0,  4,  0,  8, NA, "Am486DX4",    UARCH_AM486,      UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(AMD,  0,  4,  0,  9, NA, "Am486DX4WB",  UARCH_AM486,      UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(AMD,  0,  4,  0, 14, NA, "Am5x86",      UARCH_AM5X86,     350) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(AMD,  0,  4,  0, 15, NA, "Am5x86WB",    UARCH_AM5X86,     350) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(AMD,  0,  5,  0,  0, NA, "SSA5 (K5)",   UARCH_SSA5,       350) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(AMD,  0,  5,  0,  1, NA, "K5",          UARCH_K5,         350) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(AMD,  0,  5,  0,  2, NA, "K5",          UARCH_K5,         350) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(AMD,  0,  5,  0,  3, NA, "K5",          UARCH_K5,         350) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
+  UARCH_ENTRY(AMD,  0,  5,  0,  6, NA, "K6",          UARCH_K6,         300)
+  UARCH_ENTRY(AMD,  0,  5,  0,  7, NA, "K6",          UARCH_K6,         250) // *p from sandpile.org
+  UARCH_ENTRY(AMD,  0,  5,  0, 10, NA, "K7",          UARCH_K7,         130) // Geode NX
+  UARCH_ENTRY(AMD,  0,  5,  0, 13, NA, "K6",          UARCH_K6,          80) // *p from sandpile.org
+  UARCH_ENTRY(AMD,  0,  5, NA, NA, NA, "K6",          UARCH_K6,         UNK)
+  UARCH_ENTRY(AMD,  0,  6,  0,  1, NA, "K7",          UARCH_K7,         250)
+  UARCH_ENTRY(AMD,  0,  6,  0,  2, NA, "K7",          UARCH_K7,         180)
+  UARCH_ENTRY(AMD,  0,  6, NA, NA, NA, "K7",          UARCH_K7,         UNK)
+  UARCH_ENTRY(AMD,  0, 15,  0,  4,  8, "K8",          UARCH_K8,         130)
+  UARCH_ENTRY(AMD,  0, 15,  0,  4, NA, "K8",          UARCH_K8,         130)
+  UARCH_ENTRY(AMD,  0, 15,  0,  5, NA, "K8",          UARCH_K8,         130)
+  UARCH_ENTRY(AMD,  0, 15,  0,  7, NA, "K8",          UARCH_K8,         130)
+  UARCH_ENTRY(AMD,  0, 15,  0,  8, NA, "K8",          UARCH_K8,         130)
+  UARCH_ENTRY(AMD,  0, 15,  0, 11, NA, "K8",          UARCH_K8,         130)
+  UARCH_ENTRY(AMD,  0, 15,  0, 12, NA, "K8",          UARCH_K8,         130)
+  UARCH_ENTRY(AMD,  0, 15,  0, 14, NA, "K8",          UARCH_K8,         130)
+  UARCH_ENTRY(AMD,  0, 15,  0, 15, NA, "K8",          UARCH_K8,         130)
+  UARCH_ENTRY(AMD,  0, 15,  1,  4, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  1,  5, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  1,  7, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  1,  8, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  1, 11, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  1, 12, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  1, 15, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  2,  1, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  2,  3, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  2,  4, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  2,  5, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  2,  7, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  2, 11, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  2, 12, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  2, 15, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  4,  1, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  4,  3, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  4,  8, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  4, 11, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  4, 12, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  4, 15, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  5, 13, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  5, 15, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  0, 15,  6,  8, NA, "K8",          UARCH_K8,          65)
+  UARCH_ENTRY(AMD,  0, 15,  6, 11, NA, "K8",          UARCH_K8,          65)
+  UARCH_ENTRY(AMD,  0, 15,  6, 12, NA, "K8",          UARCH_K8,          65)
+  UARCH_ENTRY(AMD,  0, 15,  6, 15, NA, "K8",          UARCH_K8,          65)
+  UARCH_ENTRY(AMD,  0, 15,  7, 12, NA, "K8",          UARCH_K8,          65)
+  UARCH_ENTRY(AMD,  0, 15,  7, 15, NA, "K8",          UARCH_K8,          65)
+  UARCH_ENTRY(AMD,  0, 15, 12,  1, NA, "K8",          UARCH_K8,          90)
+  UARCH_ENTRY(AMD,  1, 15,  0,  0, NA, "K10",         UARCH_K10,         65) // sandpile.org
+  UARCH_ENTRY(AMD,  1, 15,  0,  2, NA, "K10",         UARCH_K10,         65)
+  UARCH_ENTRY(AMD,  1, 15,  0,  4, NA, "K10",         UARCH_K10,         45)
+  UARCH_ENTRY(AMD,  1, 15,  0,  5, NA, "K10",         UARCH_K10,         45)
+  UARCH_ENTRY(AMD,  1, 15,  0,  6, NA, "K10",         UARCH_K10,         45)
+  UARCH_ENTRY(AMD,  1, 15,  0,  8, NA, "K10",         UARCH_K10,         45)
+  UARCH_ENTRY(AMD,  1, 15,  0,  9, NA, "K10",         UARCH_K10,         45)
+  UARCH_ENTRY(AMD,  1, 15,  0, 10, NA, "K10",         UARCH_K10,         45)
+  UARCH_ENTRY(AMD,  2, 15, NA, NA, NA, "Puma 2008",   UARCH_PUMA_2008,   65)
+  UARCH_ENTRY(AMD,  3, 15, NA, NA, NA, "K10",         UARCH_K10,         32)
+  UARCH_ENTRY(AMD,  5, 15, NA, NA, NA, "Bobcat",      UARCH_BOBCAT,      40)
+  UARCH_ENTRY(AMD,  6, 15,  0,  0, NA, "Bulldozer",   UARCH_BULLDOZER,   32) // instlatx64 engr sample
+  UARCH_ENTRY(AMD,  6, 15,  0,  1, NA, "Bulldozer",   UARCH_BULLDOZER,   32)
+  UARCH_ENTRY(AMD,  6, 15,  0,  2, NA, "Piledriver",  UARCH_PILEDRIVER,  32)
+  UARCH_ENTRY(AMD,  6, 15,  1,  0, NA, "Piledriver",  UARCH_PILEDRIVER,  32)
+  UARCH_ENTRY(AMD,  6, 15,  1,  3, NA, "Piledriver",  UARCH_PILEDRIVER,  32)
+  UARCH_ENTRY(AMD,  6, 15,  3,  0, NA, "Steamroller", UARCH_STEAMROLLER, 28)
+  UARCH_ENTRY(AMD,  6, 15,  3,  8, NA, "Steamroller", UARCH_STEAMROLLER, 28)
+  UARCH_ENTRY(AMD,  6, 15,  4,  0, NA, "Steamroller", UARCH_STEAMROLLER, 28) // Software Optimization Guide (15h) says it has the same iNAt latencies as (6,15),(3,x).
+  UARCH_ENTRY(AMD,  6, 15,  6,  0, NA, "Excavator",   UARCH_EXCAVATOR,   28) // undocumented, but instlatx64 samples
+  UARCH_ENTRY(AMD,  6, 15,  6,  5, NA, "Excavator",   UARCH_EXCAVATOR,   28) // undocumented, but sample from Alexandros Couloumbis
+  UARCH_ENTRY(AMD,  6, 15,  7,  0, NA, "Excavator",   UARCH_EXCAVATOR,   28)
+  UARCH_ENTRY(AMD,  7, 15,  0,  0, NA, "Jaguar",      UARCH_JAGUAR,      28)
+  UARCH_ENTRY(AMD,  7, 15,  1, NA, NA, "Jaguar",      UARCH_JAGUAR,      14) // instlatx64 (PS4) Normal PS4 is 28nm, Slim and Pro are 16nm
+  UARCH_ENTRY(AMD,  7, 15,  2,  6, NA, "Jaguar",      UARCH_JAGUAR,      28) // AMD Cato (Xbox One?)
+  UARCH_ENTRY(AMD,  7, 15,  3,  0, NA, "Puma 2014",   UARCH_PUMA_2014,   28)
+  UARCH_ENTRY(AMD,  8, 15,  0,  0, NA, "Zen",         UARCH_ZEN,         14) // instlatx64 engr sample
+  UARCH_ENTRY(AMD,  8, 15,  0,  1, NA, "Zen",         UARCH_ZEN,         14)
+  UARCH_ENTRY(AMD,  8, 15,  0,  8, NA, "Zen+",        UARCH_ZEN_PLUS,    12)
+  UARCH_ENTRY(AMD,  8, 15,  1,  1, NA, "Zen",         UARCH_ZEN,         14) // found only on en.wikichip.org & instlatx64 examples
+  UARCH_ENTRY(AMD,  8, 15,  1,  8, NA, "Zen+",        UARCH_ZEN_PLUS,    12) // found only on en.wikichip.org
+  UARCH_ENTRY(AMD,  8, 15,  2,  0, NA, "Zen",         UARCH_ZEN,         14) // Dali, found on instlatx64 and en.wikichip.org
+  UARCH_ENTRY(AMD,  8, 15,  3,  1, NA, "Zen 2",       UARCH_ZEN2,         7) // found only on en.wikichip.org
+  UARCH_ENTRY(AMD,  8, 15,  4,  7, NA, "Zen 2",       UARCH_ZEN2,         7) // instlatx64 example (AMD 4700S)
+  UARCH_ENTRY(AMD,  8, 15,  5,  0, NA, "Zen",         UARCH_ZEN,         14) // instlatx64 example (Subor Z+)
+  UARCH_ENTRY(AMD,  8, 15,  6,  0, NA, "Zen 2",       UARCH_ZEN2,         7) // undocumented, geekbench.com example
+  UARCH_ENTRY(AMD,  8, 15,  6,  8, NA, "Zen 2",       UARCH_ZEN2,         7) // found on instlatx64
+  UARCH_ENTRY(AMD,  8, 15,  7,  1, NA, "Zen 2",       UARCH_ZEN2,         7) // samples from Steven Noonan and instlatx64
+  UARCH_ENTRY(AMD,  8, 15,  8,  4, NA, "Zen 2",       UARCH_ZEN2,         7) // instlatx64 (Xbox Series X?)
+  UARCH_ENTRY(AMD,  8, 15,  9,  0,  2, "Zen 2",       UARCH_ZEN2,         7) // Steam Deck (instlatx64)
+  UARCH_ENTRY(AMD,  8, 15,  10, 0, NA, "Zen 2",       UARCH_ZEN2,         6) // instlatx64
+  UARCH_ENTRY(AMD, 10, 15,  0,  1, NA, "Zen 3",       UARCH_ZEN3,         7) // instlatx64
+  UARCH_ENTRY(AMD, 10, 15,  0,  8, NA, "Zen 3",       UARCH_ZEN3,         7) // instlatx64
+  UARCH_ENTRY(AMD, 10, 15,  1,  1, NA, "Zen 4",       UARCH_ZEN4,         5) // instlatx64
+  UARCH_ENTRY(AMD, 10, 15,  1,  8, NA, "Zen 4",       UARCH_ZEN4,         5) // instlatx64
+  UARCH_ENTRY(AMD, 10, 15,  2,  1, NA, "Zen 3",       UARCH_ZEN3,         7) // instlatx64
+  UARCH_ENTRY(AMD, 10, 15,  3, NA, NA, "Zen 3",       UARCH_ZEN3,         7) // instlatx64
+  UARCH_ENTRY(AMD, 10, 15,  4,  4, NA, "Zen 3+",      UARCH_ZEN3_PLUS,    6) // instlatx64 (they say it is Zen3...)
+  UARCH_ENTRY(AMD, 10, 15,  5,  0, NA, "Zen 3",       UARCH_ZEN3,         7) // instlatx64
+  UARCH_ENTRY(AMD, 10, 15,  6,  1,  2, "Zen 4",       UARCH_ZEN4,         5) // instlatx64
+  UARCH_ENTRY(AMD, 10, 15,  7,  4,  1, "Zen 4",       UARCH_ZEN4,         4) // instlatx64
+  UARCH_ENTRY(AMD, 10, 15,  7,  5,  2, "Zen 4",       UARCH_ZEN4,         4) // instlatx64
+  UARCH_ENTRY(AMD, 10, 15,  7,  8,  0, "Zen 4",       UARCH_ZEN4,         4) // instlatx64
+  UARCH_ENTRY(AMD, 10, 15,  8, NA, NA, "Zen 4",       UARCH_ZEN4,         5) // instlatx64 (AMD MI300C)
+  UARCH_ENTRY(AMD, 10, 15,  9, NA, NA, "Zen 4",       UARCH_ZEN4,         5) // instlatx64 (AMD MI300A)
+  UARCH_ENTRY(AMD, 10, 15, 10, NA, NA, "Zen 4c",      UARCH_ZEN4C,        5) // instlatx64
+  UARCH_ENTRY(AMD, 11, 15,  0, NA, NA, "Zen 5",       UARCH_ZEN5,         4) // Turin/EPYC (instlatx64)
+  UARCH_ENTRY(AMD, 11, 15,  1, NA, NA, "Zen 5c",      UARCH_ZEN5C,        3) // Zen5c EPYC (instlatx64, https://en.wikipedia.org/wiki/Zen_5#cite_note-10)
+  UARCH_ENTRY(AMD, 11, 15,  2, NA, NA, "Zen 5",       UARCH_ZEN5,         4) // Strix Point (instlatx64)
+  UARCH_ENTRY(AMD, 11, 15,  4, NA, NA, "Zen 5",       UARCH_ZEN5,         4) // Granite Ridge (instlatx64)
+  UARCH_ENTRY(AMD, 11, 15,  6, NA, NA, "Zen 5",       UARCH_ZEN5,         4) // Krackan Point (instlatx64)
+  UARCH_ENTRY(AMD, 11, 15,  7, NA, NA, "Zen 5",       UARCH_ZEN5,         4) // Strix Halo (instlatx64)
+
+  // Hygon
+  //                  EF  F  EM   M   S
+  // https://www.phoronix.com/news/Hygon-Dhyana-AMD-China-CPUs
+  UARCH_ENTRY(HYGON,  9,  15,  0,  1, NA, "Zen",       UARCH_ZEN,      UNK) // https://github.com/Dr-Noob/cpufetch/issues/244
+  // UARCH_ENTRY(HYGON,  9,  15,  0,  2, NA, "???",       ?????????,      UNK) // http://instlatx64.atw.hu/
+};
+
+// VENDOR EF F EM M S UARCH "Name" PROCESS [VPUS]
+static bool parse_uarch_db_entry(char** tok, int num_tokens, struct uarch_db_entry* entry) {
+  int64_t vendor, ef, f, em, m, s, process, vpus = NA;
+
+  if(num_tokens != 9 && num_tokens != 10) {
+    printErr("Expected 9 or 10 fields, found %d", num_tokens);
+    return false;
+  }
+
+  if(strcmp(tok[0], "intel") == 0) vendor = CPU_VENDOR_INTEL;
+  else if(strcmp(tok[0], "amd") == 0) vendor = CPU_VENDOR_AMD;
+  else if(strcmp(tok[0], "hygon") == 0) vendor = CPU_VENDOR_HYGON;
+  else {
+    printErr("Invalid vendor: '%s'", tok[0]);
+    return false;
+  }
+
+  if(!uarch_db_parse_int(tok[1], 0, 0xFF, &ef) || !uarch_db_parse_int(tok[2], 0, 0xF, &f) ||
+     !uarch_db_parse_int(tok[3], 0, 0xF, &em) || !uarch_db_parse_int(tok[4], 0, 0xF, &m) ||
+     !uarch_db_parse_int(tok[5], 0, 0xF, &s) || !uarch_db_parse_int(tok[8], 1, 1000, &process) ||
+     (num_tokens == 10 && !uarch_db_parse_int(tok[9], 1, 16, &vpus))) {
+    return false;
+  }
+
+  entry->uarch = uarch_db_parse_symbol(tok[6], uarch_names, sizeof(uarch_names) / sizeof(uarch_names[0]));
+  if(entry->uarch < 0) return false;
+
+  entry->mask = X86_MASK(vendor, ef, f, em, m, s);
+  entry->value = X86_SIG(vendor, ef, f, em, m, s);
+  entry->str = tok[7];
+  entry->process = process;
+  entry->vendor = vendor;
+  entry->vpus = vpus;
+  return true;
 }
 
-// Inspired in Todd Allen's decode_uarch_amd
-struct uarch* get_uarch_from_cpuid_amd(uint32_t ef, uint32_t f, uint32_t em, uint32_t m, int s) {
-  struct uarch* arch = emalloc(sizeof(struct uarch));
-
-  // EF: Extended Family                                                           //
-  // F:  Family                                                                    //
-  // EM: Extended Model                                                            //
-  // M: Model                                                                      //
-  // S: Stepping                                                                   //
-  // ----------------------------------------------------------------------------- //
-  //                 EF  F  EM   M   S                                             //
-  UARCH_START
-  CHECK_UARCH(arch,  0,  4,  0,  3, NA, "Am486DX2",    UARCH_AM486,      UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch,  0,  4,  0,  7, NA, "Am486DX2WB",  UARCH_AM486,      UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch,  0,  4,  0,  8, NA, "Am486DX4",    UARCH_AM486,      UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch,  0,  4,  0,  9, NA, "Am486DX4WB",  UARCH_AM486,      UNK) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch,  0,  4,  0, 14, NA, "Am5x86",      UARCH_AM5X86,     350) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch,  0,  4,  0, 15, NA, "Am5x86WB",    UARCH_AM5X86,     350) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch,  0,  5,  0,  0, NA, "SSA5 (K5)",   UARCH_SSA5,       350) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch,  0,  5,  0,  1, NA, "K5",          UARCH_K5,         350) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch,  0,  5,  0,  2, NA, "K5",          UARCH_K5,         350) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch,  0,  5,  0,  3, NA, "K5",          UARCH_K5,         350) // https://sandpile.org/x86/cpuid.htm#level_0000_0001h
-  CHECK_UARCH(arch,  0,  5,  0,  6, NA, "K6",          UARCH_K6,         300)
-  CHECK_UARCH(arch,  0,  5,  0,  7, NA, "K6",          UARCH_K6,         250) // *p from sandpile.org
-  CHECK_UARCH(arch,  0,  5,  0, 10, NA, "K7",          UARCH_K7,         130) // Geode NX
-  CHECK_UARCH(arch,  0,  5,  0, 13, NA, "K6",          UARCH_K6,          80) // *p from sandpile.org
-  CHECK_UARCH(arch,  0,  5, NA, NA, NA, "K6",          UARCH_K6,         UNK)
-  CHECK_UARCH(arch,  0,  6,  0,  1, NA, "K7",          UARCH_K7,         250)
-  CHECK_UARCH(arch,  0,  6,  0,  2, NA, "K7",          UARCH_K7,         180)
-  CHECK_UARCH(arch,  0,  6, NA, NA, NA, "K7",          UARCH_K7,         UNK)
-  CHECK_UARCH(arch,  0, 15,  0,  4,  8, "K8",          UARCH_K8,         130)
-  CHECK_UARCH(arch,  0, 15,  0,  4, NA, "K8",          UARCH_K8,         130)
-  CHECK_UARCH(arch,  0, 15,  0,  5, NA, "K8",          UARCH_K8,         130)
-  CHECK_UARCH(arch,  0, 15,  0,  7, NA, "K8",          UARCH_K8,         130)
-  CHECK_UARCH(arch,  0, 15,  0,  8, NA, "K8",          UARCH_K8,         130)
-  CHECK_UARCH(arch,  0, 15,  0, 11, NA, "K8",          UARCH_K8,         130)
-  CHECK_UARCH(arch,  0, 15,  0, 12, NA, "K8",          UARCH_K8,         130)
-  CHECK_UARCH(arch,  0, 15,  0, 14, NA, "K8",          UARCH_K8,         130)
-  CHECK_UARCH(arch,  0, 15,  0, 15, NA, "K8",          UARCH_K8,         130)
-  CHECK_UARCH(arch,  0, 15,  1,  4, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  1,  5, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  1,  7, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  1,  8, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  1, 11, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  1, 12, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  1, 15, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  2,  1, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  2,  3, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  2,  4, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  2,  5, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  2,  7, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  2, 11, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  2, 12, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  2, 15, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  4,  1, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  4,  3, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  4,  8, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  4, 11, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  4, 12, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  4, 15, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  5, 13, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  5, 15, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  0, 15,  6,  8, NA, "K8",          UARCH_K8,          65)
-  CHECK_UARCH(arch,  0, 15,  6, 11, NA, "K8",          UARCH_K8,          65)
-  CHECK_UARCH(arch,  0, 15,  6, 12, NA, "K8",          UARCH_K8,          65)
-  CHECK_UARCH(arch,  0, 15,  6, 15, NA, "K8",          UARCH_K8,          65)
-  CHECK_UARCH(arch,  0, 15,  7, 12, NA, "K8",          UARCH_K8,          65)
-  CHECK_UARCH(arch,  0, 15,  7, 15, NA, "K8",          UARCH_K8,          65)
-  CHECK_UARCH(arch,  0, 15, 12,  1, NA, "K8",          UARCH_K8,          90)
-  CHECK_UARCH(arch,  1, 15,  0,  0, NA, "K10",         UARCH_K10,         65) // sandpile.org
-  CHECK_UARCH(arch,  1, 15,  0,  2, NA, "K10",         UARCH_K10,         65)
-  CHECK_UARCH(arch,  1, 15,  0,  4, NA, "K10",         UARCH_K10,         45)
-  CHECK_UARCH(arch,  1, 15,  0,  5, NA, "K10",         UARCH_K10,         45)
-  CHECK_UARCH(arch,  1, 15,  0,  6, NA, "K10",         UARCH_K10,         45)
-  CHECK_UARCH(arch,  1, 15,  0,  8, NA, "K10",         UARCH_K10,         45)
-  CHECK_UARCH(arch,  1, 15,  0,  9, NA, "K10",         UARCH_K10,         45)
-  CHECK_UARCH(arch,  1, 15,  0, 10, NA, "K10",         UARCH_K10,         45)
-  CHECK_UARCH(arch,  2, 15, NA, NA, NA, "Puma 2008",   UARCH_PUMA_2008,   65)
-  CHECK_UARCH(arch,  3, 15, NA, NA, NA, "K10",         UARCH_K10,         32)
-  CHECK_UARCH(arch,  5, 15, NA, NA, NA, "Bobcat",      UARCH_BOBCAT,      40)
-  CHECK_UARCH(arch,  6, 15,  0,  0, NA, "Bulldozer",   UARCH_BULLDOZER,   32) // instlatx64 engr sample
-  CHECK_UARCH(arch,  6, 15,  0,  1, NA, "Bulldozer",   UARCH_BULLDOZER,   32)
-  CHECK_UARCH(arch,  6, 15,  0,  2, NA, "Piledriver",  UARCH_PILEDRIVER,  32)
-  CHECK_UARCH(arch,  6, 15,  1,  0, NA, "Piledriver",  UARCH_PILEDRIVER,  32)
-  CHECK_UARCH(arch,  6, 15,  1,  3, NA, "Piledriver",  UARCH_PILEDRIVER,  32)
-  CHECK_UARCH(arch,  6, 15,  3,  0, NA, "Steamroller", UARCH_STEAMROLLER, 28)
-  CHECK_UARCH(arch,  6, 15,  3,  8, NA, "Steamroller", UARCH_STEAMROLLER, 28)
-  CHECK_UARCH(arch,  6, 15,  4,  0, NA, "Steamroller", UARCH_STEAMROLLER, 28) // Software Optimization Guide (15h) says it has the same iNAt latencies as (6,15),(3,x).
-  CHECK_UARCH(arch,  6, 15,  6,  0, NA, "Excavator",   UARCH_EXCAVATOR,   28) // undocumented, but instlatx64 samples
-  CHECK_UARCH(arch,  6, 15,  6,  5, NA, "Excavator",   UARCH_EXCAVATOR,   28) // undocumented, but sample from Alexandros Couloumbis
-  CHECK_UARCH(arch,  6, 15,  7,  0, NA, "Excavator",   UARCH_EXCAVATOR,   28)
-  CHECK_UARCH(arch,  7, 15,  0,  0, NA, "Jaguar",      UARCH_JAGUAR,      28)
-  CHECK_UARCH(arch,  7, 15,  1, NA, NA, "Jaguar",      UARCH_JAGUAR,      14) // instlatx64 (PS4) Normal PS4 is 28nm, Slim and Pro are 16nm
-  CHECK_UARCH(arch,  7, 15,  2,  6, NA, "Jaguar",      UARCH_JAGUAR,      28) // AMD Cato (Xbox One?)
-  CHECK_UARCH(arch,  7, 15,  3,  0, NA, "Puma 2014",   UARCH_PUMA_2014,   28)
-  CHECK_UARCH(arch,  8, 15,  0,  0, NA, "Zen",         UARCH_ZEN,         14) // instlatx64 engr sample
-  CHECK_UARCH(arch,  8, 15,  0,  1, NA, "Zen",         UARCH_ZEN,         14)
-  CHECK_UARCH(arch,  8, 15,  0,  8, NA, "Zen+",        UARCH_ZEN_PLUS,    12)
-  CHECK_UARCH(arch,  8, 15,  1,  1, NA, "Zen",         UARCH_ZEN,         14) // found only on en.wikichip.org & instlatx64 examples
-  CHECK_UARCH(arch,  8, 15,  1,  8, NA, "Zen+",        UARCH_ZEN_PLUS,    12) // found only on en.wikichip.org
-  CHECK_UARCH(arch,  8, 15,  2,  0, NA, "Zen",         UARCH_ZEN,         14) // Dali, found on instlatx64 and en.wikichip.org
-  CHECK_UARCH(arch,  8, 15,  3,  1, NA, "Zen 2",       UARCH_ZEN2,         7) // found only on en.wikichip.org
-  CHECK_UARCH(arch,  8, 15,  4,  7, NA, "Zen 2",       UARCH_ZEN2,         7) // instlatx64 example (AMD 4700S)
-  CHECK_UARCH(arch,  8, 15,  5,  0, NA, "Zen",         UARCH_ZEN,         14) // instlatx64 example (Subor Z+)
-  CHECK_UARCH(arch,  8, 15,  6,  0, NA, "Zen 2",       UARCH_ZEN2,         7) // undocumented, geekbench.com example
-  CHECK_UARCH(arch,  8, 15,  6,  8, NA, "Zen 2",       UARCH_ZEN2,         7) // found on instlatx64
-  CHECK_UARCH(arch,  8, 15,  7,  1, NA, "Zen 2",       UARCH_ZEN2,         7) // samples from Steven Noonan and instlatx64
-  CHECK_UARCH(arch,  8, 15,  8,  4, NA, "Zen 2",       UARCH_ZEN2,         7) // instlatx64 (Xbox Series X?)
-  CHECK_UARCH(arch,  8, 15,  9,  0,  2, "Zen 2",       UARCH_ZEN2,         7) // Steam Deck (instlatx64)
-  CHECK_UARCH(arch,  8, 15,  10, 0, NA, "Zen 2",       UARCH_ZEN2,         6) // instlatx64
-  CHECK_UARCH(arch, 10, 15,  0,  1, NA, "Zen 3",       UARCH_ZEN3,         7) // instlatx64
-  CHECK_UARCH(arch, 10, 15,  0,  8, NA, "Zen 3",       UARCH_ZEN3,         7) // instlatx64
-  CHECK_UARCH(arch, 10, 15,  1,  1, NA, "Zen 4",       UARCH_ZEN4,         5) // instlatx64
-  CHECK_UARCH(arch, 10, 15,  1,  8, NA, "Zen 4",       UARCH_ZEN4,         5) // instlatx64
-  CHECK_UARCH(arch, 10, 15,  2,  1, NA, "Zen 3",       UARCH_ZEN3,         7) // instlatx64
-  CHECK_UARCH(arch, 10, 15,  3, NA, NA, "Zen 3",       UARCH_ZEN3,         7) // instlatx64
-  CHECK_UARCH(arch, 10, 15,  4,  4, NA, "Zen 3+",      UARCH_ZEN3_PLUS,    6) // instlatx64 (they say it is Zen3...)
-  CHECK_UARCH(arch, 10, 15,  5,  0, NA, "Zen 3",       UARCH_ZEN3,         7) // instlatx64
-  CHECK_UARCH(arch, 10, 15,  6,  1,  2, "Zen 4",       UARCH_ZEN4,         5) // instlatx64
-  CHECK_UARCH(arch, 10, 15,  7,  4,  1, "Zen 4",       UARCH_ZEN4,         4) // instlatx64
-  CHECK_UARCH(arch, 10, 15,  7,  5,  2, "Zen 4",       UARCH_ZEN4,         4) // instlatx64
-  CHECK_UARCH(arch, 10, 15,  7,  8,  0, "Zen 4",       UARCH_ZEN4,         4) // instlatx64
-  CHECK_UARCH(arch, 10, 15,  8, NA, NA, "Zen 4",       UARCH_ZEN4,         5) // instlatx64 (AMD MI300C)
-  CHECK_UARCH(arch, 10, 15,  9, NA, NA, "Zen 4",       UARCH_ZEN4,         5) // instlatx64 (AMD MI300A)
-  CHECK_UARCH(arch, 10, 15, 10, NA, NA, "Zen 4c",      UARCH_ZEN4C,        5) // instlatx64
-  CHECK_UARCH(arch, 11, 15,  0, NA, NA, "Zen 5",       UARCH_ZEN5,         4) // Turin/EPYC (instlatx64)
-  CHECK_UARCH(arch, 11, 15,  1, NA, NA, "Zen 5c",      UARCH_ZEN5C,        3) // Zen5c EPYC (instlatx64, https://en.wikipedia.org/wiki/Zen_5#cite_note-10)
-  CHECK_UARCH(arch, 11, 15,  2, NA, NA, "Zen 5",       UARCH_ZEN5,         4) // Strix Point (instlatx64)
-  CHECK_UARCH(arch, 11, 15,  4, NA, NA, "Zen 5",       UARCH_ZEN5,         4) // Granite Ridge (instlatx64)
-  CHECK_UARCH(arch, 11, 15,  6, NA, NA, "Zen 5",       UARCH_ZEN5,         4) // Krackan Point (instlatx64)
-  CHECK_UARCH(arch, 11, 15,  7, NA, NA, "Zen 5",       UARCH_ZEN5,         4) // Strix Halo (instlatx64)
-  UARCH_END
+static struct uarch_db* get_db(void) {
+  static struct uarch_db* db = NULL;
 
-  return arch;
+  if(db == NULL) {
+    db = uarch_db_build(uarch_table, sizeof(uarch_table) / sizeof(uarch_table[0]), get_uarch_db_file(), parse_uarch_db_entry);
+  }
+  return db;
 }
 
-struct uarch* get_uarch_from_cpuid_hygon(uint32_t ef, uint32_t f, uint32_t em, uint32_t m, int s) {
-  struct uarch* arch = emalloc(sizeof(struct uarch));
-
-  // EF: Extended Family                                                           //
-  // F:  Family                                                                    //
-  // EM: Extended Model                                                            //
-  // M: Model                                                                      //
-  // S: Stepping                                                                   //
-  // ----------------------------------------------------------------------------- //
-  //                 EF  F  EM   M   S                                             //
-  UARCH_START
-  // https://www.phoronix.com/news/Hygon-Dhyana-AMD-China-CPUs
-  CHECK_UARCH(arch,  9,  15,  0,  1, NA, "Zen",       UARCH_ZEN,      UNK) // https://github.com/Dr-Noob/cpufetch/issues/244
-  // CHECK_UARCH(arch,  9,  15,  0,  2, NA, "???",       ?????????,      UNK) // http://instlatx64.atw.hu/
-  UARCH_END
+static const struct uarch_db_entry* lookup_uarch(VENDOR vendor, int32_t ef, int32_t f, int32_t em, int32_t m, int32_t s) {
+  return uarch_db_lookup(get_db(), X86_SIG(vendor, ef, f, em, m, s));
+}
+
+struct uarch* get_uarch_from_db(VENDOR vendor, int32_t ef, int32_t f, int32_t em, int32_t m, int32_t s) {
+  struct uarch* arch = amalloc(sizeof(struct uarch));
+  const struct uarch_db_entry* entry = lookup_uarch(vendor, ef, f, em, m, s);
+  if(entry == NULL) {
+    printBugCheckRelease("Unknown microarchitecture detected: M=0x%X EM=0x%X F=0x%X EF=0x%X S=0x%X", m, em, f, ef, s);
+    fill_uarch(arch, STRING_UNKNOWN, UARCH_UNKNOWN, UNK);
+  }
+  else {
+    fill_uarch(arch, entry->str, entry->uarch, entry->process);
+    arch->vpus = entry->vpus;
+  }
 
   return arch;
 }
 
 struct uarch* get_uarch_from_cpuid(struct cpuInfo* cpu, uint32_t dump, uint32_t ef, uint32_t f, uint32_t em, uint32_t m, int s) {
   if(cpu->cpu_vendor == CPU_VENDOR_INTEL) {
-    struct uarch* arch = emalloc(sizeof(struct uarch));
+    // An entry of the --uarch-db file takes priority over the special cases below
+    if(uarch_db_is_override(get_db(), lookup_uarch(CPU_VENDOR_INTEL, ef, f, em, m, s))) {
+      return get_uarch_from_db(CPU_VENDOR_INTEL, ef, f, em, m, s);
+    }
+
+    struct uarch* arch = amalloc(sizeof(struct uarch));
     // TODO: Refactor these 3 checks in a common function.
     if(dump == 0x000806E9) {
       if (cpu->cpu_name == NULL) {
@@ -511,13 +635,10 @@ struct uarch* get_uarch_from_cpuid(struct cpuInfo* cpu, uint32_t dump, uint32_t
 
       return arch;
     }
-    return get_uarch_from_cpuid_intel(ef, f, em, m, s);
-  }
-  else if(cpu->cpu_vendor == CPU_VENDOR_AMD) {
-    return get_uarch_from_cpuid_amd(ef, f, em, m, s);
+    return get_uarch_from_db(CPU_VENDOR_INTEL, ef, f, em, m, s);
   }
-  else if(cpu->cpu_vendor == CPU_VENDOR_HYGON) {
-    return get_uarch_from_cpuid_hygon(ef, f, em, m, s);
+  else if(cpu->cpu_vendor == CPU_VENDOR_AMD || cpu->cpu_vendor == CPU_VENDOR_HYGON) {
+    return get_uarch_from_db(cpu->cpu_vendor, ef, f, em, m, s);
   }
   else {
     printBug("Invalid CPU vendor: %d", cpu->cpu_vendor);
@@ -530,7 +651,7 @@ char* infer_cpu_name_from_uarch(struct uarch* arch) {
   char* cpu_name = NULL;
   if (arch == NULL) {
     printErr("infer_cpu_name_from_uarch: Unable to find CPU name");
-    cpu_name = ecalloc(strlen(STRING_UNKNOWN) + 1, sizeof(char));
+    cpu_name = acalloc(strlen(STRING_UNKNOWN) + 1, sizeof(char));
     strcpy(cpu_name, STRING_UNKNOWN);
     return cpu_name;
   }
@@ -575,11 +696,11 @@ char* infer_cpu_name_from_uarch(struct uarch* arch) {
   }
 
   if (str == NULL) {
-    cpu_name = ecalloc(strlen(STRING_UNKNOWN) + 1, sizeof(char));
+    cpu_name = acalloc(strlen(STRING_UNKNOWN) + 1, sizeof(char));
     strcpy(cpu_name, STRING_UNKNOWN);
   }
   else {
-    cpu_name = ecalloc(strlen(str) + 1, sizeof(char));
+    cpu_name = acalloc(strlen(str) + 1, sizeof(char));
     strcpy(cpu_name, str);
   }
 
@@ -600,6 +721,8 @@ bool is_knights_landing(struct cpuInfo* cpu) {
 }
 
 int get_number_of_vpus(struct cpuInfo* cpu) {
+  if(cpu->arch->vpus != NA) return cpu->arch->vpus;
+
   switch(cpu->arch->uarch) {
       // Intel
       case UARCH_HASWELL:
@@ -655,7 +778,7 @@ char* get_str_uarch(struct cpuInfo* cpu) {
 }
 
 char* get_str_process(struct cpuInfo* cpu) {
-  char* str = emalloc(sizeof(char) * (strlen(STRING_UNKNOWN)+1));
+  char* str = amalloc(sizeof(char) * (strlen(STRING_UNKNOWN)+1));
   int32_t process = cpu->arch->process;
 
   if(process == UNK) {
@@ -672,7 +795,22 @@ char* get_str_process(struct cpuInfo* cpu) {
   return str;
 }
 
-void free_uarch_struct(struct uarch* arch) {
-  free(arch->uarch_str);
-  free(arch);
+// Used to rebuild the uarch from the detection cache
+struct uarch* new_uarch_struct(uint32_t u, char* str, int32_t process, int32_t vpus) {
+  struct uarch* arch = amalloc(sizeof(struct uarch));
+  fill_uarch(arch, str, u, process);
+  arch->vpus = vpus;
+  return arch;
+}
+
+uint32_t get_uarch_id(struct uarch* arch) {
+  return arch->uarch;
+}
+
+int32_t get_uarch_process(struct uarch* arch) {
+  return arch->process;
+}
+
+int32_t get_uarch_vpus(struct uarch* arch) {
+  return arch->vpus;
 }
@@ -15,6 +15,9 @@ int get_number_of_vpus(struct cpuInfo* cpu);
 bool choose_new_intel_logo_uarch(struct cpuInfo* cpu);
 char* get_str_uarch(struct cpuInfo* cpu);
 char* get_str_process(struct cpuInfo* cpu);
-void free_uarch_struct(struct uarch* arch);
+struct uarch* new_uarch_struct(uint32_t u, char* str, int32_t process, int32_t vpus);
+uint32_t get_uarch_id(struct uarch* arch);
+int32_t get_uarch_process(struct uarch* arch);
+int32_t get_uarch_vpus(struct uarch* arch);
 
 #endif